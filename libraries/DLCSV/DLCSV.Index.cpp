@@ -0,0 +1,260 @@
+/*
+ * DLCSV.Index.cpp
+ *
+ * Sidecar time index for daily CSV data files
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include <time.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.LineReader.h"
+#include "DLCSV.h"
+#include "DLCSV.Index.h"
+
+/*
+ * Private Functions
+ */
+
+static void putU32(uint8_t * p, uint32_t value)
+{
+    p[0] = (uint8_t)(value);
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t getU32(uint8_t const * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool readRowTimestamp(char const * const row, uint32_t * timestamp)
+{
+    TM time;
+    if (!CSV_readTimestampFromBuffer(row, &time)) { return false; }
+
+    *timestamp = (uint32_t)time_to_unix_seconds(&time);
+    return true;
+}
+
+/*
+ * CSVIndexWriter Public Class Functions
+ */
+
+CSVIndexWriter::CSVIndexWriter(LocalStorageInterface * storage, uint32_t resolution)
+{
+    m_storage = storage;
+    m_resolution = (resolution > 0) ? resolution : CSV_INDEX_RESOLUTION_MINUTE;
+    m_dataFile = INVALID_HANDLE;
+    m_indexFile = INVALID_HANDLE;
+    m_offset = 0;
+    m_lastSlot = 0;
+    m_slotValid = false;
+}
+
+/*
+ * begin
+ *
+ * Starts indexing rows appended to dataFile. Rows already in the file are not indexed again,
+ * but the first row written will add an entry for its slot (so appending to an existing day's
+ * file may add a second entry for the same slot, which the query handles).
+ */
+void CSVIndexWriter::begin(FILE_HANDLE dataFile, FILE_HANDLE indexFile)
+{
+    m_dataFile = dataFile;
+    m_indexFile = indexFile;
+    m_offset = (dataFile != INVALID_HANDLE) ? m_storage->fileSize(dataFile) : 0;
+    m_slotValid = false;
+}
+
+/*
+ * writeRow
+ *
+ * Writes a row to the data file, indexing it by its leading timestamp.
+ * Rows without a timestamp (e.g. a header) are written but not indexed.
+ */
+void CSVIndexWriter::writeRow(char const * const row)
+{
+    if (!row) { return; }
+
+    uint32_t length = strlen(row);
+    uint32_t timestamp;
+
+    if (readRowTimestamp(row, &timestamp))
+    {
+        addRow(timestamp, length);
+    }
+    else
+    {
+        m_offset += length;
+    }
+
+    m_storage->write(m_dataFile, row);
+}
+
+/*
+ * addRow
+ *
+ * Records that a row of length bytes with the given timestamp is about to be written
+ * to the data file by the caller. Adds an index entry if the row starts a new slot.
+ */
+void CSVIndexWriter::addRow(uint32_t timestamp, uint32_t length)
+{
+    uint32_t slot = timestamp - (timestamp % m_resolution);
+
+    if (!m_slotValid || (slot != m_lastSlot))
+    {
+        uint8_t entry[CSV_INDEX_ENTRY_SIZE];
+        putU32(&entry[0], slot);
+        putU32(&entry[4], m_offset);
+
+        m_storage->writeBytes(m_indexFile, entry, CSV_INDEX_ENTRY_SIZE);
+
+        m_lastSlot = slot;
+        m_slotValid = true;
+    }
+
+    m_offset += length;
+}
+
+uint32_t CSVIndexWriter::offset(void) { return m_offset; }
+
+/*
+ * CSVTimeQuery Public Class Functions
+ */
+
+CSVTimeQuery::CSVTimeQuery(LocalStorageInterface * storage) : m_reader(storage, INVALID_HANDLE)
+{
+    m_storage = storage;
+    m_t0 = 0;
+    m_t1 = 0;
+    m_startOffset = 0;
+    m_done = true;
+}
+
+/*
+ * begin
+ *
+ * Seeks the data file to the first row that could be in the range.
+ * Returns false if the data file is invalid or cannot be seeked.
+ */
+bool CSVTimeQuery::begin(FILE_HANDLE dataFile, FILE_HANDLE indexFile, uint32_t t0, uint32_t t1)
+{
+    m_t0 = t0;
+    m_t1 = t1;
+    m_done = true;
+    m_reader.attach(INVALID_HANDLE);
+
+    if (dataFile == INVALID_HANDLE) { return false; }
+
+    m_startOffset = findStartOffset(indexFile);
+
+    if (!m_storage->seek(dataFile, m_startOffset)) { return false; }
+
+    m_reader.attach(dataFile);
+    m_done = false;
+
+    return true;
+}
+
+/*
+ * readRecord
+ *
+ * Reads the next row in the range into buffer (with line endings stripped)
+ * and its timestamp into timestamp. Returns the row length, or 0 if there are no more rows.
+ */
+uint32_t CSVTimeQuery::readRecord(char * buffer, uint32_t n, uint32_t * timestamp)
+{
+    uint32_t length;
+    uint32_t rowTime;
+
+    while (!m_done && !m_reader.endOfFile())
+    {
+        length = m_reader.readLine(buffer, n, true);
+
+        if (length == 0) { continue; }
+
+        if (!readRowTimestamp(buffer, &rowTime)) { continue; }
+        if (rowTime < m_t0) { continue; }
+
+        if (rowTime > m_t1)
+        {
+            m_done = true;
+            break;
+        }
+
+        if (timestamp) { *timestamp = rowTime; }
+        return length;
+    }
+
+    m_done = true;
+    return 0;
+}
+
+uint32_t CSVTimeQuery::startOffset(void) { return m_startOffset; }
+
+/*
+ * CSVTimeQuery Private Class Functions
+ */
+
+/*
+ * findStartOffset
+ *
+ * Returns the offset of the first entry with the latest slot time at or before t0.
+ * Equal slot times can appear if a day's file was appended to after a restart; the first
+ * is used since rows in both parts of the file may be in range.
+ */
+uint32_t CSVTimeQuery::findStartOffset(FILE_HANDLE indexFile)
+{
+    if (indexFile == INVALID_HANDLE) { return 0; }
+    if (!m_storage->seek(indexFile, 0)) { return 0; }
+
+    uint8_t entries[CSV_INDEX_ENTRY_SIZE * CSV_INDEX_READ_ENTRIES];
+    uint32_t count;
+    uint32_t i;
+    uint32_t slot;
+
+    uint32_t bestOffset = 0;
+    uint32_t bestSlot = 0;
+    bool found = false;
+
+    while ((count = m_storage->readBytes(indexFile, (char *)entries, sizeof(entries))) >= CSV_INDEX_ENTRY_SIZE)
+    {
+        for (i = 0; (i + CSV_INDEX_ENTRY_SIZE) <= count; i += CSV_INDEX_ENTRY_SIZE)
+        {
+            slot = getU32(&entries[i]);
+
+            if (slot > m_t0) { return bestOffset; }
+
+            if (!found || (slot > bestSlot))
+            {
+                bestSlot = slot;
+                bestOffset = getU32(&entries[i + 4]);
+                found = true;
+            }
+        }
+    }
+
+    return bestOffset;
+}
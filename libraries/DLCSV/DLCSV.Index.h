@@ -0,0 +1,87 @@
+#ifndef _DL_CSV_INDEX_H_
+#define _DL_CSV_INDEX_H_
+
+/*
+ * CSV time index
+ *
+ * Sidecar index for a daily CSV data file (see Filename_getIndex), mapping time slots
+ * (minutes or hours) to the byte offset of the first row in that slot.
+ *
+ * The index is a sequence of 8 byte entries, appended as rows are written:
+ *   slot start time (u32, unix seconds) | byte offset of first row in slot (u32)
+ * All values are little-endian.
+ *
+ * Rows are expected to be appended in time order and to start with a timestamp
+ * written by CSV_writeTimestampToBuffer. Timestamps are compared as time_to_unix_seconds
+ * of the TM they were written from.
+ */
+
+#define CSV_INDEX_RESOLUTION_MINUTE (60UL)
+#define CSV_INDEX_RESOLUTION_HOUR (3600UL)
+
+#define CSV_INDEX_ENTRY_SIZE (8)
+#define CSV_INDEX_READ_ENTRIES (16)
+
+/*
+ * CSVIndexWriter
+ *
+ * Appends rows to the data file and an index entry each time a row starts a new slot.
+ * Both files should be open for writing (appending) before begin() is called.
+ */
+
+class CSVIndexWriter
+{
+    public:
+        CSVIndexWriter(LocalStorageInterface * storage, uint32_t resolution);
+
+        void begin(FILE_HANDLE dataFile, FILE_HANDLE indexFile);
+        void writeRow(char const * const row);
+        void addRow(uint32_t timestamp, uint32_t length);
+        uint32_t offset(void);
+
+    private:
+        LocalStorageInterface * m_storage;
+        FILE_HANDLE m_dataFile;
+        FILE_HANDLE m_indexFile;
+
+        uint32_t m_resolution;
+        uint32_t m_offset;
+        uint32_t m_lastSlot;
+        bool m_slotValid;
+};
+
+/*
+ * CSVTimeQuery
+ *
+ * Returns the rows of a data file with timestamps between t0 and t1 (inclusive).
+ * The index is used to seek straight to the last slot starting at or before t0;
+ * if there is no index (or it is empty) the data file is read from the start.
+ * Both files should be open for reading before begin() is called.
+ *
+ * readRecord skips rows without a timestamp (e.g. the header) and rows before t0,
+ * and returns 0 once a row after t1 or the end of the file is reached.
+ * The buffer should be large enough for a whole row.
+ */
+
+class CSVTimeQuery
+{
+    public:
+        CSVTimeQuery(LocalStorageInterface * storage);
+
+        bool begin(FILE_HANDLE dataFile, FILE_HANDLE indexFile, uint32_t t0, uint32_t t1);
+        uint32_t readRecord(char * buffer, uint32_t n, uint32_t * timestamp);
+        uint32_t startOffset(void);
+
+    private:
+        uint32_t findStartOffset(FILE_HANDLE indexFile);
+
+        LocalStorageInterface * m_storage;
+        LineReader m_reader;
+
+        uint32_t m_t0;
+        uint32_t m_t1;
+        uint32_t m_startOffset;
+        bool m_done;
+};
+
+#endif
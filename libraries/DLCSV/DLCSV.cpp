@@ -31,3 +31,35 @@ void CSV_writeTimestampToBuffer(TM * time, char * buffer)
         time->tm_hour, time->tm_min, time->tm_sec);
 
 }
+
+/*
+ * CSV_readTimestampFromBuffer
+ *
+ * Reads a timestamp written by CSV_writeTimestampToBuffer back into time (including tm_yday,
+ * so that the result can be passed to time_to_unix_seconds).
+ * Returns false if the buffer does not start with a timestamp.
+ */
+bool CSV_readTimestampFromBuffer(char const * const buffer, TM * time)
+{
+    if (!buffer || !time) { return false; }
+
+    int year, month, day, hour, minute, second;
+
+    if (sscanf(buffer, "%d-%d-%d %d:%d:%d", &year, &month, &day, &hour, &minute, &second) != 6)
+    {
+        return false;
+    }
+
+    // The month is written as-is from tm_mon, so it is read back the same way
+    if ((month < JANUARY) || (month > DECEMBER)) { return false; }
+
+    time->tm_year = GREGORIAN_TO_C_YEAR(year);
+    time->tm_mon = month;
+    time->tm_mday = day;
+    time->tm_hour = hour;
+    time->tm_min = minute;
+    time->tm_sec = second;
+    time->tm_yday = calculate_days_into_year(time);
+
+    return true;
+}
@@ -2,5 +2,6 @@
 #define _DL_CSV_H_
 
 void CSV_writeTimestampToBuffer(TM * time, char * buffer);
+bool CSV_readTimestampFromBuffer(char const * const buffer, TM * time);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,276 @@
+/*
+ * DLCSV.Index.Test.cpp
+ *
+ * Tests the CSV time index writer and query
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.LineReader.h"
+#include "DLCSV.h"
+#include "DLCSV.Index.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define xstr(s) str(s)
+#define str(s) #s
+#define QUOTED_DL_PATH xstr(DL_PATH)
+
+#define TEST_DATA_PATH QUOTED_DL_PATH "/DLCSV/Test/TestData.csv"
+#define TEST_INDEX_PATH QUOTED_DL_PATH "/DLCSV/Test/TestData.idx"
+
+static LocalStorageInterface * s_storage;
+static char s_row[100];
+static char s_buffer[100];
+
+static uint32_t makeRow(uint8_t hour, uint8_t minute, uint8_t second, int value)
+{
+    TM time;
+
+    time.tm_year = 115; // 2015 as years since 1900
+    time.tm_mon = APRIL;
+    time.tm_mday = 3;
+    time.tm_hour = hour;
+    time.tm_min = minute;
+    time.tm_sec = second;
+    time.tm_yday = calculate_days_into_year(&time);
+
+    CSV_writeTimestampToBuffer(&time, s_row);
+    sprintf(&s_row[strlen(s_row)], ", %d\r\n", value);
+
+    return (uint32_t)time_to_unix_seconds(&time);
+}
+
+static uint32_t secondsInDay(uint8_t hour, uint8_t minute, uint8_t second)
+{
+    uint32_t midnight = makeRow(0, 0, 0, 0);
+    return midnight + ((uint32_t)hour * 3600UL) + ((uint32_t)minute * 60UL) + second;
+}
+
+// Writes a header then two rows per minute from 13:00 to 13:09, valued 0 to 19
+static void writeTestFiles(uint32_t resolution)
+{
+    FILE_HANDLE data = s_storage->openFile(TEST_DATA_PATH, true);
+    FILE_HANDLE index = s_storage->openFile(TEST_INDEX_PATH, true);
+
+    CSVIndexWriter writer(s_storage, resolution);
+    writer.begin(data, index);
+    writer.writeRow("Timestamp, Value\r\n");
+
+    for (uint8_t i = 0; i < 20; i++)
+    {
+        makeRow(13, i / 2, (i % 2) * 30, i);
+        writer.writeRow(s_row);
+    }
+
+    s_storage->closeFile(index);
+    s_storage->closeFile(data);
+}
+
+struct query_result
+{
+    bool began;
+    uint8_t count;
+    uint8_t outOfRange;
+    int firstValue;
+    uint32_t startOffset;
+};
+typedef struct query_result QUERY_RESULT;
+
+static void runQuery(uint32_t t0, uint32_t t1, bool useIndex, QUERY_RESULT * result)
+{
+    FILE_HANDLE data = s_storage->openFile(TEST_DATA_PATH, false);
+    FILE_HANDLE index = useIndex ? s_storage->openFile(TEST_INDEX_PATH, false) : INVALID_HANDLE;
+
+    CSVTimeQuery query(s_storage);
+    uint32_t timestamp;
+
+    memset(result, 0, sizeof(QUERY_RESULT));
+    result->firstValue = -1;
+
+    result->began = query.begin(data, index, t0, t1);
+    result->startOffset = query.startOffset();
+
+    while (query.readRecord(s_buffer, 100, &timestamp))
+    {
+        if ((timestamp < t0) || (timestamp > t1)) { result->outOfRange++; }
+        if (result->count == 0) { sscanf(strchr(s_buffer, ',') + 1, "%d", &result->firstValue); }
+        result->count++;
+    }
+
+    s_storage->closeFile(index);
+    s_storage->closeFile(data);
+}
+
+void setUp(void)
+{
+    s_storage = LocalStorage_GetLocalStorageInterface(LOCAL_STORAGE_TYPE(0));
+    s_storage->removeFile(TEST_DATA_PATH);
+    s_storage->removeFile(TEST_INDEX_PATH);
+}
+
+void tearDown(void)
+{
+    s_storage->removeFile(TEST_DATA_PATH);
+    s_storage->removeFile(TEST_INDEX_PATH);
+}
+
+void test_IndexHasOneEntryPerSlot(void)
+{
+    writeTestFiles(CSV_INDEX_RESOLUTION_MINUTE);
+
+    uint8_t entries[CSV_INDEX_ENTRY_SIZE * 11];
+    FILE_HANDLE index = s_storage->openFile(TEST_INDEX_PATH, false);
+    uint32_t count = s_storage->readBytes(index, (char *)entries, sizeof(entries));
+    s_storage->closeFile(index);
+
+    TEST_ASSERT_EQUAL(CSV_INDEX_ENTRY_SIZE * 10, count);
+
+    makeRow(13, 0, 0, 0);
+    uint32_t rowLength = strlen(s_row);
+    uint32_t headerLength = strlen("Timestamp, Value\r\n");
+    uint32_t slot = secondsInDay(13, 3, 0);
+    uint32_t offset = headerLength + (6 * rowLength);
+
+    // Fourth entry is 13:03, after the header and six rows
+    TEST_ASSERT_EQUAL_MEMORY(&slot, &entries[3 * CSV_INDEX_ENTRY_SIZE], 4);
+    TEST_ASSERT_EQUAL_MEMORY(&offset, &entries[(3 * CSV_INDEX_ENTRY_SIZE) + 4], 4);
+}
+
+void test_QueryReturnsRowsInRange(void)
+{
+    QUERY_RESULT result;
+
+    writeTestFiles(CSV_INDEX_RESOLUTION_MINUTE);
+
+    runQuery(secondsInDay(13, 3, 30), secondsInDay(13, 6, 0), true, &result);
+
+    // 13:03:30, 13:04:00, 13:04:30, 13:05:00, 13:05:30, 13:06:00
+    TEST_ASSERT_TRUE(result.began);
+    TEST_ASSERT_EQUAL(6, result.count);
+    TEST_ASSERT_EQUAL(0, result.outOfRange);
+    TEST_ASSERT_EQUAL(7, result.firstValue);
+
+    // Reading starts at the 13:03 slot
+    makeRow(13, 0, 0, 0);
+    TEST_ASSERT_EQUAL(strlen("Timestamp, Value\r\n") + (6 * strlen(s_row)), result.startOffset);
+}
+
+void test_QueryWithoutIndexReadsFromStart(void)
+{
+    QUERY_RESULT result;
+
+    writeTestFiles(CSV_INDEX_RESOLUTION_MINUTE);
+
+    runQuery(secondsInDay(13, 3, 30), secondsInDay(13, 6, 0), false, &result);
+
+    TEST_ASSERT_TRUE(result.began);
+    TEST_ASSERT_EQUAL(6, result.count);
+    TEST_ASSERT_EQUAL(0, result.outOfRange);
+    TEST_ASSERT_EQUAL(7, result.firstValue);
+    TEST_ASSERT_EQUAL(0, result.startOffset);
+}
+
+void test_QueryBeforeFirstRowStartsAtBeginning(void)
+{
+    QUERY_RESULT result;
+
+    writeTestFiles(CSV_INDEX_RESOLUTION_MINUTE);
+
+    runQuery(secondsInDay(12, 0, 0), secondsInDay(13, 0, 30), true, &result);
+
+    TEST_ASSERT_EQUAL(2, result.count);
+    TEST_ASSERT_EQUAL(0, result.firstValue);
+    TEST_ASSERT_EQUAL(0, result.startOffset);
+}
+
+void test_QueryAfterLastRowReturnsNothing(void)
+{
+    QUERY_RESULT result;
+
+    writeTestFiles(CSV_INDEX_RESOLUTION_MINUTE);
+
+    runQuery(secondsInDay(14, 0, 0), secondsInDay(15, 0, 0), true, &result);
+
+    TEST_ASSERT_TRUE(result.began);
+    TEST_ASSERT_EQUAL(0, result.count);
+}
+
+void test_HourResolutionIndexHasOneEntry(void)
+{
+    QUERY_RESULT result;
+
+    writeTestFiles(CSV_INDEX_RESOLUTION_HOUR);
+
+    FILE_HANDLE index = s_storage->openFile(TEST_INDEX_PATH, false);
+    TEST_ASSERT_EQUAL(CSV_INDEX_ENTRY_SIZE, s_storage->fileSize(index));
+    s_storage->closeFile(index);
+
+    runQuery(secondsInDay(13, 9, 0), secondsInDay(13, 9, 30), true, &result);
+
+    TEST_ASSERT_EQUAL(2, result.count);
+    TEST_ASSERT_EQUAL(18, result.firstValue);
+}
+
+void test_AppendingToExistingFileContinuesOffsets(void)
+{
+    QUERY_RESULT result;
+
+    writeTestFiles(CSV_INDEX_RESOLUTION_MINUTE);
+
+    FILE_HANDLE data = s_storage->openFile(TEST_DATA_PATH, true);
+    FILE_HANDLE index = s_storage->openFile(TEST_INDEX_PATH, true);
+    uint32_t existingSize = s_storage->fileSize(data);
+
+    CSVIndexWriter writer(s_storage, CSV_INDEX_RESOLUTION_MINUTE);
+    writer.begin(data, index);
+    TEST_ASSERT_EQUAL(existingSize, writer.offset());
+
+    makeRow(13, 20, 0, 100);
+    writer.writeRow(s_row);
+
+    s_storage->closeFile(index);
+    s_storage->closeFile(data);
+
+    runQuery(secondsInDay(13, 20, 0), secondsInDay(13, 25, 0), true, &result);
+
+    TEST_ASSERT_EQUAL(1, result.count);
+    TEST_ASSERT_EQUAL(100, result.firstValue);
+    TEST_ASSERT_EQUAL(existingSize, result.startOffset);
+}
+
+int main(void)
+{
+    UnityBegin("DLCSV.Index.Test.cpp");
+
+    RUN_TEST(test_IndexHasOneEntryPerSlot);
+    RUN_TEST(test_QueryReturnsRowsInRange);
+    RUN_TEST(test_QueryWithoutIndexReadsFromStart);
+    RUN_TEST(test_QueryBeforeFirstRowStartsAtBeginning);
+    RUN_TEST(test_QueryAfterLastRowReturnsNothing);
+    RUN_TEST(test_HourResolutionIndexHasOneEntry);
+    RUN_TEST(test_AppendingToExistingFileContinuesOffsets);
+
+    return (UnityEnd());
+}
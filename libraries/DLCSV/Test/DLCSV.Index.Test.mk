@@ -0,0 +1,16 @@
+INC_DIRS += -IDLCSV
+INC_DIRS += -IDLUtility
+INC_DIRS += -IDLLocalStorage
+
+SRC_FILES += DLCSV/DLCSV.cpp
+SRC_FILES += DLTest/DLTest.Mock.LocalStorage.cpp
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+SRC_FILES += DLUtility/DLUtility.Time.cpp
+SRC_FILES += DLLocalStorage/DLLocalStorage.Handles.cpp
+SRC_FILES += DLLocalStorage/DLLocalStorage.LineReader.cpp
+
+local_setup:
+	rm -f ./DLCSV/Test/TestData.csv ./DLCSV/Test/TestData.idx
+
+local_teardown:
+	rm -f ./DLCSV/Test/TestData.csv ./DLCSV/Test/TestData.idx
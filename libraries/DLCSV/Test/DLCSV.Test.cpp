@@ -14,6 +14,7 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <math.h>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -49,11 +50,29 @@ void test_TimestampsAreCreatedSuccessfully(void)
 	TEST_ASSERT_EQUAL_STRING("2015-04-03 13:09:34 +0000", buffer);
 }
 
+void test_TimestampsAreReadBackSuccessfully(void)
+{
+	TM testTime;
+
+	TEST_ASSERT_TRUE(CSV_readTimestampFromBuffer("2015-04-03 13:09:34 +0000, 1.23", &testTime));
+
+	TEST_ASSERT_EQUAL(115, testTime.tm_year);
+	TEST_ASSERT_EQUAL(4, testTime.tm_mon);
+	TEST_ASSERT_EQUAL(3, testTime.tm_mday);
+	TEST_ASSERT_EQUAL(13, testTime.tm_hour);
+	TEST_ASSERT_EQUAL(9, testTime.tm_min);
+	TEST_ASSERT_EQUAL(34, testTime.tm_sec);
+	TEST_ASSERT_EQUAL(calculate_days_into_year(&testTime), testTime.tm_yday);
+
+	TEST_ASSERT_FALSE(CSV_readTimestampFromBuffer("Timestamp, Voltage", &testTime));
+}
+
 int main(void)
 {
     UnityBegin("DLCSV.Test.cpp");
 
  	RUN_TEST(test_TimestampsAreCreatedSuccessfully);
+ 	RUN_TEST(test_TimestampsAreReadBackSuccessfully);
 
     return 0;
 }
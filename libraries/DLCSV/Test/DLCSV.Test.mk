@@ -1,2 +1,8 @@
 INC_DIRS += -IDLCSV
 INC_DIRS += -IDLUtility
+
+SRC_FILES += DLUtility/DLUtility.Time.cpp
+
+local_setup: ;
+
+local_teardown: ;
@@ -25,29 +25,21 @@
  */
 
 #include "DLUtility.Averager.h"
-#include "DLUtility.PD.h"
 #include "DLSensor.Thermistor.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.h"
+#include "DLDataField.ConversionPolicy.h"
 
 /*
  * Private Functions
  */
 
-/* 
- * mvToAmps
- *
- * Where a reading in mV represents a current,
- * perform a conversion based on mvPerAmp factor.
- * Since sensors may output at >0V for 0A, allow application of an offset
- *
- * mv: millivolt reading representing current
- * mvPerAmp: conversion factor
- * mvAtZero : Zero offset
- */
-static float mvToAmps(float mV, float mVperAmp, float mvAtZero)
+static void copyN(const float * raw, float * converted, uint32_t n)
 {
-	return (mV - mvAtZero) / mVperAmp;
+	if (raw != converted)
+	{
+		memmove(converted, raw, n * sizeof(float));
+	}
 }
 
 /*
@@ -78,17 +70,7 @@ float CONV_ADCtoMillivolts(float in, float mvPerBit)
  */
 float CONV_VoltsFromRaw(float raw, VOLTAGECHANNEL * conversionData)
 {
-	if (conversionData)
-	{
-		float volts = CONV_ADCtoMillivolts(raw, conversionData->mvPerBit) / 1000;
-    	volts -= conversionData->offset;
-    	volts *= conversionData->multiplier;
-    	return PD_GetInputVoltage(volts, conversionData->R1, conversionData->R2);
-    }
-    else
-    {
-    	return raw;
-    }
+	return conversionData ? ConversionPolicy<VOLTAGE>::convert(raw, *conversionData) : raw;
 }
 
 /* 
@@ -102,15 +84,7 @@ float CONV_VoltsFromRaw(float raw, VOLTAGECHANNEL * conversionData)
  */
 float CONV_AmpsFromRaw(float raw, CURRENTCHANNEL * conversionData)
 {
-	if (conversionData)
-	{
-		float mv = CONV_ADCtoMillivolts(raw, conversionData->mvPerBit);
-		return mvToAmps(mv,conversionData->mvPerAmp, conversionData->offset);
-	}
-	else
-	{
-		return raw;
-	}
+	return conversionData ? ConversionPolicy<CURRENT>::convert(raw, *conversionData) : raw;
 }
 
 /* 
@@ -123,6 +97,53 @@ float CONV_AmpsFromRaw(float raw, CURRENTCHANNEL * conversionData)
  */
 float CONV_CelsiusFromRawThermistor(float raw, THERMISTORCHANNEL * conversionData)
 {
-    Thermistor thermistor = Thermistor(conversionData->B, conversionData->R25, conversionData->highside);
-    return thermistor.TemperatureFromADCReading(conversionData->otherR, raw, conversionData->maxADC);
+    return ConversionPolicy<TEMPERATURE_C>::convert(raw, *conversionData);
+}
+
+/*
+ * CONV_VoltsFromRawN, CONV_AmpsFromRawN, CONV_CelsiusFromRawThermistorN
+ *
+ * Array versions of the conversions above.
+ * Without conversion data, the raw values are copied unchanged.
+ */
+void CONV_VoltsFromRawN(const float * raw, float * converted, uint32_t n, const VOLTAGECHANNEL * conversionData)
+{
+	if (!raw || !converted) { return; }
+
+	if (conversionData)
+	{
+		ConversionPolicy<VOLTAGE>::convertN(raw, converted, n, *conversionData);
+	}
+	else
+	{
+		copyN(raw, converted, n);
+	}
+}
+
+void CONV_AmpsFromRawN(const float * raw, float * converted, uint32_t n, const CURRENTCHANNEL * conversionData)
+{
+	if (!raw || !converted) { return; }
+
+	if (conversionData)
+	{
+		ConversionPolicy<CURRENT>::convertN(raw, converted, n, *conversionData);
+	}
+	else
+	{
+		copyN(raw, converted, n);
+	}
+}
+
+void CONV_CelsiusFromRawThermistorN(const float * raw, float * converted, uint32_t n, const THERMISTORCHANNEL * conversionData)
+{
+	if (!raw || !converted) { return; }
+
+	if (conversionData)
+	{
+		ConversionPolicy<TEMPERATURE_C>::convertN(raw, converted, n, *conversionData);
+	}
+	else
+	{
+		copyN(raw, converted, n);
+	}
 }
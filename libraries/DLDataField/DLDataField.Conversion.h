@@ -7,4 +7,12 @@ float CONV_VoltsFromRaw(float raw, VOLTAGECHANNEL * conversionData);
 float CONV_AmpsFromRaw(float raw, CURRENTCHANNEL * conversionData);
 float CONV_CelsiusFromRawThermistor(float raw, THERMISTORCHANNEL * conversionData);
 
+/*
+ * Array versions of the conversions above.
+ * raw and converted may point to the same array for in-place conversion.
+ */
+void CONV_VoltsFromRawN(const float * raw, float * converted, uint32_t n, const VOLTAGECHANNEL * conversionData);
+void CONV_AmpsFromRawN(const float * raw, float * converted, uint32_t n, const CURRENTCHANNEL * conversionData);
+void CONV_CelsiusFromRawThermistorN(const float * raw, float * converted, uint32_t n, const THERMISTORCHANNEL * conversionData);
+
 #endif
@@ -0,0 +1,146 @@
+#ifndef _DATAFIELD_CONVERSION_POLICY_H_
+#define _DATAFIELD_CONVERSION_POLICY_H_
+
+/*
+ * ConversionPolicy
+ *
+ * Compile-time raw-to-units conversion for each FIELD_TYPE.
+ * Each specialisation names its settings struct and provides inline
+ * single-value and array conversions, so code that knows the field type
+ * at compile time gets type-checked settings and no per-sample indirect calls.
+ *
+ * The CONV_ functions and NumericDataField::convertData are runtime wrappers around these.
+ * DLSensor.Thermistor.h must be included before this file.
+ */
+
+struct NOCONVERSIONSETTINGS {};
+
+template <FIELD_TYPE type>
+struct ConversionPolicy
+{
+    // Field types without a conversion leave the raw value unchanged
+    typedef NOCONVERSIONSETTINGS Settings;
+    static const bool converts = false;
+
+    static inline float convert(float raw, const Settings& settings)
+    {
+        (void)settings;
+        return raw;
+    }
+
+    static inline void convertN(const float * raw, float * converted, uint32_t n, const Settings& settings)
+    {
+        (void)settings;
+
+        uint32_t i;
+        for (i = 0; i < n; i++) { converted[i] = raw[i]; }
+    }
+};
+
+template <>
+struct ConversionPolicy<VOLTAGE>
+{
+    typedef VOLTAGECHANNEL Settings;
+    static const bool converts = true;
+
+    static inline float convert(float raw, const Settings& settings)
+    {
+        float volts = (raw * settings.mvPerBit) / 1000;
+        volts -= settings.offset;
+        volts *= settings.multiplier;
+
+        // Input voltage to the potential divider
+        return (volts * (settings.R1 + settings.R2)) / settings.R2;
+    }
+
+    // All steps are linear, so they are folded into one scale and offset
+    static inline void convertN(const float * raw, float * converted, uint32_t n, const Settings& settings)
+    {
+        float divider = (settings.R1 + settings.R2) / settings.R2;
+        float scale = (settings.mvPerBit / 1000) * settings.multiplier * divider;
+        float offset = -settings.offset * settings.multiplier * divider;
+
+        uint32_t i;
+        for (i = 0; i < n; i++) { converted[i] = (raw[i] * scale) + offset; }
+    }
+};
+
+template <>
+struct ConversionPolicy<CURRENT>
+{
+    typedef CURRENTCHANNEL Settings;
+    static const bool converts = true;
+
+    static inline float convert(float raw, const Settings& settings)
+    {
+        float mv = raw * settings.mvPerBit;
+        return (mv - settings.offset) / settings.mvPerAmp;
+    }
+
+    static inline void convertN(const float * raw, float * converted, uint32_t n, const Settings& settings)
+    {
+        float scale = settings.mvPerBit / settings.mvPerAmp;
+        float offset = -settings.offset / settings.mvPerAmp;
+
+        uint32_t i;
+        for (i = 0; i < n; i++) { converted[i] = (raw[i] * scale) + offset; }
+    }
+};
+
+template <>
+struct ConversionPolicy<TEMPERATURE_C>
+{
+    typedef THERMISTORCHANNEL Settings;
+    static const bool converts = true;
+
+    static inline float convert(float raw, const Settings& settings)
+    {
+        Thermistor thermistor = Thermistor(settings.B, settings.R25, settings.highside);
+        return thermistor.TemperatureFromADCReading(settings.otherR, raw, settings.maxADC);
+    }
+
+    static inline void convertN(const float * raw, float * converted, uint32_t n, const Settings& settings)
+    {
+        Thermistor thermistor = Thermistor(settings.B, settings.R25, settings.highside);
+
+        uint32_t i;
+        for (i = 0; i < n; i++)
+        {
+            converted[i] = thermistor.TemperatureFromADCReading(settings.otherR, raw[i], settings.maxADC);
+        }
+    }
+};
+
+/*
+ * FieldConverter
+ *
+ * Binds a ConversionPolicy to one channel's settings, e.g.
+ *     FieldConverter<VOLTAGE> converter(voltageSettings);
+ *     float volts = converter.convert(raw);
+ */
+
+template <FIELD_TYPE type>
+class FieldConverter
+{
+    public:
+        typedef typename ConversionPolicy<type>::Settings Settings;
+
+        FieldConverter(const Settings& settings) : m_settings(settings) {}
+
+        inline float convert(float raw) const
+        {
+            return ConversionPolicy<type>::convert(raw, m_settings);
+        }
+
+        inline void convert(const float * raw, float * converted, uint32_t n) const
+        {
+            ConversionPolicy<type>::convertN(raw, converted, n, m_settings);
+        }
+
+        const Settings& settings(void) const { return m_settings; }
+
+    private:
+        const Settings& m_settings;
+};
+
+#endif
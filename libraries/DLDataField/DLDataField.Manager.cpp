@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #endif
 
 #ifdef TEST
@@ -31,7 +32,12 @@
 #include "DLUtility.Averager.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.h"
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.Statistics.h"
+#include "DLUtility.Arena.h"
+#include "DLDataField.Store.h"
 #include "DLDataField.Manager.h"
+#include "DLSensor.Thermistor.h"
 #include "DLSettings.Reader.Errors.h"
 #include "DLSettings.DataChannels.h"
 #include "DLUtility.h"
@@ -43,7 +49,11 @@ DataFieldManager::DataFieldManager(uint32_t dataSize, uint32_t averagerSize)
     m_dataSize = dataSize;
     m_averagerSize = averagerSize;
     m_fieldCount = 0;
-    m_dataCount = 0;
+    m_numericCount = 0;
+    m_stringCount = 0;
+    m_statistics = 0;
+    m_statisticCount = 0;
+    m_aggregateLevels = 0;
 
     uint8_t i = 0;
     for (i = 0; i < MAX_FIELDS; i++)
@@ -57,27 +67,67 @@ uint8_t DataFieldManager::fieldCount()
     return m_fieldCount;
 }
 
+/*
+ * columnCount
+ *
+ * Returns the number of values in each row of data:
+ * one per field plus any statistic columns for the numeric fields.
+ */
+uint8_t DataFieldManager::columnCount()
+{
+    return m_fieldCount + (m_numericCount * m_statisticCount);
+}
+
 /*
  * addField
  *
  * Add a field to the manager.
  * Stores field pointer in next free location in m_fields.
  * Channel number is stored in m_channelNumbers.
+ * Numeric fields are also added to the gather map used by storeDataBlock.
+ * Adding a field changes the row layout, so fails once the store holds any rows.
+ *
+ * The averages of fields added to a manager go into the manager's store, not the field,
+ * so their getRawData/getConvData functions return DATAFIELD_NO_DATA_VALUE.
+ * Use getDataArray/getDataBlock to read the data instead.
  */
 bool DataFieldManager::addField(NumericDataField * field)
 {
     if (!field) { return false; }
 
     if (m_fieldCount == MAX_FIELDS) { return false; }
+    if (m_store.hasData()) { return false; }
 
     // The field might need extra setup based on the datatype/sensor and platform.
     // The platform interface takes care of that.
     PLATFORM_specialFieldSetup(field);
 
-    field->setDataSizes(m_dataSize, m_averagerSize);
+    // Manager fields have no averager: level 0 of the aggregator is the storage window,
+    // and any other aggregation levels are built on top of it.
+    field->setDataSizes(m_dataSize, 0);
+    if (!field->addAggregateLevel(m_averagerSize, 1)) { return false; }
+
+    uint8_t level;
+    for (level = 0; level < m_aggregateLevels; level++)
+    {
+        if (!field->addAggregateLevel(m_aggregateRatios[level], m_aggregateDepths[level])) { return false; }
+    }
+
+    if (field->getType() == TEMPERATURE_C)
+    {
+        field->setThermistorTableSize(THERMISTOR_LUT_DEFAULT_SIZE);
+    }
+
+    if (m_statistics & STATISTIC_STDDEV) { field->enableStatistics(); }
 
     m_fields[m_fieldCount] = field;
     m_channelNumbers[m_fieldCount] = field->getChannelNumber();
+
+    m_numericFields[m_numericCount] = field;
+    m_numericDataIndex[m_numericCount] = field->getChannelNumber() - 1;
+    m_numericColumns[m_numericCount] = m_fieldCount;
+    m_numericCount++;
+
     m_fieldCount++;
 
     return true;
@@ -88,52 +138,272 @@ bool DataFieldManager::addField(StringDataField * field)
     if (!field) { return false; }
 
     if (m_fieldCount == MAX_FIELDS) { return false; }
+    if (m_store.hasData()) { return false; }
 
     m_fields[m_fieldCount] = field;
     m_channelNumbers[m_fieldCount] = field->getChannelNumber();
 
+    m_stringFields[m_stringCount] = field;
+    m_stringCount++;
+
     m_fieldCount++;
     return true;
 }
 
-void DataFieldManager::storeDataArray(int32_t * data)
+/*
+ * storeDataArray
+ *
+ * Pushes one sample per field into the field aggregators.
+ * When the storage window (averagerSize samples) is complete,
+ * the averages are written as a single row into the store.
+ * The data array is for ALL channels on the platform (data[0] is channel 1)
+ * and holds length values. Returns false (and stores nothing) if the array
+ * does not include every channel that has a numeric field.
+ */
+bool DataFieldManager::storeDataArray(int32_t * data, uint32_t length)
+{
+    return storeDataBlock(data, 1, length);
+}
+
+/*
+ * storeDataBlock
+ *
+ * As storeDataArray, but for nRows rows of channel data in one call
+ * (e.g. a burst of ADC reads buffered by an interrupt).
+ * stride is the number of values from the start of one row to the start of the next,
+ * which is also the number of channels in each row.
+ */
+bool DataFieldManager::storeDataBlock(const int32_t * rows, uint32_t nRows, uint32_t stride)
 {
-    uint16_t field = 0;
+    if (!rows) { return false; }
+    if (!rowsHaveAllChannels(stride)) { return false; }
+    if (!prepareStore()) { return false; }
 
-    // The data manager stores only the fields of interest, but 
-    // the incoming data array is for ALL channels for the platform
-    // dataIndex is the correct index for the raw data array
-    uint16_t dataIndex;
+    uint32_t row;
+    uint8_t field;
 
-    bool newAverageStored = false;
-    for (field = 0; field < m_fieldCount; field++)
+    // String columns (and numeric fields without a new average) are stored as "no data"
+    uint8_t columns = columnCount();
+    float averages[MAX_COLUMNS];
+    fillArray(averages, DATAFIELD_NO_DATA_VALUE, columns);
+
+    for (row = 0; row < nRows; row++)
     {
-        NumericDataField* pField = (NumericDataField*)m_fields[field];
-        if (pField)
+        bool newAverageStored = false;
+        for (field = 0; field < m_numericCount; field++)
+        {
+            if (m_numericFields[field]->averageData(rows[m_numericDataIndex[field]], &averages[m_numericColumns[field]]))
+            {
+                newAverageStored = true;
+                if (m_statistics) { writeStatistics(averages, field); }
+            }
+        }
+
+        if (newAverageStored)
         {
-            dataIndex = m_channelNumbers[field] - 1;
-            newAverageStored |= pField->storeData( data[dataIndex] );
+            float * pStoreRow = m_store.pushRow();
+            memcpy(pStoreRow, averages, columns * sizeof(float));
+            fillArray(averages, DATAFIELD_NO_DATA_VALUE, columns);
         }
+
+        rows += stride;
     }
 
-    if (newAverageStored) { m_dataCount++; }
+    return true;
 }
 
+/*
+ * drainSampleQueue
+ *
+ * Stores up to maxRows rows from a SampleQueue (filled by a sampling interrupt or thread)
+ * as storeDataBlock would. Rows are read in place in the queue, not copied.
+ * Each queue row must hold a value for every channel, as for storeDataArray.
+ * Returns the number of rows stored (zero if the queue rows are too short).
+ */
+uint32_t DataFieldManager::drainSampleQueue(SampleQueue * queue, uint32_t maxRows)
+{
+    if (!queue) { return 0; }
+    if (!rowsHaveAllChannels(queue->columns())) { return 0; }
+
+    uint32_t total = 0;
+    const int32_t * rows;
+    uint32_t count;
+
+    while ((total < maxRows) && ((count = queue->peekRows(&rows)) > 0))
+    {
+        count = min(count, maxRows - total);
+        storeDataBlock(rows, count, queue->columns());
+        queue->release(count);
+        total += count;
+    }
+
+    return total;
+}
+
+/*
+ * getDataArray
+ *
+ * Writes the oldest stored row into buffer (columnCount() values:
+ * one per field, followed by any statistic columns).
+ * If there is no data, each value is DATAFIELD_NO_DATA_VALUE.
+ */
 void DataFieldManager::getDataArray(float * buffer, bool converted, bool alsoRemove)
 {
-    uint16_t field;
-    for(field = 0; field < m_fieldCount; ++field)
+    float * row = m_store.getRow(0);
+
+    if (!row)
+    {
+        fillArray(buffer, DATAFIELD_NO_DATA_VALUE, columnCount());
+        return;
+    }
+
+    memcpy(buffer, row, columnCount() * sizeof(float));
+
+    if (converted) { convertRows(buffer, 1); }
+
+    if (alsoRemove) { m_store.removeOldest(); }
+}
+
+/*
+ * getDataBlock
+ *
+ * Copies up to maxRows of raw (unconverted) rows, oldest first, into buffer.
+ * The buffer must have space for maxRows * columnCount() values.
+ * Returns the number of rows copied.
+ */
+uint32_t DataFieldManager::getDataBlock(float * buffer, uint32_t maxRows, bool alsoRemove)
+{
+    return m_store.copyRows(buffer, maxRows, alsoRemove);
+}
+
+/*
+ * addAggregateLevel
+ *
+ * Level 0 of every numeric field's aggregator is the storage window (averagerSize samples),
+ * whose means are the rows in the store. This adds a level on top of the existing ones
+ * to every numeric field added from now on (so this should be called before the fields
+ * are added, and before setupAllValidChannels). The first added level's ratio is in
+ * storage windows: for example, a ratio of UPLOAD_AVERAGING_INTERVAL_SECS / STORAGE_AVERAGING_INTERVAL_SECS
+ * makes level 1 the upload window, without averaging the raw samples a second time.
+ * See AggregatePyramid for the meaning of ratio and depth.
+ */
+bool DataFieldManager::addAggregateLevel(uint16_t ratio, uint16_t depth)
+{
+    if (m_aggregateLevels == (AGGREGATOR_MAX_LEVELS - 1)) { return false; }
+    if (ratio == 0 || depth == 0) { return false; }
+
+    m_aggregateRatios[m_aggregateLevels] = ratio;
+    m_aggregateDepths[m_aggregateLevels] = depth;
+    m_aggregateLevels++;
+    return true;
+}
+
+/*
+ * getLatestAggregates
+ *
+ * Writes the most recent completed aggregate at the requested level into buffer (one per field).
+ * Level 0 is the storage window and level 1 onwards are the levels added by addAggregateLevel.
+ * Fields without an aggregate at that level get a count of zero and DATAFIELD_NO_DATA_VALUE values.
+ * Returns the number of fields that had an aggregate.
+ */
+uint8_t DataFieldManager::getLatestAggregates(uint8_t level, AGGREGATE * buffer)
+{
+    if (!buffer) { return 0; }
+
+    uint8_t field;
+    uint8_t found = 0;
+    for (field = 0; field < m_fieldCount; ++field)
     {
-        if (converted)
+        buffer[field].min = DATAFIELD_NO_DATA_VALUE;
+        buffer[field].max = DATAFIELD_NO_DATA_VALUE;
+        buffer[field].mean = DATAFIELD_NO_DATA_VALUE;
+        buffer[field].count = 0;
+    }
+
+    for (field = 0; field < m_numericCount; ++field)
+    {
+        AggregatePyramid * pAggregator = m_numericFields[field]->getAggregator();
+
+        if (pAggregator && pAggregator->getLatest(level, &buffer[m_numericColumns[field]]))
         {
-            buffer[field] = ((NumericDataField*)m_fields[field])->getConvData(alsoRemove);
+            found++;
         }
-        else
+    }
+    return found;
+}
+
+/*
+ * getConvDataBlock
+ *
+ * As getDataBlock, but each numeric field's values are converted to real-world units.
+ */
+uint32_t DataFieldManager::getConvDataBlock(float * buffer, uint32_t maxRows, bool alsoRemove)
+{
+    uint32_t rows = m_store.copyRows(buffer, maxRows, alsoRemove);
+    convertRows(buffer, rows);
+    return rows;
+}
+
+/*
+ * setStatisticColumns
+ *
+ * Adds min, max and/or standard deviation columns (see statistic_column)
+ * for every numeric field. Each value summarises the raw samples in the
+ * averaging window of the average stored in the same row.
+ * Min and max come from the storage window aggregate; only the standard
+ * deviation needs any extra work per sample.
+ * This changes the row layout, so fails once the store holds any rows.
+ * Fields created by setupAllValidChannels only have arena space for statistics
+ * if this is called before setupAllValidChannels.
+ */
+bool DataFieldManager::setStatisticColumns(uint8_t statistics)
+{
+    if (statistics & ~STATISTIC_ALL) { return false; }
+    if (m_store.hasData()) { return false; }
+
+    m_statistics = statistics;
+    m_statisticCount = 0;
+
+    uint8_t bit;
+    for (bit = 0; bit < MAX_STATISTICS; bit++)
+    {
+        if (statistics & (1 << bit)) { m_statisticCount++; }
+    }
+
+    uint8_t field;
+    for (field = 0; field < m_numericCount; field++)
+    {
+        if ((m_statistics & STATISTIC_STDDEV) && !m_numericFields[field]->enableStatistics())
         {
-            buffer[field] = ((NumericDataField*)m_fields[field])->getRawData(alsoRemove);
+            // Most likely the field arena has no room (see setupAllValidChannels)
+            m_statistics = 0;
+            m_statisticCount = 0;
+            return false;
         }
     }
-    if (alsoRemove) { m_dataCount--; }
+
+    return true;
+}
+
+/*
+ * getStatisticColumn
+ *
+ * Returns the column holding a statistic for the nth numeric field,
+ * or -1 if that statistic is not enabled.
+ */
+int16_t DataFieldManager::getStatisticColumn(uint8_t numericField, uint8_t statistic)
+{
+    if (!(m_statistics & statistic) || (numericField >= m_numericCount)) { return -1; }
+
+    int16_t column = m_fieldCount + (numericField * m_statisticCount);
+
+    uint8_t bit;
+    for (bit = 1; bit < statistic; bit <<= 1)
+    {
+        if (m_statistics & bit) { column++; }
+    }
+
+    return column;
 }
 
 DataField * DataFieldManager::getChannel(uint8_t channel)
@@ -169,19 +439,59 @@ uint32_t DataFieldManager::writeHeadersToBuffer(char * buffer, uint8_t bufferLen
         }
     }
 
+    static char const * const statisticNames[] = {" min", " max", " sd"};
+    uint8_t bit;
+    for (i = 0; i < m_numericCount; ++i)
+    {
+        for (bit = 0; bit < MAX_STATISTICS; bit++)
+        {
+            if (m_statistics & (1 << bit))
+            {
+                headerAccumulator.writeString(", ");
+                headerAccumulator.writeString(m_numericFields[i]->getTypeString());
+                headerAccumulator.writeString(statisticNames[bit]);
+            }
+        }
+    }
+
     headerAccumulator.writeString("\r\n");
 
     return headerAccumulator.length();
 }
 
-void DataFieldManager::setupAllValidChannels(void)
+/*
+ * setupAllValidChannels
+ *
+ * Creates a field for each valid numeric channel in the settings.
+ * The fields and everything they allocate are taken from the manager's arena,
+ * which is sized once here from the number of valid channels.
+ * The arena is never freed (fields and settings hold pointers into it),
+ * so this can only be called once; later calls return false and add no fields.
+ */
+bool DataFieldManager::setupAllValidChannels(void)
 {
+    if (m_arena.size()) { return false; }
+
     uint8_t ch;
     NumericDataField * field;
     FIELD_TYPE type;
     void * data;
 
     uint32_t maxChannels = Settings_GetMaxChannels();
+    uint32_t arenaSize = 0;
+
+    for (ch = 1; ch < maxChannels; ch++)
+    {
+        if (Settings_ChannelSettingIsValid(ch) && channelIsNumeric(Settings_GetChannelType(ch)))
+        {
+            arenaSize += fieldArenaSize(Settings_GetChannelType(ch));
+        }
+    }
+
+    if (arenaSize == 0) { return true; }
+
+    if (!m_arena.reserve(arenaSize)) { return false; }
+
     for (ch = 1; ch < maxChannels; ch++)
     {
         if (Settings_ChannelSettingIsValid(ch))
@@ -189,30 +499,42 @@ void DataFieldManager::setupAllValidChannels(void)
             type = Settings_GetChannelType(ch);
             data = Settings_GetData(ch);
 
-            switch(type)
+            if (channelIsNumeric(type))
             {
-            case VOLTAGE:
-            case CURRENT:
-            case TEMPERATURE_C:
-            case TEMPERATURE_K:
-            case TEMPERATURE_F:
-                field = new NumericDataField(type, data, ch);
+                field = new (m_arena) NumericDataField(type, data, ch);
+                if (!field) { return false; }
+
+                field->setArena(&m_arena);
                 #ifdef TEST
                 std::cout << "Adding channel " << (int)ch << ", type " << field->getTypeString() << std::endl;
                 #endif
                 addField(field);
-                break;
-            default:
-                break;
             }
         }
     }
+
+    #ifdef TEST
+    std::cout << "Field arena: " << m_arena.highWaterMark() << " of " << m_arena.size() << " bytes used" << std::endl;
+    #endif
+
+    return m_arena.failures() == 0;
+}
+
+/*
+ * getArena
+ *
+ * Returns the arena that setupAllValidChannels allocates fields from
+ * (e.g. to report its high-water mark)
+ */
+Arena * DataFieldManager::getArena(void)
+{
+    return &m_arena;
 }
 
 bool DataFieldManager::hasData(void)
 {
     uint8_t i = 0;
-    bool atLeastOneFieldHasData = false;
+    bool atLeastOneFieldHasData = m_store.hasData();
     for (i = 0; i < m_fieldCount; i++)
     {
         atLeastOneFieldHasData |= m_fields[i]->hasData();
@@ -222,10 +544,206 @@ bool DataFieldManager::hasData(void)
 
 uint32_t DataFieldManager::count(void)
 {
-    return m_dataCount;
+    return m_store.length();
 }
 
 uint32_t * DataFieldManager::getChannelNumbers(void)
 {
     return m_channelNumbers;
-}
\ No newline at end of file
+}
+
+/*
+ * Private Functions
+ */
+
+/*
+ * prepareStore
+ *
+ * The store needs one column per field (plus statistics), so it is only allocated
+ * when data is first stored (by which time all fields should have been added).
+ * The layout can only change while the store is empty (see addField),
+ * so reallocating here never discards stored rows.
+ */
+bool DataFieldManager::prepareStore(void)
+{
+    if (m_fieldCount == 0) { return false; }
+
+    if (m_store.columns() != columnCount())
+    {
+        return m_store.setSize(m_dataSize, columnCount());
+    }
+    return true;
+}
+
+/*
+ * rowsHaveAllChannels
+ *
+ * Checks the gather map against the length of each incoming row of channel data,
+ * so that no numeric field reads past the end of a row.
+ */
+bool DataFieldManager::rowsHaveAllChannels(uint32_t rowLength)
+{
+    uint8_t field;
+    for (field = 0; field < m_numericCount; field++)
+    {
+        if (m_numericDataIndex[field] >= rowLength) { return false; }
+    }
+    return true;
+}
+
+/*
+ * fieldArenaSize
+ *
+ * Returns the arena space needed for each field created by setupAllValidChannels:
+ * the field itself, its aggregation levels (including the storage window),
+ * statistics (if used), its thermistor table (for thermistor fields) and
+ * room for its own data buffer, should storeData be called on it directly.
+ */
+uint32_t DataFieldManager::fieldArenaSize(FIELD_TYPE type)
+{
+    uint32_t size = ARENA_ALIGN(sizeof(NumericDataField))
+        + ARENA_ALIGN(m_dataSize * sizeof(float))
+        + ARENA_ALIGN(sizeof(AggregatePyramid))
+        + ARENA_ALIGN(sizeof(AGGREGATE));
+
+    uint8_t level;
+    for (level = 0; level < m_aggregateLevels; level++)
+    {
+        size += ARENA_ALIGN(m_aggregateDepths[level] * sizeof(AGGREGATE));
+    }
+
+    if (m_statistics & STATISTIC_STDDEV)
+    {
+        size += 2 * ARENA_ALIGN(sizeof(Statistics<int32_t>));
+    }
+
+    if (type == TEMPERATURE_C)
+    {
+        size += ARENA_ALIGN(sizeof(ThermistorLUT))
+            + ARENA_ALIGN(THERMISTOR_LUT_DEFAULT_SIZE * sizeof(float));
+    }
+
+    return size;
+}
+
+bool DataFieldManager::channelIsNumeric(FIELD_TYPE type)
+{
+    switch(type)
+    {
+    case VOLTAGE:
+    case CURRENT:
+    case TEMPERATURE_C:
+    case TEMPERATURE_K:
+    case TEMPERATURE_F:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+ * writeStatistics
+ *
+ * Copies the last window statistics for the nth numeric field into a row
+ */
+void DataFieldManager::writeStatistics(float * row, uint8_t numericField)
+{
+    NumericDataField * pField = m_numericFields[numericField];
+    AggregatePyramid * pAggregator = pField->getAggregator();
+    Statistics<int32_t> * pStatistics = pField->getWindowStatistics();
+
+    AGGREGATE window;
+    int16_t column;
+
+    if (pAggregator && pAggregator->getLatest(0, &window))
+    {
+        if ((column = getStatisticColumn(numericField, STATISTIC_MIN)) >= 0)
+        {
+            row[column] = window.min;
+        }
+        if ((column = getStatisticColumn(numericField, STATISTIC_MAX)) >= 0)
+        {
+            row[column] = window.max;
+        }
+    }
+
+    if (pStatistics && ((column = getStatisticColumn(numericField, STATISTIC_STDDEV)) >= 0))
+    {
+        row[column] = pStatistics->stdDev();
+    }
+}
+
+/*
+ * convertRows
+ *
+ * Converts the numeric columns of nRows rows in buffer in place.
+ * Each column is gathered into a contiguous chunk so that the
+ * array conversion functions can work on many values per call.
+ *
+ * Min and max columns are converted like the average. The standard deviation
+ * is converted as the change in converted value from the average to the
+ * average plus one standard deviation, which is exact for linear conversions.
+ */
+void DataFieldManager::convertRows(float * buffer, uint32_t nRows)
+{
+    float chunk[CONVERSION_CHUNK_SIZE];
+    float deviationChunk[CONVERSION_CHUNK_SIZE];
+    uint8_t columns = columnCount();
+    uint8_t field;
+    uint32_t firstRow;
+    uint32_t i;
+
+    for (firstRow = 0; firstRow < nRows; firstRow += CONVERSION_CHUNK_SIZE)
+    {
+        uint32_t rowsInChunk = min(nRows - firstRow, (uint32_t)CONVERSION_CHUNK_SIZE);
+        float * pFirstRow = &buffer[firstRow * columns];
+
+        for (field = 0; field < m_numericCount; ++field)
+        {
+            NumericDataField * pField = m_numericFields[field];
+            float * pColumn = &pFirstRow[m_numericColumns[field]];
+            float * pDeviation = NULL;
+            int16_t column;
+
+            for (i = 0; i < rowsInChunk; i++) { chunk[i] = pColumn[i * columns]; }
+
+            if ((column = getStatisticColumn(field, STATISTIC_STDDEV)) >= 0)
+            {
+                pDeviation = &pFirstRow[column];
+                for (i = 0; i < rowsInChunk; i++) { deviationChunk[i] = chunk[i] + pDeviation[i * columns]; }
+                pField->convertArray(deviationChunk, deviationChunk, rowsInChunk);
+            }
+
+            pField->convertArray(chunk, chunk, rowsInChunk);
+
+            for (i = 0; i < rowsInChunk; i++) { pColumn[i * columns] = chunk[i]; }
+
+            if (pDeviation)
+            {
+                for (i = 0; i < rowsInChunk; i++) { pDeviation[i * columns] = fabs(deviationChunk[i] - chunk[i]); }
+            }
+
+            convertColumn(pFirstRow, getStatisticColumn(field, STATISTIC_MIN), pField, rowsInChunk, chunk);
+            convertColumn(pFirstRow, getStatisticColumn(field, STATISTIC_MAX), pField, rowsInChunk, chunk);
+        }
+    }
+}
+
+/*
+ * convertColumn
+ *
+ * Converts one column of nRows rows in place, using chunk as scratch space.
+ * Does nothing if column is negative.
+ */
+void DataFieldManager::convertColumn(float * buffer, int16_t column, NumericDataField * pField, uint32_t nRows, float * chunk)
+{
+    if (column < 0) { return; }
+
+    uint8_t columns = columnCount();
+    float * pColumn = &buffer[column];
+    uint32_t i;
+
+    for (i = 0; i < nRows; i++) { chunk[i] = pColumn[i * columns]; }
+    pField->convertArray(chunk, chunk, nRows);
+    for (i = 0; i < nRows; i++) { pColumn[i * columns] = chunk[i]; }
+}
@@ -3,33 +3,93 @@
 
 #define MAX_FIELDS 32
 
+/*
+ * Each numeric field can have extra columns with statistics for each averaging window.
+ * These are stored after the field columns, in the order below, grouped by field.
+ */
+enum statistic_column
+{
+    STATISTIC_MIN = 0x01,
+    STATISTIC_MAX = 0x02,
+    STATISTIC_STDDEV = 0x04
+};
+#define STATISTIC_ALL (STATISTIC_MIN | STATISTIC_MAX | STATISTIC_STDDEV)
+#define MAX_STATISTICS 3
+
+#define MAX_COLUMNS (MAX_FIELDS * (1 + MAX_STATISTICS))
+
+// Number of values converted at a time when converting a block of rows
+#define CONVERSION_CHUNK_SIZE 64
+
+// Defined in DLUtility.SampleQueue.h
+class SampleQueue;
+
 class DataFieldManager
 {
     public:
         DataFieldManager(uint32_t dataSize, uint32_t averagerSize);
         uint8_t fieldCount();
+        uint8_t columnCount();
         bool addField(NumericDataField * field);
         bool addField(StringDataField * field);
         DataField * getField(uint8_t index);
         DataField * getChannel(uint8_t index);
         DataField ** getFields(void);
 
-        void storeDataArray(int32_t * data);
+        bool storeDataArray(int32_t * data, uint32_t length);
+        bool storeDataBlock(const int32_t * rows, uint32_t nRows, uint32_t stride);
+        uint32_t drainSampleQueue(SampleQueue * queue, uint32_t maxRows);
         void getDataArray(float * buffer, bool converted, bool alsoRemove);
+        uint32_t getDataBlock(float * buffer, uint32_t maxRows, bool alsoRemove);
+        uint32_t getConvDataBlock(float * buffer, uint32_t maxRows, bool alsoRemove);
         uint32_t writeHeadersToBuffer(char * buffer, uint8_t bufferLength);
 
-        void setupAllValidChannels(void);
+        bool addAggregateLevel(uint16_t ratio, uint16_t depth);
+        uint8_t getLatestAggregates(uint8_t level, AGGREGATE * buffer);
+
+        bool setStatisticColumns(uint8_t statistics);
+        int16_t getStatisticColumn(uint8_t numericField, uint8_t statistic);
+
+        bool setupAllValidChannels(void);
+        Arena * getArena(void);
         uint32_t * getChannelNumbers(void);
         bool hasData(void);
         uint32_t count(void);
 
     private:
+        bool prepareStore(void);
+        bool rowsHaveAllChannels(uint32_t rowLength);
+        uint32_t fieldArenaSize(FIELD_TYPE type);
+        bool channelIsNumeric(FIELD_TYPE type);
+        void writeStatistics(float * row, uint8_t numericField);
+        void convertRows(float * buffer, uint32_t nRows);
+        void convertColumn(float * buffer, int16_t column, NumericDataField * pField, uint32_t nRows, float * chunk);
+
         DataField * m_fields[MAX_FIELDS];
+        DataFieldStore m_store;
+        Arena m_arena;
         uint8_t m_fieldCount;
-        uint32_t m_dataCount;
+
+        // Gather map for incoming data, built as fields are added:
+        // numeric field n reads data[m_numericDataIndex[n]] and writes store column m_numericColumns[n]
+        NumericDataField * m_numericFields[MAX_FIELDS];
+        uint32_t m_numericDataIndex[MAX_FIELDS];
+        uint8_t m_numericColumns[MAX_FIELDS];
+        uint8_t m_numericCount;
+
+        StringDataField * m_stringFields[MAX_FIELDS];
+        uint8_t m_stringCount;
+
+        uint8_t m_statistics;
+        uint8_t m_statisticCount;
+
         uint32_t m_dataSize;
         uint32_t m_averagerSize;
         uint32_t m_channelNumbers[MAX_FIELDS];
+
+        uint16_t m_aggregateRatios[AGGREGATOR_MAX_LEVELS];
+        uint16_t m_aggregateDepths[AGGREGATOR_MAX_LEVELS];
+        uint8_t m_aggregateLevels;
 };
 
 #endif
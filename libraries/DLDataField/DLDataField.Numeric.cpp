@@ -29,8 +29,14 @@
  */
 
 #include "DLUtility.Averager.h"
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.Statistics.h"
+#include "DLUtility.FixedPoint.h"
+#include "DLUtility.Arena.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.Conversion.h"
+#include "DLSensor.Thermistor.h"
+#include "DLDataField.ConversionPolicy.h"
 #include "DLDataField.h"
 #include "DLUtility.h"
 
@@ -63,27 +69,75 @@ NumericDataField::NumericDataField(FIELD_TYPE type, void * fieldData, uint32_t c
 {
     m_conversionData = fieldData;
     m_altConversionFn = NULL;
+    m_data = NULL;
+    m_fixedData = NULL;
+    m_fixedConversion = NULL;
+    m_aggregator = NULL;
+    m_thermistorLUT = NULL;
+    m_thermistorTable = NULL;
+    m_thermistorTableSize = 0;
+    m_thermistorTableCapacity = 0;
+    m_statistics = NULL;
+    m_windowStatistics = NULL;
 }
 
 NumericDataField::~NumericDataField()
 {
-    delete[] m_data;
+    // Anything allocated from an arena is owned by the arena
+    if (!m_arena)
+    {
+        delete[] m_data;
+        delete[] m_fixedData;
+        delete m_averager;
+        delete m_aggregator;
+        delete m_thermistorLUT;
+        delete m_statistics;
+        delete m_windowStatistics;
+    }
+    delete m_fixedConversion;
+}
+
+/*
+ * setArena
+ *
+ * Allocates the averager, data buffer, aggregator and statistics of this field
+ * from an arena, rather than from the heap. Must be called before setDataSizes
+ * (and before any of the other setup functions).
+ * The arena must have room for them: see DataFieldManager::fieldArenaSize.
+ */
+void NumericDataField::setArena(Arena * arena)
+{
+    m_arena = arena;
 }
 
+/*
+ * setDataSizes
+ *
+ * Sets the size of this field's own data buffer and of its averager.
+ * The data buffer is only allocated on the first call to storeData (or storeFixedData):
+ * fields owned by a DataFieldManager store their averages in the manager's
+ * DataFieldStore instead, so normally never need their own buffer.
+ *
+ * With an averager size of zero there is no averager, and the averaging window
+ * is level 0 of the aggregation pyramid instead (see addAggregateLevel).
+ */
 void NumericDataField::setDataSizes(uint32_t N, uint32_t averagerN)
 {
-    if (N == 0 || averagerN == 0) { return; }
+    if (N == 0) { return; }
 
     setSize(N);
 
-    m_data = new float[N];
+    if (averagerN == 0) { return; }
 
-    if (m_data)
+    if (m_arena)
     {
-        fillArray(m_data, 0.0f, N);
+        int32_t * buffer = (int32_t*)m_arena->allocate(averagerN * sizeof(int32_t));
+        m_averager = buffer ? new (*m_arena) Averager<int32_t>(averagerN, buffer) : NULL;
+    }
+    else
+    {
+        m_averager = new Averager<int32_t>(averagerN);
     }
-
-    m_averager = new Averager<int32_t>(averagerN);
 }
 
 
@@ -92,9 +146,98 @@ void NumericDataField::setAltConversion(APP_CONVERSION_FN * altConversionFn)
     m_altConversionFn = altConversionFn;
 }
 
+/*
+ * addAggregateLevel
+ *
+ * Adds a level to this field's aggregation pyramid (creating it on first use).
+ * Every raw sample passed to storeData/averageData also feeds the pyramid,
+ * so storage, upload and serial output can each read the resolution they need.
+ * Aggregates are of raw data; use convertData on the values as required.
+ *
+ * If the field has no averager, each level 0 aggregate is also the average
+ * returned by averageData (and stored by storeData), so each sample is
+ * only accumulated once.
+ */
+bool NumericDataField::addAggregateLevel(uint16_t ratio, uint16_t depth)
+{
+    if (!m_aggregator)
+    {
+        m_aggregator = m_arena ? new (*m_arena) AggregatePyramid() : new AggregatePyramid();
+        if (!m_aggregator) { return false; }
+    }
+
+    if (m_arena)
+    {
+        AGGREGATE * history = (AGGREGATE*)m_arena->allocate(depth * sizeof(AGGREGATE));
+        return history ? m_aggregator->addLevel(ratio, depth, history) : false;
+    }
+
+    return m_aggregator->addLevel(ratio, depth);
+}
+
+/*
+ * enableStatistics
+ *
+ * Tracks min/max/mean/variance of the raw samples in each averaging window.
+ * getWindowStatistics returns the statistics for the last completed window
+ * (they are updated at the same time as the average).
+ */
+bool NumericDataField::enableStatistics(void)
+{
+    if (m_statistics) { return true; }
+
+    if (m_arena)
+    {
+        m_statistics = new (*m_arena) Statistics<int32_t>();
+        m_windowStatistics = m_statistics ? new (*m_arena) Statistics<int32_t>() : NULL;
+        if (!m_windowStatistics) { m_statistics = NULL; }
+    }
+    else
+    {
+        m_statistics = new Statistics<int32_t>();
+        m_windowStatistics = new Statistics<int32_t>();
+    }
+
+    return m_statistics && m_windowStatistics;
+}
+
+/*
+ * setThermistorTableSize
+ *
+ * Thermistor fields can convert through a lookup table built from the channel settings,
+ * rather than evaluating the Beta equation for every value. This (re)builds the table
+ * at a different size; a size of zero stops the table being used and conversions
+ * go back to the Beta equation. DataFieldManager::addField builds the table at
+ * THERMISTOR_LUT_DEFAULT_SIZE when the channel is set up.
+ *
+ * If the channel settings change, the table is rebuilt on the next conversion.
+ * With an arena, the table memory is allocated the first time and reused,
+ * so the table cannot then be made any larger.
+ */
+bool NumericDataField::setThermistorTableSize(uint16_t tableSize)
+{
+    if ((m_fieldType != TEMPERATURE_C) || !m_conversionData || m_altConversionFn) { return false; }
+
+    if (m_arena && m_thermistorTable && (tableSize > m_thermistorTableCapacity)) { return false; }
+
+    m_thermistorTableSize = tableSize;
+
+    if (tableSize && buildThermistorLUT()) { return true; }
+
+    m_thermistorTableSize = 0;
+    return false;
+}
+
+/*
+ * getRawData
+ *
+ * Returns the oldest stored average, or DATAFIELD_NO_DATA_VALUE if there is none.
+ * Fields added to a DataFieldManager have their averages stored in the manager's store,
+ * so for those fields this returns DATAFIELD_NO_DATA_VALUE unless storeData was called directly.
+ */
 float NumericDataField::getRawData(bool alsoRemove)
 {
-    if (length() > 0)
+    if ((length() > 0) && m_data)
     {
         float data = m_data[ getTailIndex() ];
         if (alsoRemove) { pop(); }
@@ -108,7 +251,18 @@ float NumericDataField::getRawData(bool alsoRemove)
 
 float NumericDataField::getConvData(bool alsoRemove)
 {
-    float data = getRawData(alsoRemove);
+    return convertData(getRawData(alsoRemove));
+}
+
+/*
+ * convertData
+ *
+ * Runtime dispatch onto the ConversionPolicy for this field's type.
+ * Code that knows the field type at compile time can use FieldConverter directly.
+ */
+float NumericDataField::convertData(float data)
+{
+    ThermistorLUT * pLUT;
 
     if (m_conversionData)
     {
@@ -122,13 +276,21 @@ float NumericDataField::getConvData(bool alsoRemove)
             switch (m_fieldType)
             {
             case VOLTAGE:
-                data = CONV_VoltsFromRaw(data, (VOLTAGECHANNEL*)m_conversionData);
+                data = ConversionPolicy<VOLTAGE>::convert(data, *(VOLTAGECHANNEL*)m_conversionData);
                 break;
             case CURRENT:
-                data = CONV_AmpsFromRaw(data, (CURRENTCHANNEL*)m_conversionData);
+                data = ConversionPolicy<CURRENT>::convert(data, *(CURRENTCHANNEL*)m_conversionData);
                 break;
             case TEMPERATURE_C:
-                data = CONV_CelsiusFromRawThermistor(data, (THERMISTORCHANNEL*)m_conversionData);
+                if ((pLUT = currentThermistorLUT()))
+                {
+                    data = pLUT->TemperatureFromADCReading(data);
+                }
+                else
+                {
+                    data = ConversionPolicy<TEMPERATURE_C>::convert(data, *(THERMISTORCHANNEL*)m_conversionData);
+                }
+                break;
             default:
                 break;
             }
@@ -138,21 +300,237 @@ float NumericDataField::getConvData(bool alsoRemove)
     return data;
 }
 
+/*
+ * convertArray
+ *
+ * Converts n raw values in one call (raw and converted may be the same array).
+ * Uses the array conversion policies unless an alternative conversion is set.
+ */
+void NumericDataField::convertArray(const float * raw, float * converted, uint32_t n)
+{
+    if (!raw || !converted) { return; }
+
+    uint32_t i;
+    ThermistorLUT * pLUT;
+
+    if (m_conversionData && !m_altConversionFn)
+    {
+        switch (m_fieldType)
+        {
+        case VOLTAGE:
+            ConversionPolicy<VOLTAGE>::convertN(raw, converted, n, *(VOLTAGECHANNEL*)m_conversionData);
+            return;
+        case CURRENT:
+            ConversionPolicy<CURRENT>::convertN(raw, converted, n, *(CURRENTCHANNEL*)m_conversionData);
+            return;
+        case TEMPERATURE_C:
+            if ((pLUT = currentThermistorLUT()))
+            {
+                for (i = 0; i < n; i++)
+                {
+                    converted[i] = pLUT->TemperatureFromADCReading(raw[i]);
+                }
+            }
+            else
+            {
+                ConversionPolicy<TEMPERATURE_C>::convertN(raw, converted, n, *(THERMISTORCHANNEL*)m_conversionData);
+            }
+            return;
+        default:
+            break;
+        }
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        converted[i] = convertData(raw[i]);
+    }
+}
+
 bool NumericDataField::storeData(int32_t data)
 {
-    bool dataStored = false;
-    m_averager->newData(data);
-    if (m_averager->full())
+    // Floating-point and fixed-point data share the head/tail indexes (see storeFixedData)
+    if (m_fixedData) { return false; }
+
+    float average;
+    bool dataStored = averageData(data, &average);
+
+    if (dataStored)
     {
+        if (!m_data)
+        {
+            m_data = m_arena ? (float*)m_arena->allocate(storageSize() * sizeof(float)) : new float[storageSize()];
+            if (!m_data) { return false; }
+            fillArray(m_data, 0.0f, storageSize());
+        }
+
         prePush();
-        m_data[getWriteIndex()] = (float)m_averager->getFloatAverage();
+        m_data[getWriteIndex()] = average;
         postPush();
+    }
+    return dataStored;
+}
+
+/*
+ * averageData
+ *
+ * Pushes data into the averager. If that fills the averager, the average is written
+ * to *average, the averager is reset and the function returns true.
+ * (Without an averager, the same happens when level 0 of the aggregator completes.)
+ * Nothing is written to this field's own data buffer.
+ */
+bool NumericDataField::averageData(int32_t data, float * average)
+{
+    if (!addToAverager(data)) { return false; }
+
+    if (m_averager)
+    {
+        if (average) { *average = m_averager->getFloatAverage(); }
         m_averager->reset(NULL);
-        dataStored = true;
+    }
+    else if (average)
+    {
+        AGGREGATE window;
+        m_aggregator->getLatest(0, &window);
+        *average = window.mean;
+    }
+    return true;
+}
+
+/*
+ * enableFixedPoint
+ *
+ * Prepares the fixed-point conversion for this field.
+ * Voltage and current conversions are linear, so are precalculated as a fixed-point
+ * scale and offset. Other conversions (and alternative conversion functions)
+ * are not, and convertFixedData falls back to floating point for them;
+ * in that case this returns false.
+ */
+bool NumericDataField::enableFixedPoint(void)
+{
+    delete m_fixedConversion;
+    m_fixedConversion = NULL;
+
+    if (!m_conversionData || m_altConversionFn) { return false; }
+
+    double scale;
+    double offset;
+
+    switch (m_fieldType)
+    {
+    case VOLTAGE:
+    {
+        VOLTAGECHANNEL * pSettings = (VOLTAGECHANNEL*)m_conversionData;
+        double divider = ((double)pSettings->R1 + pSettings->R2) / pSettings->R2;
+        scale = ((double)pSettings->mvPerBit / 1000) * pSettings->multiplier * divider;
+        offset = -(double)pSettings->offset * pSettings->multiplier * divider;
+        break;
+    }
+    case CURRENT:
+    {
+        CURRENTCHANNEL * pSettings = (CURRENTCHANNEL*)m_conversionData;
+        scale = (double)pSettings->mvPerBit / pSettings->mvPerAmp;
+        offset = -(double)pSettings->offset / pSettings->mvPerAmp;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    m_fixedConversion = new FIXED_LINEAR;
+    if (!m_fixedConversion) { return false; }
+
+    FIXED_LinearFromFloat(m_fixedConversion, scale, offset);
+    return true;
+}
+
+/*
+ * storeFixedData, averageFixedData
+ *
+ * As storeData and averageData, but averages are kept as Q16.16 values
+ * (in a separate buffer to the floating-point data).
+ * Both buffers are indexed by the field's one head/tail pair, so a field stores
+ * either floating-point or fixed-point data: whichever is stored first allocates
+ * its buffer and the other store function then returns false.
+ */
+bool NumericDataField::storeFixedData(int32_t data)
+{
+    if (m_data) { return false; }
+
+    FIXED average;
+    bool dataStored = averageFixedData(data, &average);
+
+    if (dataStored)
+    {
+        if (!m_fixedData)
+        {
+            m_fixedData = m_arena ? (int32_t*)m_arena->allocate(storageSize() * sizeof(int32_t)) : new int32_t[storageSize()];
+            if (!m_fixedData) { return false; }
+            fillArray(m_fixedData, (int32_t)0, storageSize());
+        }
+
+        prePush();
+        m_fixedData[getWriteIndex()] = average;
+        postPush();
     }
     return dataStored;
 }
 
+bool NumericDataField::averageFixedData(int32_t data, int32_t * average)
+{
+    if (!addToAverager(data)) { return false; }
+
+    if (m_averager)
+    {
+        if (average) { *average = m_averager->getFixedAverage(); }
+        m_averager->reset(NULL);
+    }
+    else if (average)
+    {
+        AGGREGATE window;
+        m_aggregator->getLatest(0, &window);
+        *average = FIXED_FromFloat(window.mean);
+    }
+    return true;
+}
+
+int32_t NumericDataField::getRawFixedData(bool alsoRemove)
+{
+    if ((length() > 0) && m_fixedData)
+    {
+        FIXED data = m_fixedData[ getTailIndex() ];
+        if (alsoRemove) { pop(); }
+        return data;
+    }
+    else
+    {
+        return DATAFIELD_NO_FIXED_DATA_VALUE;
+    }
+}
+
+int32_t NumericDataField::getConvFixedData(bool alsoRemove)
+{
+    FIXED data = getRawFixedData(alsoRemove);
+    return (data == DATAFIELD_NO_FIXED_DATA_VALUE) ? data : convertFixedData(data);
+}
+
+int32_t NumericDataField::convertFixedData(int32_t raw)
+{
+    if (m_fixedConversion)
+    {
+        return FIXED_ApplyLinear(raw, m_fixedConversion);
+    }
+    else
+    {
+        return FIXED_FromFloat(convertData(FIXED_ToFloat(raw)));
+    }
+}
+
+void NumericDataField::getConvDataAsFixedString(char * buf, uint8_t decimals, bool alsoRemove)
+{
+    FIXED_ToString(buf, getConvFixedData(alsoRemove), decimals);
+}
+
 void NumericDataField::getRawDataAsString(char * buf, char const * const fmt, bool alsoRemove)
 {
     float data = getRawData(alsoRemove);
@@ -192,9 +570,114 @@ void NumericDataField::getConfigString(char * buffer)
     }
 }
 
+/*
+ * Private Class Functions
+ */
+
+/*
+ * addToAverager
+ *
+ * Feeds a sample to the averager (and aggregator and statistics, if used).
+ * Without an averager, level 0 of the aggregator is the averaging window.
+ * Returns true if this completes an averaging window; if there is an averager,
+ * the caller must then read the average and reset the averager.
+ */
+bool NumericDataField::addToAverager(int32_t data)
+{
+    bool windowComplete;
+
+    if (m_averager)
+    {
+        if (m_aggregator) { m_aggregator->newData(data); }
+        m_averager->newData(data);
+        windowComplete = m_averager->full();
+    }
+    else if (m_aggregator)
+    {
+        windowComplete = m_aggregator->newData(data);
+    }
+    else
+    {
+        return false;
+    }
+
+    if (m_statistics)
+    {
+        m_statistics->newData(data);
+
+        if (windowComplete)
+        {
+            *m_windowStatistics = *m_statistics;
+            m_statistics->reset();
+        }
+    }
+
+    return windowComplete;
+}
+
+/*
+ * buildThermistorLUT
+ *
+ * Builds the thermistor table from the current channel settings
+ * (from the field's arena, if it has one).
+ */
+bool NumericDataField::buildThermistorLUT(void)
+{
+    THERMISTORCHANNEL * pSettings = (THERMISTORCHANNEL*)m_conversionData;
+
+    if (m_thermistorLUT)
+    {
+        m_thermistorLUT->setThermistor(pSettings->B, pSettings->R25, pSettings->highside);
+    }
+    else
+    {
+        m_thermistorLUT = m_arena ?
+            new (*m_arena) ThermistorLUT(pSettings->B, pSettings->R25, pSettings->highside) :
+            new ThermistorLUT(pSettings->B, pSettings->R25, pSettings->highside);
+
+        if (!m_thermistorLUT) { return false; }
+    }
+
+    if (!m_arena)
+    {
+        return m_thermistorLUT->build(pSettings->otherR, pSettings->maxADC, m_thermistorTableSize);
+    }
+
+    if (!m_thermistorTable)
+    {
+        m_thermistorTable = (float*)m_arena->allocate(m_thermistorTableSize * sizeof(float));
+        if (!m_thermistorTable) { return false; }
+        m_thermistorTableCapacity = m_thermistorTableSize;
+    }
+
+    return m_thermistorLUT->build(pSettings->otherR, pSettings->maxADC, m_thermistorTableSize, m_thermistorTable);
+}
+
+/*
+ * currentThermistorLUT
+ *
+ * Returns the thermistor table to convert with, or NULL to use the Beta equation.
+ * The table is rebuilt first if the channel settings have changed since it was built.
+ */
+ThermistorLUT * NumericDataField::currentThermistorLUT(void)
+{
+    if (!m_thermistorLUT || !m_thermistorTableSize) { return NULL; }
+
+    THERMISTORCHANNEL * pSettings = (THERMISTORCHANNEL*)m_conversionData;
+
+    if (!m_thermistorLUT->builtFrom(pSettings->B, pSettings->R25, pSettings->highside, pSettings->otherR, pSettings->maxADC))
+    {
+        if (!buildThermistorLUT()) { return NULL; }
+    }
+
+    return m_thermistorLUT;
+}
+
 #ifdef TEST
 void NumericDataField::printContents(void)
 {
+    if (!m_data) { return; }
+
     uint8_t i;
     for (i = 0; i <= m_maxIndex; ++i)
     {
@@ -202,4 +685,4 @@ void NumericDataField::printContents(void)
     }
     std::cout << std::endl;
 }
-#endif
\ No newline at end of file
+#endif
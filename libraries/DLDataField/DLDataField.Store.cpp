@@ -0,0 +1,236 @@
+/*
+ * DLDataField.Store.cpp
+ *
+ * Contiguous row-major storage for the averaged data of all fields in a DataFieldManager
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLDataField.Store.h"
+#include "DLUtility.HelperMacros.h"
+
+/*
+ * Defines and Typedefs
+ */
+
+// The head/tail indexes for the store are stored in a two-value array.
+// Both are row indexes that wrap at the store capacity.
+#define H 0 // First entry is the head of the list (the next row to write)
+#define T 1 // Second entry is the tail (the oldest row)
+
+/*
+ * Public Class Functions
+ */
+
+DataFieldStore::DataFieldStore()
+{
+    m_data = NULL;
+    m_index[H] = 0;
+    m_index[T] = 0;
+    m_count = 0;
+    m_capacity = 0;
+    m_columns = 0;
+}
+
+DataFieldStore::~DataFieldStore()
+{
+    delete[] m_data;
+}
+
+/*
+ * setSize
+ *
+ * (Re)allocates the store as a single block of rows * columns values.
+ * Any data already in the store is discarded.
+ */
+bool DataFieldStore::setSize(uint32_t rows, uint32_t columns)
+{
+    delete[] m_data;
+    m_data = NULL;
+    m_capacity = 0;
+    m_columns = 0;
+
+    clear();
+
+    if (rows == 0 || columns == 0) { return false; }
+
+    m_data = new float[rows * columns];
+
+    if (m_data)
+    {
+        m_capacity = rows;
+        m_columns = columns;
+    }
+
+    return m_data != NULL;
+}
+
+uint32_t DataFieldStore::capacity(void)
+{
+    return m_capacity;
+}
+
+uint32_t DataFieldStore::columns(void)
+{
+    return m_columns;
+}
+
+uint32_t DataFieldStore::length(void)
+{
+    return m_count;
+}
+
+bool DataFieldStore::hasData(void)
+{
+    return length() > 0;
+}
+
+bool DataFieldStore::full(void)
+{
+    return (m_capacity > 0) && (length() == m_capacity);
+}
+
+/*
+ * pushRow
+ *
+ * Makes room for a new row (discarding the oldest if the store is full)
+ * and returns a pointer to it so that the caller can write m_columns values.
+ */
+float * DataFieldStore::pushRow(void)
+{
+    if (!m_data) { return NULL; }
+
+    if (full()) { removeOldest(); }
+
+    float * row = &m_data[m_index[H] * m_columns];
+    incrementwithrollover(m_index[H], m_capacity - 1);
+    m_count++;
+    return row;
+}
+
+/*
+ * getRow
+ *
+ * Returns a pointer to a stored row, where index 0 is the oldest row.
+ * Returns NULL if there is no such row.
+ */
+float * DataFieldStore::getRow(uint32_t index)
+{
+    if (index >= length()) { return NULL; }
+
+    return &m_data[getRowIndex(index) * m_columns];
+}
+
+void DataFieldStore::removeOldest(void)
+{
+    if (m_count > 0)
+    {
+        incrementwithrollover(m_index[T], m_capacity - 1);
+        m_count--;
+    }
+}
+
+void DataFieldStore::clear(void)
+{
+    m_index[H] = 0;
+    m_index[T] = 0;
+    m_count = 0;
+}
+
+/*
+ * getSegments
+ *
+ * The stored rows (oldest first) occupy at most two contiguous regions of the store.
+ * This function returns pointers to those regions and the number of rows in each.
+ * The return value is the total number of rows.
+ */
+uint32_t DataFieldStore::getSegments(float ** first, uint32_t * firstRows, float ** second, uint32_t * secondRows)
+{
+    uint32_t count = length();
+    uint32_t tail = count ? m_index[T] : 0;
+    uint32_t rowsToEnd = m_capacity - tail;
+
+    uint32_t nFirst = min(count, rowsToEnd);
+    uint32_t nSecond = count - nFirst;
+
+    if (first) { *first = nFirst ? &m_data[tail * m_columns] : NULL; }
+    if (firstRows) { *firstRows = nFirst; }
+    if (second) { *second = nSecond ? m_data : NULL; }
+    if (secondRows) { *secondRows = nSecond; }
+
+    return count;
+}
+
+/*
+ * copyRows
+ *
+ * Copies up to maxRows rows (oldest first) into buffer,
+ * which must have space for maxRows * columns() values.
+ * Returns the number of rows copied.
+ */
+uint32_t DataFieldStore::copyRows(float * buffer, uint32_t maxRows, bool alsoRemove)
+{
+    if (!buffer) { return 0; }
+
+    float * first;
+    float * second;
+    uint32_t firstRows;
+    uint32_t secondRows;
+
+    getSegments(&first, &firstRows, &second, &secondRows);
+
+    firstRows = min(firstRows, maxRows);
+    secondRows = min(secondRows, maxRows - firstRows);
+
+    if (firstRows)
+    {
+        memcpy(buffer, first, firstRows * m_columns * sizeof(float));
+    }
+
+    if (secondRows)
+    {
+        memcpy(&buffer[firstRows * m_columns], second, secondRows * m_columns * sizeof(float));
+    }
+
+    if (alsoRemove)
+    {
+        m_index[T] = getRowIndex(firstRows + secondRows);
+        m_count -= (firstRows + secondRows);
+    }
+
+    return firstRows + secondRows;
+}
+
+/*
+ * Private Class Functions
+ */
+
+/*
+ * getRowIndex
+ *
+ * Returns the index of the row offset rows on from the tail.
+ * The offset is never more than the capacity, so one compare-and-wrap is enough.
+ */
+uint32_t DataFieldStore::getRowIndex(uint32_t offset)
+{
+    uint32_t index = m_index[T] + offset;
+    return (index < m_capacity) ? index : index - m_capacity;
+}
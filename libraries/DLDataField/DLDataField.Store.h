@@ -0,0 +1,45 @@
+#ifndef _DATAFIELD_STORE_H_
+#define _DATAFIELD_STORE_H_
+
+/*
+ * DataFieldStore
+ *
+ * Row-major sample store for a DataFieldManager.
+ * Every row holds one value per field, all rows are kept in a single
+ * contiguous allocation and the whole store shares one head/tail index pair.
+ * Because rows are contiguous, N rows can be exported with (at most) two memcpy calls.
+ */
+
+class DataFieldStore
+{
+    public:
+        DataFieldStore();
+        ~DataFieldStore();
+
+        bool setSize(uint32_t rows, uint32_t columns);
+        uint32_t capacity(void);
+        uint32_t columns(void);
+
+        uint32_t length(void);
+        bool hasData(void);
+        bool full(void);
+
+        float * pushRow(void);
+        float * getRow(uint32_t index);
+        void removeOldest(void);
+        void clear(void);
+
+        uint32_t getSegments(float ** first, uint32_t * firstRows, float ** second, uint32_t * secondRows);
+        uint32_t copyRows(float * buffer, uint32_t maxRows, bool alsoRemove);
+
+    private:
+        uint32_t getRowIndex(uint32_t offset);
+
+        float * m_data;
+        uint32_t m_index[2];
+        uint32_t m_count;
+        uint32_t m_capacity;
+        uint32_t m_columns;
+};
+
+#endif
@@ -29,58 +29,111 @@
  */
 
 #include "DLUtility.Averager.h"
+#include "DLUtility.Arena.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.h"
 #include "DLUtility.h"
 
-StringDataField::StringDataField(FIELD_TYPE type, uint8_t len, uint32_t N, uint32_t channelNumber) : DataField(type, channelNumber)
+StringDataField::StringDataField(FIELD_TYPE type, uint8_t len, uint32_t N, uint32_t channelNumber, Arena * arena) : DataField(type, channelNumber)
 {
-    
     setSize(N);
-    
-    m_data = new char*[N];
-    
-    if (m_data)
+
+    m_arena = arena;
+    m_maxLength = len;
+
+    uint32_t slots = storageSize();
+
+    if (m_arena)
     {
-        uint8_t i = 0;
-        for (i = 0; i < N; i++)
-        {
-            m_data[i] = new char[len];
-        }
+        m_data = (char*)m_arena->allocate(slots * len);
+        m_lengths = (uint8_t*)m_arena->allocate(slots);
+    }
+    else
+    {
+        m_data = new char[slots * len];
+        m_lengths = new uint8_t[slots];
     }
 
-    m_maxLength = len;
+    if (m_data) { memset(m_data, 0, slots * len); }
+    if (m_lengths) { memset(m_lengths, 0, slots); }
 }
 
 StringDataField::~StringDataField()
 {
-    uint8_t i = 0;
-    for (i = 0; i < m_maxIndex; i++)
-    {
-        delete[] m_data[i];
-    }
+    // Anything allocated from an arena is owned by the arena
+    if (m_arena) { return; }
 
     delete[] m_data;
+    delete[] m_lengths;
 }
 
+/*
+ * storeData
+ *
+ * Stores a copy of the string (clipped to the field length, including the null terminator).
+ * If the length of data is already known, it can be passed in to avoid a strlen.
+ */
 void StringDataField::storeData(char const * data)
 {
+    storeData(data, data ? (uint8_t)min(strlen(data), (size_t)UINT8_MAX) : 0);
+}
+
+void StringDataField::storeData(char const * data, uint8_t length)
+{
+    if (!m_data || !m_lengths || !m_maxLength) { return; }
+
+    if (!data) { length = 0; }
+    if (length > (m_maxLength - 1)) { length = m_maxLength - 1; }
+
     prePush();
-    strncpy_safe(m_data[getWriteIndex()], data, m_maxLength);
+    uint32_t index = getWriteIndex();
+    char * slot = getSlot(index);
+    memcpy(slot, data, length);
+    slot[length] = '\0';
+    m_lengths[index] = length;
     postPush();
 }
 
 char * StringDataField::getData(bool alsoRemove)
 {
-    char * data = m_data[ getTailIndex() ];
+    char * data = getSlot(getTailIndex());
     if (alsoRemove) { pop(); }
     return data;
 }
 
-void StringDataField::copy(char * buf, bool alsoRemove)
+/*
+ * getView
+ *
+ * Returns a pointer to the oldest string and its length without copying.
+ * If alsoRemove is true, the view is only valid until the next call to storeData.
+ */
+STRING_VIEW StringDataField::getView(bool alsoRemove)
 {
-    char * data = m_data[ getTailIndex() ];
-    strncpy_safe(buf, data, m_maxLength);
+    uint32_t index = getTailIndex();
+    STRING_VIEW view = {getSlot(index), m_lengths[index]};
     if (alsoRemove) { pop(); }
+    return view;
 }
 
+/*
+ * copy
+ *
+ * Copies the oldest string (and its null terminator) into buf,
+ * which must be at least as long as the field length.
+ * Returns the string length.
+ */
+uint8_t StringDataField::copy(char * buf, bool alsoRemove)
+{
+    STRING_VIEW view = getView(alsoRemove);
+    memcpy(buf, view.data, view.length + 1);
+    return view.length;
+}
+
+/*
+ * Private Class Functions
+ */
+
+char * StringDataField::getSlot(uint32_t index)
+{
+    return &m_data[index * m_maxLength];
+}
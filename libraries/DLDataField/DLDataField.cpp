@@ -75,11 +75,21 @@ DataField::DataField(FIELD_TYPE fieldType, uint32_t channelNumber)
  	m_index[T] = 0;
     m_index[H] = 0;
     m_maxIndex = 0;
+    m_count = 0;
     m_channelNumber = channelNumber;
+    m_averager = NULL;
+    m_arena = NULL;
 }
 
 DataField::~DataField() {}
 
+/*
+ * setSize
+ *
+ * Sets the number of values the field holds.
+ * The head/tail indexes wrap with a compare against m_maxIndex,
+ * so no modulo is needed and storage is exactly this size.
+ */
 void DataField::setSize(uint32_t length)
 {
  	m_maxIndex = length - 1;
@@ -92,10 +102,7 @@ FIELD_TYPE DataField::getType(void)
 
 void DataField::pop(void)
 {
-	if (length())
-	{
-		m_index[T]++;
-	}
+	removeOldest();
 }
 
 void DataField::prePush(void)
@@ -105,12 +112,13 @@ void DataField::prePush(void)
 
 void DataField::postPush(void)
 {
-	m_index[H]++;
+	incrementwithrollover(m_index[H], m_maxIndex);
+	m_count++;
 }
 
 bool DataField::full(void)
 {
-	return (m_index[H] - m_index[T]) >= (m_maxIndex + 1);
+	return m_count > m_maxIndex;
 }
 
 /*void DataField::incrementIndexes(void)
@@ -127,12 +135,22 @@ bool DataField::full(void)
 
 uint32_t DataField::getWriteIndex(void)
 {
-	return m_index[H] % (m_maxIndex + 1);
+	return m_index[H];
 }
 
 uint32_t DataField::getTailIndex(void)
 {
-	return m_index[T] % (m_maxIndex + 1);
+	return m_index[T];
+}
+
+/*
+ * storageSize
+ *
+ * Returns the number of slots a derived class must allocate for its data
+ */
+uint32_t DataField::storageSize(void)
+{
+	return m_maxIndex + 1;
 }
 
 /*uint32_t DataField::getRealReadIndex(uint32_t requestedIndex)
@@ -151,15 +169,16 @@ char const * DataField::getTypeString(void)
 
 uint32_t DataField::length(void)
 {
-		return min((m_index[H] - m_index[T]), m_maxIndex + 1);
+		return m_count;
 }
 
 void DataField::removeOldest(void)
 {
 	// Move the read index on one, effectively ignoring the oldest value.
-	if (length() > 0)
+	if (m_count > 0)
 	{
-		m_index[T]++;
+		incrementwithrollover(m_index[T], m_maxIndex);
+		m_count--;
 	}
 }
 
@@ -3,14 +3,44 @@
 
 // A datafield should return this value if data is requested when none exists
 #define DATAFIELD_NO_DATA_VALUE (float)(0xFFFFFFFF)
+// As above, for fixed-point (Q16.16) data
+#define DATAFIELD_NO_FIXED_DATA_VALUE ((int32_t)0x80000000)
 
 typedef float (APP_CONVERSION_FN)(float, void *);
 
+// Defined in DLUtility.Aggregator.h
+class AggregatePyramid;
+
+// Defined in DLSensor.Thermistor.h
+class ThermistorLUT;
+
+// Defined in DLUtility.Statistics.h
+template <typename T> class Statistics;
+
+// Defined in DLUtility.FixedPoint.h
+struct fixed_linear;
+
+// Defined in DLUtility.Arena.h
+class Arena;
+
+/*
+ * STRING_VIEW
+ *
+ * Read-only view of a stored string (no copy or strlen needed).
+ * data is also null-terminated.
+ */
+struct string_view_data
+{
+    char const * data;
+    uint8_t length;
+};
+typedef struct string_view_data STRING_VIEW;
+
 class DataField
 {
     public:
         DataField(FIELD_TYPE fieldType, uint32_t channelNumber);
-        ~DataField();
+        virtual ~DataField();
 
         void setSize(uint32_t length);
         FIELD_TYPE getType(void);
@@ -23,6 +53,9 @@ class DataField
 
         uint32_t getChannelNumber(void);
 
+        virtual bool isString(void) { return false; }
+        virtual bool isNumeric(void) { return false; }
+
     protected:
 
         //void incrementIndexes(void);
@@ -36,12 +69,17 @@ class DataField
         //uint32_t getRealReadIndex(uint32_t requestedIndex);
 
         uint32_t getWriteIndex(void);
+        uint32_t storageSize(void);
 
         FIELD_TYPE m_fieldType;
         uint32_t m_index[2];
         uint32_t m_maxIndex;
+        uint32_t m_count;
         uint32_t m_channelNumber;
         Averager<int32_t> * m_averager;
+
+        // If set, buffers are allocated from this arena instead of the heap
+        Arena * m_arena;
 };
 
 class NumericDataField : public DataField
@@ -53,14 +91,35 @@ class NumericDataField : public DataField
         NumericDataField(FIELD_TYPE type, void * fieldData, uint32_t channelNumber);
         ~NumericDataField();
 
+        void setArena(Arena * arena);
         void setDataSizes(uint32_t N, uint32_t averagerN);
 
         bool storeData(int32_t data);
+        bool averageData(int32_t data, float * average);
 
         void setAltConversion(APP_CONVERSION_FN * altConversionFn);
 
+        bool addAggregateLevel(uint16_t ratio, uint16_t depth);
+        AggregatePyramid * getAggregator(void) { return m_aggregator; }
+
+        bool setThermistorTableSize(uint16_t tableSize);
+
+        bool enableStatistics(void);
+        Statistics<int32_t> * getWindowStatistics(void) { return m_windowStatistics; }
+
+        // Fixed-point (Q16.16) data path
+        bool enableFixedPoint(void);
+        bool storeFixedData(int32_t data);
+        bool averageFixedData(int32_t data, int32_t * average);
+        int32_t getRawFixedData(bool alsoRemove);
+        int32_t getConvFixedData(bool alsoRemove);
+        int32_t convertFixedData(int32_t raw);
+        void getConvDataAsFixedString(char * buf, uint8_t decimals, bool alsoRemove);
+
         float getRawData(bool alsoRemove);
         float getConvData(bool alsoRemove);
+        float convertData(float raw);
+        void convertArray(const float * raw, float * converted, uint32_t n);
         void getRawDataAsString(char * buf, char const * const fmt, bool alsoRemove);
         void getConvDataAsString(char * buf, char const * const fmt, bool alsoRemove);
         void getConfigString(char * buffer);
@@ -70,9 +129,22 @@ class NumericDataField : public DataField
 
         void * getConversionParams(void) { return m_conversionData; }
     private:
+        bool addToAverager(int32_t data);
+        bool buildThermistorLUT(void);
+        ThermistorLUT * currentThermistorLUT(void);
+
         float * m_data;
+        int32_t * m_fixedData;
+        struct fixed_linear * m_fixedConversion;
         void * m_conversionData;
         APP_CONVERSION_FN * m_altConversionFn;
+        AggregatePyramid * m_aggregator;
+        ThermistorLUT * m_thermistorLUT;
+        float * m_thermistorTable;
+        uint16_t m_thermistorTableSize;
+        uint16_t m_thermistorTableCapacity;
+        Statistics<int32_t> * m_statistics;
+        Statistics<int32_t> * m_windowStatistics;
         #ifdef TEST
         void printContents(void);
         #endif
@@ -83,18 +155,25 @@ class StringDataField : public DataField
     public:
         // len is length of each string
         // N is number of strings to store
-        StringDataField(FIELD_TYPE type, uint8_t len, uint32_t N, uint32_t channelNumber);
+        // arena is optional: if given, all storage is allocated from it
+        StringDataField(FIELD_TYPE type, uint8_t len, uint32_t N, uint32_t channelNumber, Arena * arena = 0);
         ~StringDataField();
 
         void storeData(char const * data);
+        void storeData(char const * data, uint8_t length);
         char * getData(bool alsoRemove);
-        void copy(char * buf, bool alsoRemove);
+        STRING_VIEW getView(bool alsoRemove);
+        uint8_t copy(char * buf, bool alsoRemove);
 
         bool isString(void) { return true; }
         bool isNumeric(void) { return false; }
 
     private:
-        char ** m_data;
+        char * getSlot(uint32_t index);
+
+        // All strings are stored in one slab of storageSize() * m_maxLength bytes
+        char * m_data;
+        uint8_t * m_lengths;
         uint8_t m_maxLength;
 };
 
@@ -0,0 +1,133 @@
+/*
+ * DLDataField.Conversion.Benchmark.cpp
+ *
+ * Compares the single-value and array conversion functions
+ * over a day of one-second data
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <iostream>
+
+#include "DLDataField.Types.h"
+#include "DLDataField.Conversion.h"
+
+#define N_VALUES (24UL * 60UL * 60UL)
+#define REPEATS 20
+
+static VOLTAGECHANNEL s_voltageChannel = {
+    .mvPerBit = 0.125f,
+    .offset = 0.0f,
+    .multiplier = 1.0f,
+    .R1 = 200000.0f,
+    .R2 = 10000.0f,
+};
+
+static CURRENTCHANNEL s_currentChannel = {
+    .mvPerBit = 0.125f,
+    .offset = 60.0f,
+    .mvPerAmp = 600.0f,
+};
+
+static THERMISTORCHANNEL s_thermistorChannel = {
+    .R25 = 10000.0f,
+    .B = 3000.0f,
+    .otherR = 10000.0f,
+    .maxADC = 1023.0f,
+    .highside = true
+};
+
+static float s_raw[N_VALUES];
+static float s_converted[N_VALUES];
+
+static double elapsedMs(clock_t start)
+{
+    return 1000.0 * (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void report(char const * const name, double singleMs, double arrayMs)
+{
+    std::cout << name << ": single " << singleMs << "ms, array " << arrayMs << "ms";
+    std::cout << " (x" << (singleMs / arrayMs) << ")" << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    (void)argc; (void)argv;
+
+    uint32_t i;
+    uint8_t r;
+    clock_t start;
+    double singleMs;
+    double arrayMs;
+    float check = 0.0f;
+
+    for (i = 0; i < N_VALUES; i++)
+    {
+        s_raw[i] = (float)(1 + (i % 1022));
+    }
+
+    std::cout << "Converting " << N_VALUES << " values " << REPEATS << " times" << std::endl;
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        for (i = 0; i < N_VALUES; i++) { s_converted[i] = CONV_VoltsFromRaw(s_raw[i], &s_voltageChannel); }
+        check += s_converted[r];
+    }
+    singleMs = elapsedMs(start);
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        CONV_VoltsFromRawN(s_raw, s_converted, N_VALUES, &s_voltageChannel);
+        check += s_converted[r];
+    }
+    arrayMs = elapsedMs(start);
+    report("Volts", singleMs, arrayMs);
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        for (i = 0; i < N_VALUES; i++) { s_converted[i] = CONV_AmpsFromRaw(s_raw[i], &s_currentChannel); }
+        check += s_converted[r];
+    }
+    singleMs = elapsedMs(start);
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        CONV_AmpsFromRawN(s_raw, s_converted, N_VALUES, &s_currentChannel);
+        check += s_converted[r];
+    }
+    arrayMs = elapsedMs(start);
+    report("Amps", singleMs, arrayMs);
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        for (i = 0; i < N_VALUES; i++) { s_converted[i] = CONV_CelsiusFromRawThermistor(s_raw[i], &s_thermistorChannel); }
+        check += s_converted[r];
+    }
+    singleMs = elapsedMs(start);
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        CONV_CelsiusFromRawThermistorN(s_raw, s_converted, N_VALUES, &s_thermistorChannel);
+        check += s_converted[r];
+    }
+    arrayMs = elapsedMs(start);
+    report("Celsius", singleMs, arrayMs);
+
+    // Stops the compiler optimising away the conversions
+    std::cout << "(Checksum " << check << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * DLDataField.ConversionPolicy.Benchmark.cpp
+ *
+ * Compares per-sample conversion through the runtime NumericDataField
+ * interface against the compile-time FieldConverter
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <iostream>
+
+#include "DLUtility.Averager.h"
+#include "DLSensor.Thermistor.h"
+#include "DLDataField.Types.h"
+#include "DLDataField.h"
+#include "DLDataField.Conversion.h"
+#include "DLDataField.ConversionPolicy.h"
+
+#define N_VALUES (24UL * 60UL * 60UL)
+#define REPEATS 20
+
+static VOLTAGECHANNEL s_voltageChannel = {
+    .mvPerBit = 0.125f,
+    .offset = 0.0f,
+    .multiplier = 1.0f,
+    .R1 = 200000.0f,
+    .R2 = 10000.0f,
+};
+
+static CURRENTCHANNEL s_currentChannel = {
+    .mvPerBit = 0.125f,
+    .offset = 60.0f,
+    .mvPerAmp = 600.0f,
+};
+
+static float s_raw[N_VALUES];
+static float s_converted[N_VALUES];
+
+static double elapsedMs(clock_t start)
+{
+    return 1000.0 * (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static float altVoltageConversion(float raw, void * data)
+{
+    return CONV_VoltsFromRaw(raw, (VOLTAGECHANNEL*)data);
+}
+
+template <FIELD_TYPE type>
+static float benchmark(char const * const name, typename ConversionPolicy<type>::Settings& settings, bool useAltFn)
+{
+    uint32_t i;
+    uint8_t r;
+    clock_t start;
+    float check = 0.0f;
+
+    NumericDataField field(type, &settings, 1);
+    if (useAltFn) { field.setAltConversion(altVoltageConversion); }
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        for (i = 0; i < N_VALUES; i++) { s_converted[i] = field.convertData(s_raw[i]); }
+        check += s_converted[r];
+    }
+    double runtimeMs = elapsedMs(start);
+
+    FieldConverter<type> converter(settings);
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        for (i = 0; i < N_VALUES; i++) { s_converted[i] = converter.convert(s_raw[i]); }
+        check += s_converted[r];
+    }
+    double policyMs = elapsedMs(start);
+
+    std::cout << name << ": NumericDataField " << runtimeMs << "ms, FieldConverter " << policyMs << "ms";
+    std::cout << " (x" << (runtimeMs / policyMs) << ")" << std::endl;
+
+    return check;
+}
+
+int main(int argc, char * argv[])
+{
+    (void)argc; (void)argv;
+
+    uint32_t i;
+    float check = 0.0f;
+
+    for (i = 0; i < N_VALUES; i++)
+    {
+        s_raw[i] = (float)(1 + (i % 1022));
+    }
+
+    std::cout << "Converting " << N_VALUES << " values " << REPEATS << " times, one value per call" << std::endl;
+
+    check += benchmark<VOLTAGE>("Volts", s_voltageChannel, false);
+    check += benchmark<VOLTAGE>("Volts (alternative conversion)", s_voltageChannel, true);
+    check += benchmark<CURRENT>("Amps", s_currentChannel, false);
+
+    // Stops the compiler optimising away the conversions
+    std::cout << "(Checksum " << check << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * DLDataField.FixedPoint.Benchmark.cpp
+ *
+ * Compares the floating-point and fixed-point (Q16.16) data paths of a NumericDataField:
+ * storing and averaging samples, converting to volts/amps and formatting as a string.
+ * Reports CPU cycles per sample (where a cycle counter is available).
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include <iostream>
+
+#include "DLUtility.Averager.h"
+#include "DLUtility.FixedPoint.h"
+#include "DLDataField.Types.h"
+#include "DLDataField.h"
+
+#define N_VALUES (24UL * 60UL * 60UL)
+#define AVERAGER_SIZE 10
+#define FIELD_SIZE 16
+
+static VOLTAGECHANNEL s_voltageChannel = {
+    .mvPerBit = 4.8828125f,
+    .offset = 0.0f,
+    .multiplier = 1.0f,
+    .R1 = 200000.0f,
+    .R2 = 10000.0f,
+};
+
+static CURRENTCHANNEL s_currentChannel = {
+    .mvPerBit = 4.8828125f,
+    .offset = 2500.0f,
+    .mvPerAmp = 185.0f,
+};
+
+static int32_t s_raw[N_VALUES];
+
+/*
+ * Cycle counter: the TSC on x86 hosts, otherwise clock() ticks
+ */
+static uint64_t getCycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    return (uint64_t)clock();
+#endif
+}
+
+static char const * const s_cycleUnit =
+#if defined(__i386__) || defined(__x86_64__)
+    "cycles";
+#else
+    "clock ticks";
+#endif
+
+static uint64_t runFloat(NumericDataField& field, uint32_t * check)
+{
+    char buffer[32];
+    uint32_t i;
+
+    uint64_t start = getCycles();
+    for (i = 0; i < N_VALUES; i++)
+    {
+        if (field.storeData(s_raw[i]))
+        {
+            field.getConvDataAsString(buffer, "%.3f", true);
+            *check += buffer[0];
+        }
+    }
+    return getCycles() - start;
+}
+
+static uint64_t runFixed(NumericDataField& field, uint32_t * check)
+{
+    char buffer[32];
+    uint32_t i;
+
+    uint64_t start = getCycles();
+    for (i = 0; i < N_VALUES; i++)
+    {
+        if (field.storeFixedData(s_raw[i]))
+        {
+            field.getConvDataAsFixedString(buffer, 3, true);
+            *check += buffer[0];
+        }
+    }
+    return getCycles() - start;
+}
+
+static void report(char const * const name, uint64_t floatCycles, uint64_t fixedCycles)
+{
+    std::cout << name << ": float " << ((double)floatCycles / N_VALUES) << " " << s_cycleUnit << "/sample, ";
+    std::cout << "fixed " << ((double)fixedCycles / N_VALUES) << " " << s_cycleUnit << "/sample";
+    std::cout << " (x" << ((double)floatCycles / fixedCycles) << ")" << std::endl;
+}
+
+static void benchmark(char const * const name, FIELD_TYPE type, void * settings, uint32_t * check)
+{
+    NumericDataField floatField = NumericDataField(type, settings, 0);
+    NumericDataField fixedField = NumericDataField(type, settings, 0);
+
+    floatField.setDataSizes(FIELD_SIZE, AVERAGER_SIZE);
+    fixedField.setDataSizes(FIELD_SIZE, AVERAGER_SIZE);
+    fixedField.enableFixedPoint();
+
+    uint64_t floatCycles = runFloat(floatField, check);
+    uint64_t fixedCycles = runFixed(fixedField, check);
+
+    report(name, floatCycles, fixedCycles);
+}
+
+int main(int argc, char * argv[])
+{
+    (void)argc; (void)argv;
+
+    uint32_t i;
+    uint32_t check = 0;
+
+    for (i = 0; i < N_VALUES; i++)
+    {
+        s_raw[i] = (int32_t)(1 + ((i * 7) % 1022));
+    }
+
+    std::cout << "Storing, converting and formatting " << N_VALUES << " samples (averaged in " << AVERAGER_SIZE << "s)" << std::endl;
+
+    benchmark("Volts", VOLTAGE, (void*)&s_voltageChannel, &check);
+    benchmark("Amps", CURRENT, (void*)&s_currentChannel, &check);
+
+    // Stops the compiler optimising away the formatting
+    std::cout << "(Checksum " << check << ")" << std::endl;
+
+    return 0;
+}
@@ -2,6 +2,9 @@
 
 #include "DLUtility.Averager.h"
 #include "DLDataField.h"
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.Arena.h"
+#include "DLDataField.Store.h"
 #include "DLDataField.Manager.h"
 
 static DataFieldManager * s_dataManager;
@@ -28,8 +28,11 @@
  * Local Application Includes
  */
 
+#include "DLUtility.HelperMacros.h"
+#include "DLSensor.Thermistor.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.Conversion.h"
+#include "DLDataField.ConversionPolicy.h"
 
 void test_ConversionToVoltsIsCorrect(void)
 {
@@ -109,6 +112,151 @@ void test_ConversionHighsideThermistorToTemperatureIsCorrect(void)
 	TEST_ASSERT_FLOAT_WITHIN_MESSAGE(expected, actual, expected/100, message);
 }
 
+static float s_rawValues[] = {0.0f, 1.0f, 346.0f, 511.5f, 712.0f, 845.0f, 1023.0f, 4000.0f, 5280.0f};
+
+void test_ArrayConversionToVoltsMatchesSingleConversion(void)
+{
+	VOLTAGECHANNEL testChannel = 
+	{
+	    .mvPerBit = 0.125,
+	    .offset = 0.1,
+	    .multiplier = 1.5,
+	    .R1 = 20000,
+	    .R2 = 10000
+	};
+
+	float actual[N_ELE(s_rawValues)];
+	CONV_VoltsFromRawN(s_rawValues, actual, N_ELE(s_rawValues), &testChannel);
+
+	uint8_t i;
+	for (i = 0; i < N_ELE(s_rawValues); i++)
+	{
+		TEST_ASSERT_FLOAT_WITHIN(1e-4, CONV_VoltsFromRaw(s_rawValues[i], &testChannel), actual[i]);
+	}
+}
+
+void test_ArrayConversionToAmpsMatchesSingleConversion(void)
+{
+	CURRENTCHANNEL testChannel = {
+    	.mvPerBit = 0.125,
+    	.offset = 600,
+    	.mvPerAmp = 60
+    };
+
+	float actual[N_ELE(s_rawValues)];
+	CONV_AmpsFromRawN(s_rawValues, actual, N_ELE(s_rawValues), &testChannel);
+
+	uint8_t i;
+	for (i = 0; i < N_ELE(s_rawValues); i++)
+	{
+		TEST_ASSERT_FLOAT_WITHIN(1e-4, CONV_AmpsFromRaw(s_rawValues[i], &testChannel), actual[i]);
+	}
+}
+
+void test_ArrayConversionToCelsiusMatchesSingleConversion(void)
+{
+	THERMISTORCHANNEL testChannel = 
+	{
+    	.R25 = 10000,
+    	.B = 3000,
+    	.otherR = 10000,
+    	.maxADC = 1023,
+    	.highside = true
+	};
+
+	// Only values inside the ADC range are valid for the thermistor
+	float actual[6];
+	CONV_CelsiusFromRawThermistorN(&s_rawValues[1], actual, 6, &testChannel);
+
+	uint8_t i;
+	for (i = 0; i < 6; i++)
+	{
+		TEST_ASSERT_EQUAL_FLOAT(CONV_CelsiusFromRawThermistor(s_rawValues[i+1], &testChannel), actual[i]);
+	}
+}
+
+void test_ArrayConversionCanBeInPlace(void)
+{
+	CURRENTCHANNEL testChannel = {
+    	.mvPerBit = 0.125,
+    	.offset = 600,
+    	.mvPerAmp = 60
+    };
+
+	float values[] = {4800.0f, 5280.0f};
+	CONV_AmpsFromRawN(values, values, 2, &testChannel);
+
+	TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.0f, values[0]);
+	TEST_ASSERT_FLOAT_WITHIN(1e-4, 1.0f, values[1]);
+
+	// No conversion data just copies the data
+	float copied[2];
+	CONV_AmpsFromRawN(s_rawValues, copied, 2, NULL);
+	TEST_ASSERT_EQUAL_FLOAT_ARRAY(s_rawValues, copied, 2);
+}
+
+void test_FieldConverterMatchesRuntimeConversion(void)
+{
+	VOLTAGECHANNEL voltageChannel = 
+	{
+	    .mvPerBit = 0.125,
+	    .offset = 0.1,
+	    .multiplier = 1.5,
+	    .R1 = 20000,
+	    .R2 = 10000
+	};
+
+	CURRENTCHANNEL currentChannel = {
+    	.mvPerBit = 0.125,
+    	.offset = 600,
+    	.mvPerAmp = 60
+    };
+
+	THERMISTORCHANNEL thermistorChannel = 
+	{
+    	.R25 = 10000,
+    	.B = 3000,
+    	.otherR = 10000,
+    	.maxADC = 1023,
+    	.highside = false
+	};
+
+	FieldConverter<VOLTAGE> voltageConverter(voltageChannel);
+	FieldConverter<CURRENT> currentConverter(currentChannel);
+	FieldConverter<TEMPERATURE_C> thermistorConverter(thermistorChannel);
+
+	uint8_t i;
+	for (i = 1; i < 7; i++)
+	{
+		float raw = s_rawValues[i];
+		TEST_ASSERT_EQUAL_FLOAT(CONV_VoltsFromRaw(raw, &voltageChannel), voltageConverter.convert(raw));
+		TEST_ASSERT_EQUAL_FLOAT(CONV_AmpsFromRaw(raw, &currentChannel), currentConverter.convert(raw));
+		TEST_ASSERT_EQUAL_FLOAT(CONV_CelsiusFromRawThermistor(raw, &thermistorChannel), thermistorConverter.convert(raw));
+	}
+
+	float converted[6];
+	thermistorConverter.convert(&s_rawValues[1], converted, 6);
+	for (i = 0; i < 6; i++)
+	{
+		TEST_ASSERT_EQUAL_FLOAT(thermistorConverter.convert(s_rawValues[i+1]), converted[i]);
+	}
+
+	TEST_ASSERT_TRUE(ConversionPolicy<VOLTAGE>::converts);
+	TEST_ASSERT_FALSE(ConversionPolicy<CARDINAL_DIRECTION>::converts);
+}
+
+void test_FieldConverterWithoutConversionPassesRawValuesThrough(void)
+{
+	NOCONVERSIONSETTINGS settings;
+	FieldConverter<CARDINAL_DIRECTION> converter(settings);
+
+	TEST_ASSERT_EQUAL_FLOAT(s_rawValues[3], converter.convert(s_rawValues[3]));
+
+	float converted[6];
+	converter.convert(&s_rawValues[1], converted, 6);
+	TEST_ASSERT_EQUAL_FLOAT_ARRAY(&s_rawValues[1], converted, 6);
+}
+
 int main(void)
 {
     UnityBegin("DLDataField.Conversion.cpp");
@@ -116,6 +264,12 @@ int main(void)
     RUN_TEST(test_ConversionToVoltsIsCorrect);
     RUN_TEST(test_ConversionToAmpsIsCorrect);
     RUN_TEST(test_ConversionHighsideThermistorToTemperatureIsCorrect);
+    RUN_TEST(test_ArrayConversionToVoltsMatchesSingleConversion);
+    RUN_TEST(test_ArrayConversionToAmpsMatchesSingleConversion);
+    RUN_TEST(test_ArrayConversionToCelsiusMatchesSingleConversion);
+    RUN_TEST(test_ArrayConversionCanBeInPlace);
+    RUN_TEST(test_FieldConverterMatchesRuntimeConversion);
+    RUN_TEST(test_FieldConverterWithoutConversionPassesRawValuesThrough);
 
     UnityEnd();
     return 0;
@@ -14,6 +14,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <math.h>
 
 #include <iostream>
 
@@ -21,10 +22,20 @@
  * Local Application Includes
  */
 
+#include "DLUtility.HelperMacros.h"
 #include "DLUtility.Averager.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.h"
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.Statistics.h"
+#include "DLUtility.Arena.h"
+#include "DLUtility.RingBuffer.h"
+#include "DLUtility.SampleQueue.h"
+#include "DLDataField.Store.h"
 #include "DLDataField.Manager.h"
+#include "DLSettings.Reader.Errors.h"
+#include "DLSettings.DataChannels.h"
+#include "DLSensor.Thermistor.h"
 
 /*
  * Unity Test Framework
@@ -145,8 +156,8 @@ void test_managerDataArrayCanBeAdded(void)
     s_manager->addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 7) );
     s_manager->addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 12) );
 
-    int32_t input[] = {34, 5432, 632, -532};
-    s_manager->storeDataArray(input);
+    int32_t input[] = {34, 0, 5432, 0, 0, 0, 632, 0, 0, 0, 0, -532};
+    TEST_ASSERT_TRUE(s_manager->storeDataArray(input, N_ELE(input)));
 
     float actualFloats[] = {0.0, 0.0, 0.0, 0.0};
     float expectedFloats[] = {34.0, 5432.0, 632.0, -532.0};
@@ -161,6 +172,389 @@ void test_managerDataArrayCanBeAdded(void)
     TEST_ASSERT_EQUAL_FLOAT_ARRAY_MESSAGE(expectedFloats, actualFloats, 4, message);
 }
 
+void test_managerRejectsRowsWithoutAllChannels(void)
+{
+    DataFieldManager manager(10, 1);
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 3) );
+
+    int32_t input[] = {1, 2, 3};
+    TEST_ASSERT_FALSE(manager.storeDataArray(input, 2));
+    TEST_ASSERT_FALSE(manager.storeDataBlock(input, 1, 2));
+
+    SampleQueue queue;
+    queue.setSize(4, 2);
+    queue.push(input);
+    TEST_ASSERT_EQUAL(0, manager.drainSampleQueue(&queue, 1));
+    TEST_ASSERT_EQUAL(1, queue.length());
+
+    TEST_ASSERT_EQUAL(0, manager.count());
+
+    TEST_ASSERT_TRUE(manager.storeDataArray(input, 3));
+    TEST_ASSERT_EQUAL(1, manager.count());
+}
+
+void test_managerStoresOneRowPerCompletedAverage(void)
+{
+    DataFieldManager manager(10, 2);
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 2) );
+
+    int32_t input1[] = {10, 100};
+    int32_t input2[] = {20, 300};
+
+    manager.storeDataArray(input1, N_ELE(input1));
+    TEST_ASSERT_EQUAL(0, manager.count());
+    TEST_ASSERT_FALSE(manager.hasData());
+
+    manager.storeDataArray(input2, N_ELE(input2));
+    TEST_ASSERT_EQUAL(1, manager.count());
+    TEST_ASSERT_TRUE(manager.hasData());
+
+    float expected[] = {15.0f, 200.0f};
+    float actual[2];
+    manager.getDataArray(actual, false, true);
+
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, 2);
+    TEST_ASSERT_EQUAL(0, manager.count());
+    TEST_ASSERT_FALSE(manager.hasData());
+}
+
+void test_managerFieldsCannotBeAddedOnceDataIsStored(void)
+{
+    DataFieldManager manager(10, 1);
+    TEST_ASSERT_TRUE(manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) ));
+
+    int32_t input[] = {10, 100};
+    manager.storeDataArray(input, N_ELE(input));
+
+    TEST_ASSERT_FALSE(manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 2) ));
+    TEST_ASSERT_FALSE(manager.addField( new StringDataField(CARDINAL_DIRECTION, 8, 3, 2) ));
+    TEST_ASSERT_FALSE(manager.setStatisticColumns(STATISTIC_MIN));
+    TEST_ASSERT_EQUAL(1, manager.fieldCount());
+    TEST_ASSERT_EQUAL(1, manager.count());
+}
+
+void test_managerDataBlockReturnsRowsOldestFirst(void)
+{
+    DataFieldManager manager(3, 1);
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 2) );
+
+    int32_t input[2];
+    int32_t i;
+    for (i = 0; i < 4; i++)
+    {
+        input[0] = i;
+        input[1] = -i;
+        manager.storeDataArray(input, N_ELE(input));
+    }
+
+    // Only the three newest rows are kept
+    float expected[] = {1.0f, -1.0f, 2.0f, -2.0f, 3.0f, -3.0f};
+    float actual[6];
+
+    TEST_ASSERT_EQUAL(3, manager.getDataBlock(actual, 3, true));
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, 6);
+    TEST_ASSERT_EQUAL(0, manager.count());
+}
+
+void test_managerDataBlockIngestsStridedRows(void)
+{
+    DataFieldManager manager(10, 2);
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 3) );
+    manager.addField( new StringDataField(CARDINAL_DIRECTION, 8, 3, 2) );
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+
+    // Four rows of four channels; channel 4 is not used by any field
+    int32_t input[] = {
+        1, 0, 10, 999,
+        3, 0, 30, 999,
+        5, 0, 50, 999,
+        7, 0, 70, 999
+    };
+
+    manager.storeDataBlock(input, 4, 4);
+
+    TEST_ASSERT_EQUAL(2, manager.count());
+
+    float expected[] = {20.0f, DATAFIELD_NO_DATA_VALUE, 2.0f, 60.0f, DATAFIELD_NO_DATA_VALUE, 6.0f};
+    float actual[6];
+
+    TEST_ASSERT_EQUAL(2, manager.getDataBlock(actual, 2, false));
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, 6);
+
+    // Converted data leaves the string column alone
+    manager.getDataArray(actual, true, true);
+    TEST_ASSERT_EQUAL_FLOAT(DATAFIELD_NO_DATA_VALUE, actual[1]);
+    TEST_ASSERT_EQUAL(1, manager.count());
+}
+
+void test_managerDrainsSampleQueueInBatches(void)
+{
+    DataFieldManager manager(10, 2);
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 2) );
+
+    SampleQueue queue;
+    queue.setSize(4, 2);
+
+    int32_t row[2];
+    int32_t i;
+
+    // Six rows with a queue of four: the first drain empties the storage up to the wrap
+    for (i = 0; i < 4; i++)
+    {
+        row[0] = i; row[1] = i * 10;
+        queue.push(row);
+    }
+
+    TEST_ASSERT_EQUAL(3, manager.drainSampleQueue(&queue, 3));
+    TEST_ASSERT_EQUAL(1, manager.count());
+
+    for (i = 4; i < 6; i++)
+    {
+        row[0] = i; row[1] = i * 10;
+        queue.push(row);
+    }
+
+    TEST_ASSERT_EQUAL(3, manager.drainSampleQueue(&queue, 100));
+    TEST_ASSERT_EQUAL(0, queue.length());
+    TEST_ASSERT_EQUAL(3, manager.count());
+
+    float expected[] = {0.5f, 5.0f, 2.5f, 25.0f, 4.5f, 45.0f};
+    float actual[6];
+
+    TEST_ASSERT_EQUAL(3, manager.getDataBlock(actual, 3, false));
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, 6);
+}
+
+void test_managerConvertedDataBlockMatchesConvertedDataArray(void)
+{
+    DataFieldManager manager(100, 1);
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+    manager.addField( new NumericDataField(CURRENT, &s_currentChannelSettings, 2) );
+
+    // More rows than a single conversion chunk
+    int32_t input[2];
+    int32_t i;
+    for (i = 0; i < 80; i++)
+    {
+        input[0] = i * 50;
+        input[1] = 1000 + i * 25;
+        manager.storeDataArray(input, N_ELE(input));
+    }
+
+    float block[80 * 2];
+    float row[2];
+
+    TEST_ASSERT_EQUAL(80, manager.getConvDataBlock(block, 80, false));
+
+    for (i = 0; i < 80; i++)
+    {
+        manager.getDataArray(row, true, true);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, row[0], block[i*2]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4, row[1], block[i*2 + 1]);
+    }
+}
+
+void test_managerStoresStatisticColumns(void)
+{
+    DataFieldManager manager(10, 4);
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+    manager.addField( new StringDataField(CARDINAL_DIRECTION, 8, 3, 2) );
+    manager.addField( new NumericDataField(CURRENT, &s_currentChannelSettings, 3) );
+
+    TEST_ASSERT_TRUE(manager.setStatisticColumns(STATISTIC_MIN | STATISTIC_STDDEV));
+    TEST_ASSERT_EQUAL(3 + 2 * 2, manager.columnCount());
+
+    TEST_ASSERT_EQUAL(3, manager.getStatisticColumn(0, STATISTIC_MIN));
+    TEST_ASSERT_EQUAL(4, manager.getStatisticColumn(0, STATISTIC_STDDEV));
+    TEST_ASSERT_EQUAL(5, manager.getStatisticColumn(1, STATISTIC_MIN));
+    TEST_ASSERT_EQUAL(-1, manager.getStatisticColumn(1, STATISTIC_MAX));
+
+    int32_t input[] = {
+        2, 0, 1000,
+        4, 0, 1000,
+        4, 0, 1000,
+        6, 0, 1000,
+    };
+    manager.storeDataBlock(input, 4, 3);
+
+    float expected[] = {4.0f, DATAFIELD_NO_DATA_VALUE, 1000.0f, 2.0f, sqrtf(2.0f), 1000.0f, 0.0f};
+    float actual[7];
+    manager.getDataArray(actual, false, false);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, 7);
+
+    // Standard deviation of a linear conversion scales with the conversion
+    float scale = s_currentChannelSettings.mvPerBit / s_currentChannelSettings.mvPerAmp;
+    manager.getDataArray(actual, true, false);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.0f, actual[6]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, (1000.0f - s_currentChannelSettings.offset / s_currentChannelSettings.mvPerBit) * scale, actual[5]);
+
+    char headers[200];
+    manager.writeHeadersToBuffer(headers, 200);
+    TEST_ASSERT_EQUAL_STRING(
+        "Voltage (V), Wind Direction, Current (A), Voltage (V) min, Voltage (V) sd, Current (A) min, Current (A) sd\r\n",
+        headers);
+}
+
+void test_statisticsSurviveThermistorTableRebuild(void)
+{
+    THERMISTORCHANNEL thermistorSettings = {10000, 3000, 10000, 1023, false};
+    NumericDataField * field = new NumericDataField(TEMPERATURE_C, &thermistorSettings, 1);
+
+    TEST_ASSERT_TRUE(field->enableStatistics());
+    Statistics<int32_t> * statistics = field->getWindowStatistics();
+
+    TEST_ASSERT_TRUE(field->setThermistorTableSize(32));
+    TEST_ASSERT_EQUAL_PTR(statistics, field->getWindowStatistics());
+
+    delete field;
+}
+
+void test_thermistorTableFollowsSettingsChanges(void)
+{
+    THERMISTORCHANNEL thermistorSettings = {10000, 3000, 10000, 1023, false};
+    NumericDataField field(TEMPERATURE_C, &thermistorSettings, 1);
+
+    TEST_ASSERT_TRUE(field.setThermistorTableSize(THERMISTOR_LUT_DEFAULT_SIZE));
+
+    Thermistor before(3000, 10000, false);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, before.TemperatureFromADCReading(10000.0f, 300.0f, 1023), field.convertData(300.0f));
+
+    thermistorSettings.B = 4000;
+    thermistorSettings.highside = true;
+
+    Thermistor after(4000, 10000, true);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, after.TemperatureFromADCReading(10000.0f, 300.0f, 1023), field.convertData(300.0f));
+}
+
+void test_thermistorTableIsAllocatedFromFieldArena(void)
+{
+    THERMISTORCHANNEL thermistorSettings = {10000, 3000, 10000, 1023, false};
+    Arena arena;
+    arena.reserve(ARENA_ALIGN(sizeof(ThermistorLUT)) + ARENA_ALIGN(32 * sizeof(float)));
+
+    NumericDataField field(TEMPERATURE_C, &thermistorSettings, 1);
+    field.setArena(&arena);
+
+    TEST_ASSERT_TRUE(field.setThermistorTableSize(32));
+    TEST_ASSERT_EQUAL(arena.size(), arena.used());
+
+    // Rebuilding reuses the same memory, which cannot grow
+    TEST_ASSERT_TRUE(field.setThermistorTableSize(16));
+    TEST_ASSERT_FALSE(field.setThermistorTableSize(64));
+    TEST_ASSERT_TRUE(field.setThermistorTableSize(32));
+
+    thermistorSettings.otherR = 4700;
+    Thermistor thermistor(3000, 10000, false);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, thermistor.TemperatureFromADCReading(4700.0f, 300.0f, 1023), field.convertData(300.0f));
+    TEST_ASSERT_EQUAL(0, arena.failures());
+}
+
+void test_managerAggregatesEachNumericField(void)
+{
+    // Storage window of two samples, with a level of two storage windows on top
+    DataFieldManager manager(3, 2);
+    TEST_ASSERT_TRUE(manager.addAggregateLevel(2, 4));
+
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 1) );
+    manager.addField( new StringDataField(CARDINAL_DIRECTION, 8, 3, 2) );
+    manager.addField( new NumericDataField(VOLTAGE, &s_voltageChannelSettings, 3) );
+
+    int32_t input[3];
+    int32_t i;
+    for (i = 1; i <= 4; i++)
+    {
+        input[0] = i;
+        input[1] = 0;
+        input[2] = i * 10;
+        manager.storeDataArray(input, N_ELE(input));
+    }
+
+    AGGREGATE aggregates[3];
+
+    // Level 0 is the storage window, and matches the stored rows
+    TEST_ASSERT_EQUAL(2, manager.getLatestAggregates(0, aggregates));
+    TEST_ASSERT_EQUAL_FLOAT(3.5f, aggregates[0].mean);
+    TEST_ASSERT_EQUAL(2, aggregates[0].count);
+    TEST_ASSERT_EQUAL(2, manager.count());
+
+    TEST_ASSERT_EQUAL(2, manager.getLatestAggregates(1, aggregates));
+
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, aggregates[0].min);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, aggregates[0].max);
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, aggregates[0].mean);
+    TEST_ASSERT_EQUAL(4, aggregates[0].count);
+
+    TEST_ASSERT_EQUAL(0, aggregates[1].count);
+
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, aggregates[2].mean);
+
+    TEST_ASSERT_EQUAL(0, manager.getLatestAggregates(2, aggregates));
+}
+
+void test_managerAggregateLevelsAreLimited(void)
+{
+    DataFieldManager manager(3, 2);
+
+    uint8_t level;
+    for (level = 1; level < AGGREGATOR_MAX_LEVELS; level++)
+    {
+        TEST_ASSERT_TRUE(manager.addAggregateLevel(2, 1));
+    }
+    TEST_ASSERT_FALSE(manager.addAggregateLevel(2, 1));
+}
+
+void test_managerAllocatesChannelFieldsFromArena(void)
+{
+    DataFieldManager manager(10, 4);
+    manager.addAggregateLevel(2, 3);
+    TEST_ASSERT_TRUE(manager.setStatisticColumns(STATISTIC_STDDEV));
+
+    Settings_InitDataChannels();
+    Settings_parseDataChannelSetting("CH1.type = Current", 1);
+    Settings_parseDataChannelSetting("CH1.mvperbit = 0.125", 2);
+    Settings_parseDataChannelSetting("CH1.offset = 60.0", 3);
+    Settings_parseDataChannelSetting("CH1.mvperamp = 600.0", 4);
+    Settings_parseDataChannelSetting("CH2.type = Current", 5);
+    Settings_parseDataChannelSetting("CH2.mvperbit = 0.125", 6);
+    Settings_parseDataChannelSetting("CH2.offset = 60.0", 7);
+    Settings_parseDataChannelSetting("CH2.mvperamp = 600.0", 8);
+
+    TEST_ASSERT_TRUE(manager.setupAllValidChannels());
+
+    TEST_ASSERT_EQUAL(2, manager.fieldCount());
+    TEST_ASSERT_NOT_NULL(((NumericDataField*)manager.getField(0))->getAggregator());
+    TEST_ASSERT_NOT_NULL(((NumericDataField*)manager.getField(1))->getWindowStatistics());
+
+    Arena * pArena = manager.getArena();
+    TEST_ASSERT_TRUE(pArena->size() > 0);
+    TEST_ASSERT_EQUAL(0, pArena->failures());
+
+    int32_t data[] = {100, 200};
+    uint8_t i;
+    for (i = 0; i < 4; i++) { manager.storeDataArray(data, N_ELE(data)); }
+
+    TEST_ASSERT_EQUAL(1, manager.count());
+
+    // The arena also has room for each field's own data buffer, which fills it exactly
+    for (i = 0; i < 4; i++)
+    {
+        ((NumericDataField*)manager.getField(0))->storeData(100);
+        ((NumericDataField*)manager.getField(1))->storeData(200);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, ((NumericDataField*)manager.getField(0))->getRawData(false));
+    TEST_ASSERT_EQUAL_FLOAT(200.0f, ((NumericDataField*)manager.getField(1))->getRawData(false));
+    TEST_ASSERT_EQUAL(pArena->size(), pArena->highWaterMark());
+    TEST_ASSERT_EQUAL(0, pArena->failures());
+
+    // The arena is never freed, so the channels can only be set up once
+    TEST_ASSERT_FALSE(manager.setupAllValidChannels());
+    TEST_ASSERT_EQUAL(2, manager.fieldCount());
+}
+
 int main(void)
 {
     UnityBegin("DLDataField.Manager.Test.cpp");
@@ -173,6 +567,20 @@ int main(void)
     RUN_TEST(test_hasDataRemainingReturnsTrueWhenAtLeastOneFieldHasData);
     RUN_TEST(test_managerReturnsCorrectArrayOfChannelNumbers);
     RUN_TEST(test_managerDataArrayCanBeAdded);
+    RUN_TEST(test_managerRejectsRowsWithoutAllChannels);
+    RUN_TEST(test_managerStoresOneRowPerCompletedAverage);
+    RUN_TEST(test_managerFieldsCannotBeAddedOnceDataIsStored);
+    RUN_TEST(test_managerDataBlockReturnsRowsOldestFirst);
+    RUN_TEST(test_managerDataBlockIngestsStridedRows);
+    RUN_TEST(test_managerDrainsSampleQueueInBatches);
+    RUN_TEST(test_managerConvertedDataBlockMatchesConvertedDataArray);
+    RUN_TEST(test_managerStoresStatisticColumns);
+    RUN_TEST(test_statisticsSurviveThermistorTableRebuild);
+    RUN_TEST(test_thermistorTableFollowsSettingsChanges);
+    RUN_TEST(test_thermistorTableIsAllocatedFromFieldArena);
+    RUN_TEST(test_managerAggregatesEachNumericField);
+    RUN_TEST(test_managerAggregateLevelsAreLimited);
+    RUN_TEST(test_managerAllocatesChannelFieldsFromArena);
 
     UnityEnd();
     return 0;
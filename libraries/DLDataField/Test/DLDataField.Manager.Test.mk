@@ -1,11 +1,18 @@
 SRC_FILES += DLDataField/DLDataField.cpp DLDataField/DLDataField.String.cpp
 SRC_FILES += DLDataField/DLDataField.Numeric.cpp DLDataField/DLDataField.Conversion.cpp
+SRC_FILES += DLDataField/DLDataField.Store.cpp
 SRC_FILES += DLUtility/DLUtility.ArrayFunctions.cpp DLUtility/DLUtility.Strings.cpp
-SRC_FILES += DLUtility/DLUtility.Averager.cpp
+SRC_FILES += DLUtility/DLUtility.Averager.cpp DLUtility/DLUtility.PD.cpp
+SRC_FILES += DLUtility/DLUtility.FixedPoint.cpp
+SRC_FILES += DLUtility/DLUtility.Arena.cpp
+SRC_FILES += DLUtility/DLUtility.RingBuffer.cpp
+SRC_FILES += DLUtility/DLUtility.SampleQueue.cpp
+SRC_FILES += DLUtility/DLUtility.Aggregator.cpp DLUtility/DLUtility.Statistics.cpp
 
 SRC_FILES += DLSensor/DLSensor.Thermistor.cpp
 
 SRC_FILES += DLSettings/DLSettings.DataChannels.cpp DLSettings/DLSettings.DataChannels.Helper.cpp
+SRC_FILES += DLSettings/DLSettings.Reader.Errors.cpp
 
 SRC_FILES += DLPlatform/DLPlatform.cpp
 
@@ -0,0 +1,167 @@
+/*
+ * DLDataField.Store.Test.cpp
+ * 
+ * Tests the DataFieldStore class
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLDataField.Store.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+static DataFieldStore * s_store;
+
+static void pushTestRow(float first, float second, float third)
+{
+    float * row = s_store->pushRow();
+    row[0] = first;
+    row[1] = second;
+    row[2] = third;
+}
+
+void setUp(void)
+{
+    s_store = new DataFieldStore();
+    s_store->setSize(4, 3);
+}
+
+void tearDown(void)
+{
+    delete s_store;
+}
+
+static void test_StoreStartsEmptyWithCorrectSize(void)
+{
+    TEST_ASSERT_EQUAL(4, s_store->capacity());
+    TEST_ASSERT_EQUAL(3, s_store->columns());
+    TEST_ASSERT_EQUAL(0, s_store->length());
+    TEST_ASSERT_FALSE(s_store->hasData());
+    TEST_ASSERT_NULL(s_store->getRow(0));
+}
+
+static void test_StoreRowsAreReturnedOldestFirst(void)
+{
+    pushTestRow(1.0f, 2.0f, 3.0f);
+    pushTestRow(4.0f, 5.0f, 6.0f);
+
+    TEST_ASSERT_EQUAL(2, s_store->length());
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, s_store->getRow(0)[0]);
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, s_store->getRow(1)[2]);
+
+    s_store->removeOldest();
+    TEST_ASSERT_EQUAL(1, s_store->length());
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, s_store->getRow(0)[0]);
+}
+
+static void test_StoreRowsAreContiguous(void)
+{
+    pushTestRow(1.0f, 2.0f, 3.0f);
+    pushTestRow(4.0f, 5.0f, 6.0f);
+
+    TEST_ASSERT_EQUAL_PTR(s_store->getRow(0) + 3, s_store->getRow(1));
+}
+
+static void test_StoreOverwritesOldestRowWhenFull(void)
+{
+    uint8_t i;
+    for (i = 0; i < 6; i++)
+    {
+        pushTestRow(i, i * 10, i * 100);
+    }
+
+    TEST_ASSERT_TRUE(s_store->full());
+    TEST_ASSERT_EQUAL(4, s_store->length());
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, s_store->getRow(0)[0]);
+    TEST_ASSERT_EQUAL_FLOAT(500.0f, s_store->getRow(3)[2]);
+}
+
+static void test_StoreSegmentsSplitAtWrap(void)
+{
+    uint8_t i;
+    for (i = 0; i < 6; i++)
+    {
+        pushTestRow(i, i * 10, i * 100);
+    }
+
+    float * first;
+    float * second;
+    uint32_t firstRows;
+    uint32_t secondRows;
+
+    TEST_ASSERT_EQUAL(4, s_store->getSegments(&first, &firstRows, &second, &secondRows));
+    TEST_ASSERT_EQUAL(2, firstRows);
+    TEST_ASSERT_EQUAL(2, secondRows);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, first[0]);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, second[0]);
+}
+
+static void test_StoreCopyRowsCopiesAcrossWrapAndRemoves(void)
+{
+    uint8_t i;
+    for (i = 0; i < 6; i++)
+    {
+        pushTestRow(i, i * 10, i * 100);
+    }
+
+    float actual[9];
+    float expected[] = {2.0f, 20.0f, 200.0f, 3.0f, 30.0f, 300.0f, 4.0f, 40.0f, 400.0f};
+
+    TEST_ASSERT_EQUAL(3, s_store->copyRows(actual, 3, true));
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, 9);
+    TEST_ASSERT_EQUAL(1, s_store->length());
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, s_store->getRow(0)[0]);
+}
+
+static void test_StoreWithNonPowerOfTwoCapacityWrapsCorrectly(void)
+{
+    s_store->setSize(3, 3);
+
+    uint8_t i;
+    for (i = 0; i < 100; i++)
+    {
+        pushTestRow(i, i * 10, i * 100);
+        if ((i % 2) == 0) { s_store->removeOldest(); }
+    }
+
+    float actual[9];
+    float expected[] = {97.0f, 970.0f, 9700.0f, 98.0f, 980.0f, 9800.0f, 99.0f, 990.0f, 9900.0f};
+
+    TEST_ASSERT_EQUAL(3, s_store->length());
+    TEST_ASSERT_EQUAL(3, s_store->copyRows(actual, 3, true));
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, 9);
+    TEST_ASSERT_FALSE(s_store->hasData());
+}
+
+int main(void)
+{
+    UnityBegin("DLDataField.Store.Test.cpp");
+
+    RUN_TEST(test_StoreStartsEmptyWithCorrectSize);
+    RUN_TEST(test_StoreRowsAreReturnedOldestFirst);
+    RUN_TEST(test_StoreRowsAreContiguous);
+    RUN_TEST(test_StoreOverwritesOldestRowWhenFull);
+    RUN_TEST(test_StoreSegmentsSplitAtWrap);
+    RUN_TEST(test_StoreCopyRowsCopiesAcrossWrapAndRemoves);
+    RUN_TEST(test_StoreWithNonPowerOfTwoCapacityWrapsCorrectly);
+
+    UnityEnd();
+    return 0;
+}
@@ -0,0 +1,7 @@
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+
+INC_DIRS += -IDLUtility
+
+local_setup: ;
+
+local_teardown: ;
@@ -22,6 +22,9 @@
  */
 
 #include "DLUtility.Averager.h"
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.FixedPoint.h"
+#include "DLUtility.Arena.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.h"
 #include "DLDataField.Conversion.h"
@@ -49,6 +52,14 @@ static CURRENTCHANNEL s_currentChannelSettings = {
 	.mvPerAmp = 600.0f,
 };
 
+static VOLTAGECHANNEL s_scaledVoltageChannelSettings = {
+	.mvPerBit = 4.8828125f,
+	.offset = 12.0f,
+	.multiplier = 1.0f,
+	.R1 = 90000.0f,
+	.R2 = 10000.0f,
+};
+
 static float sampleConversionFunction(float in, void * data)
 {
 	(void)data;
@@ -137,6 +148,18 @@ static void test_DatafieldStoreArrayOfInts_CorrectlyStoresIntsInAverager(void)
 	TEST_ASSERT_EQUAL_FLOAT(DATAFIELD_NO_DATA_VALUE, dataField.getRawData(false));
 }
 
+static void test_DatafieldWithoutAveragerAveragesWithAggregator(void)
+{
+	NumericDataField dataField = NumericDataField(VOLTAGE, (void*)&s_voltageChannelSettings, 0);
+	dataField.setDataSizes(10, 0);
+	TEST_ASSERT_TRUE(dataField.addAggregateLevel(10, 1));
+
+	fillWithTestIntData(&dataField);
+	TEST_ASSERT_EQUAL_FLOAT(s_expectedAverage, dataField.getRawData(true));
+	TEST_ASSERT_EQUAL_FLOAT(DATAFIELD_NO_DATA_VALUE, dataField.getRawData(false));
+	TEST_ASSERT_EQUAL(1, dataField.getAggregator()->completed(0));
+}
+
 static void test_DatafieldStoreArrayOfInts_CorrectlyReturnsRawAndConvertedData(void)
 {
 	NumericDataField voltsDataField = NumericDataField(VOLTAGE, (void*)&s_voltageChannelSettings, 0);
@@ -225,6 +248,36 @@ static void test_DatafieldStoreArrayOfStrings_BehavesAsCircularBuffer(void)
 	TEST_ASSERT_EQUAL_STRING("NW", dataField.getData(true));
 }
 
+static void test_DatafieldStringViewsReturnStoredLengths(void)
+{
+	StringDataField dataField = StringDataField(CARDINAL_DIRECTION, 3, 5, 0);
+	fillWithTestStringData(&dataField);
+
+	int16_t i;
+	for (i = 0; i < 5; ++i)
+	{
+		STRING_VIEW view = dataField.getView(true);
+		TEST_ASSERT_EQUAL(strlen(strDataArray[i]), view.length);
+		TEST_ASSERT_EQUAL_STRING(strDataArray[i], view.data);
+	}
+}
+
+static void test_DatafieldStringWithKnownLengthIsClipped(void)
+{
+	StringDataField dataField = StringDataField(CARDINAL_DIRECTION, 4, 2, 0);
+	char buffer[4];
+
+	dataField.storeData("NNE", 2);
+	dataField.storeData("WNW-OVERFLOW", 12);
+
+	TEST_ASSERT_EQUAL(2, dataField.copy(buffer, true));
+	TEST_ASSERT_EQUAL_STRING("NN", buffer);
+
+	STRING_VIEW view = dataField.getView(false);
+	TEST_ASSERT_EQUAL(3, view.length);
+	TEST_ASSERT_EQUAL_STRING("WNW", view.data);
+}
+
 static void test_GetFieldTypeString_ReturnsStringforValidIndexAndEmptyOtherwise(void)
 {
 	StringDataField dataField = StringDataField(DEGREES_DIRECTION, 3, 5, 0);
@@ -364,6 +417,96 @@ static void test_DatafieldUsesAlternativeConversionFunction(void)
 	TEST_ASSERT_EQUAL_FLOAT(s_expectedAverage * 2, voltsDataField.getConvData(0));
 }
 
+static void test_DatafieldFixedPointMatchesFloatingPoint(void)
+{
+	NumericDataField floatField = NumericDataField(VOLTAGE, (void*)&s_scaledVoltageChannelSettings, 0);
+	NumericDataField fixedField = NumericDataField(VOLTAGE, (void*)&s_scaledVoltageChannelSettings, 0);
+	floatField.setDataSizes(10, 3);
+	fixedField.setDataSizes(10, 3);
+
+	TEST_ASSERT_TRUE(fixedField.enableFixedPoint());
+
+	int32_t readings[] = {0, 1, 1, 511, 512, 512, 1000, 1023, 1023};
+	uint8_t i;
+	for (i = 0; i < 9; ++i)
+	{
+		floatField.storeData(readings[i]);
+		fixedField.storeFixedData(readings[i]);
+	}
+
+	TEST_ASSERT_EQUAL(3, fixedField.length());
+
+	for (i = 0; i < 3; ++i)
+	{
+		float expectedRaw = floatField.getRawData(false);
+		float expectedConverted = floatField.getConvData(true);
+		float actualRaw = FIXED_ToFloat(fixedField.getRawFixedData(false));
+		float actualConverted = FIXED_ToFloat(fixedField.getConvFixedData(true));
+
+		TEST_ASSERT_FLOAT_WITHIN(0.0001f, expectedRaw, actualRaw);
+		TEST_ASSERT_FLOAT_WITHIN(0.001f, expectedConverted, actualConverted);
+	}
+
+	TEST_ASSERT_EQUAL(DATAFIELD_NO_FIXED_DATA_VALUE, fixedField.getRawFixedData(false));
+}
+
+static void test_DatafieldFixedPointStringsAreCorrect(void)
+{
+	NumericDataField ampsDataField = NumericDataField(CURRENT, (void*)&s_currentChannelSettings, 0);
+	ampsDataField.setDataSizes(10, 10);
+
+	TEST_ASSERT_TRUE(ampsDataField.enableFixedPoint());
+
+	uint8_t i;
+	for (i = 0; i < 10; ++i)
+	{
+		ampsDataField.storeFixedData(s_intDataArray[i]);
+	}
+
+	char expected[16];
+	char actual[16];
+	sprintf(expected, "%.3f", CONV_AmpsFromRaw(s_expectedAverage, &s_currentChannelSettings));
+	ampsDataField.getConvDataAsFixedString(actual, 3, false);
+
+	TEST_ASSERT_EQUAL_STRING(expected, actual);
+}
+
+static void test_DatafieldRejectsMixedFloatAndFixedPointData(void)
+{
+	NumericDataField fixedField = NumericDataField(CURRENT, &s_currentChannelSettings, 1);
+	fixedField.setDataSizes(4, 1);
+	TEST_ASSERT_TRUE(fixedField.storeFixedData(100));
+	TEST_ASSERT_FALSE(fixedField.storeData(200));
+	TEST_ASSERT_EQUAL(1, fixedField.length());
+	TEST_ASSERT_EQUAL(DATAFIELD_NO_DATA_VALUE, fixedField.getRawData(false));
+	TEST_ASSERT_EQUAL_FLOAT(100.0f, FIXED_ToFloat(fixedField.getRawFixedData(false)));
+
+	NumericDataField floatField = NumericDataField(CURRENT, &s_currentChannelSettings, 1);
+	floatField.setDataSizes(4, 1);
+	TEST_ASSERT_TRUE(floatField.storeData(100));
+	TEST_ASSERT_FALSE(floatField.storeFixedData(200));
+	TEST_ASSERT_EQUAL(1, floatField.length());
+	TEST_ASSERT_EQUAL(DATAFIELD_NO_FIXED_DATA_VALUE, floatField.getRawFixedData(false));
+	TEST_ASSERT_EQUAL_FLOAT(100.0f, floatField.getRawData(false));
+}
+
+static void test_DatafieldFixedPointFallsBackForAlternativeConversion(void)
+{
+	NumericDataField voltsDataField = NumericDataField(VOLTAGE, (void*)&s_voltageChannelSettings, 0);
+	voltsDataField.setDataSizes(10, 10);
+	voltsDataField.setAltConversion(sampleConversionFunction);
+
+	TEST_ASSERT_FALSE(voltsDataField.enableFixedPoint());
+
+	uint8_t i;
+	for (i = 0; i < 10; ++i)
+	{
+		voltsDataField.storeFixedData(s_intDataArray[i]);
+	}
+
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, s_expectedAverage * 2, FIXED_ToFloat(voltsDataField.getConvFixedData(false)));
+}
+
 /*static void test_writeNumericDataFieldsToBuffer_WritesCorrectValues(void)
 {
 	NumericDataField fieldArray[] = {
@@ -400,6 +543,36 @@ static void test_writeStringDataFieldsToBuffer_WritesCorrectValues(void)
 	TEST_ASSERT_EQUAL_STRING("N, NE, E", buffer);
 }*/
 
+static void test_DatafieldsCanBeAllocatedFromArena(void)
+{
+	Arena arena;
+	arena.reserve(1024);
+
+	NumericDataField * pNumeric = new (arena) NumericDataField(CURRENT, (void*)&s_currentChannelSettings, 0);
+	TEST_ASSERT_NOT_NULL(pNumeric);
+
+	pNumeric->setArena(&arena);
+	pNumeric->setDataSizes(10, 10);
+	fillWithTestIntData(pNumeric);
+
+	TEST_ASSERT_EQUAL_FLOAT(s_expectedAverage, pNumeric->getRawData(false));
+
+	StringDataField * pString = new (arena) StringDataField(CARDINAL_DIRECTION, 5, 5, 0, &arena);
+	TEST_ASSERT_NOT_NULL(pString);
+
+	fillWithTestStringData(pString);
+	TEST_ASSERT_EQUAL_STRING("N", pString->getData(false));
+
+	uint32_t used = arena.used();
+	TEST_ASSERT_TRUE(used > 0);
+	TEST_ASSERT_EQUAL(used, arena.highWaterMark());
+
+	// Storing more data must not allocate any more
+	fillWithTestIntData(pNumeric);
+	fillWithTestStringData(pString);
+	TEST_ASSERT_EQUAL(used, arena.used());
+}
+
 int main(void)
 {
     UnityBegin("DLDataField.cpp");
@@ -411,6 +584,7 @@ int main(void)
     RUN_TEST(test_DatafieldStoreAsString_ClipsStringsLongerThanMaximumLength);
 
     RUN_TEST(test_DatafieldStoreArrayOfInts_CorrectlyStoresIntsInAverager);
+    RUN_TEST(test_DatafieldWithoutAveragerAveragesWithAggregator);
     RUN_TEST(test_DatafieldStoreArrayOfInts_CorrectlyReturnsRawAndConvertedData);
     RUN_TEST(test_DatafieldStoreArrayOfInts_BehavesAsCircularBuffer);
 
@@ -423,10 +597,19 @@ int main(void)
 
     RUN_TEST(test_DatafieldStoreArrayOfStrings_CorrectlyStoresStrings);
     RUN_TEST(test_DatafieldStoreArrayOfStrings_BehavesAsCircularBuffer);
+    RUN_TEST(test_DatafieldStringViewsReturnStoredLengths);
+    RUN_TEST(test_DatafieldStringWithKnownLengthIsClipped);
 
     RUN_TEST(test_GetFieldTypeString_ReturnsStringforValidIndexAndEmptyOtherwise);
 
     RUN_TEST(test_DatafieldUsesAlternativeConversionFunction);
+
+    RUN_TEST(test_DatafieldFixedPointMatchesFloatingPoint);
+    RUN_TEST(test_DatafieldFixedPointStringsAreCorrect);
+    RUN_TEST(test_DatafieldFixedPointFallsBackForAlternativeConversion);
+    RUN_TEST(test_DatafieldRejectsMixedFloatAndFixedPointData);
+
+    RUN_TEST(test_DatafieldsCanBeAllocatedFromArena);
     
     //RUN_TEST(test_writeNumericDataFieldsToBuffer_WritesCorrectValues);
     //RUN_TEST(test_writeStringDataFieldsToBuffer_WritesCorrectValues);
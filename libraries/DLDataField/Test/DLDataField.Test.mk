@@ -1,7 +1,8 @@
 SRC_FILES += DLDataField/DLDataField.String.cpp DLDataField/DLDataField.Numeric.cpp 
 SRC_FILES += DLDataField/DLDataField.Conversion.cpp
 SRC_FILES += DLUtility/DLUtility.ArrayFunctions.cpp DLUtility/DLUtility.Strings.cpp
-SRC_FILES += DLUtility/DLUtility.Averager.cpp
+SRC_FILES += DLUtility/DLUtility.Averager.cpp DLUtility/DLUtility.Aggregator.cpp
+SRC_FILES += DLUtility/DLUtility.Statistics.cpp DLUtility/DLUtility.FixedPoint.cpp DLUtility/DLUtility.Arena.cpp
 
 SRC_FILES += DLUtility/DLUtility.PD.cpp
 
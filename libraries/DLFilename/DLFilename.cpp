@@ -27,6 +27,7 @@
 #include "DLUtility.h"
  
 static char s_buffer[20];
+static char s_indexBuffer[20];
 
 /* Private Function Definitions */
 static bool checkDayIsValid(uint8_t day)
@@ -86,6 +87,17 @@ void Filename_setFromDate(uint8_t day, uint8_t month, uint8_t year, uint16_t ind
     s_buffer[c++] = 's';
     s_buffer[c++] = 'v';
     s_buffer[c++] = '\0';
+
+    /* The index file for each data file is Dyy-mm-dd.idx */
+    for (c = 0; s_buffer[c] != '.'; c++)
+    {
+        s_indexBuffer[c] = s_buffer[c];
+    }
+    s_indexBuffer[c++] = '.';
+    s_indexBuffer[c++] = 'i';
+    s_indexBuffer[c++] = 'd';
+    s_indexBuffer[c++] = 'x';
+    s_indexBuffer[c++] = '\0';
 }
 
 char const * Filename_get(void)
@@ -93,3 +105,7 @@ char const * Filename_get(void)
     return s_buffer;
 }
 
+char const * Filename_getIndex(void)
+{
+    return s_indexBuffer;
+}
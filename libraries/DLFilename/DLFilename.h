@@ -3,5 +3,6 @@
 
 void Filename_setFromDate(uint8_t day, uint8_t month, uint8_t year, uint16_t index);
 char const * Filename_get(void);
+char const * Filename_getIndex(void);
 
 #endif
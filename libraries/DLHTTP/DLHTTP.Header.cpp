@@ -89,7 +89,7 @@ void Header::setFromLine(const char * p)
     if (!p) { return; }
     
     // Get the name (up to the colon character)
-    while( *p && *p != ':' && i < MAX_HTTP_HEADER_NAME_LENGTH)
+    while( *p && *p != ':' && i < MAX_HTTP_HEADER_NAME_LENGTH - 1)
     {
         m_name[i++] = tolower( *p++ );
         m_name[i] = '\0';
@@ -102,7 +102,7 @@ void Header::setFromLine(const char * p)
 
 	// Get value
     i = 0;
-	while( *p && *p != '\0' && i < MAX_HTTP_HEADER_VALUE_LENGTH)
+	while( *p && *p != '\0' && i < MAX_HTTP_HEADER_VALUE_LENGTH - 1)
     {
 		m_value[i++] = *p++;
         m_value[i] = '\0';
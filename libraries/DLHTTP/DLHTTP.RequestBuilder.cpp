@@ -57,8 +57,7 @@
 //
 //---------------------------------------------------------------------
 
-RequestBuilder::RequestBuilder():
-    accumulator(NULL, 0)
+RequestBuilder::RequestBuilder()
 {
     m_headerCount = 0;
     m_paramCount = 0;
@@ -66,6 +65,7 @@ RequestBuilder::RequestBuilder():
     m_method = NULL;
     m_url = NULL;
     m_body = NULL;
+    m_contentLength[0] = '\0';
 }
 
 RequestBuilder::~RequestBuilder() {}
@@ -83,11 +83,17 @@ void RequestBuilder::setURLParam( const char* name, const char* value )
     m_params[m_paramCount++].value = value;
 }
 
+/*
+ * putHeader
+ *
+ * Adds a header to the request. The name and value are not copied,
+ * so they must stay valid until the request has been written.
+ */
 void RequestBuilder::putHeader( const char* header, const char* value )
 {
     if (m_headerCount == MAX_HTTP_HEADERS) { return; }
-    m_headers[m_headerCount].setName(header);
-    m_headers[m_headerCount++].setValue(value);
+    m_headers[m_headerCount].name = header;
+    m_headers[m_headerCount++].value = value;
 }
 
 void RequestBuilder::putBody(const char * body)
@@ -97,74 +103,129 @@ void RequestBuilder::putBody(const char * body)
 
 void RequestBuilder::writeToBuffer(char * buf, uint16_t maxLength, bool addContentLengthHeader)
 {
+    if (!m_method || !m_url || !buf) { return; }
+
+    HTTPBufferSink sink(buf, maxLength);
+    writeRequest(&sink, addContentLengthHeader);
+}
+
+/*
+ * writeHead
+ *
+ * Writes the request line, headers and the blank line that ends them to a sink,
+ * so that the body can then be streamed after them.
+ * The Content-Length header is only written if contentLength is not negative.
+ * Returns false if any write to the sink failed.
+ */
+bool RequestBuilder::writeHead(HTTPSink * sink, int32_t contentLength)
+{
+    if (!m_method || !m_url || !sink) { return false; }
+
+    bool ok = writeLines(sink, contentLength);
+    ok &= sink->writeString(CRLF);
 
+    return ok;
+}
+
+/*
+ * gather
+ *
+ * Builds the same request as writeToBuffer, but as a list of segments pointing at
+ * the method, URL, parameters, headers and body themselves, so nothing is copied.
+ * The segments are only valid while those strings are, and until the builder is next used.
+ * Returns the number of segments needed: if this is more than maxSegments, the list is incomplete.
+ */
+uint8_t RequestBuilder::gather(HTTPSegment * segments, uint8_t maxSegments, bool addContentLengthHeader)
+{
+    if (!m_method || !m_url || !segments) { return 0; }
+
+    HTTPGatherSink sink(segments, maxSegments);
+    writeRequest(&sink, addContentLengthHeader);
+
+    return sink.count();
+}
+
+void RequestBuilder::reset(void)
+{
+    m_url = NULL;
+    m_body = NULL;
+    m_paramCount = 0;
+    m_headerCount = 0;
+}
+
+/*
+ * writeLines
+ *
+ * Writes the request line and header lines (but not the blank line after them).
+ * The Content-Length header is only written if contentLength is not negative.
+ */
+bool RequestBuilder::writeLines(HTTPSink * sink, int32_t contentLength)
+{
     uint8_t i = 0;
+    bool ok = true;
+
+    if (!m_method || !m_url || !sink) { return false; }
 
-    if (!m_method || !m_url || !buf) { return; }
-    
-    accumulator.detach();
-    accumulator.attach(buf, maxLength); 
-    accumulator.reset();
-    
     /* Write status line */
-    accumulator.writeString(m_method);
-    accumulator.writeChar(' ');
-    accumulator.writeString(m_url);
+    ok &= sink->writeString(m_method);
+    ok &= sink->writeString(" ");
+    ok &= sink->writeString(m_url);
 
     if (m_paramCount > 0)
     {
         // Write params after URL
-        accumulator.writeChar('?');
+        ok &= sink->writeString("?");
         for (i = 0; i < m_paramCount; i++)
         {
-            accumulator.writeString(m_params[i].name);
-            accumulator.writeChar('=');
-            accumulator.writeString(m_params[i].value);
+            ok &= sink->writeString(m_params[i].name);
+            ok &= sink->writeString("=");
+            ok &= sink->writeString(m_params[i].value);
             if (!lastinloop(i, m_paramCount))
             {
-                accumulator.writeChar('&');
+                ok &= sink->writeString("&");
             }
         }
     }
 
-    accumulator.writeChar(' ');
-    accumulator.writeString("HTTP/1.1");
-    accumulator.writeString(CRLF);
-    
-    /* Write header lines */
-    
+    ok &= sink->writeString(" HTTP/1.1" CRLF);
 
+    /* Write header lines */
     for (i = 0; i < m_headerCount; i++)
     {
-        accumulator.writeString(m_headers[i].getName());
-        accumulator.writeString(": ");
-        accumulator.writeString(m_headers[i].getValue());
-        accumulator.writeString(CRLF);
+        ok &= sink->writeString(m_headers[i].name);
+        ok &= sink->writeString(": ");
+        ok &= sink->writeString(m_headers[i].value);
+        ok &= sink->writeString(CRLF);
     }
-    
-    if (addContentLengthHeader && m_body)
+
+    if (contentLength >= 0)
     {
-        char lengthStr[5];
-        sprintf(lengthStr, "%d", (int)strlen(m_body));
-        
-        accumulator.writeString("Content-Length: ");
-        accumulator.writeString(lengthStr);
-        accumulator.writeString(CRLF);
+        sprintf(m_contentLength, "%ld", (long)contentLength);
+
+        ok &= sink->writeString("Content-Length: ");
+        ok &= sink->writeString(m_contentLength);
+        ok &= sink->writeString(CRLF);
     }
-    
+
+    return ok;
+}
+
+/*
+ * Private Class Functions
+ */
+
+// Writes the whole request, with the body (if any) after a blank line and followed by CRLF
+bool RequestBuilder::writeRequest(HTTPSink * sink, bool addContentLengthHeader)
+{
+    bool ok = writeLines(sink, (addContentLengthHeader && m_body) ? (int32_t)strlen(m_body) : -1);
+
     /* Write body */ 
     if (m_body)
     {
-        accumulator.writeString(CRLF);
-        accumulator.writeString(m_body);
-        accumulator.writeString(CRLF);
+        ok &= sink->writeString(CRLF);
+        ok &= sink->writeString(m_body);
+        ok &= sink->writeString(CRLF);
     }
-}
 
-void RequestBuilder::reset(void)
-{
-    m_url = NULL;
-    m_body = NULL;
-    m_paramCount = 0;
-    m_headerCount = 0;
-}
\ No newline at end of file
+    return ok;
+}
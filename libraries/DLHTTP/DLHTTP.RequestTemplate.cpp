@@ -0,0 +1,115 @@
+/*
+ * DLHTTP.RequestTemplate.cpp
+ *
+ * Pre-rendered request line and headers for requests that are sent repeatedly
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLHTTP.h"
+
+//---------------------------------------------------------------------
+//
+// RequestTemplate
+//
+//---------------------------------------------------------------------
+
+RequestTemplate::RequestTemplate() : m_headLength(0)
+{
+    m_head[0] = '\0';
+}
+
+/*
+ * render
+ *
+ * Renders the request line and headers set on the builder (which should not include Content-Length).
+ * Returns false if they don't fit in MAX_HTTP_TEMPLATE_LENGTH chars.
+ */
+bool RequestTemplate::render(RequestBuilder * builder)
+{
+    m_headLength = 0;
+    m_head[0] = '\0';
+
+    if (!builder) { return false; }
+
+    HTTPBufferSink sink(m_head, MAX_HTTP_TEMPLATE_LENGTH);
+    if (!builder->writeLines(&sink, -1)) { return false; }
+
+    m_headLength = sink.length();
+    return true;
+}
+
+bool RequestTemplate::isRendered(void) { return m_headLength > 0; }
+
+uint16_t RequestTemplate::headLength(void) { return m_headLength; }
+
+/*
+ * fill
+ *
+ * Writes the whole request into buffer: the rendered head, then the Content-Length,
+ * a blank line and the body followed by CRLF (the same as RequestBuilder::writeToBuffer).
+ * Returns the length of the request, or 0 if it does not fit in maxLength chars
+ * (including the terminator) or the template has not been rendered.
+ */
+uint16_t RequestTemplate::fill(char * buffer, uint16_t maxLength, const char * body, uint16_t bodyLength)
+{
+    char lengthLine[32];
+
+    if (!buffer || !isRendered()) { return 0; }
+    if (!body) { bodyLength = 0; }
+
+    uint16_t lengthLineLength = sprintf(lengthLine, "Content-Length: %u" CRLF CRLF, bodyLength);
+    uint32_t total = (uint32_t)m_headLength + lengthLineLength + bodyLength + 2;
+
+    if (total + 1 > maxLength) { return 0; }
+
+    char * p = buffer;
+    memcpy(p, m_head, m_headLength); p += m_headLength;
+    memcpy(p, lengthLine, lengthLineLength); p += lengthLineLength;
+    if (bodyLength) { memcpy(p, body, bodyLength); p += bodyLength; }
+    memcpy(p, CRLF, 3);
+
+    return total;
+}
+
+/*
+ * writeTo
+ *
+ * Writes the same request as fill straight to a sink.
+ * Returns false if the template has not been rendered or any write failed.
+ */
+bool RequestTemplate::writeTo(HTTPSink * sink, const char * body, uint16_t bodyLength)
+{
+    char lengthLine[32];
+
+    if (!sink || !isRendered()) { return false; }
+    if (!body) { bodyLength = 0; }
+
+    uint16_t lengthLineLength = sprintf(lengthLine, "Content-Length: %u" CRLF CRLF, bodyLength);
+
+    bool ok = sink->write(m_head, m_headLength);
+    ok &= sink->write(lengthLine, lengthLineLength);
+    if (bodyLength) { ok &= sink->write(body, bodyLength); }
+    ok &= sink->writeString(CRLF);
+
+    return ok;
+}
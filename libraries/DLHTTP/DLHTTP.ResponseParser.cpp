@@ -51,67 +51,164 @@
 #include "DLUtility.Strings.h"
 #include "DLHTTP.h"
 
+// Largest Content-Length that m_Length (an int) can hold
+#define MAX_CONTENT_LENGTH ((unsigned long)(~0U >> 1))
+
 //---------------------------------------------------------------------
 //
 // ResponseParser
 //
 //---------------------------------------------------------------------
 
-ResponseParser::ResponseParser(const char * response) : m_headerCount(0), m_lineAccumulator(m_headerBuffer, MAX_HTTP_HEADER_TOTAL_LENGTH)
+ResponseParser::ResponseParser() : m_lineAccumulator(m_headerBuffer, MAX_HTTP_HEADER_TOTAL_LENGTH)
+{
+    setCallbacks(NULL, NULL, NULL, NULL, NULL);
+    reset();
+}
+
+ResponseParser::ResponseParser(const char * response) : m_lineAccumulator(m_headerBuffer, MAX_HTTP_HEADER_TOTAL_LENGTH)
+{
+    setCallbacks(NULL, NULL, NULL, NULL, NULL);
+    reset();
+
+    if (response)
+    {
+        feed(response, strlen(response));
+    }
+}
+
+void ResponseParser::reset(void)
 {
     m_State = STATUSLINE;
     m_version = 0;
     m_status = 0;
+    m_reason[0] = '\0';
     m_BytesRead = 0;
     m_Length = -1;
     m_headerCount = 0;
     m_lineAccumulator.attach(&m_headerBuffer[0], MAX_HTTP_HEADER_TOTAL_LENGTH);
+}
 
-    uint16_t count = strlen(response);
+/*
+ * setCallbacks
+ *
+ * Sets the functions to call as the response is parsed (any can be NULL).
+ * userdata is passed to each callback unchanged.
+ */
 
-	while( count > 0 && m_State != COMPLETE )
-	{
-		if( m_State == STATUSLINE ||
-			m_State == HEADERS
-			)
-		{
-			// we want to accumulate a line
-			while( count > 0 )
-			{
-				char c = (char)*response++;
-				--count;
-				if( c == '\n' )
-				{
-					// now got a whole line!
-					switch( m_State )
-					{
-						case STATUSLINE:
-							processStatusLine( m_lineAccumulator.c_str() );
-							break;
-						case HEADERS:
-							processHeaderLine( m_lineAccumulator.c_str() );
-							break;
-						default:
-							break;
-					}
-					m_lineAccumulator.reset();
-					break;		// break out of line accumulation!
-				}
-				else
-				{
-					if( c != '\r' )		// just ignore CR
-						m_lineAccumulator.writeChar(c);
-				}
-			}
-		}
-		else if( m_State == BODY )
-		{
-			int bytesused = 0;
-            bytesused = processBody( response, count );
-			response += bytesused;
-			count -= bytesused;
-		}
-	}    
+void ResponseParser::setCallbacks(ResponseStatus_CB onStatus, ResponseHeader_CB onHeader,
+    ResponseData_CB onData, ResponseComplete_CB onComplete, void * userdata)
+{
+    m_onStatus = onStatus;
+    m_onHeader = onHeader;
+    m_onData = onData;
+    m_onComplete = onComplete;
+    m_userdata = userdata;
+}
+
+/*
+ * feed
+ *
+ * Parses the next count bytes of the response. Can be called repeatedly as data arrives,
+ * with the data split at any point.
+ * Returns the number of bytes used (fewer than count once the response is complete or malformed).
+ */
+
+uint16_t ResponseParser::feed(const char * data, uint16_t count)
+{
+    uint16_t used = 0;
+
+    if (!data) { return 0; }
+
+    while( used < count && m_State != COMPLETE && m_State != MALFORMED )
+    {
+        if( m_State == STATUSLINE || m_State == HEADERS )
+        {
+            char c = data[used++];
+            if( c == '\n' )
+            {
+                // now got a whole line!
+                if ( m_State == STATUSLINE )
+                {
+                    processStatusLine( m_lineAccumulator.c_str() );
+                }
+                else
+                {
+                    processHeaderLine( m_lineAccumulator.c_str() );
+                }
+                m_lineAccumulator.reset();
+            }
+            else if( c != '\r' ) // just ignore CR
+            {
+                m_lineAccumulator.writeChar(c);
+            }
+        }
+        else if( m_State == BODY )
+        {
+            used += processBody( &data[used], count - used );
+        }
+    }
+
+    return used;
+}
+
+/*
+ * end
+ *
+ * Call when the connection closes. A response with no Content-Length ends here
+ * (one that is shorter than its Content-Length is left incomplete).
+ */
+
+void ResponseParser::end(void)
+{
+    if ( m_State == BODY && m_Length == -1 ) { finish(); }
+}
+
+bool ResponseParser::gotStatus() const { return m_State != STATUSLINE; }
+bool ResponseParser::gotHeaders() const { return (m_State == BODY) || (m_State == COMPLETE); }
+bool ResponseParser::isComplete() const { return m_State == COMPLETE; }
+bool ResponseParser::isMalformed() const { return m_State == MALFORMED; }
+int ResponseParser::getContentLength() const { return m_Length; }
+
+/*
+ * allowsKeepAlive
+ *
+ * Returns true if the connection this response came in on can be reused: the response
+ * must be complete (so its end was known from the Content-Length) and the server must not
+ * have asked to close.
+ */
+
+bool ResponseParser::allowsKeepAlive()
+{
+    if ( m_State != COMPLETE ) { return false; }
+    if ( m_Length == -1 ) { return false; } // Body ran to the end of the connection
+
+    return connectionPersists();
+}
+
+/*
+ * connectionPersists
+ *
+ * Returns true if the server will keep the connection open after this response, going by
+ * its headers. HTTP/1.1 connections are persistent by default, HTTP/1.0 ones are not.
+ */
+
+bool ResponseParser::connectionPersists()
+{
+    char connectionName[] = "connection"; // getHeaderValue lowercases the name in place
+    const char * connection = getHeaderValue( connectionName );
+
+    if ( connection )
+    {
+        char value[MAX_HTTP_HEADER_VALUE_LENGTH];
+        strncpy_safe(value, connection, MAX_HTTP_HEADER_VALUE_LENGTH);
+        toLowerStr(value);
+
+        if ( strcmp(value, "close") == 0 ) { return false; }
+        if ( strcmp(value, "keep-alive") == 0 ) { return true; }
+    }
+
+    return m_version == 11;
 }
 
 /*
@@ -157,7 +254,6 @@ const char* ResponseParser::getHeaderValue(char  * name )
 // returns number of bytes used.
 int ResponseParser::processBody( const char * data, int count )
 {
-    (void)data;
 	int n = count;
 	if( m_Length != -1 )
 	{
@@ -167,8 +263,14 @@ int ResponseParser::processBody( const char * data, int count )
 			n = remaining;
 	}
 
+	// Never report more (or less) than was given
+	if( n < 0 ) { n = 0; }
+	if( n > count ) { n = count; }
+
 	m_BytesRead += n;
 
+	if ( m_onData && n > 0 ) { m_onData(data, n, m_userdata); }
+
 	// Finish if we know we're done
 	if( m_Length != -1 && m_BytesRead == m_Length )
 	{
@@ -182,6 +284,7 @@ int ResponseParser::processBody( const char * data, int count )
 void ResponseParser::finish()
 {
 	m_State = COMPLETE;
+	if ( m_onComplete ) { m_onComplete(this, m_userdata); }
 }
 
 
@@ -194,41 +297,41 @@ void ResponseParser::processStatusLine( const char * line )
     if (strncmp("HTTP/1.", line, 7) == 0)
     {
         m_version = line[7] == '0' ? 10 : 11;
+        line += 8;
     }
     else
     {
         m_version = 0;
+        line += strlen(line); // Not a status line, so leave status as 0
     }
-    line += 8;
     line = skipSpaces(line);
     
     char status[4];
     
     // ASSUMES status code is exactly three digits long!
-    status[0] = *line++;
-    status[1] = *line++;
-    status[2] = *line++;
-    status[3] = '\0';
+    uint8_t i;
+    for (i = 0; (i < 3) && *line; i++)
+    {
+        status[i] = *line++;
+    }
+    status[i] = '\0';
     m_status = atoi( status );
     
     line = skipSpaces(line);
     
     // rest of line is reason
-    uint8_t i = 0;
-    while( *line != '\r' )
+    i = 0;
+    while( *line && (*line != '\r') && (i < MAX_HTTP_RESPONSE_REASON_LENGTH - 1) )
     {
         m_reason[i++] = *line++;
     }
-
-    /*
-	printf( "version: '%d'\n", m_version );
-	printf( "status: '%d'\n", m_status );
-	printf( "reason: '%s'\n", m_reason );
-	*/
+    m_reason[i] = '\0';
 
 	// OK, now we expect headers!
 	m_State = HEADERS;
 	clearHeaderAccumulator();
+
+	if ( m_onStatus ) { m_onStatus(this, m_userdata); }
 }
 
 void ResponseParser::processHeaderLine( const char * line )
@@ -237,6 +340,7 @@ void ResponseParser::processHeaderLine( const char * line )
 	{
 
 		storeHeader();	// end of headers
+		if( m_State == MALFORMED ) { return; }
 		beginBody();	// start on body now!
         
         return;
@@ -265,13 +369,47 @@ void ResponseParser::storeHeader()
 {
 	if( strlen(m_lineAccumulator.c_str()) == 0) { return; }
 
-	m_headers[m_headerCount++].setFromLine(m_lineAccumulator.c_str());
-    
-//	printf("header: ['%s': '%s']\n", header.c_str(), value.c_str() );	
+	// Headers past MAX_HTTP_HEADERS are not kept, but are still passed to the callback
+	Header overflow;
+	Header * header = (m_headerCount < MAX_HTTP_HEADERS) ? &m_headers[m_headerCount++] : &overflow;
+
+	header->setFromLine(m_lineAccumulator.c_str());
+
+	if (header->matchName("content-length") && !parseContentLength(header->getValue()))
+	{
+		// The end of the body can't be known, so nothing more can be read from this connection
+		m_State = MALFORMED;
+	}
+
+	if ( m_onHeader ) { m_onHeader(header, m_userdata); }
 
 	clearHeaderAccumulator();
 }
 
+/*
+ * parseContentLength
+ *
+ * Sets m_Length from a Content-Length header value.
+ * Returns false if the value is not a whole number, or is too big for m_Length.
+ */
+
+bool ResponseParser::parseContentLength( const char * value )
+{
+	if (!value) { return false; }
+
+	value = skipSpaces(value);
+	if ( !isdigit(*value) ) { return false; } // strtoul would accept (and negate) a sign
+
+	char * end;
+	unsigned long length = strtoul(value, &end, 10); // ULONG_MAX if it overflows
+
+	if ( *skipSpaces(end) != '\0' ) { return false; }
+	if ( length > MAX_CONTENT_LENGTH ) { return false; }
+
+	m_Length = (int)length;
+	return true;
+}
+
 void ResponseParser::clearHeaderAccumulator(void)
 {
     m_lineAccumulator.reset();
@@ -282,16 +420,8 @@ void ResponseParser::clearHeaderAccumulator(void)
 // first...
 void ResponseParser::beginBody()
 {
-
-	m_Length = -1;	// unknown
-    
-	// length supplied?
-	const char* contentlen = getHeaderValue( (char*)"content-length" );
-	if( contentlen )
-	{
-		m_Length = atoi( contentlen );
-	}
-
+	// Content-Length (if any) was picked up by storeHeader
+	
 	// check for various cases where we expect zero-length body
 	if( m_status == NO_CONTENT ||
 		m_status == NOT_MODIFIED ||
@@ -300,13 +430,10 @@ void ResponseParser::beginBody()
 		m_Length = 0;
 	}
 
-/*
-	printf("---------BeginBody()--------\n");
-	printf("Length: %d\n", m_Length );
-	printf("----------------------------\n");
-*/
 	// now start reading body data!
 	m_State = BODY;
+
+	if ( m_Length == 0 ) { finish(); }
 }
 
 int ResponseParser::getVersion() const
@@ -0,0 +1,157 @@
+/*
+ * DLHTTP.Stream.cpp
+ *
+ * Sinks for HTTP requests generated in chunks
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLHTTP.h"
+
+//---------------------------------------------------------------------
+//
+// HTTPSink
+//
+//---------------------------------------------------------------------
+
+bool HTTPSink::writeString(const char * s)
+{
+    if (!s) { return true; }
+    return write(s, strlen(s));
+}
+
+bool HTTPSink::writeSegments(const HTTPSegment * segments, uint8_t count)
+{
+    if (!segments) { return false; }
+
+    bool ok = true;
+    uint8_t i;
+    for (i = 0; i < count; i++)
+    {
+        ok &= write(segments[i].data, segments[i].length);
+    }
+    return ok;
+}
+
+//---------------------------------------------------------------------
+//
+// HTTPLengthCounter
+//
+//---------------------------------------------------------------------
+
+HTTPLengthCounter::HTTPLengthCounter() : m_length(0) {}
+
+bool HTTPLengthCounter::write(const char * data, uint32_t n)
+{
+    (void)data;
+    m_length += n;
+    return true;
+}
+
+uint32_t HTTPLengthCounter::length(void) { return m_length; }
+
+void HTTPLengthCounter::reset(void) { m_length = 0; }
+
+//---------------------------------------------------------------------
+//
+// HTTPBufferSink
+//
+//---------------------------------------------------------------------
+
+HTTPBufferSink::HTTPBufferSink(char * buffer, uint16_t maxLength) :
+    m_accumulator((maxLength > 0) ? buffer : NULL, maxLength)
+{
+}
+
+/*
+ * write
+ *
+ * Copies as much of data as will fit.
+ * Returns false if the buffer filled up before all of data was written.
+ */
+bool HTTPBufferSink::write(const char * data, uint32_t n)
+{
+    if (!data) { return false; }
+
+    uint32_t i;
+    for (i = 0; i < n; i++)
+    {
+        if (!m_accumulator.writeChar(data[i])) { return false; }
+    }
+
+    return true;
+}
+
+uint16_t HTTPBufferSink::length(void) { return m_accumulator.length(); }
+
+//---------------------------------------------------------------------
+//
+// HTTPGatherSink
+//
+//---------------------------------------------------------------------
+
+HTTPGatherSink::HTTPGatherSink(HTTPSegment * segments, uint8_t maxSegments) :
+    m_segments(segments), m_maxSegments(segments ? maxSegments : 0), m_count(0)
+{
+}
+
+/*
+ * write
+ *
+ * Adds a segment pointing at data (empty writes are skipped).
+ * Returns false once there are more segments than will fit; count() still goes up,
+ * so that the number needed is known.
+ */
+bool HTTPGatherSink::write(const char * data, uint32_t n)
+{
+    if (!data) { return false; }
+    if (n == 0) { return true; }
+
+    if (m_count < m_maxSegments)
+    {
+        m_segments[m_count].data = data;
+        m_segments[m_count].length = n;
+    }
+
+    if (m_count < 0xFF) { m_count++; }
+
+    return m_count <= m_maxSegments;
+}
+
+uint8_t HTTPGatherSink::count(void) { return m_count; }
+
+//---------------------------------------------------------------------
+//
+// HTTPGatheredRequest
+//
+//---------------------------------------------------------------------
+
+HTTPGatheredRequest::HTTPGatheredRequest(const HTTPSegment * segments, uint8_t count) :
+    m_segments(segments), m_count(count)
+{
+}
+
+bool HTTPGatheredRequest::writeTo(HTTPSink * sink)
+{
+    if (!sink) { return false; }
+    return sink->writeSegments(m_segments, m_count);
+}
@@ -54,6 +54,7 @@
 #define MAX_HTTP_HEADER_NAME_LENGTH     (30) // Maximum length of single header name
 #define MAX_HTTP_HEADER_VALUE_LENGTH    (80) // Maximum length of single header value
 #define MAX_HTTP_RESPONSE_REASON_LENGTH (40) // Maximum length of HTTP response reason string
+#define MAX_HTTP_TEMPLATE_LENGTH        (200) // Maximum length of a request template's request line and headers
 
 // Maximum header length: assume a maximum of 10 chars extra on top of name and value
 #define MAX_HTTP_HEADER_TOTAL_LENGTH (MAX_HTTP_HEADER_NAME_LENGTH + MAX_HTTP_HEADER_VALUE_LENGTH + 10)
@@ -133,6 +134,37 @@ struct urlparam
 };
 typedef struct urlparam URLParam;
 
+//-------------------------------------------------
+// HeaderRef
+//
+// Name and value pointers of a header to be sent.
+// Like URL parameters, the strings are not copied,
+// so they must stay valid until the request is written.
+// ------------------------------------------------
+struct headerref
+{
+    const char * name;
+    const char * value;
+};
+typedef struct headerref HeaderRef;
+
+//-------------------------------------------------
+// HTTPSegment
+//
+// Pointer and length of one part of a request, for
+// a gather list that is written without copying.
+// ------------------------------------------------
+struct httpsegment
+{
+    const char * data;
+    uint16_t length;
+};
+typedef struct httpsegment HTTPSegment;
+
+// Most segments a RequestBuilder request can need: the request line (with parameters),
+// four per header, the Content-Length header, the blank line and the body with its CRLF
+#define MAX_HTTP_REQUEST_SEGMENTS (5 + (4 * MAX_HTTP_URL_PARAMS) + (4 * MAX_HTTP_HEADERS) + 3 + 3)
+
 //-------------------------------------------------
 // Header
 //
@@ -162,13 +194,39 @@ class Header
 // ResponseParser
 //
 // Handles parsing of response data.
+// The whole response can be passed to the constructor,
+// or it can be fed in as it arrives, with callbacks
+// as the status line, each header and the body data
+// are parsed.
 // ------------------------------------------------
 
+class ResponseParser;
+
+typedef void (*ResponseStatus_CB)(const ResponseParser * parser, void * userdata);
+typedef void (*ResponseHeader_CB)(Header * header, void * userdata);
+typedef void (*ResponseData_CB)(const char * data, int n, void * userdata);
+typedef void (*ResponseComplete_CB)(const ResponseParser * parser, void * userdata);
+
 class ResponseParser
 {
     public:
 
+        ResponseParser();
         ResponseParser(const char * response);
+
+        void reset(void);
+        void setCallbacks(ResponseStatus_CB onStatus, ResponseHeader_CB onHeader,
+            ResponseData_CB onData, ResponseComplete_CB onComplete, void * userdata);
+
+        uint16_t feed(const char * data, uint16_t count);
+        void end(void);
+
+        bool gotStatus() const;
+        bool gotHeaders() const;
+        bool isComplete() const;
+        bool isMalformed() const;
+        bool allowsKeepAlive();
+        bool connectionPersists();
         
         // retrieve a header (returns 0 if not present)
         const char* getHeaderValue(char* name );
@@ -179,6 +237,7 @@ class ResponseParser
         int getStatus() const;          // get the HTTP status code
         int getVersion() const;         // get the HTTP version code
         const char* getReason() const;  // get the HTTP response reason string
+        int getContentLength() const;   // -1 if unknown
         int headerCount() const;
 
     private:
@@ -187,6 +246,7 @@ class ResponseParser
             HEADERS,		// reading in header lines
             BODY,			// waiting for some body data
             COMPLETE,		// response is complete!
+            MALFORMED,		// response can't be parsed (e.g. bad Content-Length), so parsing stopped
         } m_State;
 
         char * m_method;		// req method: "GET", "POST" etc...
@@ -210,6 +270,7 @@ class ResponseParser
         FixedLengthAccumulator m_lineAccumulator; // line accumulation for states that want it
 
         void storeHeader();
+        bool parseContentLength( const char * value );
         void processStatusLine( const char * line );
         void processHeaderLine( const char * line );
 
@@ -219,6 +280,92 @@ class ResponseParser
         void finish();
         
         void clearHeaderAccumulator(void);
+
+        ResponseStatus_CB m_onStatus;
+        ResponseHeader_CB m_onHeader;
+        ResponseData_CB m_onData;
+        ResponseComplete_CB m_onComplete;
+        void * m_userdata;
+};
+
+//-------------------------------------------------
+// HTTPSink
+//
+// Receives request data in chunks as it is generated,
+// e.g. straight to a network client.
+// ------------------------------------------------
+
+class HTTPSink
+{
+    public:
+        virtual bool write(const char * data, uint32_t n) = 0;
+        bool writeString(const char * s);
+        bool writeSegments(const HTTPSegment * segments, uint8_t count);
+};
+
+// Counts the bytes written (for a dry run to find the Content-Length)
+class HTTPLengthCounter : public HTTPSink
+{
+    public:
+        HTTPLengthCounter();
+        bool write(const char * data, uint32_t n);
+        uint32_t length(void);
+        void reset(void);
+
+    private:
+        uint32_t m_length;
+};
+
+// Writes into a NULL-terminated buffer of maxLength chars (including the terminator)
+class HTTPBufferSink : public HTTPSink
+{
+    public:
+        HTTPBufferSink(char * buffer, uint16_t maxLength);
+        bool write(const char * data, uint32_t n);
+        uint16_t length(void);
+
+    private:
+        FixedLengthAccumulator m_accumulator;
+};
+
+// Records each write as a segment pointing at the data written, without copying it.
+// Only use it where the data outlives the segments (as RequestBuilder::gather does).
+class HTTPGatherSink : public HTTPSink
+{
+    public:
+        HTTPGatherSink(HTTPSegment * segments, uint8_t maxSegments);
+        bool write(const char * data, uint32_t n);
+        uint8_t count(void);
+
+    private:
+        HTTPSegment * m_segments;
+        uint8_t m_maxSegments;
+        uint8_t m_count;
+};
+
+//-------------------------------------------------
+// HTTPRequestStream
+//
+// A request that is generated on demand into a sink,
+// rather than built in a buffer first.
+// ------------------------------------------------
+
+class HTTPRequestStream
+{
+    public:
+        virtual bool writeTo(HTTPSink * sink) = 0;
+};
+
+// A request held as a gather list, written segment by segment
+class HTTPGatheredRequest : public HTTPRequestStream
+{
+    public:
+        HTTPGatheredRequest(const HTTPSegment * segments, uint8_t count);
+        bool writeTo(HTTPSink * sink);
+
+    private:
+        const HTTPSegment * m_segments;
+        uint8_t m_count;
 };
 
 class RequestBuilder
@@ -234,12 +381,17 @@ class RequestBuilder
         void putBody(const char * body);
         
         void writeToBuffer(char * buf, uint16_t maxLength, bool addContentLengthHeader = false);
+        bool writeHead(HTTPSink * sink, int32_t contentLength);
+        uint8_t gather(HTTPSegment * segments, uint8_t maxSegments, bool addContentLengthHeader = false);
+        bool writeLines(HTTPSink * sink, int32_t contentLength);
         
         void reset(void);
         
     private:
+        bool writeRequest(HTTPSink * sink, bool addContentLengthHeader);
+
         // HTTP header name/value pairs
-        Header m_headers[MAX_HTTP_HEADERS];
+        HeaderRef m_headers[MAX_HTTP_HEADERS];
         uint8_t m_headerCount;
 
         // URL param name/value pairs
@@ -249,9 +401,35 @@ class RequestBuilder
         const char * m_method;
         const char * m_url;
         const char * m_body;
-        
-        FixedLengthAccumulator accumulator;
 
+        // Content-Length digits (kept here so that gathered requests can point at them)
+        char m_contentLength[12];
+};
+
+//-------------------------------------------------
+// RequestTemplate
+//
+// The request line and headers of a request that is
+// sent repeatedly with only the body changing,
+// rendered once from a RequestBuilder. Each request
+// then only needs the Content-Length and body adding.
+// ------------------------------------------------
+
+class RequestTemplate
+{
+    public:
+        RequestTemplate();
+
+        bool render(RequestBuilder * builder);
+        bool isRendered(void);
+        uint16_t headLength(void);
+
+        uint16_t fill(char * buffer, uint16_t maxLength, const char * body, uint16_t bodyLength);
+        bool writeTo(HTTPSink * sink, const char * body, uint16_t bodyLength);
+
+    private:
+        char m_head[MAX_HTTP_TEMPLATE_LENGTH];
+        uint16_t m_headLength;
 };
 
 #endif // _DL_HTTP_H_
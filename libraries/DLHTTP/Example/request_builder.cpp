@@ -6,7 +6,7 @@ A sample command-line application using the DLHTTP module
 You can pipe the output of this example to nc to get responses from URLs
 
 Build with:
-g++ -I ../../DLUtility request_builder.cpp ../DLHTTP.Header.cpp ../DLHTTP.RequestBuilder.cpp -o request_builder.exe
+g++ -I ../../DLUtility request_builder.cpp ../DLHTTP.Header.cpp ../DLHTTP.RequestBuilder.cpp ../DLHTTP.Stream.cpp ../../DLUtility/DLUtility.Strings.cpp -o request_builder.exe
 
 For GET requests:
 request_builder.exe api.thingspeak.com GET "api_key,WHATEVERAPIKEY,field1,10.00,field2,12.00"
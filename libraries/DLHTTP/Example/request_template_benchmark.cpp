@@ -0,0 +1,92 @@
+/*
+request_template_benchmark.cpp
+
+A command-line benchmark of building Thingspeak-style update posts,
+with a RequestBuilder each time and with a pre-rendered RequestTemplate.
+
+Build with:
+g++ -O2 -I ../../DLUtility request_template_benchmark.cpp ../DLHTTP.Header.cpp ../DLHTTP.RequestBuilder.cpp ../DLHTTP.RequestTemplate.cpp ../DLHTTP.Stream.cpp ../../DLUtility/DLUtility.Strings.cpp -o request_template_benchmark.exe
+
+Run with an optional number of requests to build (default 1000000):
+request_template_benchmark.exe 1000000
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../DLUtility/DLUtility.Strings.h"
+#include "../DLHTTP.h"
+
+static char s_request[512];
+static char s_body[128];
+
+static uint16_t encodeBody(unsigned long i)
+{
+    return sprintf(s_body, "1=%.5f&2=%.5f&3=%.5f", i * 0.1, i * 0.2, i * 0.3);
+}
+
+static void setupBuilder(RequestBuilder * builder)
+{
+    builder->reset();
+    builder->setMethodAndURL("POST", "/update");
+    builder->putHeader("Host", "api.thingspeak.com");
+    builder->putHeader("X-THINGSPEAKAPIKEY", "IZ2O45C3BM257VCH");
+    builder->putHeader("Content-Type", "application/x-www-form-urlencoded");
+}
+
+static double rate(unsigned long count, clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    return seconds > 0 ? count / seconds : 0;
+}
+
+int main(int argc, char * argv[])
+{
+    unsigned long count = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000UL;
+    unsigned long i;
+    unsigned long check = 0;
+    RequestBuilder builder;
+    RequestTemplate postTemplate;
+    clock_t start;
+
+    // Body encoding alone, for comparison
+    start = clock();
+    for (i = 0; i < count; i++)
+    {
+        check += encodeBody(i);
+    }
+    double encodeRate = rate(count, start);
+
+    // Builder: every header re-added and the whole request re-rendered each time
+    start = clock();
+    for (i = 0; i < count; i++)
+    {
+        encodeBody(i);
+        setupBuilder(&builder);
+        builder.putBody(s_body);
+        builder.writeToBuffer(s_request, sizeof(s_request), true);
+        check += s_request[0];
+    }
+    double builderRate = rate(count, start);
+
+    // Template: headers rendered once, then only the Content-Length and body per request
+    setupBuilder(&builder);
+    postTemplate.render(&builder);
+
+    start = clock();
+    for (i = 0; i < count; i++)
+    {
+        uint16_t length = encodeBody(i);
+        check += postTemplate.fill(s_request, sizeof(s_request), s_body, length);
+    }
+    double templateRate = rate(count, start);
+
+    std::cout << "Requests built per second (" << count << " requests):" << std::endl;
+    std::cout << "  Body encoding only: " << (unsigned long)encodeRate << std::endl;
+    std::cout << "  RequestBuilder:     " << (unsigned long)builderRate << std::endl;
+    std::cout << "  RequestTemplate:    " << (unsigned long)templateRate << std::endl;
+
+    return (check == 0) ? 1 : 0;
+}
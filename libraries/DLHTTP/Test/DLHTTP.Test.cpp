@@ -30,6 +30,63 @@
 
 char requestBuffer[512];
 RequestBuilder builder;
+
+// Records the streaming parser callbacks
+struct callback_record
+{
+    int statusCalls;
+    int status;
+    int headerCalls;
+    char lastHeader[MAX_HTTP_HEADER_NAME_LENGTH];
+    char body[64];
+    int bodyLength;
+    int completeCalls;
+};
+typedef struct callback_record CALLBACK_RECORD;
+
+static CALLBACK_RECORD s_record;
+
+static void onStatus(const ResponseParser * parser, void * userdata)
+{
+    CALLBACK_RECORD * record = (CALLBACK_RECORD *)userdata;
+    record->statusCalls++;
+    record->status = parser->getStatus();
+}
+
+static void onHeader(Header * header, void * userdata)
+{
+    CALLBACK_RECORD * record = (CALLBACK_RECORD *)userdata;
+    record->headerCalls++;
+    strcpy(record->lastHeader, header->getName());
+}
+
+static void onData(const char * data, int n, void * userdata)
+{
+    CALLBACK_RECORD * record = (CALLBACK_RECORD *)userdata;
+    memcpy(&record->body[record->bodyLength], data, n);
+    record->bodyLength += n;
+    record->body[record->bodyLength] = '\0';
+}
+
+static void onComplete(const ResponseParser * parser, void * userdata)
+{
+    (void)parser;
+    CALLBACK_RECORD * record = (CALLBACK_RECORD *)userdata;
+    record->completeCalls++;
+}
+
+static void setupParser(ResponseParser * parser)
+{
+    memset(&s_record, 0, sizeof(s_record));
+    parser->setCallbacks(onStatus, onHeader, onData, onComplete, &s_record);
+}
+
+static char const * s_streamedResponse =
+    "HTTP/1.1 202 Accepted\r\n"
+    "Content-Type: text/plain\r\n"
+    "Content-Length: 12\r\n"
+    "\r\n"
+    "Hello, world";
         
 void test_header_isSuccessfulyParsed(void)
 {
@@ -104,6 +161,148 @@ void test_requestbuilder_BuildsWithURLParameters(void)
         "Host: www.example.com\r\n", requestBuffer); 
 }
 
+void test_requestbuilder_GathersWithoutCopying(void)
+{
+    static const char body[] = "field1=1.00000&field2=2.00000";
+    char apiKey[] = "IZ2O45C3BM257VCH";
+    HTTPSegment segments[MAX_HTTP_REQUEST_SEGMENTS];
+    char gathered[512];
+
+    builder.reset();
+    builder.setMethodAndURL("POST", "/update");
+    builder.putHeader("Host", "api.thingspeak.com");
+    builder.putHeader("X-THINGSPEAKAPIKEY", apiKey);
+    builder.putBody(body);
+
+    uint8_t count = builder.gather(segments, MAX_HTTP_REQUEST_SEGMENTS, true);
+    TEST_ASSERT_TRUE(count > 0);
+    TEST_ASSERT_TRUE(count <= MAX_HTTP_REQUEST_SEGMENTS);
+
+    // The segments point at the caller's strings rather than copies of them
+    bool foundBody = false;
+    bool foundKey = false;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        foundBody |= (segments[i].data == body) && (segments[i].length == strlen(body));
+        foundKey |= (segments[i].data == apiKey);
+    }
+    TEST_ASSERT_TRUE(foundBody);
+    TEST_ASSERT_TRUE(foundKey);
+
+    // Writing the segments out gives the same request as writeToBuffer
+    HTTPGatheredRequest request(segments, count);
+    HTTPBufferSink sink(gathered, sizeof(gathered));
+    TEST_ASSERT_TRUE(request.writeTo(&sink));
+
+    builder.writeToBuffer(requestBuffer, 512, true);
+    TEST_ASSERT_EQUAL_STRING(requestBuffer, gathered);
+    TEST_ASSERT_EQUAL_STRING(
+        "POST /update HTTP/1.1\r\n"
+        "Host: api.thingspeak.com\r\n"
+        "X-THINGSPEAKAPIKEY: IZ2O45C3BM257VCH\r\n"
+        "Content-Length: 29\r\n"
+        "\r\n"
+        "field1=1.00000&field2=2.00000\r\n", gathered);
+}
+
+void test_requestbuilder_GatherReportsSegmentsNeeded(void)
+{
+    HTTPSegment segments[MAX_HTTP_REQUEST_SEGMENTS];
+
+    builder.reset();
+    builder.setMethodAndURL("GET", "/");
+    builder.putHeader("Host", "www.example.com");
+
+    uint8_t needed = builder.gather(segments, MAX_HTTP_REQUEST_SEGMENTS);
+    TEST_ASSERT_EQUAL(needed, builder.gather(segments, 2));
+    TEST_ASSERT_TRUE(needed > 2);
+}
+
+void test_requestbuilder_DoesNotStoreHeaderCopies(void)
+{
+    TEST_ASSERT_TRUE(sizeof(RequestBuilder) < (MAX_HTTP_HEADERS * sizeof(Header)));
+}
+
+static void setupPostBuilder(void)
+{
+    builder.reset();
+    builder.setMethodAndURL("POST", "/update");
+    builder.putHeader("Host", "api.thingspeak.com");
+    builder.putHeader("X-THINGSPEAKAPIKEY", "IZ2O45C3BM257VCH");
+    builder.putHeader("Content-Type", "application/x-www-form-urlencoded");
+}
+
+void test_requesttemplate_MatchesBuilderOutput(void)
+{
+    const char * bodies[] = {"1=1.00000", "1=2.00000&2=123.45600", ""};
+    char filled[512];
+    RequestTemplate postTemplate;
+
+    setupPostBuilder();
+    TEST_ASSERT_FALSE(postTemplate.isRendered());
+    TEST_ASSERT_TRUE(postTemplate.render(&builder));
+
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        builder.putBody(bodies[i]);
+        builder.writeToBuffer(requestBuffer, 512, true);
+
+        uint16_t length = postTemplate.fill(filled, sizeof(filled), bodies[i], strlen(bodies[i]));
+        TEST_ASSERT_EQUAL(strlen(requestBuffer), length);
+        TEST_ASSERT_EQUAL_STRING(requestBuffer, filled);
+    }
+}
+
+void test_requesttemplate_WritesToSink(void)
+{
+    const char body[] = "1=1.00000&2=2.00000";
+    char filled[512];
+    char streamed[512];
+    RequestTemplate postTemplate;
+
+    setupPostBuilder();
+    postTemplate.render(&builder);
+
+    HTTPBufferSink sink(streamed, sizeof(streamed));
+    TEST_ASSERT_TRUE(postTemplate.writeTo(&sink, body, strlen(body)));
+
+    postTemplate.fill(filled, sizeof(filled), body, strlen(body));
+    TEST_ASSERT_EQUAL_STRING(filled, streamed);
+}
+
+void test_requesttemplate_FillFailsIfRequestDoesNotFit(void)
+{
+    const char body[] = "1=1.00000";
+    RequestTemplate postTemplate;
+
+    // Not rendered yet
+    TEST_ASSERT_EQUAL(0, postTemplate.fill(requestBuffer, 512, body, strlen(body)));
+
+    setupPostBuilder();
+    postTemplate.render(&builder);
+
+    uint16_t length = postTemplate.fill(requestBuffer, 512, body, strlen(body));
+    TEST_ASSERT_TRUE(length > 0);
+
+    // Exactly enough room (including the terminator), then one char too few
+    TEST_ASSERT_EQUAL(length, postTemplate.fill(requestBuffer, length + 1, body, strlen(body)));
+    TEST_ASSERT_EQUAL(0, postTemplate.fill(requestBuffer, length, body, strlen(body)));
+}
+
+void test_requesttemplate_RenderFailsIfHeadersTooLong(void)
+{
+    char longValue[MAX_HTTP_TEMPLATE_LENGTH];
+    memset(longValue, 'x', sizeof(longValue) - 1);
+    longValue[sizeof(longValue) - 1] = '\0';
+
+    RequestTemplate postTemplate;
+    setupPostBuilder();
+    builder.putHeader("X-Long", longValue);
+
+    TEST_ASSERT_FALSE(postTemplate.render(&builder));
+    TEST_ASSERT_FALSE(postTemplate.isRendered());
+}
+
 void test_responseparser_ReadsHTTPStatusLine(void)
 {
     char response[] = "HTTP/1.0 200 OK\r\n";
@@ -138,6 +337,221 @@ void test_responseparser_ReadsHTTPHeaders(void)
     TEST_ASSERT_EQUAL_STRING(headerValues[1], responseParser.getHeaderValue(headerNames[1]));
 }
 
+void test_responseparser_FeedsInOneGo(void)
+{
+    ResponseParser parser;
+    setupParser(&parser);
+
+    TEST_ASSERT_EQUAL(strlen(s_streamedResponse), parser.feed(s_streamedResponse, strlen(s_streamedResponse)));
+
+    TEST_ASSERT_EQUAL(1, s_record.statusCalls);
+    TEST_ASSERT_EQUAL(202, s_record.status);
+    TEST_ASSERT_EQUAL(2, s_record.headerCalls);
+    TEST_ASSERT_EQUAL_STRING("content-length", s_record.lastHeader);
+    TEST_ASSERT_EQUAL_STRING("Hello, world", s_record.body);
+    TEST_ASSERT_EQUAL(1, s_record.completeCalls);
+
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL(12, parser.getContentLength());
+    TEST_ASSERT_EQUAL_STRING("Accepted", parser.getReason());
+}
+
+void test_responseparser_FeedsOneByteAtATime(void)
+{
+    ResponseParser parser;
+    setupParser(&parser);
+
+    uint16_t i;
+    for (i = 0; i < strlen(s_streamedResponse); i++)
+    {
+        TEST_ASSERT_EQUAL(1, parser.feed(&s_streamedResponse[i], 1));
+
+        // The status is available as soon as the first line is in
+        if (i < strlen("HTTP/1.1 202 Accepted\r\n") - 1)
+        {
+            TEST_ASSERT_FALSE(parser.gotStatus());
+        }
+        else
+        {
+            TEST_ASSERT_TRUE(parser.gotStatus());
+        }
+    }
+
+    TEST_ASSERT_EQUAL(1, s_record.statusCalls);
+    TEST_ASSERT_EQUAL(2, s_record.headerCalls);
+    TEST_ASSERT_EQUAL_STRING("Hello, world", s_record.body);
+    TEST_ASSERT_EQUAL(1, s_record.completeCalls);
+}
+
+void test_responseparser_StopsAtEndOfBody(void)
+{
+    char response[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Length: 2\r\n"
+        "\r\n"
+        "OKHTTP/1.1 200 OK\r\n";
+
+    ResponseParser parser;
+    setupParser(&parser);
+
+    TEST_ASSERT_EQUAL(strlen(response) - strlen("HTTP/1.1 200 OK\r\n"), parser.feed(response, strlen(response)));
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL_STRING("OK", s_record.body);
+    TEST_ASSERT_EQUAL(1, s_record.statusCalls);
+}
+
+void test_responseparser_EmptyBodyCompletesAfterHeaders(void)
+{
+    char response[] = "HTTP/1.1 204 No Content\r\n\r\n";
+
+    ResponseParser parser;
+    setupParser(&parser);
+    parser.feed(response, strlen(response));
+
+    TEST_ASSERT_TRUE(parser.gotHeaders());
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL(1, s_record.completeCalls);
+}
+
+void test_responseparser_UnknownLengthCompletesAtEnd(void)
+{
+    char response[] = "HTTP/1.0 200 OK\r\n\r\nSome data";
+
+    ResponseParser parser;
+    setupParser(&parser);
+    parser.feed(response, strlen(response));
+
+    TEST_ASSERT_FALSE(parser.isComplete());
+    TEST_ASSERT_EQUAL(-1, parser.getContentLength());
+
+    parser.end();
+    TEST_ASSERT_TRUE(parser.isComplete());
+    TEST_ASSERT_EQUAL_STRING("Some data", s_record.body);
+    TEST_ASSERT_EQUAL(1, s_record.completeCalls);
+}
+
+void test_responseparser_ExtraHeadersAreOnlyPassedToCallback(void)
+{
+    char header[] = "X-Header: value\r\n";
+
+    ResponseParser parser;
+    setupParser(&parser);
+
+    parser.feed("HTTP/1.1 200 OK\r\n", 17);
+
+    uint8_t i;
+    for (i = 0; i < MAX_HTTP_HEADERS + 2; i++)
+    {
+        parser.feed(header, strlen(header));
+    }
+    parser.feed("\r\n", 2);
+
+    TEST_ASSERT_EQUAL(MAX_HTTP_HEADERS, parser.headerCount());
+    TEST_ASSERT_EQUAL(MAX_HTTP_HEADERS + 2, s_record.headerCalls);
+    TEST_ASSERT_TRUE(parser.gotHeaders());
+}
+
+void test_responseparser_CanBeReset(void)
+{
+    ResponseParser parser;
+    setupParser(&parser);
+    parser.feed(s_streamedResponse, strlen(s_streamedResponse));
+
+    parser.reset();
+    TEST_ASSERT_FALSE(parser.gotStatus());
+    TEST_ASSERT_EQUAL(0, parser.headerCount());
+
+    parser.feed("HTTP/1.1 404 Not Found\r\n", 24);
+    TEST_ASSERT_EQUAL(404, parser.getStatus());
+    TEST_ASSERT_EQUAL(2, s_record.statusCalls);
+}
+
+void test_responseparser_KeepAliveNeedsFramedResponse(void)
+{
+    ResponseParser http11("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nOK");
+    TEST_ASSERT_TRUE(http11.allowsKeepAlive());
+
+    // Not all of the body has been read yet
+    ResponseParser partial("HTTP/1.1 200 OK\r\nContent-Length: 20\r\n\r\nOK");
+    TEST_ASSERT_FALSE(partial.allowsKeepAlive());
+
+    // Closing the connection doesn't complete a response shorter than its Content-Length
+    partial.end();
+    TEST_ASSERT_FALSE(partial.isComplete());
+
+    // The body ran to the end of the connection
+    ResponseParser unframed("HTTP/1.1 200 OK\r\n\r\nOK");
+    unframed.end();
+    TEST_ASSERT_FALSE(unframed.allowsKeepAlive());
+}
+
+void test_responseparser_KeepAliveFollowsConnectionHeader(void)
+{
+    ResponseParser close11("HTTP/1.1 200 OK\r\nConnection: Close\r\nContent-Length: 0\r\n\r\n");
+    TEST_ASSERT_FALSE(close11.allowsKeepAlive());
+
+    ResponseParser default10("HTTP/1.0 200 OK\r\nContent-Length: 0\r\n\r\n");
+    TEST_ASSERT_FALSE(default10.allowsKeepAlive());
+
+    ResponseParser keepAlive10("HTTP/1.0 200 OK\r\nConnection: Keep-Alive\r\nContent-Length: 0\r\n\r\n");
+    TEST_ASSERT_TRUE(keepAlive10.allowsKeepAlive());
+}
+
+void test_responseparser_NegativeContentLengthIsMalformed(void)
+{
+    char headers[] = "HTTP/1.1 200 OK\r\nContent-Length: -5\r\n\r\n";
+
+    ResponseParser parser;
+    setupParser(&parser);
+    parser.feed(headers, strlen(headers));
+
+    TEST_ASSERT_TRUE(parser.isMalformed());
+    TEST_ASSERT_EQUAL(200, parser.getStatus());
+
+    // Nothing more is parsed, and feed never reports more bytes used than it was given
+    TEST_ASSERT_EQUAL(0, parser.feed("OK", 2));
+    TEST_ASSERT_FALSE(parser.isComplete());
+    TEST_ASSERT_FALSE(parser.allowsKeepAlive());
+    TEST_ASSERT_EQUAL(0, s_record.completeCalls);
+}
+
+void test_responseparser_OverflowingContentLengthIsMalformed(void)
+{
+    ResponseParser huge("HTTP/1.1 200 OK\r\nContent-Length: 99999999999\r\n\r\nOK");
+    TEST_ASSERT_TRUE(huge.isMalformed());
+    TEST_ASSERT_FALSE(huge.allowsKeepAlive());
+
+    ResponseParser wraps("HTTP/1.1 200 OK\r\nContent-Length: 4294967298\r\n\r\nOK");
+    TEST_ASSERT_TRUE(wraps.isMalformed());
+}
+
+void test_responseparser_NonNumericContentLengthIsMalformed(void)
+{
+    ResponseParser trailing("HTTP/1.1 200 OK\r\nContent-Length: 2x\r\n\r\nOK");
+    TEST_ASSERT_TRUE(trailing.isMalformed());
+
+    ResponseParser empty("HTTP/1.1 200 OK\r\nContent-Length:\r\n\r\nOK");
+    TEST_ASSERT_TRUE(empty.isMalformed());
+
+    ResponseParser valid("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nOK");
+    TEST_ASSERT_FALSE(valid.isMalformed());
+    TEST_ASSERT_TRUE(valid.isComplete());
+}
+
+void test_responseparser_BodyNeverUsesMoreThanGiven(void)
+{
+    char headers[] = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\n";
+
+    ResponseParser parser;
+    setupParser(&parser);
+    parser.feed(headers, strlen(headers));
+
+    TEST_ASSERT_EQUAL(2, parser.feed("OK", 2));
+    TEST_ASSERT_EQUAL(3, parser.feed("OK!!!", 5));
+    TEST_ASSERT_EQUAL(0, parser.feed("!", 1));
+    TEST_ASSERT_TRUE(parser.isComplete());
+}
+
 int main(void)
 {
     UnityBegin("DLHTTP.cpp");
@@ -149,9 +563,31 @@ int main(void)
     RUN_TEST(test_requestbuilder_BuildsWithBodyContent);
     RUN_TEST(test_requestbuilder_BuildsWithContentLengthHeader);
     RUN_TEST(test_requestbuilder_BuildsWithURLParameters);
+    RUN_TEST(test_requestbuilder_GathersWithoutCopying);
+    RUN_TEST(test_requestbuilder_GatherReportsSegmentsNeeded);
+    RUN_TEST(test_requestbuilder_DoesNotStoreHeaderCopies);
+
+    RUN_TEST(test_requesttemplate_MatchesBuilderOutput);
+    RUN_TEST(test_requesttemplate_WritesToSink);
+    RUN_TEST(test_requesttemplate_FillFailsIfRequestDoesNotFit);
+    RUN_TEST(test_requesttemplate_RenderFailsIfHeadersTooLong);
 
     RUN_TEST(test_responseparser_ReadsHTTPStatusLine);
     RUN_TEST(test_responseparser_ReadsHTTPHeaders);
+
+    RUN_TEST(test_responseparser_FeedsInOneGo);
+    RUN_TEST(test_responseparser_FeedsOneByteAtATime);
+    RUN_TEST(test_responseparser_StopsAtEndOfBody);
+    RUN_TEST(test_responseparser_EmptyBodyCompletesAfterHeaders);
+    RUN_TEST(test_responseparser_UnknownLengthCompletesAtEnd);
+    RUN_TEST(test_responseparser_ExtraHeadersAreOnlyPassedToCallback);
+    RUN_TEST(test_responseparser_CanBeReset);
+    RUN_TEST(test_responseparser_KeepAliveNeedsFramedResponse);
+    RUN_TEST(test_responseparser_KeepAliveFollowsConnectionHeader);
+    RUN_TEST(test_responseparser_NegativeContentLengthIsMalformed);
+    RUN_TEST(test_responseparser_OverflowingContentLengthIsMalformed);
+    RUN_TEST(test_responseparser_NonNumericContentLengthIsMalformed);
+    RUN_TEST(test_responseparser_BodyNeverUsesMoreThanGiven);
     
-    return 0;
+    return (UnityEnd());
 }
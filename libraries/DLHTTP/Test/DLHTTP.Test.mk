@@ -1,3 +1,7 @@
-SRC_FILES += DLUtility/DLUtility.Strings.cpp DLHTTP/DLHTTP.Header.cpp DLHTTP/DLHTTP.RequestBuilder.cpp DLHTTP/DLHTTP.ResponseParser.cpp
+SRC_FILES += DLUtility/DLUtility.Strings.cpp DLHTTP/DLHTTP.Header.cpp DLHTTP/DLHTTP.RequestBuilder.cpp DLHTTP/DLHTTP.ResponseParser.cpp DLHTTP/DLHTTP.Stream.cpp DLHTTP/DLHTTP.RequestTemplate.cpp
 
 INC_DIRS += -IDLUtility/
+
+local_setup: ;
+
+local_teardown: ;
@@ -0,0 +1,460 @@
+/*
+ * DLLocalStorage.BinaryLog.cpp
+ *
+ * Compact binary append-only log format for local storage
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+#include <time.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.h"
+#include "DLCSV.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.BinaryLog.h"
+
+/*
+ * Private Functions
+ */
+
+static uint8_t * putU16(uint8_t * p, uint16_t value)
+{
+    p[0] = (uint8_t)(value);
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+static uint8_t * putU32(uint8_t * p, uint32_t value)
+{
+    p[0] = (uint8_t)(value);
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+static uint8_t * putFloat(uint8_t * p, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return putU32(p, bits);
+}
+
+static uint16_t getU16(uint8_t const * p)
+{
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static uint32_t getU32(uint8_t const * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float getFloat(uint8_t const * p)
+{
+    uint32_t bits = getU32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/*
+ * Public Functions
+ */
+
+/*
+ * BINLOG_CRC16
+ *
+ * CRC-16/CCITT (polynomial 0x1021). Start with crc = 0xFFFF,
+ * or pass in a previous result to continue over more data.
+ */
+uint16_t BINLOG_CRC16(uint16_t crc, uint8_t const * data, uint32_t n)
+{
+    uint8_t bit;
+
+    if (!data) { return crc; }
+
+    while (n--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/*
+ * BinaryLogWriter Public Class Functions
+ */
+
+BinaryLogWriter::BinaryLogWriter(LocalStorageInterface * storage)
+{
+    m_storage = storage;
+    m_file = INVALID_HANDLE;
+    m_channelCount = 0;
+    m_block = NULL;
+    m_recordsPerBlock = 0;
+    m_pending = 0;
+    m_recordsWritten = 0;
+    m_blocksWritten = 0;
+    m_bytesWritten = 0;
+}
+
+BinaryLogWriter::~BinaryLogWriter()
+{
+    delete[] m_block;
+}
+
+/*
+ * begin
+ *
+ * Sets up the channel map and allocates the block buffer.
+ * If writeHeader is false, the file is assumed to already start with a header for
+ * the same channel map (e.g. when appending to an existing log).
+ */
+bool BinaryLogWriter::begin(FILE_HANDLE file, BINLOG_CHANNEL const * channels, uint8_t nChannels,
+    uint16_t recordsPerBlock, bool writeHeader)
+{
+    if (!m_storage || !channels) { return false; }
+    if ((nChannels == 0) || (nChannels > BINLOG_MAX_CHANNELS)) { return false; }
+    if (recordsPerBlock == 0) { return false; }
+
+    delete[] m_block;
+    m_block = new uint8_t[BINLOG_BLOCK_SIZE(nChannels, recordsPerBlock)];
+    if (!m_block) { return false; }
+
+    memcpy(m_channels, channels, nChannels * sizeof(BINLOG_CHANNEL));
+    m_channelCount = nChannels;
+    m_recordsPerBlock = recordsPerBlock;
+    m_file = file;
+    m_pending = 0;
+
+    if (writeHeader) { this->writeHeader(); }
+
+    return true;
+}
+
+bool BinaryLogWriter::writeRecord(uint32_t timestamp, BINLOG_VALUE const * values)
+{
+    if (!m_block || !values) { return false; }
+
+    uint8_t * p = m_block + BINLOG_BLOCK_HEADER_SIZE + (m_pending * BINLOG_RECORD_SIZE(m_channelCount));
+    uint8_t i;
+
+    p = putU32(p, timestamp);
+    for (i = 0; i < m_channelCount; i++)
+    {
+        // Both value types are 4 bytes, so the integer view writes either bit pattern
+        p = putU32(p, (uint32_t)values[i].i);
+    }
+
+    m_pending++;
+    m_recordsWritten++;
+
+    if (m_pending == m_recordsPerBlock)
+    {
+        flush();
+    }
+
+    return true;
+}
+
+/*
+ * flush
+ *
+ * Writes any pending records as a (possibly short) block.
+ */
+void BinaryLogWriter::flush(void)
+{
+    if (!m_block || (m_pending == 0)) { return; }
+
+    uint32_t size = BINLOG_BLOCK_SIZE(m_channelCount, m_pending);
+    uint8_t * p = m_block;
+
+    p = putU16(p, BINLOG_BLOCK_SYNC);
+    p = putU16(p, m_pending);
+
+    uint16_t crc = BINLOG_CRC16(0xFFFF, m_block, size - BINLOG_CRC_SIZE);
+    putU16(m_block + size - BINLOG_CRC_SIZE, crc);
+
+    m_storage->writeBytes(m_file, m_block, size);
+
+    m_bytesWritten += size;
+    m_blocksWritten++;
+    m_pending = 0;
+}
+
+uint16_t BinaryLogWriter::pendingRecords(void) { return m_pending; }
+uint32_t BinaryLogWriter::recordsWritten(void) { return m_recordsWritten; }
+uint32_t BinaryLogWriter::blocksWritten(void) { return m_blocksWritten; }
+uint32_t BinaryLogWriter::bytesWritten(void) { return m_bytesWritten; }
+
+/*
+ * BinaryLogWriter Private Class Functions
+ */
+
+void BinaryLogWriter::writeHeader(void)
+{
+    uint8_t header[BINLOG_HEADER_SIZE(BINLOG_MAX_CHANNELS)];
+    uint8_t * p = header;
+    uint8_t i;
+
+    memcpy(p, BINLOG_MAGIC, 4);
+    p += 4;
+    *p++ = BINLOG_VERSION;
+    *p++ = m_channelCount;
+    p = putU16(p, m_recordsPerBlock);
+
+    for (i = 0; i < m_channelCount; i++)
+    {
+        *p++ = m_channels[i].number;
+        *p++ = (uint8_t)m_channels[i].type;
+        p = putU16(p, 0);
+        p = putFloat(p, m_channels[i].scale);
+        p = putFloat(p, m_channels[i].offset);
+    }
+
+    putU16(p, BINLOG_CRC16(0xFFFF, header, p - header));
+
+    m_storage->writeBytes(m_file, header, BINLOG_HEADER_SIZE(m_channelCount));
+    m_bytesWritten += BINLOG_HEADER_SIZE(m_channelCount);
+}
+
+/*
+ * BinaryLogReader Public Class Functions
+ */
+
+BinaryLogReader::BinaryLogReader(LocalStorageInterface * storage)
+{
+    m_storage = storage;
+    m_file = INVALID_HANDLE;
+    m_channelCount = 0;
+    m_block = NULL;
+    m_recordsPerBlock = 0;
+    m_recordsInBlock = 0;
+    m_recordIndex = 0;
+    m_badBlocks = 0;
+    m_error = false;
+}
+
+BinaryLogReader::~BinaryLogReader()
+{
+    delete[] m_block;
+}
+
+/*
+ * begin
+ *
+ * Reads and validates the file header, then allocates a buffer for one block.
+ */
+bool BinaryLogReader::begin(FILE_HANDLE file)
+{
+    uint8_t header[BINLOG_HEADER_SIZE(BINLOG_MAX_CHANNELS)];
+    uint8_t * p = header;
+    uint8_t i;
+
+    m_file = file;
+    m_error = true;
+    m_recordsInBlock = 0;
+    m_recordIndex = 0;
+    m_badBlocks = 0;
+
+    if (!m_storage) { return false; }
+
+    if (m_storage->readBytes(m_file, (char *)header, BINLOG_FILE_HEADER_FIXED_SIZE) != BINLOG_FILE_HEADER_FIXED_SIZE) { return false; }
+    if (memcmp(p, BINLOG_MAGIC, 4) != 0) { return false; }
+    if (p[4] != BINLOG_VERSION) { return false; }
+
+    uint8_t nChannels = p[5];
+    uint16_t recordsPerBlock = getU16(&p[6]);
+
+    if ((nChannels == 0) || (nChannels > BINLOG_MAX_CHANNELS) || (recordsPerBlock == 0)) { return false; }
+
+    uint32_t remaining = BINLOG_HEADER_SIZE(nChannels) - BINLOG_FILE_HEADER_FIXED_SIZE;
+    if (m_storage->readBytes(m_file, (char *)&header[BINLOG_FILE_HEADER_FIXED_SIZE], remaining) != remaining) { return false; }
+
+    uint32_t crcIndex = BINLOG_HEADER_SIZE(nChannels) - BINLOG_CRC_SIZE;
+    if (BINLOG_CRC16(0xFFFF, header, crcIndex) != getU16(&header[crcIndex])) { return false; }
+
+    p = &header[BINLOG_FILE_HEADER_FIXED_SIZE];
+    for (i = 0; i < nChannels; i++)
+    {
+        m_channels[i].number = p[0];
+        m_channels[i].type = (BINLOG_VALUE_TYPE)p[1];
+        m_channels[i].scale = getFloat(&p[4]);
+        m_channels[i].offset = getFloat(&p[8]);
+        p += BINLOG_CHANNEL_SIZE;
+    }
+
+    delete[] m_block;
+    m_block = new uint8_t[BINLOG_BLOCK_SIZE(nChannels, recordsPerBlock)];
+    if (!m_block) { return false; }
+
+    m_channelCount = nChannels;
+    m_recordsPerBlock = recordsPerBlock;
+    m_error = false;
+
+    return true;
+}
+
+uint8_t BinaryLogReader::channelCount(void) { return m_channelCount; }
+
+BINLOG_CHANNEL const * BinaryLogReader::getChannel(uint8_t index)
+{
+    return (index < m_channelCount) ? &m_channels[index] : NULL;
+}
+
+float BinaryLogReader::convert(uint8_t index, BINLOG_VALUE value)
+{
+    if (index >= m_channelCount) { return 0.0f; }
+
+    if (m_channels[index].type == BINLOG_FLOAT) { return value.f; }
+
+    return ((float)value.i * m_channels[index].scale) + m_channels[index].offset;
+}
+
+/*
+ * readRecord
+ *
+ * Reads the next record, fetching a new block from storage when required.
+ * Returns false at the end of the log (or if the log cannot be read).
+ */
+bool BinaryLogReader::readRecord(uint32_t * timestamp, BINLOG_VALUE * values)
+{
+    if (m_error || !m_block) { return false; }
+
+    while (m_recordIndex == m_recordsInBlock)
+    {
+        if (!readBlock()) { return false; }
+    }
+
+    uint8_t const * p = m_block + BINLOG_BLOCK_HEADER_SIZE + (m_recordIndex * BINLOG_RECORD_SIZE(m_channelCount));
+    uint8_t i;
+
+    if (timestamp) { *timestamp = getU32(p); }
+    p += BINLOG_TIMESTAMP_SIZE;
+
+    if (values)
+    {
+        for (i = 0; i < m_channelCount; i++)
+        {
+            values[i].i = (int32_t)getU32(p);
+            p += BINLOG_VALUE_SIZE;
+        }
+    }
+
+    m_recordIndex++;
+    return true;
+}
+
+/*
+ * readCSVLine
+ *
+ * Reads the next record and writes it to buffer in the CSV layout:
+ * the timestamp then each converted value (printed using fmt), separated by ", ".
+ * Returns the length of the line, or 0 at the end of the log.
+ * The line is truncated if the buffer is too short.
+ */
+uint32_t BinaryLogReader::readCSVLine(char * buffer, uint16_t length, char const * const fmt)
+{
+    if (!buffer || !fmt) { return 0; }
+
+    uint32_t timestamp;
+    BINLOG_VALUE values[BINLOG_MAX_CHANNELS];
+
+    if (!readRecord(&timestamp, values)) { return 0; }
+
+    TM time;
+    char field[32];
+    uint8_t i;
+
+    FixedLengthAccumulator lineAccumulator(buffer, length);
+
+    unix_seconds_to_time(timestamp, &time);
+    CSV_writeTimestampToBuffer(&time, field);
+    lineAccumulator.writeString(field);
+
+    for (i = 0; i < m_channelCount; i++)
+    {
+        snprintf(field, sizeof(field), fmt, convert(i, values[i]));
+        lineAccumulator.writeString(", ");
+        lineAccumulator.writeString(field);
+    }
+
+    lineAccumulator.writeString("\r\n");
+
+    return lineAccumulator.length();
+}
+
+uint32_t BinaryLogReader::badBlocks(void) { return m_badBlocks; }
+bool BinaryLogReader::inError(void) { return m_error; }
+
+/*
+ * BinaryLogReader Private Class Functions
+ */
+
+/*
+ * readBlock
+ *
+ * Reads the next block into the block buffer.
+ * A block with a bad CRC is counted and left empty so that the caller moves on to the next one.
+ * A bad sync word or short read ends the log, since block boundaries can no longer be trusted.
+ */
+bool BinaryLogReader::readBlock(void)
+{
+    m_recordIndex = 0;
+    m_recordsInBlock = 0;
+
+    if (m_storage->readBytes(m_file, (char *)m_block, BINLOG_BLOCK_HEADER_SIZE) != BINLOG_BLOCK_HEADER_SIZE)
+    {
+        return false; // Normal end of log
+    }
+
+    uint16_t count = getU16(&m_block[2]);
+
+    if ((getU16(m_block) != BINLOG_BLOCK_SYNC) || (count == 0) || (count > m_recordsPerBlock))
+    {
+        m_error = true;
+        return false;
+    }
+
+    uint32_t remaining = BINLOG_BLOCK_SIZE(m_channelCount, count) - BINLOG_BLOCK_HEADER_SIZE;
+
+    if (m_storage->readBytes(m_file, (char *)&m_block[BINLOG_BLOCK_HEADER_SIZE], remaining) != remaining)
+    {
+        m_error = true;
+        return false;
+    }
+
+    uint32_t crcIndex = BINLOG_BLOCK_SIZE(m_channelCount, count) - BINLOG_CRC_SIZE;
+
+    if (BINLOG_CRC16(0xFFFF, m_block, crcIndex) != getU16(&m_block[crcIndex]))
+    {
+        m_badBlocks++;
+        return true;
+    }
+
+    m_recordsInBlock = count;
+    return true;
+}
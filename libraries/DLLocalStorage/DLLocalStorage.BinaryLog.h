@@ -0,0 +1,150 @@
+#ifndef _LOCAL_STORAGE_BINARY_LOG_H_
+#define _LOCAL_STORAGE_BINARY_LOG_H_
+
+/*
+ * Binary log format
+ *
+ * A compact, append-only alternative to CSV text for local storage.
+ * All multi-byte values are little-endian.
+ *
+ * File header:
+ *   "DLB1" | version (u8) | channel count (u8) | records per block (u16)
+ *   then per channel: number (u8) | value type (u8) | reserved (u16) | scale (f32) | offset (f32)
+ *   then CRC16 of all preceding header bytes
+ *
+ * Each block:
+ *   sync (u16) | record count (u16) | records | CRC16 of sync, count and records
+ *
+ * Each record is a u32 timestamp (unix seconds) followed by one 4-byte value per channel.
+ * Integer values are converted with (value * scale) + offset, float values are stored as-is.
+ */
+
+#define BINLOG_MAGIC "DLB1"
+#define BINLOG_VERSION (1)
+#define BINLOG_BLOCK_SYNC (0x4B42)
+
+#define BINLOG_MAX_CHANNELS (32)
+
+#define BINLOG_FILE_HEADER_FIXED_SIZE (8)
+#define BINLOG_CHANNEL_SIZE (12)
+#define BINLOG_BLOCK_HEADER_SIZE (4)
+#define BINLOG_CRC_SIZE (2)
+#define BINLOG_TIMESTAMP_SIZE (4)
+#define BINLOG_VALUE_SIZE (4)
+
+#define BINLOG_HEADER_SIZE(channels) (BINLOG_FILE_HEADER_FIXED_SIZE + ((channels) * BINLOG_CHANNEL_SIZE) + BINLOG_CRC_SIZE)
+#define BINLOG_RECORD_SIZE(channels) (BINLOG_TIMESTAMP_SIZE + ((channels) * BINLOG_VALUE_SIZE))
+#define BINLOG_BLOCK_SIZE(channels, records) \
+    (BINLOG_BLOCK_HEADER_SIZE + ((records) * BINLOG_RECORD_SIZE(channels)) + BINLOG_CRC_SIZE)
+
+enum binlog_value_type
+{
+    BINLOG_INT32,
+    BINLOG_FLOAT
+};
+typedef enum binlog_value_type BINLOG_VALUE_TYPE;
+
+struct binlog_channel
+{
+    uint8_t number;
+    BINLOG_VALUE_TYPE type;
+    float scale;
+    float offset;
+};
+typedef struct binlog_channel BINLOG_CHANNEL;
+
+union binlog_value
+{
+    int32_t i;
+    float f;
+};
+typedef union binlog_value BINLOG_VALUE;
+
+uint16_t BINLOG_CRC16(uint16_t crc, uint8_t const * data, uint32_t n);
+
+/*
+ * BinaryLogWriter
+ *
+ * Collects records into a block buffer and writes each block (with its CRC)
+ * to storage in a single writeBytes call when the block is full or on flush().
+ */
+
+class BinaryLogWriter
+{
+    public:
+        BinaryLogWriter(LocalStorageInterface * storage);
+        ~BinaryLogWriter();
+
+        bool begin(FILE_HANDLE file, BINLOG_CHANNEL const * channels, uint8_t nChannels,
+            uint16_t recordsPerBlock, bool writeHeader);
+
+        bool writeRecord(uint32_t timestamp, BINLOG_VALUE const * values);
+        void flush(void);
+
+        uint16_t pendingRecords(void);
+        uint32_t recordsWritten(void);
+        uint32_t blocksWritten(void);
+        uint32_t bytesWritten(void);
+
+    private:
+        void writeHeader(void);
+
+        LocalStorageInterface * m_storage;
+        FILE_HANDLE m_file;
+
+        BINLOG_CHANNEL m_channels[BINLOG_MAX_CHANNELS];
+        uint8_t m_channelCount;
+
+        uint8_t * m_block;
+        uint16_t m_recordsPerBlock;
+        uint16_t m_pending;
+
+        uint32_t m_recordsWritten;
+        uint32_t m_blocksWritten;
+        uint32_t m_bytesWritten;
+};
+
+/*
+ * BinaryLogReader
+ *
+ * Streams a binary log back one block at a time.
+ * Blocks that fail their CRC check are skipped and counted.
+ */
+
+class BinaryLogReader
+{
+    public:
+        BinaryLogReader(LocalStorageInterface * storage);
+        ~BinaryLogReader();
+
+        bool begin(FILE_HANDLE file);
+
+        uint8_t channelCount(void);
+        BINLOG_CHANNEL const * getChannel(uint8_t index);
+        float convert(uint8_t index, BINLOG_VALUE value);
+
+        bool readRecord(uint32_t * timestamp, BINLOG_VALUE * values);
+        uint32_t readCSVLine(char * buffer, uint16_t length, char const * const fmt);
+
+        uint32_t badBlocks(void);
+        bool inError(void);
+
+    private:
+        bool readBlock(void);
+
+        LocalStorageInterface * m_storage;
+        FILE_HANDLE m_file;
+
+        BINLOG_CHANNEL m_channels[BINLOG_MAX_CHANNELS];
+        uint8_t m_channelCount;
+
+        uint8_t * m_block;
+        uint16_t m_recordsPerBlock;
+        uint16_t m_recordsInBlock;
+        uint16_t m_recordIndex;
+
+        uint32_t m_badBlocks;
+        bool m_error;
+};
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * DLLocalStorage.Buffered.cpp
+ *
+ * Write-behind block buffer for local storage devices
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.HelperMacros.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.Buffered.h"
+
+/*
+ * Private Functions
+ */
+
+static unsigned long getMicros(void)
+{
+#ifdef ARDUINO
+    return micros();
+#else
+    return (unsigned long)(((unsigned long long)clock() * 1000000UL) / CLOCKS_PER_SEC);
+#endif
+}
+
+// Echoes text written to storage, as the underlying storage's write() would have done
+static void echo(char const * const text)
+{
+#ifdef ARDUINO
+    Serial.print(text);
+#else
+    fputs(text, stdout);
+#endif
+}
+
+/*
+ * Public Class Functions
+ */
+
+BufferedLocalStorage::BufferedLocalStorage(LocalStorageInterface * storage, uint16_t flushThreshold, unsigned long maxAgeMs)
+{
+    m_storage = storage;
+    m_pending = 0;
+    m_flushThreshold = ((flushThreshold > 0) && (flushThreshold <= BUFFERED_STORAGE_BLOCK_SIZE)) ?
+        flushThreshold : BUFFERED_STORAGE_BLOCK_SIZE;
+    m_file = INVALID_HANDLE;
+    m_maxAgeMs = maxAgeMs;
+    m_pendingSinceMs = 0;
+    m_pendingSeen = false;
+    m_echo = false;
+    resetStats();
+}
+
+bool BufferedLocalStorage::inError() { return m_storage->inError(); }
+
+bool BufferedLocalStorage::fileExists(char const * const filePath)
+{
+    return m_storage->fileExists(filePath);
+}
+
+bool BufferedLocalStorage::directoryExists(char const * const dirPath)
+{
+    return m_storage->directoryExists(dirPath);
+}
+
+bool BufferedLocalStorage::mkDir(char const * const dirPath)
+{
+    return m_storage->mkDir(dirPath);
+}
+
+/*
+ * write
+ *
+ * Buffered like writeBytes. Flushes go through the underlying storage's writeBytes,
+ * which doesn't echo, so the text is echoed here (if set) as it is written.
+ */
+void BufferedLocalStorage::write(FILE_HANDLE file, char const * const toWrite)
+{
+    if (!toWrite) { return; }
+    writeBytes(file, (uint8_t const *)toWrite, strlen(toWrite));
+
+    if (m_echo) { echo(toWrite); }
+}
+
+/*
+ * writeBytes
+ *
+ * Copies data into the block, flushing each time the threshold is reached.
+ * While the block is empty, whole blocks are passed straight through without copying.
+ */
+void BufferedLocalStorage::writeBytes(FILE_HANDLE file, uint8_t const * const toWrite, uint32_t n)
+{
+    if (!toWrite) { return; }
+
+    // Pending data belongs to one file only
+    if (file != m_file) { flush(); }
+    m_file = file;
+
+    m_stats.bytesWritten += n;
+
+    uint8_t const * p = toWrite;
+    uint16_t toCopy;
+
+    while (n)
+    {
+        if ((m_pending == 0) && (n >= BUFFERED_STORAGE_BLOCK_SIZE))
+        {
+            physicalWrite(p, BUFFERED_STORAGE_BLOCK_SIZE);
+            p += BUFFERED_STORAGE_BLOCK_SIZE;
+            n -= BUFFERED_STORAGE_BLOCK_SIZE;
+            continue;
+        }
+
+        toCopy = min(n, (uint32_t)(m_flushThreshold - m_pending));
+        memcpy(&m_block[m_pending], p, toCopy);
+        m_pending += toCopy;
+        p += toCopy;
+        n -= toCopy;
+
+        if (m_pending >= m_flushThreshold) { flush(); }
+    }
+}
+
+uint32_t BufferedLocalStorage::readBytes(FILE_HANDLE file, char * buffer, uint32_t n)
+{
+    flush();
+    return m_storage->readBytes(file, buffer, n);
+}
+
+uint32_t BufferedLocalStorage::readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool stripCRLF)
+{
+    flush();
+    return m_storage->readLine(file, buffer, n, stripCRLF);
+}
+
+FILE_HANDLE BufferedLocalStorage::openFile(char const * const filename, bool forWrite)
+{
+    flush();
+    return m_storage->openFile(filename, forWrite);
+}
+
+void BufferedLocalStorage::closeFile(FILE_HANDLE file)
+{
+    flush();
+    m_file = INVALID_HANDLE;
+    m_storage->closeFile(file);
+}
+
+bool BufferedLocalStorage::endOfFile(FILE_HANDLE file)
+{
+    flush();
+    return m_storage->endOfFile(file);
+}
+
+bool BufferedLocalStorage::seek(FILE_HANDLE file, uint32_t position)
+{
+    flush();
+    return m_storage->seek(file, position);
+}
+
+uint32_t BufferedLocalStorage::fileSize(FILE_HANDLE file)
+{
+    flush();
+    return m_storage->fileSize(file);
+}
+
+void BufferedLocalStorage::setEcho(bool set)
+{
+    m_echo = set;
+    m_storage->setEcho(set);
+}
+
+void BufferedLocalStorage::removeFile(char const * const dirPath)
+{
+    flush();
+    m_storage->removeFile(dirPath);
+}
+
+void BufferedLocalStorage::flush(void)
+{
+    if (m_pending == 0) { return; }
+
+    physicalWrite(m_block, m_pending);
+    m_pending = 0;
+    m_pendingSeen = false;
+}
+
+/*
+ * tick
+ *
+ * Call regularly with the current time (e.g. millis()).
+ * Flushes the block if data has been pending for at least the maximum age.
+ * Returns true if a flush happened.
+ */
+bool BufferedLocalStorage::tick(unsigned long ms)
+{
+    if ((m_maxAgeMs == 0) || (m_pending == 0)) { return false; }
+
+    if (!m_pendingSeen)
+    {
+        m_pendingSinceMs = ms;
+        m_pendingSeen = true;
+    }
+
+    if ((ms - m_pendingSinceMs) >= m_maxAgeMs)
+    {
+        flush();
+        return true;
+    }
+
+    return false;
+}
+
+uint16_t BufferedLocalStorage::pending(void) { return m_pending; }
+
+BUFFERED_STORAGE_STATS const * BufferedLocalStorage::getStats(void) { return &m_stats; }
+
+void BufferedLocalStorage::resetStats(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/*
+ * Private Class Functions
+ */
+
+void BufferedLocalStorage::physicalWrite(uint8_t const * data, uint32_t n)
+{
+    unsigned long start = getMicros();
+
+    m_storage->writeBytes(m_file, data, n);
+
+    uint32_t elapsed = getMicros() - start;
+
+    m_stats.bytesFlushed += n;
+    m_stats.flushes++;
+    m_stats.totalFlushMicros += elapsed;
+    m_stats.maxFlushMicros = max(m_stats.maxFlushMicros, elapsed);
+}
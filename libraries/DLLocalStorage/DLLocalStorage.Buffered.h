@@ -0,0 +1,75 @@
+#ifndef _LOCAL_STORAGE_BUFFERED_H_
+#define _LOCAL_STORAGE_BUFFERED_H_
+
+/*
+ * BufferedLocalStorage
+ *
+ * Write-behind layer over another LocalStorageInterface.
+ * Writes are gathered into a 512-byte (one SD sector) block and passed on in a single
+ * writeBytes call when the block reaches the flush threshold, when data has been pending
+ * for longer than the maximum age or when flush() is called.
+ * The age of pending data is measured from the first tick() call that sees it.
+ * Any operation that could observe or move the file (open, close, read, remove) flushes first.
+ * If echo is set, text passed to write() is echoed to serial when it is written, not when it is flushed.
+ */
+
+#define BUFFERED_STORAGE_BLOCK_SIZE (512)
+
+struct buffered_storage_stats
+{
+    uint32_t bytesWritten; // Bytes passed to write/writeBytes
+    uint32_t bytesFlushed; // Bytes passed to the underlying storage
+    uint32_t flushes; // Calls to the underlying storage writeBytes
+    uint32_t totalFlushMicros;
+    uint32_t maxFlushMicros;
+};
+typedef struct buffered_storage_stats BUFFERED_STORAGE_STATS;
+
+class BufferedLocalStorage : public LocalStorageInterface
+{
+    public:
+        BufferedLocalStorage(LocalStorageInterface * storage,
+            uint16_t flushThreshold = BUFFERED_STORAGE_BLOCK_SIZE, unsigned long maxAgeMs = 0);
+
+        bool inError();
+        bool fileExists(char const * const filePath);
+        bool directoryExists(char const * const dirPath);
+        bool mkDir(char const * const dirPath);
+        void write(FILE_HANDLE file, char const * const toWrite);
+        void writeBytes(FILE_HANDLE file, uint8_t const * const toWrite, uint32_t n);
+        uint32_t readBytes(FILE_HANDLE file, char * buffer, uint32_t n);
+        uint32_t readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool stripCRLF);
+        FILE_HANDLE openFile(char const * const filename, bool forWrite);
+        void closeFile(FILE_HANDLE file);
+        bool endOfFile(FILE_HANDLE file);
+        bool seek(FILE_HANDLE file, uint32_t position);
+        uint32_t fileSize(FILE_HANDLE file);
+        void setEcho(bool set);
+        void removeFile(char const * const dirPath);
+
+        void flush(void);
+        bool tick(unsigned long ms);
+
+        uint16_t pending(void);
+        BUFFERED_STORAGE_STATS const * getStats(void);
+        void resetStats(void);
+
+    private:
+        void physicalWrite(uint8_t const * data, uint32_t n);
+
+        LocalStorageInterface * m_storage;
+
+        uint8_t m_block[BUFFERED_STORAGE_BLOCK_SIZE];
+        uint16_t m_pending;
+        uint16_t m_flushThreshold;
+        FILE_HANDLE m_file;
+
+        unsigned long m_maxAgeMs;
+        unsigned long m_pendingSinceMs;
+        bool m_pendingSeen;
+        bool m_echo;
+
+        BUFFERED_STORAGE_STATS m_stats;
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * DLLocalStorage.Handles.cpp
+ *
+ * Handle table and LRU of open files for local storage devices
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLUtility.HelperMacros.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
+
+/*
+ * Public Class Functions
+ */
+
+StorageHandleTable::StorageHandleTable(uint8_t maxOpen)
+{
+    m_maxOpen = ((maxOpen > 0) && (maxOpen <= STORAGE_MAX_HANDLES)) ? maxOpen : 1;
+    m_useCounter = 0;
+    memset(m_handles, 0, sizeof(m_handles));
+    for (uint8_t i = 0; i < STORAGE_MAX_HANDLES; i++)
+    {
+        m_handles[i].slot = STORAGE_NO_SLOT;
+    }
+}
+
+/*
+ * add
+ *
+ * Creates a (suspended) handle for the path.
+ * Returns INVALID_HANDLE if the path is too long or all handles are in use.
+ */
+FILE_HANDLE StorageHandleTable::add(char const * const path, bool forWrite)
+{
+    if (!path || (strlen(path) >= STORAGE_MAX_PATH)) { return INVALID_HANDLE; }
+
+    for (uint8_t i = 0; i < STORAGE_MAX_HANDLES; i++)
+    {
+        if (!m_handles[i].inUse)
+        {
+            strncpy_safe(m_handles[i].path, path, STORAGE_MAX_PATH);
+            m_handles[i].inUse = true;
+            m_handles[i].forWrite = forWrite;
+            m_handles[i].slot = STORAGE_NO_SLOT;
+            m_handles[i].position = 0;
+            m_handles[i].lastUsed = 0;
+            return (FILE_HANDLE)i;
+        }
+    }
+
+    return INVALID_HANDLE;
+}
+
+void StorageHandleTable::remove(FILE_HANDLE handle)
+{
+    STORAGE_HANDLE * pHandle = get(handle);
+    if (!pHandle) { return; }
+
+    pHandle->inUse = false;
+    pHandle->slot = STORAGE_NO_SLOT;
+}
+
+STORAGE_HANDLE * StorageHandleTable::get(FILE_HANDLE handle)
+{
+    if ((handle < 0) || (handle >= STORAGE_MAX_HANDLES)) { return NULL; }
+    return m_handles[handle].inUse ? &m_handles[handle] : NULL;
+}
+
+void StorageHandleTable::touch(FILE_HANDLE handle)
+{
+    STORAGE_HANDLE * pHandle = get(handle);
+    if (pHandle) { pHandle->lastUsed = ++m_useCounter; }
+}
+
+void StorageHandleTable::setOpen(FILE_HANDLE handle, uint8_t slot)
+{
+    STORAGE_HANDLE * pHandle = get(handle);
+    if (pHandle) { pHandle->slot = slot; }
+}
+
+void StorageHandleTable::setSuspended(FILE_HANDLE handle, uint32_t position)
+{
+    STORAGE_HANDLE * pHandle = get(handle);
+    if (!pHandle) { return; }
+
+    pHandle->slot = STORAGE_NO_SLOT;
+    pHandle->position = position;
+}
+
+/*
+ * freeSlot
+ *
+ * Returns a physical slot not used by any open handle, or STORAGE_NO_SLOT if all are in use.
+ */
+uint8_t StorageHandleTable::freeSlot(void)
+{
+    bool used[STORAGE_MAX_HANDLES];
+    uint8_t i;
+
+    memset(used, 0, sizeof(used));
+
+    for (i = 0; i < STORAGE_MAX_HANDLES; i++)
+    {
+        if (m_handles[i].inUse && (m_handles[i].slot != STORAGE_NO_SLOT))
+        {
+            used[m_handles[i].slot] = true;
+        }
+    }
+
+    for (i = 0; i < m_maxOpen; i++)
+    {
+        if (!used[i]) { return i; }
+    }
+
+    return STORAGE_NO_SLOT;
+}
+
+/*
+ * leastRecentlyUsed
+ *
+ * Returns the open handle that was used longest ago, or INVALID_HANDLE if no handle is open.
+ */
+FILE_HANDLE StorageHandleTable::leastRecentlyUsed(void)
+{
+    FILE_HANDLE lru = INVALID_HANDLE;
+
+    for (uint8_t i = 0; i < STORAGE_MAX_HANDLES; i++)
+    {
+        if (m_handles[i].inUse && (m_handles[i].slot != STORAGE_NO_SLOT))
+        {
+            if ((lru == INVALID_HANDLE) || (m_handles[i].lastUsed < m_handles[lru].lastUsed))
+            {
+                lru = (FILE_HANDLE)i;
+            }
+        }
+    }
+
+    return lru;
+}
+
+uint8_t StorageHandleTable::handleCount(void)
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < STORAGE_MAX_HANDLES; i++)
+    {
+        if (m_handles[i].inUse) { count++; }
+    }
+    return count;
+}
+
+uint8_t StorageHandleTable::openCount(void)
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < STORAGE_MAX_HANDLES; i++)
+    {
+        if (m_handles[i].inUse && (m_handles[i].slot != STORAGE_NO_SLOT)) { count++; }
+    }
+    return count;
+}
+
+uint8_t StorageHandleTable::maxOpen(void) { return m_maxOpen; }
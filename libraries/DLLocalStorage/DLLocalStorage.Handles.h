@@ -0,0 +1,67 @@
+#ifndef _LOCAL_STORAGE_HANDLES_H_
+#define _LOCAL_STORAGE_HANDLES_H_
+
+/*
+ * StorageHandleTable
+ *
+ * Bookkeeping for the file handles returned by a LocalStorageInterface.
+ * Each handle remembers its path, mode and read position, so that any number of handles
+ * (up to STORAGE_MAX_HANDLES) can be shared between a smaller number of physically open files.
+ * When a handle that is not physically open is used, the storage implementation asks for a
+ * free physical slot; if there is none, the least recently used open handle is suspended
+ * (its position saved and its file closed) to make room.
+ *
+ * On the LinkIt ONE only one file can be open at a time, so there handles only save the
+ * bookkeeping: using two files in turn (e.g. reading the backlog while appending to the log)
+ * still closes and reopens a file on every switch. Keeping both files open only happens
+ * on the host, where STORAGE_MAX_OPEN_FILES is 2.
+ */
+
+#define STORAGE_MAX_HANDLES (8)
+#ifdef ARDUINO
+#define STORAGE_MAX_OPEN_FILES (1)
+#else
+#define STORAGE_MAX_OPEN_FILES (2)
+#endif
+#define STORAGE_MAX_PATH (64)
+
+#define STORAGE_NO_SLOT (0xFF)
+
+struct storage_handle
+{
+    char path[STORAGE_MAX_PATH];
+    bool inUse;
+    bool forWrite;
+    uint8_t slot; // Physical slot while open, STORAGE_NO_SLOT when suspended
+    uint32_t position; // Saved read position while suspended
+    uint32_t lastUsed;
+};
+typedef struct storage_handle STORAGE_HANDLE;
+
+class StorageHandleTable
+{
+    public:
+        StorageHandleTable(uint8_t maxOpen);
+
+        FILE_HANDLE add(char const * const path, bool forWrite);
+        void remove(FILE_HANDLE handle);
+        STORAGE_HANDLE * get(FILE_HANDLE handle);
+
+        void touch(FILE_HANDLE handle);
+        void setOpen(FILE_HANDLE handle, uint8_t slot);
+        void setSuspended(FILE_HANDLE handle, uint32_t position);
+
+        uint8_t freeSlot(void);
+        FILE_HANDLE leastRecentlyUsed(void);
+
+        uint8_t handleCount(void);
+        uint8_t openCount(void);
+        uint8_t maxOpen(void);
+
+    private:
+        STORAGE_HANDLE m_handles[STORAGE_MAX_HANDLES];
+        uint8_t m_maxOpen;
+        uint32_t m_useCounter;
+};
+
+#endif
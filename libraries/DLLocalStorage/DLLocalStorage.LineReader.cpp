@@ -0,0 +1,118 @@
+/*
+ * DLLocalStorage.LineReader.cpp
+ *
+ * Buffered line reader for local storage devices
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.HelperMacros.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.LineReader.h"
+
+/*
+ * Public Class Functions
+ */
+
+LineReader::LineReader(LocalStorageInterface * storage, FILE_HANDLE file)
+{
+    m_storage = storage;
+    attach(file);
+}
+
+/*
+ * attach
+ *
+ * Starts reading from a (newly opened) file, discarding any buffered data.
+ */
+void LineReader::attach(FILE_HANDLE file)
+{
+    m_file = file;
+    m_start = 0;
+    m_end = 0;
+    m_eof = (m_storage == NULL) || (file == INVALID_HANDLE);
+}
+
+uint32_t LineReader::readLine(char * buffer, uint32_t n, bool stripCRLF)
+{
+    if (!buffer || (n == 0)) { return 0; }
+
+    uint32_t readCount = 0;
+    uint32_t length;
+    char * pStart;
+    char * pNewline = NULL;
+
+    while ((readCount < n) && !pNewline)
+    {
+        if ((m_start == m_end) && !fill()) { break; }
+
+        pStart = &m_block[m_start];
+        length = min((uint32_t)(m_end - m_start), n - readCount);
+
+        pNewline = (char *)memchr(pStart, '\n', length);
+        if (pNewline) { length = (pNewline - pStart) + 1; }
+
+        memcpy(&buffer[readCount], pStart, length);
+        readCount += length;
+        m_start += length;
+    }
+
+    if (stripCRLF)
+    {
+        while ((readCount > 0) && ((buffer[readCount - 1] == '\r') || (buffer[readCount - 1] == '\n')))
+        {
+            buffer[--readCount] = '\0';
+        }
+    }
+
+    if (readCount < n)
+    {
+        buffer[readCount] = '\0'; // NULL-terminate if there is room left in the buffer
+    }
+
+    return readCount;
+}
+
+/*
+ * endOfFile
+ *
+ * Returns true once all data in the file has been returned by readLine.
+ */
+bool LineReader::endOfFile(void)
+{
+    return (m_start == m_end) && !fill();
+}
+
+/*
+ * Private Class Functions
+ */
+
+bool LineReader::fill(void)
+{
+    if (m_eof) { return false; }
+
+    m_start = 0;
+    m_end = m_storage->readBytes(m_file, m_block, LINE_READER_BLOCK_SIZE);
+
+    if (m_end == 0) { m_eof = true; }
+
+    return m_end > 0;
+}
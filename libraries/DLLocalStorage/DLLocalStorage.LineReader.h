@@ -0,0 +1,43 @@
+#ifndef _LOCAL_STORAGE_LINE_READER_H_
+#define _LOCAL_STORAGE_LINE_READER_H_
+
+/*
+ * LineReader
+ *
+ * Buffered line reader over any LocalStorageInterface.
+ * The file is read in LINE_READER_BLOCK_SIZE blocks with readBytes and each line
+ * is found with memchr, instead of fetching the file one character at a time.
+ *
+ * readLine behaves like readLineWithReadFunction: up to n chars are copied into buffer
+ * (including the '\n' unless stripCRLF is set), the buffer is NULL-terminated if there is
+ * room, and the number of chars written (excluding the NULL) is returned.
+ * A line longer than n chars is returned over several calls.
+ *
+ * The reader owns the file position, so the file should not be read directly while
+ * a LineReader is attached to it.
+ */
+
+#define LINE_READER_BLOCK_SIZE (512)
+
+class LineReader
+{
+    public:
+        LineReader(LocalStorageInterface * storage, FILE_HANDLE file);
+
+        void attach(FILE_HANDLE file);
+        uint32_t readLine(char * buffer, uint32_t n, bool stripCRLF = false);
+        bool endOfFile(void);
+
+    private:
+        bool fill(void);
+
+        LocalStorageInterface * m_storage;
+        FILE_HANDLE m_file;
+
+        char m_block[LINE_READER_BLOCK_SIZE];
+        uint16_t m_start;
+        uint16_t m_end;
+        bool m_eof;
+};
+
+#endif
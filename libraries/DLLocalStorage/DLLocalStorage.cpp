@@ -25,6 +25,7 @@
  */
 
 #include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
 #include "DLLocalStorage.linkitonesd.h"
 /*
  * Public Functions 
@@ -18,16 +18,19 @@ typedef int8_t FILE_HANDLE;
 class LocalStorageInterface
 {
     public:
-        virtual bool inError();
+        virtual bool inError() { return false; }
         virtual bool fileExists(char const * const filePath) = 0;
         virtual bool directoryExists(char const * const dirPath) = 0;
         virtual bool mkDir(char const * const dirPath) = 0;
         virtual void write(FILE_HANDLE file, char const * const toWrite) = 0;
+        virtual void writeBytes(FILE_HANDLE file, uint8_t const * const toWrite, uint32_t n) = 0;
         virtual uint32_t readBytes(FILE_HANDLE file, char * buffer, uint32_t n) = 0;
         virtual uint32_t readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool stripCRLF) = 0;
         virtual FILE_HANDLE openFile(char const * const filename, bool forWrite) = 0;
         virtual void closeFile(FILE_HANDLE file) = 0;
         virtual bool endOfFile(FILE_HANDLE file) = 0;
+        virtual bool seek(FILE_HANDLE file, uint32_t position) = 0;
+        virtual uint32_t fileSize(FILE_HANDLE file) = 0;
         virtual void setEcho(bool set) = 0;
         virtual void removeFile(char const * const dirPath) = 0;
 
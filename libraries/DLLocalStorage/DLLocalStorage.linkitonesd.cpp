@@ -28,23 +28,22 @@
 
 #include "DLUtility.h"
 #include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
 #include "DLLocalStorage.linkitonesd.h"
 
 /*
  * Private Variables
  */
 
-// Since the LinkIt ONE can only have one open file at a time, keep this as a file-local static member.
-// The LinkItOne SD class then just acts as an interface to interact with this file object.
-static LFile s_file;
-static bool s_fileIsOpenForRead = false;
-static bool s_fileIsOpenForWrite = false;
+// The physical files shared between all handles. The LinkIt ONE can only have one open file at a time,
+// so each handle that is used after another has to reopen its file (and the other is suspended).
+static LFile s_files[STORAGE_MAX_OPEN_FILES];
 
 /*
  * Public Functions
  */
 
-LinkItOneSD::LinkItOneSD()
+LinkItOneSD::LinkItOneSD() : m_handles(STORAGE_MAX_OPEN_FILES)
 {
     m_successfulInit = LSD.begin(); // Start the LinkIt ONE SD Interface
     m_echo = false;
@@ -72,88 +71,99 @@ bool LinkItOneSD::mkDir(char const * const dirPath)
     return LSD.mkdir((char*)dirPath);
 }
 
+// readLineWithReadFunction takes a plain function, so keep track of the file it reads from here
+static LFile * s_pReadLineFile = NULL;
+
 static char readOneByteFromFile(void)
 {
-	return s_file.available() ? s_file.read() : '\0';
+	return s_pReadLineFile->available() ? s_pReadLineFile->read() : '\0';
 }
 
 FILE_HANDLE LinkItOneSD::openFile(char const * const filename, bool forWrite)
 {
-    s_file.close(); // Ensure previous file (if any) is closed
-    s_file = LSD.open(filename, forWrite ? FILE_WRITE : FILE_READ);
+    FILE_HANDLE file = m_handles.add(filename, forWrite);
 
-    if (s_file)
+    if (file == INVALID_HANDLE)
     {
-    	s_fileIsOpenForWrite = forWrite;
-    	s_fileIsOpenForRead = !forWrite;
+    	Serial.print("No free handle for '");
+    	Serial.print(filename);
+    	Serial.println("'");
+    	return INVALID_HANDLE;
     }
-    else
+
+    if (getSlot(file) == STORAGE_NO_SLOT)
     {
     	Serial.print("Could not open '");
     	Serial.print(filename);
     	Serial.println(forWrite ? "' for write" : "' for read");
-    	s_fileIsOpenForWrite = false;
-    	s_fileIsOpenForRead = false;
+    	m_handles.remove(file);
+    	return INVALID_HANDLE;
     }
 
-    return s_file ? 0 : INVALID_HANDLE; // The LinkIt ONE can only support one open file at a time, so no need to track file handles
+    return file;
 }
 
 void LinkItOneSD::write(FILE_HANDLE file, char const * const toWrite)
 {
-	(void)file; // The LinkIt ONE can only support one open file at a time, so discard handle
-	bool fileAvailableForWrite = true;
-	fileAvailableForWrite &= !s_file.isDirectory();
-	fileAvailableForWrite &= s_fileIsOpenForWrite;
+	STORAGE_HANDLE * pHandle = m_handles.get(file);
 
-	if (fileAvailableForWrite)
+	if (pHandle && pHandle->forWrite && toWrite)
 	{
-		s_file.print(toWrite);
-		if (m_echo)
+		uint8_t slot = getSlot(file);
+		if ((slot != STORAGE_NO_SLOT) && !s_files[slot].isDirectory())
 		{
-			Serial.print(toWrite);
+			s_files[slot].print(toWrite);
+			if (m_echo)
+			{
+				Serial.print(toWrite);
+			}
 		}
 	}
-	else
+}
+
+void LinkItOneSD::writeBytes(FILE_HANDLE file, uint8_t const * const toWrite, uint32_t n)
+{
+	STORAGE_HANDLE * pHandle = m_handles.get(file);
+
+	if (pHandle && pHandle->forWrite && toWrite)
 	{
-		/*Serial.print("File not open when writing because ");
-		if (s_file.isDirectory())
+		uint8_t slot = getSlot(file);
+		if ((slot != STORAGE_NO_SLOT) && !s_files[slot].isDirectory())
 		{
-			Serial.println(" file is directory.");
+			s_files[slot].write(toWrite, n);
 		}
-		else if (!s_fileIsOpenForWrite)
-		{
-			Serial.println(" file was not opened in write mode.");
-		}*/
 	}
 }
 
 uint32_t LinkItOneSD::readBytes(FILE_HANDLE file, char * buffer, uint32_t n)
 {
-	(void)file; // The LinkIt ONE can only support one open file at a time, so discard handle
-	bool fileAvailableForRead = true;
-	fileAvailableForRead &= !s_file.isDirectory();
-	fileAvailableForRead &= s_fileIsOpenForRead;
+	STORAGE_HANDLE * pHandle = m_handles.get(file);
 
-	if (fileAvailableForRead && buffer)
+	if (pHandle && !pHandle->forWrite && buffer)
 	{
-		return s_file.read(buffer, n);
+		uint8_t slot = getSlot(file);
+		if ((slot != STORAGE_NO_SLOT) && !s_files[slot].isDirectory())
+		{
+			return s_files[slot].read(buffer, n);
+		}
 	}
+
+	return 0;
 }
 
 uint32_t LinkItOneSD::readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool stripCRLF)
 {
-	(void)file; // The LinkIt ONE can only support one open file at a time, so discard handle
-	bool fileAvailableForRead = true;
-	fileAvailableForRead &= !s_file.isDirectory();
-	fileAvailableForRead &= s_fileIsOpenForRead;
-
+	STORAGE_HANDLE * pHandle = m_handles.get(file);
 	uint32_t readCount = 0;
-	bool eol = false;
 
-	if (fileAvailableForRead && buffer)
+	if (pHandle && !pHandle->forWrite && buffer)
 	{
-		readCount = readLineWithReadFunction(readOneByteFromFile, buffer, n, stripCRLF);
+		uint8_t slot = getSlot(file);
+		if ((slot != STORAGE_NO_SLOT) && !s_files[slot].isDirectory())
+		{
+			s_pReadLineFile = &s_files[slot];
+			readCount = readLineWithReadFunction(readOneByteFromFile, buffer, n, stripCRLF);
+		}
 	}
 
 	return readCount;
@@ -161,19 +171,92 @@ uint32_t LinkItOneSD::readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool
 
 bool LinkItOneSD::endOfFile(FILE_HANDLE file)
 {
-	(void)file; // The LinkIt ONE can only support one open file at a time, so discard handle
-	return !s_file.available();
+	uint8_t slot = getSlot(file);
+	return (slot == STORAGE_NO_SLOT) || !s_files[slot].available();
+}
+
+bool LinkItOneSD::seek(FILE_HANDLE file, uint32_t position)
+{
+	STORAGE_HANDLE * pHandle = m_handles.get(file);
+
+	// Files opened for write always append, so only read handles can seek
+	if (!pHandle || pHandle->forWrite) { return false; }
+
+	uint8_t slot = getSlot(file);
+	return (slot != STORAGE_NO_SLOT) && s_files[slot].seek(position);
+}
+
+uint32_t LinkItOneSD::fileSize(FILE_HANDLE file)
+{
+	uint8_t slot = getSlot(file);
+	return (slot == STORAGE_NO_SLOT) ? 0 : s_files[slot].size();
 }
 
 void LinkItOneSD::closeFile(FILE_HANDLE file)
 {
-    (void)file; // The LinkIt ONE can only support one open file at a time, so discard handle
-    s_file.close();
-    s_fileIsOpenForWrite = false;
-    s_fileIsOpenForRead = false;
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+    if (!pHandle) { return; }
+
+    if (pHandle->slot != STORAGE_NO_SLOT)
+    {
+        s_files[pHandle->slot].close();
+    }
+
+    m_handles.remove(file);
 }
 
 void LinkItOneSD::removeFile(char const * const dirPath)
 {
     LSD.remove((char*)dirPath);
-}
\ No newline at end of file
+}
+
+/*
+ * Private Functions
+ */
+
+uint8_t LinkItOneSD::getSlot(FILE_HANDLE file)
+{
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+    if (!pHandle) { return STORAGE_NO_SLOT; }
+
+    if (pHandle->slot == STORAGE_NO_SLOT)
+    {
+        uint8_t slot = m_handles.freeSlot();
+        if (slot == STORAGE_NO_SLOT)
+        {
+            FILE_HANDLE lru = m_handles.leastRecentlyUsed();
+            slot = m_handles.get(lru)->slot;
+            suspend(lru);
+        }
+
+        if (!resume(file, slot)) { return STORAGE_NO_SLOT; }
+    }
+
+    m_handles.touch(file);
+    return pHandle->slot;
+}
+
+void LinkItOneSD::suspend(FILE_HANDLE file)
+{
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+    LFile& f = s_files[pHandle->slot];
+
+    // Files opened for write always append, so only the read position needs saving
+    uint32_t position = pHandle->forWrite ? 0 : f.position();
+
+    f.close();
+    m_handles.setSuspended(file, position);
+}
+
+bool LinkItOneSD::resume(FILE_HANDLE file, uint8_t slot)
+{
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+
+    s_files[slot] = LSD.open(pHandle->path, pHandle->forWrite ? FILE_WRITE : FILE_READ);
+    if (!s_files[slot]) { return false; }
+
+    if (!pHandle->forWrite) { s_files[slot].seek(pHandle->position); }
+
+    m_handles.setOpen(file, slot);
+    return true;
+}
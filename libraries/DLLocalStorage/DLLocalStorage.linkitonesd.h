@@ -14,15 +14,23 @@ class LinkItOneSD : public LocalStorageInterface
         bool directoryExists(char const * const dirPath);
         bool mkDir(char const * const dirPath);
         void write(FILE_HANDLE file, char const * const toWrite);
+        void writeBytes(FILE_HANDLE file, uint8_t const * const toWrite, uint32_t n);
         uint32_t readBytes(FILE_HANDLE file, char * buffer, uint32_t n);
         uint32_t readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool stripCRLF);
         FILE_HANDLE openFile(char const * const filename, bool forWrite = false);
         bool endOfFile(FILE_HANDLE file);
+        bool seek(FILE_HANDLE file, uint32_t position);
+        uint32_t fileSize(FILE_HANDLE file);
         void closeFile(FILE_HANDLE file);
         void setEcho(bool set);
         void removeFile(char const * const dirPath);
 
     private:
+        uint8_t getSlot(FILE_HANDLE file);
+        void suspend(FILE_HANDLE file);
+        bool resume(FILE_HANDLE file, uint8_t slot);
+
+        StorageHandleTable m_handles;
         bool m_echo;
         bool m_successfulInit;
 };
@@ -0,0 +1,137 @@
+/*
+ * DLLocalStorage.LineReader.Benchmark.cpp
+ *
+ * Compares reading a large CSV file one character at a time through readLineWithReadFunction
+ * (as LinkItOneSD::readLine does) with the block-buffered LineReader, both through the mock storage
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <iostream>
+
+#include "DLUtility.Readline.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
+#include "DLLocalStorage.LineReader.h"
+
+#define CSV_PATH "LineReader.Benchmark.csv"
+#define N_LINES (100UL * 1000UL)
+
+static LocalStorageInterface * s_storage;
+static FILE_HANDLE s_handle;
+
+static double elapsedMs(clock_t start)
+{
+    return 1000.0 * (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static uint32_t createCSV(void)
+{
+    FILE * f = fopen(CSV_PATH, "wb");
+    uint32_t bytes = 0;
+    uint32_t i;
+
+    bytes += fprintf(f, "Timestamp, Voltage, Current, Temperature, Irradiance\r\n");
+    for (i = 0; i < N_LINES; i++)
+    {
+        bytes += fprintf(f, "2015-04-03 13:%02lu:%02lu +0000, %lu.%03lu, %lu.%02lu, %lu.%lu, %lu\r\n",
+            (unsigned long)(i / 60) % 60, (unsigned long)i % 60,
+            (unsigned long)(i % 30), (unsigned long)(i % 1000), (unsigned long)(i % 12), (unsigned long)(i % 100),
+            (unsigned long)(i % 40), (unsigned long)(i % 10), (unsigned long)(i % 1200));
+    }
+
+    fclose(f);
+    return bytes;
+}
+
+// Fetches one character per call, like readOneByteFromFile in the LinkIt ONE SD driver
+static char readOneByte(void)
+{
+    char c;
+    return s_storage->readBytes(s_handle, &c, 1) ? c : '\0';
+}
+
+static uint32_t readByteAtATime(uint32_t * lines)
+{
+    char lineBuffer[256];
+    uint32_t total = 0;
+    uint32_t count;
+
+    *lines = 0;
+    s_handle = s_storage->openFile(CSV_PATH, false);
+
+    while ((count = readLineWithReadFunction(readOneByte, lineBuffer, 256, true)) > 0)
+    {
+        total += count;
+        (*lines)++;
+    }
+
+    s_storage->closeFile(s_handle);
+    return total;
+}
+
+static uint32_t readWithLineReader(uint32_t * lines)
+{
+    char lineBuffer[256];
+    uint32_t total = 0;
+
+    *lines = 0;
+    s_handle = s_storage->openFile(CSV_PATH, false);
+    LineReader reader(s_storage, s_handle);
+
+    while (!reader.endOfFile())
+    {
+        total += reader.readLine(lineBuffer, 256, true);
+        (*lines)++;
+    }
+
+    s_storage->closeFile(s_handle);
+    return total;
+}
+
+int main(int argc, char * argv[])
+{
+    (void)argc; (void)argv;
+
+    clock_t start;
+    double byteMs;
+    double blockMs;
+    uint32_t byteLines;
+    uint32_t blockLines;
+    uint32_t byteChars;
+    uint32_t blockChars;
+
+    s_storage = LocalStorage_GetLocalStorageInterface(LOCAL_STORAGE_TYPE(0));
+
+    uint32_t bytes = createCSV();
+    std::cout << "Reading " << bytes << " byte CSV file (" << N_LINES + 1 << " lines) through mock storage" << std::endl;
+
+    start = clock();
+    byteChars = readByteAtATime(&byteLines);
+    byteMs = elapsedMs(start);
+
+    start = clock();
+    blockChars = readWithLineReader(&blockLines);
+    blockMs = elapsedMs(start);
+
+    std::cout << "readLineWithReadFunction (one byte per read): " << byteMs << "ms" << std::endl;
+    std::cout << "LineReader (" << LINE_READER_BLOCK_SIZE << " byte blocks): " << blockMs << "ms (x" << (byteMs / blockMs) << ")" << std::endl;
+
+    if ((byteLines != blockLines) || (byteChars != blockChars))
+    {
+        std::cout << "Mismatch: " << byteLines << "/" << blockLines << " lines, ";
+        std::cout << byteChars << "/" << blockChars << " chars" << std::endl;
+    }
+
+    s_storage->removeFile(CSV_PATH);
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+/*
+ * DLLocalStorage.BinaryLog.Test.cpp
+ *
+ * Tests the binary log writer and reader
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.h"
+#include "DLCSV.h"
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.BinaryLog.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define xstr(s) str(s)
+#define str(s) #s
+#define QUOTED_DL_PATH xstr(DL_PATH)
+
+#define TEST_LOG_PATH QUOTED_DL_PATH "/DLLocalStorage/Test/TestLog.bin"
+
+static LocalStorageInterface * s_storage;
+
+static BINLOG_CHANNEL s_channels[3] = {
+    {1, BINLOG_INT32, 0.5f, 1.0f},
+    {2, BINLOG_FLOAT, 1.0f, 0.0f},
+    {5, BINLOG_INT32, 2.0f, -10.0f}
+};
+
+static void writeTestLog(uint32_t nRecords, uint16_t recordsPerBlock)
+{
+    BinaryLogWriter writer(s_storage);
+    BINLOG_VALUE values[3];
+    uint32_t r;
+
+    FILE_HANDLE file = s_storage->openFile(TEST_LOG_PATH, true);
+    writer.begin(file, s_channels, 3, recordsPerBlock, true);
+
+    for (r = 0; r < nRecords; r++)
+    {
+        values[0].i = r;
+        values[1].f = (float)r * 1.5f;
+        values[2].i = -(int32_t)r;
+        writer.writeRecord(1000 + r, values);
+    }
+
+    writer.flush();
+    s_storage->closeFile(file);
+}
+
+void setUp(void)
+{
+    s_storage = LocalStorage_GetLocalStorageInterface(LOCAL_STORAGE_TYPE(0));
+    s_storage->removeFile(TEST_LOG_PATH);
+}
+
+void tearDown(void)
+{
+    s_storage->removeFile(TEST_LOG_PATH);
+}
+
+void test_CRC16MatchesCCITTCheckValue(void)
+{
+    uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL(0x29B1, BINLOG_CRC16(0xFFFF, check, 9));
+
+    // CRC can be continued over split data
+    uint16_t crc = BINLOG_CRC16(0xFFFF, check, 4);
+    TEST_ASSERT_EQUAL(0x29B1, BINLOG_CRC16(crc, &check[4], 5));
+}
+
+void test_WriterOnlyWritesWholeBlocks(void)
+{
+    BinaryLogWriter writer(s_storage);
+    BINLOG_VALUE values[3] = {{0}, {0}, {0}};
+    uint8_t r;
+
+    FILE_HANDLE file = s_storage->openFile(TEST_LOG_PATH, true);
+    TEST_ASSERT_TRUE(writer.begin(file, s_channels, 3, 4, true));
+    TEST_ASSERT_EQUAL(BINLOG_HEADER_SIZE(3), writer.bytesWritten());
+
+    for (r = 0; r < 3; r++) { writer.writeRecord(r, values); }
+    TEST_ASSERT_EQUAL(3, writer.pendingRecords());
+    TEST_ASSERT_EQUAL(0, writer.blocksWritten());
+
+    writer.writeRecord(3, values);
+    TEST_ASSERT_EQUAL(0, writer.pendingRecords());
+    TEST_ASSERT_EQUAL(1, writer.blocksWritten());
+    TEST_ASSERT_EQUAL(BINLOG_HEADER_SIZE(3) + BINLOG_BLOCK_SIZE(3, 4), writer.bytesWritten());
+
+    writer.writeRecord(4, values);
+    writer.flush();
+    TEST_ASSERT_EQUAL(2, writer.blocksWritten());
+    TEST_ASSERT_EQUAL(5, writer.recordsWritten());
+    TEST_ASSERT_EQUAL(BINLOG_HEADER_SIZE(3) + BINLOG_BLOCK_SIZE(3, 4) + BINLOG_BLOCK_SIZE(3, 1), writer.bytesWritten());
+
+    s_storage->closeFile(file);
+}
+
+void test_ReaderReturnsRecordsWrittenByWriter(void)
+{
+    writeTestLog(10, 4);
+
+    BinaryLogReader reader(s_storage);
+    FILE_HANDLE file = s_storage->openFile(TEST_LOG_PATH, false);
+    TEST_ASSERT_TRUE(reader.begin(file));
+
+    TEST_ASSERT_EQUAL(3, reader.channelCount());
+    TEST_ASSERT_EQUAL(5, reader.getChannel(2)->number);
+    TEST_ASSERT_EQUAL(BINLOG_FLOAT, reader.getChannel(1)->type);
+    TEST_ASSERT_EQUAL_FLOAT(-10.0f, reader.getChannel(2)->offset);
+    TEST_ASSERT_NULL(reader.getChannel(3));
+
+    uint32_t timestamp;
+    BINLOG_VALUE values[3];
+    uint32_t r;
+
+    for (r = 0; r < 10; r++)
+    {
+        TEST_ASSERT_TRUE(reader.readRecord(&timestamp, values));
+        TEST_ASSERT_EQUAL(1000 + r, timestamp);
+        TEST_ASSERT_EQUAL(r, values[0].i);
+        TEST_ASSERT_EQUAL_FLOAT((float)r * 1.5f, values[1].f);
+        TEST_ASSERT_EQUAL(-(int32_t)r, values[2].i);
+    }
+
+    TEST_ASSERT_FALSE(reader.readRecord(&timestamp, values));
+    TEST_ASSERT_FALSE(reader.inError());
+    TEST_ASSERT_EQUAL(0, reader.badBlocks());
+
+    s_storage->closeFile(file);
+}
+
+void test_ReaderConvertsIntegerChannelsWithHeaderParameters(void)
+{
+    writeTestLog(1, 4);
+
+    BinaryLogReader reader(s_storage);
+    FILE_HANDLE file = s_storage->openFile(TEST_LOG_PATH, false);
+    TEST_ASSERT_TRUE(reader.begin(file));
+
+    BINLOG_VALUE value;
+
+    value.i = 10;
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, reader.convert(0, value));
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, reader.convert(2, value));
+
+    value.f = 2.25f;
+    TEST_ASSERT_EQUAL_FLOAT(2.25f, reader.convert(1, value));
+
+    s_storage->closeFile(file);
+}
+
+void test_ReaderSkipsBlockWithBadCRC(void)
+{
+    writeTestLog(12, 4);
+
+    // Corrupt one value in the second block
+    FILE * f = fopen(TEST_LOG_PATH, "r+b");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, BINLOG_HEADER_SIZE(3) + BINLOG_BLOCK_SIZE(3, 4) + BINLOG_BLOCK_HEADER_SIZE + 5, SEEK_SET);
+    fputc(0xAA, f);
+    fclose(f);
+
+    BinaryLogReader reader(s_storage);
+    FILE_HANDLE file = s_storage->openFile(TEST_LOG_PATH, false);
+    TEST_ASSERT_TRUE(reader.begin(file));
+
+    uint32_t timestamps[12];
+    uint32_t count = 0;
+
+    while (reader.readRecord(&timestamps[count], NULL)) { count++; }
+
+    TEST_ASSERT_EQUAL(8, count);
+    TEST_ASSERT_EQUAL(1, reader.badBlocks());
+    TEST_ASSERT_EQUAL(1003, timestamps[3]);
+    TEST_ASSERT_EQUAL(1008, timestamps[4]);
+
+    s_storage->closeFile(file);
+}
+
+void test_ReaderRejectsFileWithoutValidHeader(void)
+{
+    FILE_HANDLE file = s_storage->openFile(TEST_LOG_PATH, true);
+    s_storage->write(file, "Timestamp, Voltage\r\n");
+    s_storage->closeFile(file);
+
+    BinaryLogReader reader(s_storage);
+    file = s_storage->openFile(TEST_LOG_PATH, false);
+    TEST_ASSERT_FALSE(reader.begin(file));
+    TEST_ASSERT_TRUE(reader.inError());
+    TEST_ASSERT_FALSE(reader.readRecord(NULL, NULL));
+
+    s_storage->closeFile(file);
+}
+
+void test_ReaderConvertsRecordsToCSVLines(void)
+{
+    writeTestLog(2, 4);
+
+    BinaryLogReader reader(s_storage);
+    FILE_HANDLE file = s_storage->openFile(TEST_LOG_PATH, false);
+    TEST_ASSERT_TRUE(reader.begin(file));
+
+    TM time;
+    char timestamp[32];
+    char expected[100];
+    char actual[100];
+
+    unix_seconds_to_time(1001, &time);
+    CSV_writeTimestampToBuffer(&time, timestamp);
+    sprintf(expected, "%s, 1.50, 1.50, -12.00\r\n", timestamp);
+
+    TEST_ASSERT_TRUE(reader.readCSVLine(actual, 100, "%.2f") > 0);
+    uint32_t length = reader.readCSVLine(actual, 100, "%.2f");
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+    TEST_ASSERT_EQUAL(strlen(expected), length);
+
+    // A binary record is much smaller than the same record as text
+    TEST_ASSERT_TRUE(BINLOG_RECORD_SIZE(3) * 2 < length);
+
+    TEST_ASSERT_EQUAL(0, reader.readCSVLine(actual, 100, "%.2f"));
+
+    s_storage->closeFile(file);
+}
+
+int main(void)
+{
+    UnityBegin("DLLocalStorage.BinaryLog.Test.cpp");
+
+    RUN_TEST(test_CRC16MatchesCCITTCheckValue);
+    RUN_TEST(test_WriterOnlyWritesWholeBlocks);
+    RUN_TEST(test_ReaderReturnsRecordsWrittenByWriter);
+    RUN_TEST(test_ReaderConvertsIntegerChannelsWithHeaderParameters);
+    RUN_TEST(test_ReaderSkipsBlockWithBadCRC);
+    RUN_TEST(test_ReaderRejectsFileWithoutValidHeader);
+    RUN_TEST(test_ReaderConvertsRecordsToCSVLines);
+
+    return (UnityEnd());
+}
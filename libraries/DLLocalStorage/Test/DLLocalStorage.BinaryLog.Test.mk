@@ -0,0 +1,15 @@
+INC_DIRS += -IDLLocalStorage
+INC_DIRS += -IDLUtility
+INC_DIRS += -IDLCSV
+
+SRC_FILES += DLTest/DLTest.Mock.LocalStorage.cpp
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+SRC_FILES += DLLocalStorage/DLLocalStorage.Handles.cpp
+SRC_FILES += DLUtility/DLUtility.Time.cpp
+SRC_FILES += DLCSV/DLCSV.cpp
+
+local_setup:
+	rm -f ./DLLocalStorage/Test/TestLog.bin
+
+local_teardown:
+	rm -f ./DLLocalStorage/Test/TestLog.bin
@@ -0,0 +1,249 @@
+/*
+ * DLLocalStorage.Buffered.Test.cpp
+ *
+ * Tests the write-behind local storage buffer
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.Buffered.h"
+#include "DLLocalStorage.Handles.h"
+#include "DLTest.Mock.LocalStorage.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define xstr(s) str(s)
+#define str(s) #s
+#define QUOTED_DL_PATH xstr(DL_PATH)
+
+#define TEST_FILE_PATH QUOTED_DL_PATH "/DLLocalStorage/Test/TestBuffered.csv"
+#define TEST_ECHO_PATH QUOTED_DL_PATH "/DLLocalStorage/Test/TestBufferedEcho.txt"
+
+static TestStorageInterface s_mock;
+
+static FILE_HANDLE openTestFile(BufferedLocalStorage& storage)
+{
+    return storage.openFile(TEST_FILE_PATH, true);
+}
+
+static uint32_t readTestFile(char * buffer, uint32_t n)
+{
+    FILE_HANDLE file = s_mock.openFile(TEST_FILE_PATH, false);
+    uint32_t count = s_mock.readBytes(file, buffer, n);
+    s_mock.closeFile(file);
+    return count;
+}
+
+void setUp(void)
+{
+    s_mock.removeFile(TEST_FILE_PATH);
+    s_mock.clearWriteRecord();
+}
+
+void tearDown(void)
+{
+    s_mock.removeFile(TEST_FILE_PATH);
+}
+
+void test_SmallWritesAreCoalescedIntoBlocks(void)
+{
+    BufferedLocalStorage storage(&s_mock);
+    FILE_HANDLE file = openTestFile(storage);
+    uint16_t i;
+
+    // 200 writes of 4 bytes each
+    for (i = 0; i < 200; i++) { storage.write(file, "abc,"); }
+
+    TEST_ASSERT_EQUAL(1, s_mock.getWriteCount());
+    TEST_ASSERT_EQUAL(BUFFERED_STORAGE_BLOCK_SIZE, s_mock.getWriteSize(0));
+    TEST_ASSERT_EQUAL(800 - BUFFERED_STORAGE_BLOCK_SIZE, storage.pending());
+
+    storage.flush();
+    TEST_ASSERT_EQUAL(2, s_mock.getWriteCount());
+    TEST_ASSERT_EQUAL(800 - BUFFERED_STORAGE_BLOCK_SIZE, s_mock.getWriteSize(1));
+    TEST_ASSERT_EQUAL(0, storage.pending());
+
+    storage.closeFile(file);
+
+    char actual[1000];
+    TEST_ASSERT_EQUAL(800, readTestFile(actual, 1000));
+    TEST_ASSERT_EQUAL_MEMORY("abc,abc,", &actual[508], 8);
+}
+
+void test_LowerThresholdFlushesEarlier(void)
+{
+    BufferedLocalStorage storage(&s_mock, 10);
+    FILE_HANDLE file = openTestFile(storage);
+
+    storage.write(file, "123456");
+    TEST_ASSERT_EQUAL(0, s_mock.getWriteCount());
+    storage.write(file, "789012");
+    TEST_ASSERT_EQUAL(1, s_mock.getWriteCount());
+    TEST_ASSERT_EQUAL(10, s_mock.getWriteSize(0));
+    TEST_ASSERT_EQUAL(2, storage.pending());
+
+    storage.closeFile(file);
+}
+
+void test_LargeWritesPassWholeBlocksThrough(void)
+{
+    BufferedLocalStorage storage(&s_mock);
+    FILE_HANDLE file = openTestFile(storage);
+
+    uint8_t data[1100];
+    memset(data, 'x', sizeof(data));
+
+    storage.writeBytes(file, data, 1100);
+
+    TEST_ASSERT_EQUAL(2, s_mock.getWriteCount());
+    TEST_ASSERT_EQUAL(BUFFERED_STORAGE_BLOCK_SIZE, s_mock.getWriteSize(0));
+    TEST_ASSERT_EQUAL(BUFFERED_STORAGE_BLOCK_SIZE, s_mock.getWriteSize(1));
+    TEST_ASSERT_EQUAL(1100 - (2 * BUFFERED_STORAGE_BLOCK_SIZE), storage.pending());
+
+    storage.closeFile(file);
+    TEST_ASSERT_EQUAL(3, s_mock.getWriteCount());
+}
+
+void test_TickFlushesPendingDataAfterMaximumAge(void)
+{
+    BufferedLocalStorage storage(&s_mock, BUFFERED_STORAGE_BLOCK_SIZE, 1000);
+    FILE_HANDLE file = openTestFile(storage);
+
+    TEST_ASSERT_FALSE(storage.tick(0)); // Nothing pending
+
+    storage.write(file, "data");
+    TEST_ASSERT_FALSE(storage.tick(5000)); // Age is measured from here
+    TEST_ASSERT_FALSE(storage.tick(5999));
+    TEST_ASSERT_EQUAL(0, s_mock.getWriteCount());
+
+    TEST_ASSERT_TRUE(storage.tick(6000));
+    TEST_ASSERT_EQUAL(1, s_mock.getWriteCount());
+    TEST_ASSERT_EQUAL(4, s_mock.getWriteSize(0));
+
+    storage.write(file, "more");
+    TEST_ASSERT_FALSE(storage.tick(6500));
+    TEST_ASSERT_TRUE(storage.tick(7500));
+
+    storage.closeFile(file);
+}
+
+void test_TickDoesNotFlushWithoutMaximumAge(void)
+{
+    BufferedLocalStorage storage(&s_mock);
+    FILE_HANDLE file = openTestFile(storage);
+
+    storage.write(file, "data");
+    TEST_ASSERT_FALSE(storage.tick(0));
+    TEST_ASSERT_FALSE(storage.tick(100000));
+    TEST_ASSERT_EQUAL(0, s_mock.getWriteCount());
+
+    storage.closeFile(file);
+}
+
+void test_CloseAndReadFlushPendingData(void)
+{
+    BufferedLocalStorage storage(&s_mock);
+    FILE_HANDLE file = openTestFile(storage);
+
+    storage.write(file, "TEST LINE\r\n");
+    TEST_ASSERT_EQUAL(0, s_mock.getWriteCount());
+    storage.closeFile(file);
+    TEST_ASSERT_EQUAL(1, s_mock.getWriteCount());
+
+    char actual[20];
+    file = storage.openFile(TEST_FILE_PATH, false);
+    storage.readLine(file, actual, 20, true);
+    storage.closeFile(file);
+
+    TEST_ASSERT_EQUAL_STRING("TEST LINE", actual);
+}
+
+void test_StatsCountBytesAndFlushes(void)
+{
+    BufferedLocalStorage storage(&s_mock, 8);
+    FILE_HANDLE file = openTestFile(storage);
+
+    storage.write(file, "0123456789");
+    storage.write(file, "012345");
+    storage.flush();
+
+    BUFFERED_STORAGE_STATS const * stats = storage.getStats();
+    TEST_ASSERT_EQUAL(16, stats->bytesWritten);
+    TEST_ASSERT_EQUAL(16, stats->bytesFlushed);
+    TEST_ASSERT_EQUAL(2, stats->flushes);
+    TEST_ASSERT_TRUE(stats->maxFlushMicros <= stats->totalFlushMicros);
+
+    storage.resetStats();
+    TEST_ASSERT_EQUAL(0, storage.getStats()->flushes);
+
+    storage.closeFile(file);
+}
+
+void test_WritesAreEchoedWhenSet(void)
+{
+    BufferedLocalStorage storage(&s_mock);
+    FILE_HANDLE file = openTestFile(storage);
+
+    // Capture stdout while writing
+    fflush(stdout);
+    int savedStdout = dup(fileno(stdout));
+    TEST_ASSERT_NOT_NULL(freopen(TEST_ECHO_PATH, "w", stdout));
+
+    storage.setEcho(true);
+    storage.write(file, "abc,");
+    storage.flush();
+    storage.setEcho(false);
+    storage.write(file, "def,");
+    storage.flush();
+
+    fflush(stdout);
+    dup2(savedStdout, fileno(stdout));
+    close(savedStdout);
+
+    char echoed[20] = "";
+    FILE * pEcho = fopen(TEST_ECHO_PATH, "r");
+    TEST_ASSERT_NOT_NULL(pEcho);
+    TEST_ASSERT_NOT_NULL(fgets(echoed, sizeof(echoed), pEcho));
+    fclose(pEcho);
+
+    // Echoed once when written, not again when flushed
+    TEST_ASSERT_EQUAL_STRING("abc,", echoed);
+
+    storage.closeFile(file);
+}
+
+int main(void)
+{
+    UnityBegin("DLLocalStorage.Buffered.Test.cpp");
+
+    RUN_TEST(test_SmallWritesAreCoalescedIntoBlocks);
+    RUN_TEST(test_LowerThresholdFlushesEarlier);
+    RUN_TEST(test_LargeWritesPassWholeBlocksThrough);
+    RUN_TEST(test_TickFlushesPendingDataAfterMaximumAge);
+    RUN_TEST(test_TickDoesNotFlushWithoutMaximumAge);
+    RUN_TEST(test_CloseAndReadFlushPendingData);
+    RUN_TEST(test_StatsCountBytesAndFlushes);
+    RUN_TEST(test_WritesAreEchoedWhenSet);
+
+    return (UnityEnd());
+}
@@ -0,0 +1,14 @@
+INC_DIRS += -IDLLocalStorage
+INC_DIRS += -IDLUtility
+
+SRC_FILES += DLTest/DLTest.Mock.LocalStorage.cpp
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+SRC_FILES += DLLocalStorage/DLLocalStorage.Handles.cpp
+
+local_setup:
+	rm -f ./DLLocalStorage/Test/TestBuffered.csv
+	rm -f ./DLLocalStorage/Test/TestBufferedEcho.txt
+
+local_teardown:
+	rm -f ./DLLocalStorage/Test/TestBuffered.csv
+	rm -f ./DLLocalStorage/Test/TestBufferedEcho.txt
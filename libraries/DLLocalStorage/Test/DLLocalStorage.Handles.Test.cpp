@@ -0,0 +1,158 @@
+/*
+ * DLLocalStorage.Handles.Test.cpp
+ *
+ * Tests the storage handle table
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+void test_HandlesAreAddedUntilTableIsFull(void)
+{
+    StorageHandleTable table(2);
+    uint8_t i;
+
+    for (i = 0; i < STORAGE_MAX_HANDLES; i++)
+    {
+        TEST_ASSERT_EQUAL(i, table.add("file.csv", false));
+    }
+
+    TEST_ASSERT_EQUAL(INVALID_HANDLE, table.add("file.csv", false));
+    TEST_ASSERT_EQUAL(STORAGE_MAX_HANDLES, table.handleCount());
+
+    table.remove(3);
+    TEST_ASSERT_EQUAL(3, table.add("other.csv", true));
+}
+
+void test_HandleStoresPathAndMode(void)
+{
+    StorageHandleTable table(2);
+
+    FILE_HANDLE handle = table.add("data/file.csv", true);
+    STORAGE_HANDLE * pHandle = table.get(handle);
+
+    TEST_ASSERT_NOT_NULL(pHandle);
+    TEST_ASSERT_EQUAL_STRING("data/file.csv", pHandle->path);
+    TEST_ASSERT_TRUE(pHandle->forWrite);
+    TEST_ASSERT_EQUAL(STORAGE_NO_SLOT, pHandle->slot);
+}
+
+void test_InvalidHandlesAreRejected(void)
+{
+    StorageHandleTable table(2);
+    char longPath[STORAGE_MAX_PATH + 1];
+
+    memset(longPath, 'a', STORAGE_MAX_PATH);
+    longPath[STORAGE_MAX_PATH] = '\0';
+
+    TEST_ASSERT_EQUAL(INVALID_HANDLE, table.add(longPath, false));
+    TEST_ASSERT_EQUAL(INVALID_HANDLE, table.add(NULL, false));
+
+    TEST_ASSERT_NULL(table.get(INVALID_HANDLE));
+    TEST_ASSERT_NULL(table.get(STORAGE_MAX_HANDLES));
+    TEST_ASSERT_NULL(table.get(0)); // Not added yet
+}
+
+void test_FreeSlotsAreLimitedByMaxOpen(void)
+{
+    StorageHandleTable table(2);
+
+    FILE_HANDLE a = table.add("a", false);
+    FILE_HANDLE b = table.add("b", false);
+
+    TEST_ASSERT_EQUAL(0, table.freeSlot());
+    table.setOpen(a, 0);
+    TEST_ASSERT_EQUAL(1, table.freeSlot());
+    table.setOpen(b, 1);
+    TEST_ASSERT_EQUAL(STORAGE_NO_SLOT, table.freeSlot());
+    TEST_ASSERT_EQUAL(2, table.openCount());
+
+    table.setSuspended(a, 100);
+    TEST_ASSERT_EQUAL(0, table.freeSlot());
+    TEST_ASSERT_EQUAL(100, table.get(a)->position);
+}
+
+void test_LeastRecentlyUsedOpenHandleIsFound(void)
+{
+    StorageHandleTable table(2);
+
+    FILE_HANDLE a = table.add("a", false);
+    FILE_HANDLE b = table.add("b", false);
+    FILE_HANDLE c = table.add("c", false);
+
+    TEST_ASSERT_EQUAL(INVALID_HANDLE, table.leastRecentlyUsed());
+
+    table.setOpen(a, 0); table.touch(a);
+    table.setOpen(b, 1); table.touch(b);
+    TEST_ASSERT_EQUAL(a, table.leastRecentlyUsed());
+
+    table.touch(a);
+    TEST_ASSERT_EQUAL(b, table.leastRecentlyUsed());
+
+    // Suspended handles are never chosen, however old
+    table.touch(c);
+    table.setSuspended(b, 0);
+    TEST_ASSERT_EQUAL(a, table.leastRecentlyUsed());
+}
+
+void test_SingleOpenFileIsSharedBetweenHandles(void)
+{
+    // As on the LinkIt ONE, where only one file can be open at a time
+    StorageHandleTable table(1);
+
+    FILE_HANDLE write = table.add("log", true);
+    FILE_HANDLE read = table.add("backlog", false);
+
+    table.setOpen(write, 0); table.touch(write);
+    TEST_ASSERT_EQUAL(STORAGE_NO_SLOT, table.freeSlot());
+
+    // Reading the backlog suspends the log file...
+    TEST_ASSERT_EQUAL(write, table.leastRecentlyUsed());
+    table.setSuspended(write, 0);
+    table.setOpen(read, table.freeSlot()); table.touch(read);
+    TEST_ASSERT_EQUAL(1, table.openCount());
+
+    // ...and appending to the log suspends the backlog, keeping its position
+    TEST_ASSERT_EQUAL(read, table.leastRecentlyUsed());
+    table.setSuspended(read, 42);
+    table.setOpen(write, table.freeSlot()); table.touch(write);
+    TEST_ASSERT_EQUAL(1, table.openCount());
+    TEST_ASSERT_EQUAL(42, table.get(read)->position);
+    TEST_ASSERT_EQUAL(0, table.get(write)->slot);
+}
+
+int main(void)
+{
+    UnityBegin("DLLocalStorage.Handles.Test.cpp");
+
+    RUN_TEST(test_HandlesAreAddedUntilTableIsFull);
+    RUN_TEST(test_HandleStoresPathAndMode);
+    RUN_TEST(test_InvalidHandlesAreRejected);
+    RUN_TEST(test_FreeSlotsAreLimitedByMaxOpen);
+    RUN_TEST(test_LeastRecentlyUsedOpenHandleIsFound);
+    RUN_TEST(test_SingleOpenFileIsSharedBetweenHandles);
+
+    return (UnityEnd());
+}
@@ -0,0 +1,7 @@
+INC_DIRS += -IDLLocalStorage
+INC_DIRS += -IDLUtility
+
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+
+local_setup: ;
+local_teardown: ;
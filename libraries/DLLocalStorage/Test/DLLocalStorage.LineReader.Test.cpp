@@ -0,0 +1,159 @@
+/*
+ * DLLocalStorage.LineReader.Test.cpp
+ *
+ * Tests the buffered line reader
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLLocalStorage.h"
+#include "DLLocalStorage.LineReader.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define xstr(s) str(s)
+#define str(s) #s
+#define QUOTED_DL_PATH xstr(DL_PATH)
+
+#define TEST_FILE_PATH QUOTED_DL_PATH "/DLLocalStorage/Test/TestLines.txt"
+
+static LocalStorageInterface * s_storage;
+static FILE_HANDLE s_handle;
+static char s_buffer[1000];
+
+static void createTestFile(char const * const contents)
+{
+    FILE * f = fopen(TEST_FILE_PATH, "wb");
+    fputs(contents, f);
+    fclose(f);
+
+    s_handle = s_storage->openFile(TEST_FILE_PATH, false);
+}
+
+void setUp(void)
+{
+    s_storage = LocalStorage_GetLocalStorageInterface(LOCAL_STORAGE_TYPE(0));
+    s_handle = INVALID_HANDLE;
+    memset(s_buffer, 'A', sizeof(s_buffer));
+}
+
+void tearDown(void)
+{
+    s_storage->closeFile(s_handle);
+    s_storage->removeFile(TEST_FILE_PATH);
+}
+
+void test_LinesAreReadWithLineEndings(void)
+{
+    createTestFile("First\nSecond\r\nThird");
+    LineReader reader(s_storage, s_handle);
+
+    TEST_ASSERT_EQUAL(6, reader.readLine(s_buffer, 1000));
+    TEST_ASSERT_EQUAL_STRING("First\n", s_buffer);
+    TEST_ASSERT_EQUAL(8, reader.readLine(s_buffer, 1000));
+    TEST_ASSERT_EQUAL_STRING("Second\r\n", s_buffer);
+    TEST_ASSERT_FALSE(reader.endOfFile());
+    TEST_ASSERT_EQUAL(5, reader.readLine(s_buffer, 1000));
+    TEST_ASSERT_EQUAL_STRING("Third", s_buffer);
+    TEST_ASSERT_TRUE(reader.endOfFile());
+    TEST_ASSERT_EQUAL(0, reader.readLine(s_buffer, 1000));
+}
+
+void test_LineEndingsCanBeStripped(void)
+{
+    createTestFile("First\nSecond\r\n\r\nFourth\n");
+    LineReader reader(s_storage, s_handle);
+
+    TEST_ASSERT_EQUAL(5, reader.readLine(s_buffer, 1000, true));
+    TEST_ASSERT_EQUAL_STRING("First", s_buffer);
+    TEST_ASSERT_EQUAL(6, reader.readLine(s_buffer, 1000, true));
+    TEST_ASSERT_EQUAL_STRING("Second", s_buffer);
+    TEST_ASSERT_EQUAL(0, reader.readLine(s_buffer, 1000, true));
+    TEST_ASSERT_EQUAL_STRING("", s_buffer);
+    TEST_ASSERT_EQUAL(6, reader.readLine(s_buffer, 1000, true));
+    TEST_ASSERT_EQUAL_STRING("Fourth", s_buffer);
+    TEST_ASSERT_TRUE(reader.endOfFile());
+}
+
+void test_LinesCanSpanBlocks(void)
+{
+    char contents[LINE_READER_BLOCK_SIZE * 2];
+    uint32_t firstLength = LINE_READER_BLOCK_SIZE + 100;
+
+    memset(contents, 'x', firstLength);
+    contents[firstLength - 1] = '\n';
+    strcpy(&contents[firstLength], "Next\n");
+
+    createTestFile(contents);
+    LineReader reader(s_storage, s_handle);
+
+    TEST_ASSERT_EQUAL(firstLength, reader.readLine(s_buffer, 1000));
+    TEST_ASSERT_EQUAL_MEMORY(contents, s_buffer, firstLength);
+    TEST_ASSERT_EQUAL(5, reader.readLine(s_buffer, 1000));
+    TEST_ASSERT_EQUAL_STRING("Next\n", s_buffer);
+}
+
+void test_LongLinesAreReturnedInParts(void)
+{
+    createTestFile("0123456789ABCDE\nNext\n");
+    LineReader reader(s_storage, s_handle);
+
+    // No room for the NULL terminator when the buffer is filled
+    TEST_ASSERT_EQUAL(10, reader.readLine(s_buffer, 10));
+    TEST_ASSERT_EQUAL_MEMORY("0123456789", s_buffer, 10);
+    TEST_ASSERT_EQUAL('A', s_buffer[10]);
+
+    TEST_ASSERT_EQUAL(6, reader.readLine(s_buffer, 10));
+    TEST_ASSERT_EQUAL_STRING("ABCDE\n", s_buffer);
+    TEST_ASSERT_EQUAL(5, reader.readLine(s_buffer, 10));
+    TEST_ASSERT_EQUAL_STRING("Next\n", s_buffer);
+}
+
+void test_EmptyFileIsAtEndOfFile(void)
+{
+    createTestFile("");
+    LineReader reader(s_storage, s_handle);
+
+    TEST_ASSERT_TRUE(reader.endOfFile());
+    TEST_ASSERT_EQUAL(0, reader.readLine(s_buffer, 1000));
+    TEST_ASSERT_EQUAL_STRING("", s_buffer);
+}
+
+void test_InvalidHandleIsAtEndOfFile(void)
+{
+    LineReader reader(s_storage, INVALID_HANDLE);
+    TEST_ASSERT_TRUE(reader.endOfFile());
+    TEST_ASSERT_EQUAL(0, reader.readLine(s_buffer, 1000));
+}
+
+int main(void)
+{
+    UnityBegin("DLLocalStorage.LineReader.Test.cpp");
+
+    RUN_TEST(test_LinesAreReadWithLineEndings);
+    RUN_TEST(test_LineEndingsCanBeStripped);
+    RUN_TEST(test_LinesCanSpanBlocks);
+    RUN_TEST(test_LongLinesAreReturnedInParts);
+    RUN_TEST(test_EmptyFileIsAtEndOfFile);
+    RUN_TEST(test_InvalidHandleIsAtEndOfFile);
+
+    return (UnityEnd());
+}
@@ -0,0 +1,201 @@
+/*
+ * DLNetwork.ConnectionCache.cpp
+ *
+ * Cache of open connections for HTTP keep-alive
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLHTTP.h"
+#include "DLNetwork.ConnectionCache.h"
+
+/*
+ * Public Class Functions
+ */
+
+ConnectionCache::ConnectionCache(NetworkConnection ** connections, uint8_t count, uint32_t idleTimeoutMs)
+{
+    m_count = (count < NETWORK_MAX_CONNECTIONS) ? count : NETWORK_MAX_CONNECTIONS;
+    m_idleTimeoutMs = idleTimeoutMs;
+
+    uint8_t i;
+    for (i = 0; i < NETWORK_MAX_CONNECTIONS; i++)
+    {
+        m_slots[i].connection = (i < m_count) ? connections[i] : NULL;
+        m_slots[i].host[0] = '\0';
+        m_slots[i].port = 0;
+        m_slots[i].lastUsed = 0;
+        m_slots[i].inUse = false;
+    }
+
+    m_lastWasReused = false;
+    m_opened = 0;
+    m_reused = 0;
+}
+
+/*
+ * get
+ *
+ * Returns a connection to host:port, reusing an open one if possible.
+ * Returns NULL if no connection could be opened, or the host name is too long to keep.
+ */
+
+NetworkConnection * ConnectionCache::get(char const * const host, uint16_t port, uint32_t now)
+{
+    if (!host) { return NULL; }
+    if (strlen(host) >= NETWORK_MAX_HOST_LENGTH) { return NULL; }
+
+    m_lastWasReused = false;
+
+    int8_t slot = find(host, port);
+
+    if (slot >= 0)
+    {
+        if (!isExpired(slot, now) && m_slots[slot].connection->isOpen())
+        {
+            m_slots[slot].inUse = true;
+            m_slots[slot].lastUsed = now;
+            m_lastWasReused = true;
+            m_reused++;
+            return m_slots[slot].connection;
+        }
+
+        // Open the connection again in the same slot
+        closeSlot(slot);
+    }
+    else
+    {
+        slot = findFree();
+        if (slot < 0) { return NULL; }
+        closeSlot(slot);
+    }
+
+    if (!m_slots[slot].connection->open(host, port)) { return NULL; }
+
+    strncpy_safe(m_slots[slot].host, host, NETWORK_MAX_HOST_LENGTH);
+    m_slots[slot].port = port;
+    m_slots[slot].inUse = true;
+    m_slots[slot].lastUsed = now;
+    m_opened++;
+
+    return m_slots[slot].connection;
+}
+
+/*
+ * release
+ *
+ * Call when an exchange has finished. The connection is kept for reuse only if keepAlive is set
+ * (i.e. the response was completely read and the server did not ask to close).
+ */
+
+void ConnectionCache::release(NetworkConnection * connection, bool keepAlive, uint32_t now)
+{
+    uint8_t i;
+    for (i = 0; i < m_count; i++)
+    {
+        if (m_slots[i].connection == connection)
+        {
+            m_slots[i].inUse = false;
+            m_slots[i].lastUsed = now;
+            if (!keepAlive) { closeSlot(i); }
+            return;
+        }
+    }
+}
+
+void ConnectionCache::closeIdle(uint32_t now)
+{
+    uint8_t i;
+    for (i = 0; i < m_count; i++)
+    {
+        if (!m_slots[i].inUse && isExpired(i, now)) { closeSlot(i); }
+    }
+}
+
+void ConnectionCache::closeAll(void)
+{
+    uint8_t i;
+    for (i = 0; i < m_count; i++) { closeSlot(i); }
+}
+
+bool ConnectionCache::lastWasReused(void) { return m_lastWasReused; }
+uint16_t ConnectionCache::opened(void) { return m_opened; }
+uint16_t ConnectionCache::reused(void) { return m_reused; }
+
+/*
+ * Private Class Functions
+ */
+
+int8_t ConnectionCache::find(char const * const host, uint16_t port)
+{
+    uint8_t i;
+    for (i = 0; i < m_count; i++)
+    {
+        if (!m_slots[i].inUse && (m_slots[i].port == port) && (strcmp(m_slots[i].host, host) == 0))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * findFree
+ *
+ * Returns an unused slot (preferring one with no open connection),
+ * otherwise the least recently used idle slot, or -1 if all are in use.
+ */
+
+int8_t ConnectionCache::findFree(void)
+{
+    int8_t oldest = -1;
+
+    uint8_t i;
+    for (i = 0; i < m_count; i++)
+    {
+        if (m_slots[i].inUse) { continue; }
+        if (m_slots[i].host[0] == '\0') { return i; }
+
+        if ((oldest < 0) || ((int32_t)(m_slots[i].lastUsed - m_slots[oldest].lastUsed) < 0))
+        {
+            oldest = i;
+        }
+    }
+
+    return oldest;
+}
+
+bool ConnectionCache::isExpired(uint8_t slot, uint32_t now)
+{
+    return (now - m_slots[slot].lastUsed) > m_idleTimeoutMs;
+}
+
+void ConnectionCache::closeSlot(uint8_t slot)
+{
+    if (m_slots[slot].host[0] != '\0')
+    {
+        m_slots[slot].connection->close();
+    }
+    m_slots[slot].host[0] = '\0';
+    m_slots[slot].port = 0;
+    m_slots[slot].inUse = false;
+}
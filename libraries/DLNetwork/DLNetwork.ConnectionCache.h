@@ -0,0 +1,81 @@
+#ifndef _NETWORK_CONNECTION_CACHE_H_
+#define _NETWORK_CONNECTION_CACHE_H_
+
+/*
+ * ConnectionCache
+ *
+ * Keeps a small number of HTTP/1.1 connections open between requests, keyed by host,
+ * so that each request to the same host doesn't pay for a new TCP handshake and teardown.
+ *
+ * get() returns the open connection to a host if there is one, otherwise opens one in a free
+ * slot (closing the least recently used connection if there are none free). Host names
+ * too long to be kept whole are refused, rather than being matched on part of their name.
+ * After each exchange, release() either keeps the connection for reuse or closes it.
+ * Connections left idle for longer than the idle timeout are closed rather than reused,
+ * since the server will probably have closed its end by then.
+ *
+ * Times are passed in (e.g. from millis()) so the cache can be used without Arduino.
+ */
+
+#define NETWORK_MAX_CONNECTIONS (2)
+#define NETWORK_IDLE_TIMEOUT_MS (15000UL)
+
+// Longest host name (including the terminator) that can be connected to. This must be at least
+// as long as any service allows for its URL (e.g. Thingspeak's _MAX_URL_LENGTH), since the whole
+// name is kept to match later requests to the open connection.
+#define NETWORK_MAX_HOST_LENGTH (64)
+
+/*
+ * NetworkConnection
+ *
+ * A single connection (socket) that the cache can open and close.
+ */
+
+class NetworkConnection
+{
+    public:
+        virtual bool open(char const * const host, uint16_t port) = 0;
+        virtual bool isOpen(void) = 0;
+        virtual void close(void) = 0;
+};
+
+class ConnectionCache
+{
+    public:
+        ConnectionCache(NetworkConnection ** connections, uint8_t count, uint32_t idleTimeoutMs);
+
+        NetworkConnection * get(char const * const host, uint16_t port, uint32_t now);
+        void release(NetworkConnection * connection, bool keepAlive, uint32_t now);
+
+        void closeIdle(uint32_t now);
+        void closeAll(void);
+
+        bool lastWasReused(void);
+        uint16_t opened(void);
+        uint16_t reused(void);
+
+    private:
+        struct cache_slot
+        {
+            NetworkConnection * connection;
+            char host[NETWORK_MAX_HOST_LENGTH];
+            uint16_t port;
+            uint32_t lastUsed;
+            bool inUse;
+        };
+
+        int8_t find(char const * const host, uint16_t port);
+        int8_t findFree(void);
+        bool isExpired(uint8_t slot, uint32_t now);
+        void closeSlot(uint8_t slot);
+
+        struct cache_slot m_slots[NETWORK_MAX_CONNECTIONS];
+        uint8_t m_count;
+        uint32_t m_idleTimeoutMs;
+
+        bool m_lastWasReused;
+        uint16_t m_opened;
+        uint16_t m_reused;
+};
+
+#endif
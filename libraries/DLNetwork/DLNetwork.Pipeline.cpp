@@ -0,0 +1,151 @@
+/*
+ * DLNetwork.Pipeline.cpp
+ *
+ * Support for sending several HTTP requests over one connection without waiting for each response
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLHTTP.h"
+#include "DLNetwork.h"
+#include "DLNetwork.Pipeline.h"
+
+/*
+ * PipelinedResponses Public Class Functions
+ */
+
+PipelinedResponses::PipelinedResponses(char ** responses, uint8_t count) : m_copy(NULL, 0)
+{
+    m_responses = responses;
+    m_count = count;
+    m_received = 0;
+    m_closing = false;
+    m_anyStatus = false;
+
+    next();
+}
+
+/*
+ * feed
+ *
+ * Parses the next count bytes read from the connection, which may hold the end of one response
+ * and the start of the next. Returns the number of bytes used (fewer than count only once all
+ * the expected responses are complete).
+ */
+
+uint16_t PipelinedResponses::feed(const char * data, uint16_t count)
+{
+    uint16_t used = 0;
+
+    if (!data) { return 0; }
+
+    while ((used < count) && !isComplete())
+    {
+        uint16_t n = m_parser.feed(&data[used], count - used);
+
+        uint16_t i;
+        for (i = 0; i < n; i++) { m_copy.writeChar(data[used + i]); }
+        used += n;
+
+        m_anyStatus |= m_parser.gotStatus();
+
+        if (m_parser.isComplete())
+        {
+            m_received++;
+            if (!m_parser.allowsKeepAlive()) { m_closing = true; }
+            next();
+        }
+        else if (m_parser.isMalformed())
+        {
+            // Parsing stopped, so the rest of the connection can't be matched to requests
+            abandon();
+        }
+        else if (m_parser.gotHeaders() && (m_parser.getContentLength() == -1) && m_parser.connectionPersists())
+        {
+            // No Content-Length (e.g. a chunked body) and the server won't close: this response never ends
+            abandon();
+        }
+    }
+
+    return used;
+}
+
+/*
+ * end
+ *
+ * Call when the connection closes. A response with no Content-Length ends here.
+ */
+
+void PipelinedResponses::end(void)
+{
+    if (isComplete()) { return; }
+
+    m_parser.end();
+    abandon();
+}
+
+/*
+ * abandon
+ *
+ * Call when reading stops before the responses are complete (e.g. on a timeout).
+ * A response whose status line arrived is counted as received: its request was answered,
+ * even if where its body ends is not known. The connection must then be closed.
+ */
+
+void PipelinedResponses::abandon(void)
+{
+    if (isComplete()) { return; }
+
+    if (m_parser.gotStatus()) { m_received++; }
+    m_closing = true;
+}
+
+uint8_t PipelinedResponses::received(void) { return m_received; }
+
+// True once every expected response is in, or the server has said no more will come
+bool PipelinedResponses::isComplete(void) { return (m_received >= m_count) || m_closing; }
+
+bool PipelinedResponses::isClosing(void) { return m_closing; }
+
+// True if the connection can be reused after the last response
+bool PipelinedResponses::allowsKeepAlive(void) { return (m_received >= m_count) && !m_closing; }
+
+bool PipelinedResponses::gotStatus(void) { return m_anyStatus; }
+
+/*
+ * PipelinedResponses Private Class Functions
+ */
+
+// Gets ready for the next response
+void PipelinedResponses::next(void)
+{
+    m_parser.reset();
+
+    if ((m_received < m_count) && m_responses && m_responses[m_received])
+    {
+        m_copy.attach(m_responses[m_received], NETWORK_RESPONSE_LENGTH);
+    }
+    else
+    {
+        m_copy.attach(m_discard, 1);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef _NETWORK_PIPELINE_H_
+#define _NETWORK_PIPELINE_H_
+
+/*
+ * PipelinedResponses
+ *
+ * Splits the responses to several pipelined requests, read back to back from one connection,
+ * and matches them to the requests in order. Each response is fed through a ResponseParser;
+ * when it completes, any bytes left over start the next response.
+ *
+ * Each response is copied (up to NETWORK_RESPONSE_LENGTH chars including the terminator)
+ * into its own buffer. A NULL buffer means that response is read but not kept.
+ *
+ * Responses must give a Content-Length for the next one to be found. If one says the server
+ * will close the connection, the rest are not expected (and their requests must be sent again).
+ * A response that has its status line but can't be read to its end (no Content-Length on a
+ * kept-alive connection, a malformed Content-Length, a timeout or an early close) still counts
+ * as received, since its request was answered and must not be sent again. The connection is
+ * closed after it.
+ */
+
+class PipelinedResponses
+{
+    public:
+        PipelinedResponses(char ** responses, uint8_t count);
+
+        uint16_t feed(const char * data, uint16_t count);
+        void end(void);
+        void abandon(void);
+
+        uint8_t received(void);
+        bool isComplete(void);
+        bool isClosing(void);
+        bool allowsKeepAlive(void);
+        bool gotStatus(void);
+
+    private:
+        void next(void);
+
+        char ** m_responses;
+        uint8_t m_count;
+        uint8_t m_received;
+        bool m_closing;
+        bool m_anyStatus;
+
+        char m_discard[1];
+        ResponseParser m_parser;
+        FixedLengthAccumulator m_copy;
+};
+
+#endif
@@ -3,6 +3,11 @@
 
 #define HTTP_PORT (80)
 
+// Response buffers passed to sendHTTPRequest, streamHTTPRequest and sendPipelinedHTTPRequests
+// must hold at least this many chars
+#define NETWORK_RESPONSE_LENGTH (256)
+#define NETWORK_RESPONSE_TIMEOUT_MS (10000UL)
+
 enum network_interface
 {
     NETWORK_INTERFACE_LINKITONE_WIFI,
@@ -10,6 +15,12 @@ enum network_interface
 };
 typedef enum network_interface NETWORK_INTERFACE;
 
+/*
+ * Forward declarations of required classes
+ */
+
+class HTTPRequestStream;
+
 /*
  * NetworkInterface is a pure abstract class.
  * Each supported interface shall inherit from this base class
@@ -20,7 +31,28 @@ class NetworkInterface
     public: 
         virtual bool tryConnection(uint8_t timeoutSeconds) = 0;
         virtual bool sendHTTPRequest(const char * const url, const char * request, char * response, bool useHTTPS=false) = 0;
+
+        // Sends a request generated in chunks straight to the connection (see HTTPRequestStream)
+        virtual bool streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * response, bool useHTTPS=false) = 0;
         virtual bool isConnected(void) = 0;
+
+        // Sends count requests back to back on one connection, without waiting for each response,
+        // and reads the responses (in order) into responses. Returns the number of responses received:
+        // the requests after that need to be sent again.
+        // Interfaces that can't pipeline send the requests one at a time, stopping at the first failure.
+        virtual uint8_t sendPipelinedHTTPRequests(const char * const url, const char ** requests, uint8_t count, char ** responses)
+        {
+            uint8_t i;
+            for (i = 0; (i < count) && requests && responses; i++)
+            {
+                if (!sendHTTPRequest(url, requests[i], responses[i])) { break; }
+            }
+            return i;
+        }
+
+        // Closes kept-alive connections that have been idle too long (see ConnectionCache).
+        // Interfaces that don't keep connections open have nothing to do.
+        virtual void closeIdleConnections(void) {}
 };
 
 NetworkInterface * Network_GetNetwork(NETWORK_INTERFACE interface);
@@ -16,7 +16,8 @@ typedef enum connection_type CONNECTION_TYPE;
  * Forward class declarations
  */
 
-class LGPRSClient;
+class GPRSConnection;
+class ConnectionCache;
 
 class LinkItOneWiFi : public NetworkInterface
 {
@@ -25,6 +26,7 @@ class LinkItOneWiFi : public NetworkInterface
         ~LinkItOneWiFi();
         bool tryConnection(uint8_t timeoutSeconds);
         bool sendHTTPRequest(const char * const url, const char * request, char * response, bool useHTTPS);
+        bool streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * response, bool useHTTPS);
         bool isConnected(void);
         
     private:
@@ -38,6 +40,9 @@ class LinkItOneGPRS : public NetworkInterface
         ~LinkItOneGPRS();
         bool tryConnection(uint8_t timeoutSeconds);
         bool sendHTTPRequest(char const * const url, const char * request, char * response, bool useHTTPS=false);
+        bool streamHTTPRequest(char const * const url, HTTPRequestStream * request, char * response, bool useHTTPS=false);
+        uint8_t sendPipelinedHTTPRequests(const char * const url, const char ** requests, uint8_t count, char ** responses);
+        void closeIdleConnections(void);
         bool isConnected(void);
 
     private:
@@ -45,9 +50,12 @@ class LinkItOneGPRS : public NetworkInterface
         char * m_pUser;
         char * m_pPwd;
         bool m_connected;
-        LGPRSClient * m_client;
-        void readResponse(char *);
-        bool connect(char const * const url);
+        GPRSConnection * m_connections;
+        ConnectionCache * m_cache;
+        void createConnections(void);
+        GPRSConnection * connect(char const * const url);
+        bool exchange(char const * const url, const char * request, HTTPRequestStream * stream, char * response);
+        uint8_t readResponses(GPRSConnection * connection, char ** responses, uint8_t count);
 
 };
 
@@ -21,13 +21,45 @@
 #include <LGPRS.h>
 #include <LGPRSClient.h>
 
+#include "DLUtility.Strings.h"
 #include "DLNetwork.h"
+#include "DLHTTP.h"
+#include "DLNetwork.ConnectionCache.h"
+#include "DLNetwork.Pipeline.h"
 #include "DLNetwork.linkitone.h"
 
 /*
  * Private Variables
  */
 
+// A GPRS client that can be kept open in the connection cache
+class GPRSConnection : public NetworkConnection
+{
+    public:
+        bool open(char const * const host, uint16_t port) { return m_client.connect(host, port); }
+        bool isOpen(void) { return m_client.connected(); }
+        void close(void) { m_client.stop(); }
+        LGPRSClient * client(void) { return &m_client; }
+
+    private:
+        LGPRSClient m_client;
+};
+
+// Passes each chunk of a streamed request straight to the GPRS client
+class GPRSClientSink : public HTTPSink
+{
+    public:
+        GPRSClientSink(LGPRSClient * client) : m_client(client) {}
+
+        bool write(const char * data, uint32_t n)
+        {
+            return m_client->write((const uint8_t *)data, n) == n;
+        }
+
+    private:
+        LGPRSClient * m_client;
+};
+
  /*
  * Public Functions 
  */
@@ -38,7 +70,8 @@ LinkItOneGPRS::LinkItOneGPRS(char * apn, char * username, char * password)
     m_pUser = username;
     m_pPwd = password;
     m_connected = false;
-    m_client = NULL;
+    m_connections = NULL;
+    m_cache = NULL;
 }
 
 LinkItOneGPRS::~LinkItOneGPRS() {}
@@ -51,88 +84,221 @@ bool LinkItOneGPRS::tryConnection(uint8_t timeoutSeconds)
     while (!m_connected && (millis() < timeout))
     {
         m_connected = LGPRS.attachGPRS(m_pAPN, m_pUser, m_pPwd);
-        if(!m_client) { m_client = new LGPRSClient(); }
+        if(!m_cache) { createConnections(); }
     }
     return m_connected;
 }
 
-bool LinkItOneGPRS::connect(char const * const url)
+bool LinkItOneGPRS::sendHTTPRequest(const char * const url, const char * request, char * response, bool useHTTPS)
 {
-    bool success = m_connected && (m_client != NULL);
+    (void)useHTTPS; // Not currently supported with LinkItOne Arduino SDK
+
+    if (!request) { return false; }
+
+    return exchange(url, request, NULL, response);
+}
+
+bool LinkItOneGPRS::streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * response, bool useHTTPS)
+{
+    (void)useHTTPS; // Not currently supported with LinkItOne Arduino SDK
+
+    if (!request) { return false; }
+
+    return exchange(url, NULL, request, response);
+}
+
+/*
+ * sendPipelinedHTTPRequests
+ *
+ * Writes all the requests to one connection, then reads the responses back in order.
+ * Returns the number of responses received.
+ */
+
+uint8_t LinkItOneGPRS::sendPipelinedHTTPRequests(const char * const url, const char ** requests, uint8_t count, char ** responses)
+{
+    if (!requests || (count == 0)) { return 0; }
+
+    GPRSConnection * connection = connect(url);
 
-    if (success)
+    if (!connection)
     {
-        Serial.print("LinkItOneGPRS::connect: Have GPRS. Trying to connect to ");
-        Serial.print(url);
-        Serial.print("...");
-        success &= m_client->connect(url, HTTP_PORT);
-        Serial.println(success ? " connected." : " failed.");
+        Serial.print("LinkItOneGPRS::sendPipelinedHTTPRequests: Failed to connect to ");
+        Serial.println(url);
+        return 0;
     }
-    else
+
+    uint8_t sent;
+    for (sent = 0; sent < count; sent++)
     {
-        if (!m_connected) { Serial.println("LinkItOneGPRS::connect: No GRPS connection!"); }
-        if (!m_client)  { Serial.println("LinkItOneGPRS::connect: No LGPRSClient!"); }
+        if (!requests[sent]) { break; }
+        if (connection->client()->print(requests[sent]) != strlen(requests[sent])) { break; }
     }
-    
-    return success;
+
+    if (sent == 0)
+    {
+        Serial.println("LinkItOneGPRS::sendPipelinedHTTPRequests: send failed");
+        m_cache->release(connection, false, millis());
+        return 0;
+    }
+
+    return readResponses(connection, responses, sent);
 }
 
-bool LinkItOneGPRS::sendHTTPRequest(const char * const url, const char * request, char * response, bool useHTTPS)
+void LinkItOneGPRS::closeIdleConnections(void)
 {
-    (void)useHTTPS; // Not currently supported with LinkItOne Arduino SDK
+    if (m_cache) { m_cache->closeIdle(millis()); }
+}
+
+bool LinkItOneGPRS::isConnected(void) { return m_connected; }
+
+/*
+ * Private Functions
+ */
+
+void LinkItOneGPRS::createConnections(void)
+{
+    NetworkConnection * connections[NETWORK_MAX_CONNECTIONS];
+
+    m_connections = new GPRSConnection[NETWORK_MAX_CONNECTIONS];
+
+    uint8_t i;
+    for (i = 0; i < NETWORK_MAX_CONNECTIONS; i++) { connections[i] = &m_connections[i]; }
+
+    m_cache = new ConnectionCache(connections, NETWORK_MAX_CONNECTIONS, NETWORK_IDLE_TIMEOUT_MS);
+}
+
+GPRSConnection * LinkItOneGPRS::connect(char const * const url)
+{
+    if (!m_connected || !m_cache)
+    {
+        if (!m_connected) { Serial.println("LinkItOneGPRS::connect: No GRPS connection!"); }
+        if (!m_cache)  { Serial.println("LinkItOneGPRS::connect: No LGPRSClient!"); }
+        return NULL;
+    }
 
-    bool success = connect(url);
+    m_cache->closeIdle(millis());
 
-    if (success)
+    GPRSConnection * connection = (GPRSConnection *)m_cache->get(url, HTTP_PORT, millis());
+
+    if (m_cache->lastWasReused())
     {
-        Serial.println("LinkItOneGPRS::sendHTTPRequest: sending");
-        m_client->print(request);
-        Serial.println("LinkItOneGPRS::sendHTTPRequest: reading response");
-        readResponse(response);
+        Serial.print("LinkItOneGPRS::connect: Reusing connection to ");
+        Serial.println(url);
     }
     else
     {
-        Serial.print("LinkItOneGPRS::sendHTTPRequest: Failed to connect to ");
-        Serial.println(url);
+        Serial.print("LinkItOneGPRS::connect: Have GPRS. Trying to connect to ");
+        Serial.print(url);
+        Serial.println(connection ? "... connected." : "... failed.");
     }
-    return success;
+
+    return connection;
 }
 
-void LinkItOneGPRS::readResponse(char * response)
+/*
+ * exchange
+ *
+ * Sends either a buffered or a streamed request and reads the response.
+ * A reused connection may have been closed by the server since it was last used,
+ * so if that gets no response the request is sent once more on a new connection.
+ * It is only sent again if no status line came back: once the server has answered,
+ * sending it again could repeat a POST that was already accepted.
+ */
+
+bool LinkItOneGPRS::exchange(char const * const url, const char * request, HTTPRequestStream * stream, char * response)
 {
-    // if there are incoming bytes available
-    // from the server, read them and print them:
-    uint16_t i = 0;
-    
-    if (m_connected && response)
+    uint8_t attempt;
+    for (attempt = 0; attempt < 2; attempt++)
     {
+        GPRSConnection * connection = connect(url);
 
-        // if the server's disconnected, stop the m_client:
-        if (m_client->connected())
+        if (!connection)
         {
-            if(m_client->available())
-            {
-                char next;
-                do
-                {
-                    next = m_client->read();
-                    response[i++] = next > -1 ?  next : '\0';
-                    
-                } while (next > -1);
-            }
-            else
-            {
-                //Serial.println("Client not available");
-            }
+            Serial.print("LinkItOneGPRS::exchange: Failed to connect to ");
+            Serial.println(url);
+            return false;
+        }
+
+        bool reused = m_cache->lastWasReused();
+        bool sent;
+
+        Serial.println("LinkItOneGPRS::exchange: sending");
+        if (stream)
+        {
+            GPRSClientSink sink(connection->client());
+            sent = stream->writeTo(&sink);
         }
         else
         {
+            sent = connection->client()->print(request) == strlen(request);
+        }
 
-            Serial.println("LinkItOneGPRS::readResponse: Disconnecting from client");
-            m_client->stop();
+        if (sent)
+        {
+            Serial.println("LinkItOneGPRS::exchange: reading response");
+            // readResponses counts the response if its status line arrived, even if its end didn't
+            if (readResponses(connection, &response, 1) == 1) { return true; }
         }
-        
+        else
+        {
+            Serial.println("LinkItOneGPRS::exchange: send failed");
+            m_cache->release(connection, false, millis());
+        }
+
+        if (!reused) { break; }
     }
+
+    return false;
 }
 
-bool LinkItOneGPRS::isConnected(void) { return m_connected; }
+/*
+ * readResponses
+ *
+ * Reads count responses in small chunks through PipelinedResponses. Each response is read
+ * completely (framed by its Content-Length) so that the connection can be used again, but at most
+ * NETWORK_RESPONSE_LENGTH chars (including the terminator) are copied into each response buffer.
+ * The connection is then kept in the cache or closed, as the responses allow.
+ * A response whose end can't be found (or doesn't arrive in time) still counts once its
+ * status line is in, and the connection is closed after it.
+ * Returns the number of responses received.
+ */
+
+uint8_t LinkItOneGPRS::readResponses(GPRSConnection * connection, char ** responses, uint8_t count)
+{
+    LGPRSClient * client = connection->client();
+    PipelinedResponses pipeline(responses, count);
+    char chunk[32];
+    unsigned long timeout = millis() + NETWORK_RESPONSE_TIMEOUT_MS;
+
+    while (!pipeline.isComplete() && (millis() < timeout))
+    {
+        int n = client->available();
+
+        if (n <= 0)
+        {
+            if (!client->connected())
+            {
+                pipeline.end(); // Body with no Content-Length ends when the server closes
+                break;
+            }
+            continue;
+        }
+
+        if (n > (int)sizeof(chunk)) { n = sizeof(chunk); }
+        n = client->read((uint8_t *)chunk, n);
+        if (n <= 0) { continue; }
+
+        pipeline.feed(chunk, n);
+    }
+
+    pipeline.abandon(); // Timed out (if not complete)
+
+    if (!pipeline.gotStatus())
+    {
+        Serial.println("LinkItOneGPRS::readResponses: No response");
+    }
+
+    m_cache->release(connection, pipeline.allowsKeepAlive(), millis());
+
+    return pipeline.received();
+}
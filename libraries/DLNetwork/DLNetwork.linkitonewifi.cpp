@@ -53,4 +53,14 @@ bool LinkItOneWiFi::sendHTTPRequest(const char * const url, const char * request
 	return false;
 }
 
+bool LinkItOneWiFi::streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * response, bool useHTTPS)
+{
+	// WIFI FUNCTIONALITY NOT YET IMPLEMENTED
+	(void)url;
+	(void)request;
+	(void)response;
+	(void)useHTTPS;
+	return false;
+}
+
 bool LinkItOneWiFi::isConnected(void) { return false; }
@@ -0,0 +1,271 @@
+/*
+ * DLNetwork.ConnectionCache.Test.cpp
+ *
+ * Tests the keep-alive connection cache
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLHTTP.h"
+#include "DLNetwork.ConnectionCache.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define TEST_PORT (80)
+#define TEST_TIMEOUT_MS (1000)
+
+// Round trips taken by a TCP handshake and teardown, against one for each request
+#define HANDSHAKE_ROUND_TRIPS (2)
+
+// Stands in for a socket to a local HTTP server, counting the connections made to it
+class StubConnection : public NetworkConnection
+{
+    public:
+        StubConnection() : opens(0), closes(0), open_(false), refuse(false) { host[0] = '\0'; }
+
+        bool open(char const * const toHost, uint16_t port)
+        {
+            (void)port;
+            if (refuse) { return false; }
+            opens++;
+            open_ = true;
+            strcpy(host, toHost);
+            return true;
+        }
+
+        bool isOpen(void) { return open_; }
+        void close(void) { closes++; open_ = false; }
+
+        // Simulate the server closing its end
+        void drop(void) { open_ = false; }
+
+        uint16_t opens;
+        uint16_t closes;
+        bool open_;
+        bool refuse;
+        char host[NETWORK_MAX_HOST_LENGTH];
+};
+
+static StubConnection s_connections[NETWORK_MAX_CONNECTIONS];
+static NetworkConnection * s_pConnections[NETWORK_MAX_CONNECTIONS];
+
+static ConnectionCache * makeCache(void)
+{
+    for (uint8_t i = 0; i < NETWORK_MAX_CONNECTIONS; i++)
+    {
+        s_connections[i] = StubConnection();
+        s_pConnections[i] = &s_connections[i];
+    }
+
+    static ConnectionCache * s_cache = NULL;
+    delete s_cache;
+    s_cache = new ConnectionCache(s_pConnections, NETWORK_MAX_CONNECTIONS, TEST_TIMEOUT_MS);
+    return s_cache;
+}
+
+static uint16_t totalOpens(void)
+{
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < NETWORK_MAX_CONNECTIONS; i++) { total += s_connections[i].opens; }
+    return total;
+}
+
+// Makes count requests 100ms apart and returns the round trips they took
+static uint16_t makeRequests(ConnectionCache * cache, uint16_t count, bool keepAlive)
+{
+    uint32_t now = 0;
+    uint16_t before = totalOpens();
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        NetworkConnection * connection = cache->get("api.thingspeak.com", TEST_PORT, now);
+        if (!connection) { return 0; }
+        cache->release(connection, keepAlive, now);
+        now += 100;
+    }
+
+    return ((totalOpens() - before) * HANDSHAKE_ROUND_TRIPS) + count;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_RequestsToSameHostReuseConnection(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    uint16_t roundTrips = makeRequests(cache, 10, true);
+
+    TEST_ASSERT_EQUAL(1, cache->opened());
+    TEST_ASSERT_EQUAL(9, cache->reused());
+    TEST_ASSERT_EQUAL(1, totalOpens());
+    TEST_ASSERT_EQUAL(10 + HANDSHAKE_ROUND_TRIPS, roundTrips);
+}
+
+void test_ConnectionsAreClosedWithoutKeepAlive(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    uint16_t roundTrips = makeRequests(cache, 10, false);
+
+    TEST_ASSERT_EQUAL(10, cache->opened());
+    TEST_ASSERT_EQUAL(0, cache->reused());
+    TEST_ASSERT_EQUAL(10, s_connections[0].closes);
+    TEST_ASSERT_EQUAL(10 * (1 + HANDSHAKE_ROUND_TRIPS), roundTrips);
+}
+
+void test_IdleConnectionsAreNotReused(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    NetworkConnection * first = cache->get("api.thingspeak.com", TEST_PORT, 0);
+    cache->release(first, true, 0);
+
+    NetworkConnection * second = cache->get("api.thingspeak.com", TEST_PORT, TEST_TIMEOUT_MS + 1);
+    TEST_ASSERT_FALSE(cache->lastWasReused());
+    TEST_ASSERT_EQUAL_PTR(first, second);
+    TEST_ASSERT_EQUAL(1, s_connections[0].closes);
+    TEST_ASSERT_EQUAL(2, s_connections[0].opens);
+}
+
+void test_ConnectionsClosedByServerAreReopened(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    NetworkConnection * connection = cache->get("api.thingspeak.com", TEST_PORT, 0);
+    cache->release(connection, true, 0);
+    s_connections[0].drop();
+
+    cache->get("api.thingspeak.com", TEST_PORT, 10);
+    TEST_ASSERT_FALSE(cache->lastWasReused());
+    TEST_ASSERT_EQUAL(2, cache->opened());
+}
+
+void test_HostsHaveSeparateConnections(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    NetworkConnection * a = cache->get("a.example.com", TEST_PORT, 0);
+    cache->release(a, true, 0);
+    NetworkConnection * b = cache->get("b.example.com", TEST_PORT, 10);
+    cache->release(b, true, 10);
+
+    TEST_ASSERT_TRUE(a != b);
+
+    TEST_ASSERT_EQUAL_PTR(a, cache->get("a.example.com", TEST_PORT, 20));
+    TEST_ASSERT_TRUE(cache->lastWasReused());
+    cache->release(a, true, 20);
+
+    // A third host takes the least recently used connection (b)
+    NetworkConnection * c = cache->get("c.example.com", TEST_PORT, 30);
+    TEST_ASSERT_EQUAL_PTR(b, c);
+    TEST_ASSERT_EQUAL_STRING("c.example.com", ((StubConnection *)c)->host);
+}
+
+void test_ConnectionsInUseAreNotShared(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    NetworkConnection * a = cache->get("api.thingspeak.com", TEST_PORT, 0);
+    NetworkConnection * b = cache->get("api.thingspeak.com", TEST_PORT, 0);
+    TEST_ASSERT_TRUE(a != b);
+
+    // No connections left
+    TEST_ASSERT_NULL(cache->get("api.thingspeak.com", TEST_PORT, 0));
+}
+
+void test_CloseIdleOnlyClosesExpiredConnections(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    NetworkConnection * a = cache->get("a.example.com", TEST_PORT, 0);
+    cache->release(a, true, 0);
+    NetworkConnection * b = cache->get("b.example.com", TEST_PORT, 500);
+    cache->release(b, true, 500);
+
+    cache->closeIdle(TEST_TIMEOUT_MS + 100);
+
+    TEST_ASSERT_FALSE(a->isOpen());
+    TEST_ASSERT_TRUE(b->isOpen());
+}
+
+void test_FailedOpenReturnsNull(void)
+{
+    ConnectionCache * cache = makeCache();
+    s_connections[0].refuse = true;
+
+    TEST_ASSERT_NULL(cache->get("api.thingspeak.com", TEST_PORT, 0));
+    TEST_ASSERT_EQUAL(0, cache->opened());
+}
+
+void test_LongHostNamesAreMatchedInFull(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    // Longer than MAX_HOST_LENGTH, and only differ in their last characters
+    char const * hostA = "datalogger-uploads.eu-west.example.com.a";
+    char const * hostB = "datalogger-uploads.eu-west.example.com.b";
+
+    NetworkConnection * a = cache->get(hostA, TEST_PORT, 0);
+    cache->release(a, true, 0);
+
+    TEST_ASSERT_EQUAL_PTR(a, cache->get(hostA, TEST_PORT, 10));
+    TEST_ASSERT_TRUE(cache->lastWasReused());
+    cache->release(a, true, 10);
+
+    TEST_ASSERT_TRUE(a != cache->get(hostB, TEST_PORT, 20));
+    TEST_ASSERT_FALSE(cache->lastWasReused());
+}
+
+void test_HostNamesTooLongToKeepAreRefused(void)
+{
+    ConnectionCache * cache = makeCache();
+
+    char host[NETWORK_MAX_HOST_LENGTH + 1];
+    memset(host, 'a', NETWORK_MAX_HOST_LENGTH);
+    host[NETWORK_MAX_HOST_LENGTH] = '\0';
+
+    TEST_ASSERT_NULL(cache->get(host, TEST_PORT, 0));
+    TEST_ASSERT_EQUAL(0, totalOpens());
+
+    host[NETWORK_MAX_HOST_LENGTH - 1] = '\0';
+    TEST_ASSERT_NOT_NULL(cache->get(host, TEST_PORT, 0));
+}
+
+int main(void)
+{
+    UnityBegin("DLNetwork.ConnectionCache.Test.cpp");
+
+    RUN_TEST(test_RequestsToSameHostReuseConnection);
+    RUN_TEST(test_ConnectionsAreClosedWithoutKeepAlive);
+    RUN_TEST(test_IdleConnectionsAreNotReused);
+    RUN_TEST(test_ConnectionsClosedByServerAreReopened);
+    RUN_TEST(test_HostsHaveSeparateConnections);
+    RUN_TEST(test_ConnectionsInUseAreNotShared);
+    RUN_TEST(test_CloseIdleOnlyClosesExpiredConnections);
+    RUN_TEST(test_FailedOpenReturnsNull);
+    RUN_TEST(test_LongHostNamesAreMatchedInFull);
+    RUN_TEST(test_HostNamesTooLongToKeepAreRefused);
+
+    return (UnityEnd());
+}
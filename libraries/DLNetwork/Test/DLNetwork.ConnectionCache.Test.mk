@@ -0,0 +1,9 @@
+INC_DIRS += -IDLNetwork
+INC_DIRS += -IDLUtility
+INC_DIRS += -IDLHTTP
+
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+
+local_setup: ;
+
+local_teardown: ;
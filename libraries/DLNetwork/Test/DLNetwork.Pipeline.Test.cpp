@@ -0,0 +1,325 @@
+/*
+ * DLNetwork.Pipeline.Test.cpp
+ *
+ * Tests matching pipelined HTTP responses to their requests
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLHTTP.h"
+#include "DLNetwork.h"
+#include "DLNetwork.Pipeline.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define TEST_REQUESTS (5)
+#define ROUND_TRIP_MS (800) // Typical of a GPRS link
+
+// Answers each request with its entry number, and can close the connection after a number of requests
+class StubServer
+{
+    public:
+        StubServer() : entry(0), closeAfter(0) { output[0] = '\0'; }
+
+        void respond(void)
+        {
+            char body[8];
+            entry++;
+            sprintf(body, "%d", entry);
+
+            bool close = (closeAfter > 0) && (entry == closeAfter);
+
+            sprintf(&output[strlen(output)], "HTTP/1.1 200 OK\r\n%sContent-Length: %d\r\n\r\n%s",
+                close ? "Connection: close\r\n" : "", (int)strlen(body), body);
+        }
+
+        int entry;
+        int closeAfter;
+        char output[1024];
+};
+
+// A link to the stub server that adds a round trip of latency each time it waits for a response
+class StubNetwork : public NetworkInterface
+{
+    public:
+        StubNetwork(bool pipeline) : elapsedMs(0), m_pipeline(pipeline) {}
+
+        bool tryConnection(uint8_t timeoutSeconds) { (void)timeoutSeconds; return true; }
+        bool isConnected(void) { return true; }
+
+        bool sendHTTPRequest(const char * const url, const char * request, char * response, bool useHTTPS)
+        {
+            (void)url; (void)request; (void)useHTTPS;
+            server.output[0] = '\0';
+            server.respond();
+            elapsedMs += ROUND_TRIP_MS;
+            strcpy(response, server.output);
+            return true;
+        }
+
+        bool streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * response, bool useHTTPS)
+        {
+            (void)url; (void)request; (void)response; (void)useHTTPS;
+            return false;
+        }
+
+        uint8_t sendPipelinedHTTPRequests(const char * const url, const char ** requests, uint8_t count, char ** responses)
+        {
+            if (!m_pipeline) { return NetworkInterface::sendPipelinedHTTPRequests(url, requests, count, responses); }
+
+            // All requests go out together, so there is one wait for all the responses
+            server.output[0] = '\0';
+            for (uint8_t i = 0; i < count; i++) { server.respond(); }
+            elapsedMs += ROUND_TRIP_MS;
+
+            // Responses arrive in 7 byte chunks, split anywhere
+            PipelinedResponses pipeline(responses, count);
+            uint16_t length = strlen(server.output);
+            for (uint16_t i = 0; (i < length) && !pipeline.isComplete(); i += 7)
+            {
+                pipeline.feed(&server.output[i], (length - i) < 7 ? (length - i) : 7);
+            }
+            return pipeline.received();
+        }
+
+        StubServer server;
+        uint32_t elapsedMs;
+
+    private:
+        bool m_pipeline;
+};
+
+static const char * s_requests[TEST_REQUESTS] = {
+    "POST /update HTTP/1.1\r\nContent-Length: 3\r\n\r\n1=1",
+    "POST /update HTTP/1.1\r\nContent-Length: 3\r\n\r\n1=2",
+    "POST /update HTTP/1.1\r\nContent-Length: 3\r\n\r\n1=3",
+    "POST /update HTTP/1.1\r\nContent-Length: 3\r\n\r\n1=4",
+    "POST /update HTTP/1.1\r\nContent-Length: 3\r\n\r\n1=5",
+};
+
+static char s_responseBuffers[TEST_REQUESTS][NETWORK_RESPONSE_LENGTH];
+static char * s_responses[TEST_REQUESTS];
+
+static const char * bodyOf(char const * response)
+{
+    char const * body = strstr(response, "\r\n\r\n");
+    return body ? body + 4 : "";
+}
+
+void setUp(void)
+{
+    for (uint8_t i = 0; i < TEST_REQUESTS; i++)
+    {
+        s_responseBuffers[i][0] = '\0';
+        s_responses[i] = s_responseBuffers[i];
+    }
+}
+
+void tearDown(void) {}
+
+void test_ResponsesAreMatchedInOrder(void)
+{
+    StubServer server;
+    for (uint8_t i = 0; i < 3; i++) { server.respond(); }
+
+    PipelinedResponses pipeline(s_responses, 3);
+    TEST_ASSERT_EQUAL(strlen(server.output), pipeline.feed(server.output, strlen(server.output)));
+
+    TEST_ASSERT_TRUE(pipeline.isComplete());
+    TEST_ASSERT_TRUE(pipeline.allowsKeepAlive());
+    TEST_ASSERT_EQUAL(3, pipeline.received());
+    TEST_ASSERT_EQUAL_STRING("1", bodyOf(s_responses[0]));
+    TEST_ASSERT_EQUAL_STRING("2", bodyOf(s_responses[1]));
+    TEST_ASSERT_EQUAL_STRING("3", bodyOf(s_responses[2]));
+}
+
+void test_ResponsesCanBeSplitAnywhere(void)
+{
+    StubServer server;
+    for (uint8_t i = 0; i < 3; i++) { server.respond(); }
+
+    PipelinedResponses pipeline(s_responses, 3);
+    uint16_t length = strlen(server.output);
+    for (uint16_t i = 0; i < length; i++)
+    {
+        pipeline.feed(&server.output[i], 1);
+        if (i < length - 1) { TEST_ASSERT_FALSE(pipeline.isComplete()); }
+    }
+
+    TEST_ASSERT_EQUAL(3, pipeline.received());
+    TEST_ASSERT_EQUAL_STRING("3", bodyOf(s_responses[2]));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK\r\nContent-Length: 1\r\n\r\n2", s_responses[1]);
+}
+
+void test_ClosingResponseEndsThePipeline(void)
+{
+    StubServer server;
+    server.closeAfter = 2;
+    for (uint8_t i = 0; i < 2; i++) { server.respond(); }
+
+    PipelinedResponses pipeline(s_responses, 4);
+    pipeline.feed(server.output, strlen(server.output));
+
+    // The last two requests were not answered and must be sent again
+    TEST_ASSERT_TRUE(pipeline.isComplete());
+    TEST_ASSERT_TRUE(pipeline.isClosing());
+    TEST_ASSERT_FALSE(pipeline.allowsKeepAlive());
+    TEST_ASSERT_EQUAL(2, pipeline.received());
+}
+
+void test_ConnectionClosedPartWayThrough(void)
+{
+    StubServer server;
+    for (uint8_t i = 0; i < 2; i++) { server.respond(); }
+
+    PipelinedResponses pipeline(s_responses, 3);
+    pipeline.feed(server.output, strlen(server.output) - 1);
+    TEST_ASSERT_EQUAL(1, pipeline.received());
+
+    // The second response was cut short, but its request was answered. The third got no answer.
+    pipeline.end();
+    TEST_ASSERT_TRUE(pipeline.isComplete());
+    TEST_ASSERT_EQUAL(2, pipeline.received());
+}
+
+void test_KeptAliveResponseWithoutContentLengthCountsOnceHeadersArrive(void)
+{
+    char const chunked[] = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n1\r\n1\r\n";
+
+    PipelinedResponses pipeline(s_responses, 2);
+    pipeline.feed(chunked, strlen(chunked));
+
+    // The end of the body can't be found, so nothing more is expected and the connection must close
+    TEST_ASSERT_TRUE(pipeline.isComplete());
+    TEST_ASSERT_FALSE(pipeline.allowsKeepAlive());
+    TEST_ASSERT_EQUAL(1, pipeline.received());
+    TEST_ASSERT_EQUAL_STRING(chunked, s_responses[0]);
+}
+
+void test_ClosingResponseWithoutContentLengthEndsWithTheConnection(void)
+{
+    char const response[] = "HTTP/1.1 200 OK\r\nConnection: close\r\n\r\n1";
+
+    PipelinedResponses pipeline(s_responses, 1);
+    pipeline.feed(response, strlen(response));
+    TEST_ASSERT_FALSE(pipeline.isComplete());
+
+    pipeline.end();
+    TEST_ASSERT_EQUAL(1, pipeline.received());
+    TEST_ASSERT_EQUAL_STRING("1", bodyOf(s_responses[0]));
+}
+
+void test_AbandonedResponseCountsOnlyIfItsStatusArrived(void)
+{
+    char const partStatus[] = "HTTP/1.1 2";
+    char const partBody[] = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\n1";
+
+    PipelinedResponses noStatus(s_responses, 1);
+    noStatus.feed(partStatus, strlen(partStatus));
+    noStatus.abandon();
+    TEST_ASSERT_TRUE(noStatus.isComplete());
+    TEST_ASSERT_FALSE(noStatus.allowsKeepAlive());
+    TEST_ASSERT_EQUAL(0, noStatus.received());
+
+    PipelinedResponses withStatus(s_responses, 1);
+    withStatus.feed(partBody, strlen(partBody));
+    withStatus.abandon();
+    TEST_ASSERT_TRUE(withStatus.isComplete());
+    TEST_ASSERT_FALSE(withStatus.allowsKeepAlive());
+    TEST_ASSERT_EQUAL(1, withStatus.received());
+}
+
+void test_NullResponseBuffersAreSkipped(void)
+{
+    StubServer server;
+    for (uint8_t i = 0; i < 2; i++) { server.respond(); }
+
+    s_responses[0] = NULL;
+    PipelinedResponses pipeline(s_responses, 2);
+    pipeline.feed(server.output, strlen(server.output));
+
+    TEST_ASSERT_EQUAL(2, pipeline.received());
+    TEST_ASSERT_EQUAL_STRING("2", bodyOf(s_responses[1]));
+}
+
+void test_BytesAfterTheLastResponseAreNotUsed(void)
+{
+    StubServer server;
+    for (uint8_t i = 0; i < 2; i++) { server.respond(); }
+
+    PipelinedResponses pipeline(s_responses, 1);
+    uint16_t used = pipeline.feed(server.output, strlen(server.output));
+
+    TEST_ASSERT_EQUAL(strlen(s_responses[0]), used);
+    TEST_ASSERT_EQUAL(1, pipeline.received());
+}
+
+void test_PipeliningSavesRoundTrips(void)
+{
+    StubNetwork sequential(false);
+    StubNetwork pipelined(true);
+
+    TEST_ASSERT_EQUAL(TEST_REQUESTS, sequential.sendPipelinedHTTPRequests("localhost", s_requests, TEST_REQUESTS, s_responses));
+    TEST_ASSERT_EQUAL_STRING("5", bodyOf(s_responses[4]));
+
+    setUp();
+    TEST_ASSERT_EQUAL(TEST_REQUESTS, pipelined.sendPipelinedHTTPRequests("localhost", s_requests, TEST_REQUESTS, s_responses));
+    TEST_ASSERT_EQUAL_STRING("1", bodyOf(s_responses[0]));
+    TEST_ASSERT_EQUAL_STRING("5", bodyOf(s_responses[4]));
+
+    TEST_ASSERT_EQUAL(TEST_REQUESTS * ROUND_TRIP_MS, sequential.elapsedMs);
+    TEST_ASSERT_EQUAL(ROUND_TRIP_MS, pipelined.elapsedMs);
+}
+
+void test_MalformedResponseEndsThePipeline(void)
+{
+    char const response[] = "HTTP/1.1 200 OK\r\nContent-Length: -5\r\n\r\nHTTP/1.1 200 OK\r\n";
+
+    PipelinedResponses pipeline(s_responses, 2);
+    uint16_t used = pipeline.feed(response, strlen(response));
+
+    // Its status was received, but the connection can't be read any further
+    TEST_ASSERT_TRUE(used <= strlen(response));
+    TEST_ASSERT_TRUE(pipeline.isComplete());
+    TEST_ASSERT_FALSE(pipeline.allowsKeepAlive());
+    TEST_ASSERT_EQUAL(1, pipeline.received());
+    TEST_ASSERT_EQUAL_STRING("", s_responses[1]);
+}
+
+int main(void)
+{
+    UnityBegin("DLNetwork.Pipeline.Test.cpp");
+
+    RUN_TEST(test_ResponsesAreMatchedInOrder);
+    RUN_TEST(test_ResponsesCanBeSplitAnywhere);
+    RUN_TEST(test_ClosingResponseEndsThePipeline);
+    RUN_TEST(test_ConnectionClosedPartWayThrough);
+    RUN_TEST(test_KeptAliveResponseWithoutContentLengthCountsOnceHeadersArrive);
+    RUN_TEST(test_ClosingResponseWithoutContentLengthEndsWithTheConnection);
+    RUN_TEST(test_AbandonedResponseCountsOnlyIfItsStatusArrived);
+    RUN_TEST(test_MalformedResponseEndsThePipeline);
+    RUN_TEST(test_NullResponseBuffersAreSkipped);
+    RUN_TEST(test_BytesAfterTheLastResponseAreNotUsed);
+    RUN_TEST(test_PipeliningSavesRoundTrips);
+
+    return (UnityEnd());
+}
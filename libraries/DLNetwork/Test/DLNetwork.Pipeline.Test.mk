@@ -0,0 +1,11 @@
+INC_DIRS += -IDLNetwork
+INC_DIRS += -IDLUtility
+INC_DIRS += -IDLHTTP
+
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+SRC_FILES += DLHTTP/DLHTTP.ResponseParser.cpp
+SRC_FILES += DLHTTP/DLHTTP.Header.cpp
+
+local_setup: ;
+
+local_teardown: ;
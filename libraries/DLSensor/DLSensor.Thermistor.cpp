@@ -96,4 +96,120 @@ float Thermistor::ResistanceFromTemperature(float t)
 float Thermistor::Rinf(void)
 {
 	return m_Rinf;
-}
\ No newline at end of file
+}
+
+ThermistorLUT::ThermistorLUT(float B, float R25, bool highSide) : m_thermistor(B, R25, highSide)
+{
+	m_B = B;
+	m_R25 = R25;
+	m_highSide = highSide;
+	m_table = NULL;
+	m_ownsTable = false;
+	m_size = 0;
+	m_otherResistor = 0.0f;
+	m_maxReading = 0;
+	m_readingsPerEntry = 0.0f;
+	m_entriesPerReading = 0.0f;
+}
+
+ThermistorLUT::~ThermistorLUT()
+{
+	if (m_ownsTable) { delete[] m_table; }
+}
+
+/*
+ * build
+ *
+ * (Re)builds the table with tableSize entries evenly spaced from 0 to maxReading.
+ * Larger tables are more accurate but use more RAM (4 bytes per entry).
+ * The table is either allocated here or supplied by the caller (e.g. from an arena),
+ * in which case it must have space for tableSize entries and is not freed by the LUT.
+ */
+bool ThermistorLUT::build(float otherResistor, uint16_t maxReading, uint16_t tableSize)
+{
+	if ((tableSize < 4) || (maxReading == 0)) { return build(otherResistor, maxReading, tableSize, NULL); }
+
+	float * table = new float[tableSize];
+	if (!table) { return false; }
+
+	bool built = build(otherResistor, maxReading, tableSize, table);
+	m_ownsTable = true;
+	return built;
+}
+
+bool ThermistorLUT::build(float otherResistor, uint16_t maxReading, uint16_t tableSize, float * table)
+{
+	if (m_ownsTable) { delete[] m_table; }
+	m_table = NULL;
+	m_ownsTable = false;
+	m_size = 0;
+
+	// At least one interpolated segment is needed between the two Beta equation segments
+	if ((tableSize < 4) || (maxReading == 0) || !table) { return false; }
+
+	m_table = table;
+	m_size = tableSize;
+	m_otherResistor = otherResistor;
+	m_maxReading = maxReading;
+	m_readingsPerEntry = (float)maxReading / (tableSize - 1);
+	m_entriesPerReading = 1.0f / m_readingsPerEntry;
+
+	uint16_t i;
+	for (i = 0; i < tableSize; i++)
+	{
+		m_table[i] = m_thermistor.TemperatureFromADCReading(otherResistor, i * m_readingsPerEntry, maxReading);
+	}
+
+	return true;
+}
+
+/*
+ * setThermistor
+ *
+ * Changes the thermistor the table is for. The table must then be rebuilt.
+ */
+void ThermistorLUT::setThermistor(float B, float R25, bool highSide)
+{
+	m_thermistor = Thermistor(B, R25, highSide);
+	m_B = B;
+	m_R25 = R25;
+	m_highSide = highSide;
+	m_size = 0;
+}
+
+/*
+ * builtFrom
+ *
+ * Returns true if the table was built for these thermistor and circuit values,
+ * so callers can tell when their settings have changed and the table needs rebuilding.
+ */
+bool ThermistorLUT::builtFrom(float B, float R25, bool highSide, float otherResistor, uint16_t maxReading)
+{
+	return m_size && (m_B == B) && (m_R25 == R25) && (m_highSide == highSide)
+		&& (m_otherResistor == otherResistor) && (m_maxReading == maxReading);
+}
+
+uint16_t ThermistorLUT::size(void)
+{
+	return m_size;
+}
+
+float ThermistorLUT::TemperatureFromADCReading(float reading)
+{
+	if (!m_table || (m_size == 0))
+	{
+		return m_thermistor.TemperatureFromADCReading(m_otherResistor, reading, m_maxReading);
+	}
+
+	float position = reading * m_entriesPerReading;
+
+	if ((position < 1.0f) || (position >= (float)(m_size - 2)))
+	{
+		return m_thermistor.TemperatureFromADCReading(m_otherResistor, reading, m_maxReading);
+	}
+
+	uint16_t index = (uint16_t)position;
+	float fraction = position - index;
+
+	return m_table[index] + ((m_table[index + 1] - m_table[index]) * fraction);
+}
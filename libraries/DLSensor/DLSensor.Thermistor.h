@@ -23,6 +23,47 @@ class Thermistor
 		bool m_highSide;
 };
 
+/*
+ * ThermistorLUT
+ *
+ * Lookup table of temperature against ADC reading for one thermistor channel,
+ * with linear interpolation between entries. Built once per channel so that
+ * converting a reading does not need a log() call.
+ * The first and last table segments (where temperature changes fastest)
+ * fall back to the Beta equation.
+ *
+ * For a 10k, B=3000 thermistor against 10k on a 10-bit ADC, the error versus the
+ * Beta equation between -40C and 125C is under 0.1C with 128 entries (0.4C with 64).
+ */
+
+#define THERMISTOR_LUT_DEFAULT_SIZE 128
+
+class ThermistorLUT
+{
+	public:
+		ThermistorLUT(float B, float R25, bool highSide);
+		~ThermistorLUT();
+		bool build(float otherResistor, uint16_t maxReading, uint16_t tableSize);
+		bool build(float otherResistor, uint16_t maxReading, uint16_t tableSize, float * table);
+		void setThermistor(float B, float R25, bool highSide);
+		bool builtFrom(float B, float R25, bool highSide, float otherResistor, uint16_t maxReading);
+		uint16_t size(void);
+		float TemperatureFromADCReading(float reading);
+
+	private:
+		Thermistor m_thermistor;
+		float m_B;
+		float m_R25;
+		bool m_highSide;
+		float * m_table;
+		bool m_ownsTable;
+		uint16_t m_size;
+		float m_otherResistor;
+		uint16_t m_maxReading;
+		float m_readingsPerEntry;
+		float m_entriesPerReading;
+};
+
 Thermistor * getHighsideThermistor(float B, float R25);
 Thermistor * getLowsideThermistor(float B, float R25);
 
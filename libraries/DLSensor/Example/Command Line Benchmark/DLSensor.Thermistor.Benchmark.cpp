@@ -0,0 +1,99 @@
+/*
+ * DLSensor.Thermistor.Benchmark.cpp
+ *
+ * Compares thermistor conversion using the Beta equation
+ * against the interpolated lookup table
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#include <iostream>
+
+#include "DLSensor.Thermistor.h"
+
+#define N_READINGS (24UL * 60UL * 60UL)
+#define REPEATS 20
+
+#define B 3000.0f
+#define R25 10000.0f
+#define OTHER_R 10000.0f
+#define MAX_ADC 1023
+
+static float s_readings[N_READINGS];
+static float s_temperatures[N_READINGS];
+
+static double elapsedMs(clock_t start)
+{
+    return 1000.0 * (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char * argv[])
+{
+    (void)argc; (void)argv;
+
+    uint32_t i;
+    uint8_t r;
+    clock_t start;
+    float check = 0.0f;
+
+    Thermistor thermistor(B, R25, true);
+
+    // Readings between about -30C and 100C
+    for (i = 0; i < N_READINGS; i++)
+    {
+        s_readings[i] = 80.0f + (float)(i % 8000) / 10.0f;
+    }
+
+    std::cout << "Converting " << N_READINGS << " readings " << REPEATS << " times" << std::endl;
+
+    start = clock();
+    for (r = 0; r < REPEATS; r++)
+    {
+        for (i = 0; i < N_READINGS; i++)
+        {
+            s_temperatures[i] = thermistor.TemperatureFromADCReading(OTHER_R, s_readings[i], MAX_ADC);
+        }
+        check += s_temperatures[r];
+    }
+    double betaMs = elapsedMs(start);
+    std::cout << "Beta equation: " << betaMs << "ms" << std::endl;
+
+    uint16_t sizes[] = {32, 64, 128, 256, 1024};
+    for (uint8_t s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++)
+    {
+        ThermistorLUT lut(B, R25, true);
+        lut.build(OTHER_R, MAX_ADC, sizes[s]);
+
+        start = clock();
+        for (r = 0; r < REPEATS; r++)
+        {
+            for (i = 0; i < N_READINGS; i++)
+            {
+                s_temperatures[i] = lut.TemperatureFromADCReading(s_readings[i]);
+            }
+            check += s_temperatures[r];
+        }
+        double lutMs = elapsedMs(start);
+
+        float maxError = 0.0f;
+        for (i = 0; i < N_READINGS; i++)
+        {
+            float error = fabsf(s_temperatures[i] - thermistor.TemperatureFromADCReading(OTHER_R, s_readings[i], MAX_ADC));
+            if (error > maxError) { maxError = error; }
+        }
+
+        std::cout << "LUT (" << sizes[s] << " entries): " << lutMs << "ms (x" << (betaMs / lutMs) << ")";
+        std::cout << ", max error " << maxError << "C" << std::endl;
+    }
+
+    // Stops the compiler optimising away the conversions
+    std::cout << "(Checksum " << check << ")" << std::endl;
+
+    return 0;
+}
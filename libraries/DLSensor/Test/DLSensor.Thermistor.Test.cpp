@@ -163,6 +163,58 @@ void test_lowsideEmpiricallyDeterminedValuesFromADC(void)
 	TEST_ASSERT_FLOAT_WITHIN_MESSAGE(expected, temp, expected/100, messageBuffer);
 }
 
+static void testLUTAgainstBetaEquation(bool highside, uint16_t tableSize, float tolerance)
+{
+	Thermistor thermistor(BETA, RESISTANCE_AT_25C, highside);
+	ThermistorLUT lut(BETA, RESISTANCE_AT_25C, highside);
+
+	TEST_ASSERT_TRUE(lut.build(10000.0, 1023, tableSize));
+	TEST_ASSERT_EQUAL(tableSize, lut.size());
+
+	float reading;
+	for (reading = 1.0f; reading < 1023.0f; reading += 0.25f)
+	{
+		float expected = thermistor.TemperatureFromADCReading(10000.0, reading, 1023);
+
+		// Only check the useful range of the thermistor
+		if ((expected < -40.0f) || (expected > 125.0f)) { continue; }
+
+		float actual = lut.TemperatureFromADCReading(reading);
+		sprintf(messageBuffer, "reading = %f, expected = %f, actual = %f", reading, expected, actual);
+		TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance, expected, actual, messageBuffer);
+	}
+}
+
+void test_highsideLUTMatchesBetaEquation(void)
+{
+	testLUTAgainstBetaEquation(true, THERMISTOR_LUT_DEFAULT_SIZE, 0.1f);
+	testLUTAgainstBetaEquation(true, 256, 0.025f);
+}
+
+void test_lowsideLUTMatchesBetaEquation(void)
+{
+	testLUTAgainstBetaEquation(false, THERMISTOR_LUT_DEFAULT_SIZE, 0.1f);
+	testLUTAgainstBetaEquation(false, 256, 0.025f);
+}
+
+void test_LUTIsExactAtTableEntries(void)
+{
+	ThermistorLUT lut(BETA, RESISTANCE_AT_25C, true);
+	lut.build(10000.0, 1023, 32);
+
+	float step = 1023.0f / 31;
+	float reading = step * 15;
+	TEST_ASSERT_EQUAL_FLOAT(highsideT.TemperatureFromADCReading(10000.0, reading, 1023), lut.TemperatureFromADCReading(reading));
+}
+
+void test_LUTRejectsInvalidSizes(void)
+{
+	ThermistorLUT lut(BETA, RESISTANCE_AT_25C, true);
+	TEST_ASSERT_FALSE(lut.build(10000.0, 1023, 3));
+	TEST_ASSERT_FALSE(lut.build(10000.0, 0, 64));
+	TEST_ASSERT_EQUAL(0, lut.size());
+}
+
 int main(void)
 {
 	UnityBegin("DLSensor.Thermistor.Test.cpp");
@@ -178,5 +230,10 @@ int main(void)
 	RUN_TEST(test_highsideEmpiricallyDeterminedValuesFromADC);
 	RUN_TEST(test_lowsideEmpiricallyDeterminedValuesFromADC);
 
+	RUN_TEST(test_highsideLUTMatchesBetaEquation);
+	RUN_TEST(test_lowsideLUTMatchesBetaEquation);
+	RUN_TEST(test_LUTIsExactAtTableEntries);
+	RUN_TEST(test_LUTRejectsInvalidSizes);
+
 	return (UnityEnd());
 }
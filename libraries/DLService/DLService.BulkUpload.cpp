@@ -0,0 +1,241 @@
+/*
+ * DLService.BulkUpload.cpp
+ *
+ * CSV data sources and request streams for bulk uploads to internet based services
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLLocalStorage.h"
+#include "DLHTTP.h"
+#include "DLService.h"
+#include "DLService.BulkUpload.h"
+
+/*
+ * Public Functions
+ */
+
+/*
+ * CSV_WholeRowsLength
+ *
+ * Returns the length of the whole rows (ending in '\n') at the start of data,
+ * stopping before the first cancelled row. If the first row is itself cancelled,
+ * *cancelled is set to its length so that the caller can skip it (otherwise it is 0).
+ */
+uint32_t CSV_WholeRowsLength(const char * data, uint32_t count, uint32_t * cancelled)
+{
+    uint32_t length = 0;
+    uint32_t i;
+
+    if (cancelled) { *cancelled = 0; }
+    if (!data) { return 0; }
+
+    for (i = 0; i < count; i++)
+    {
+        if (data[i] != '\n') { continue; }
+
+        if ((i > length) && (data[i - 1] == CSV_CANCELLED_ROW_MARK))
+        {
+            if ((length == 0) && cancelled) { *cancelled = i + 1; }
+            break;
+        }
+
+        length = i + 1;
+    }
+
+    return length;
+}
+
+/*
+ * CSVStringSource Public Class Functions
+ */
+
+CSVStringSource::CSVStringSource(const char * csvData)
+{
+    m_csvData = csvData;
+    m_done = false;
+}
+
+void CSVStringSource::rewind(void) { m_done = false; }
+
+const char * CSVStringSource::nextChunk(uint32_t * length)
+{
+    if (m_done || !m_csvData || !length) { return NULL; }
+
+    m_done = true;
+    *length = strlen(m_csvData);
+
+    return (*length > 0) ? m_csvData : NULL;
+}
+
+/*
+ * CSVFileSource Public Class Functions
+ */
+
+CSVFileSource::CSVFileSource(LocalStorageInterface * storage, FILE_HANDLE file, uint32_t start, uint32_t maxBytes)
+{
+    m_storage = storage;
+    m_file = file;
+    m_start = start;
+    m_maxBytes = (maxBytes > 0) ? maxBytes : 0xFFFFFFFFUL;
+    rewind();
+}
+
+void CSVFileSource::rewind(void)
+{
+    m_fill = 0;
+    m_returned = 0;
+    m_bytesRead = 0;
+    m_bytesReturned = 0;
+    m_rows = 0;
+    m_skipping = false;
+    m_skipped = 0;
+    m_eof = (m_file == INVALID_HANDLE) || !m_storage->seek(m_file, m_start);
+}
+
+/*
+ * nextChunk
+ *
+ * Tops up the block from the file and returns all the whole rows in it.
+ * Any part row at the end is kept and completed by the next read.
+ * Rows that can never be returned are skipped (see class description).
+ */
+const char * CSVFileSource::nextChunk(uint32_t * length)
+{
+    if (!length) { return NULL; }
+
+    // Move any part row left from the last chunk to the start of the block
+    dropFromBlock(m_returned);
+    m_returned = 0;
+
+    uint32_t cancelled;
+    uint32_t i;
+
+    while (true)
+    {
+        if (m_skipping)
+        {
+            // Discard the rest of an unsendable row. It only counts as read once its end is found.
+            if (m_fill == 0) { readIntoBlock(CSV_FILE_SOURCE_BLOCK_SIZE); }
+            if (m_fill == 0) { return NULL; }
+
+            char * pEnd = (char *)memchr(m_block, '\n', m_fill);
+            if (!pEnd)
+            {
+                m_skipped += m_fill;
+                m_fill = 0;
+                continue;
+            }
+
+            i = (pEnd - m_block) + 1;
+            m_bytesRead += m_skipped + i;
+            m_skipped = 0;
+            m_skipping = false;
+            dropFromBlock(i);
+        }
+
+        // Never return more than maxBytes in total. Skipping can leave more than that in the block.
+        uint32_t limit = m_maxBytes - m_bytesReturned;
+        readIntoBlock((limit > m_fill) ? (limit - m_fill) : 0);
+        uint32_t usable = (m_fill < limit) ? m_fill : limit;
+
+        i = CSV_WholeRowsLength(m_block, usable, &cancelled);
+
+        if (cancelled > 0)
+        {
+            m_bytesRead += cancelled;
+            dropFromBlock(cancelled);
+            continue;
+        }
+
+        if (i > 0) { break; }
+
+        // No whole row: a row that fills the block, or is the first row and fills maxBytes, can never be returned
+        bool rowTooLong = (usable == CSV_FILE_SOURCE_BLOCK_SIZE) || ((m_bytesReturned == 0) && (m_fill >= limit));
+        if (!rowTooLong) { return NULL; }
+
+        // The skip starts from the beginning of the block, which is the start of this row
+        m_skipping = true;
+        m_skipped = 0;
+    }
+
+    m_returned = i;
+    m_bytesRead += i;
+    m_bytesReturned += i;
+
+    uint32_t j;
+    for (j = 0; j < i; j++)
+    {
+        if (m_block[j] == '\n') { m_rows++; }
+    }
+
+    *length = i;
+    return m_block;
+}
+
+uint32_t CSVFileSource::bytesRead(void) { return m_bytesRead; }
+
+uint16_t CSVFileSource::rows(void) { return m_rows; }
+
+/*
+ * CSVFileSource Private Class Functions
+ */
+
+// Reads up to maxToRead more bytes from the file into the free part of the block
+void CSVFileSource::readIntoBlock(uint32_t maxToRead)
+{
+    uint32_t toRead = CSV_FILE_SOURCE_BLOCK_SIZE - m_fill;
+    if (toRead > maxToRead) { toRead = maxToRead; }
+
+    if (m_eof || (toRead == 0)) { return; }
+
+    uint32_t count = m_storage->readBytes(m_file, &m_block[m_fill], toRead);
+    if (count < toRead) { m_eof = true; }
+    m_fill += count;
+}
+
+// Removes n bytes from the start of the block
+void CSVFileSource::dropFromBlock(uint32_t n)
+{
+    if (n == 0) { return; }
+
+    memmove(m_block, &m_block[n], m_fill - n);
+    m_fill -= n;
+}
+
+/*
+ * BulkUploadRequest Public Class Functions
+ */
+
+BulkUploadRequest::BulkUploadRequest(ServiceInterface * service, CSVDataSource * source, const char * filename, uint8_t nFields)
+{
+    m_service = service;
+    m_source = source;
+    m_filename = filename;
+    m_nFields = nFields;
+}
+
+bool BulkUploadRequest::writeTo(HTTPSink * sink)
+{
+    if (!m_service) { return false; }
+    return m_service->writeBulkUpload(sink, m_source, m_filename, m_nFields);
+}
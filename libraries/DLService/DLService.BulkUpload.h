@@ -0,0 +1,123 @@
+#ifndef _SERVICE_BULK_UPLOAD_H_
+#define _SERVICE_BULK_UPLOAD_H_
+
+/*
+ * Streaming bulk uploads
+ *
+ * A bulk upload request is generated twice: once into an HTTPLengthCounter to find the
+ * Content-Length, then again into the real sink (e.g. the network connection).
+ * The CSV data is pulled in chunks from a CSVDataSource, which is rewound before each pass,
+ * so neither the request nor the CSV data has to be held in RAM.
+ */
+
+#define CSV_FILE_SOURCE_BLOCK_SIZE (256)
+
+/*
+ * Cancelled rows
+ *
+ * A row that ends with CSV_CANCELLED_ROW_MARK (just before its '\n') is never uploaded.
+ * UploadQueue uses this to close off a row that was only partly written (e.g. on power loss).
+ */
+
+#define CSV_CANCELLED_ROW_MARK ('\x18')
+
+uint32_t CSV_WholeRowsLength(const char * data, uint32_t count, uint32_t * cancelled);
+
+/*
+ * CSVDataSource
+ *
+ * Provides CSV data in chunks. nextChunk returns a pointer to the next chunk (valid until
+ * the next call) and its length, or NULL when there is no more data.
+ */
+
+class CSVDataSource
+{
+    public:
+        virtual void rewind(void) = 0;
+        virtual const char * nextChunk(uint32_t * length) = 0;
+};
+
+/*
+ * CSVStringSource
+ *
+ * CSV data already in RAM, returned as a single chunk.
+ */
+
+class CSVStringSource : public CSVDataSource
+{
+    public:
+        CSVStringSource(const char * csvData);
+
+        void rewind(void);
+        const char * nextChunk(uint32_t * length);
+
+    private:
+        const char * m_csvData;
+        bool m_done;
+};
+
+/*
+ * CSVFileSource
+ *
+ * Up to maxBytes of CSV data read from a file on local storage, starting at offset start
+ * (maxBytes of 0 means to the end of the file). The file should be open for reading.
+ *
+ * Only whole rows (ending in '\n') are returned, so a part written last row is left out.
+ * Rows that can never be returned are skipped: cancelled rows, rows of CSV_FILE_SOURCE_BLOCK_SIZE
+ * bytes or more, and a first row longer than maxBytes. Skipped rows are not returned, but do count
+ * towards bytesRead(), so a caller that moves on by bytesRead() moves past them.
+ * After a pass, bytesRead() and rows() give the amount of data that was read and returned.
+ */
+
+class CSVFileSource : public CSVDataSource
+{
+    public:
+        CSVFileSource(LocalStorageInterface * storage, FILE_HANDLE file, uint32_t start, uint32_t maxBytes);
+
+        void rewind(void);
+        const char * nextChunk(uint32_t * length);
+
+        uint32_t bytesRead(void);
+        uint16_t rows(void);
+
+    private:
+        void readIntoBlock(uint32_t maxToRead);
+        void dropFromBlock(uint32_t n);
+
+        LocalStorageInterface * m_storage;
+        FILE_HANDLE m_file;
+        uint32_t m_start;
+        uint32_t m_maxBytes;
+
+        char m_block[CSV_FILE_SOURCE_BLOCK_SIZE];
+        uint16_t m_fill;
+        uint16_t m_returned;
+
+        uint32_t m_bytesRead;
+        uint32_t m_bytesReturned;
+        uint16_t m_rows;
+        bool m_skipping;
+        uint32_t m_skipped;
+        bool m_eof;
+};
+
+/*
+ * BulkUploadRequest
+ *
+ * Adapts a service's bulk upload to an HTTPRequestStream, for NetworkInterface::streamHTTPRequest.
+ */
+
+class BulkUploadRequest : public HTTPRequestStream
+{
+    public:
+        BulkUploadRequest(ServiceInterface * service, CSVDataSource * source, const char * filename, uint8_t nFields);
+        bool writeTo(HTTPSink * sink);
+
+    private:
+        ServiceInterface * m_service;
+        CSVDataSource * m_source;
+        const char * m_filename;
+        uint8_t m_nFields;
+};
+
+#endif
@@ -0,0 +1,371 @@
+/*
+ * DLService.UploadQueue.cpp
+ *
+ * Persistent queue of CSV rows for bulk upload to internet based services
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLLocalStorage.h"
+#include "DLNetwork.h"
+#include "DLService.h"
+#include "DLHTTP.h"
+#include "DLService.BulkUpload.h"
+#include "DLService.UploadQueue.h"
+
+/*
+ * Private Functions
+ */
+
+static void putU32(uint8_t * p, uint32_t value)
+{
+    p[0] = (uint8_t)(value);
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t getU32(uint8_t const * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*
+ * Public Class Functions
+ */
+
+UploadQueue::UploadQueue(LocalStorageInterface * storage, char const * const queuePath, char const * const cursorPath)
+{
+    m_storage = storage;
+    m_queuePath = queuePath;
+    m_cursorPath = cursorPath;
+    m_size = 0;
+    m_cursor = 0;
+    m_batchLength = 0;
+}
+
+/*
+ * begin
+ *
+ * Picks up any backlog (and its cursor) left on storage from a previous run.
+ * If the last row was only partly written (e.g. power was lost during enqueue), it is
+ * closed off as a cancelled row, so it is never uploaded and new rows start on a line of their own.
+ */
+bool UploadQueue::begin(void)
+{
+    m_size = 0;
+    m_batchLength = 0;
+
+    if (m_storage->fileExists(m_queuePath))
+    {
+        FILE_HANDLE queue = m_storage->openFile(m_queuePath, false);
+        if (queue == INVALID_HANDLE) { return false; }
+
+        char last = '\n';
+        m_size = m_storage->fileSize(queue);
+        if ((m_size > 0) && m_storage->seek(queue, m_size - 1))
+        {
+            m_storage->readBytes(queue, &last, 1);
+        }
+        m_storage->closeFile(queue);
+
+        if (last != '\n')
+        {
+            char const cancel[] = {CSV_CANCELLED_ROW_MARK, '\n', '\0'};
+            if (!enqueue(cancel)) { return false; }
+        }
+    }
+
+    m_cursor = readCursor();
+
+    // A cursor past the end of the queue is left over from an interrupted reset
+    if (m_cursor >= m_size) { reset(); }
+
+    return !m_storage->inError();
+}
+
+/*
+ * enqueue
+ *
+ * Appends a row (which should end with "\r\n") to the queue.
+ */
+bool UploadQueue::enqueue(char const * const row)
+{
+    if (!row) { return false; }
+
+    FILE_HANDLE queue = m_storage->openFile(m_queuePath, true);
+    if (queue == INVALID_HANDLE) { return false; }
+
+    m_storage->write(queue, row);
+    m_storage->closeFile(queue);
+
+    m_size += strlen(row);
+
+    return true;
+}
+
+/*
+ * pending
+ *
+ * Returns the number of bytes in the queue not yet acknowledged.
+ */
+uint32_t UploadQueue::pending(void) { return m_size - m_cursor; }
+
+/*
+ * readBatch
+ *
+ * Reads as many whole rows from the cursor as fit in buffer (including the NULL terminator)
+ * and returns the number of rows read. A row too long to ever fit in the buffer is skipped,
+ * as is a cancelled row (the batch stops before one, and it is skipped when it is first).
+ * The rows are not removed from the queue until acknowledge() is called.
+ */
+uint16_t UploadQueue::readBatch(char * buffer, uint32_t maxLength)
+{
+    m_batchLength = 0;
+
+    if (!buffer || (maxLength < 2)) { return 0; }
+    buffer[0] = '\0';
+
+    if (pending() == 0) { return 0; }
+
+    FILE_HANDLE queue = m_storage->openFile(m_queuePath, false);
+    if (queue == INVALID_HANDLE) { return 0; }
+
+    uint32_t count;
+    uint32_t cancelled;
+    uint32_t skipped;
+    uint32_t length = 0;
+    uint16_t rows = 0;
+    uint32_t i;
+    char * pEnd;
+
+    while ((pending() > 0) && m_storage->seek(queue, m_cursor))
+    {
+        count = m_storage->readBytes(queue, buffer, maxLength - 1);
+
+        i = CSV_WholeRowsLength(buffer, count, &cancelled);
+
+        if (cancelled > 0)
+        {
+            m_cursor += cancelled;
+            writeCursor();
+            continue;
+        }
+
+        if ((i > 0) || (count < (maxLength - 1)))
+        {
+            length = i;
+            break;
+        }
+
+        // No newline in a full buffer, so this row can never be sent: skip past its end
+        skipped = count;
+        pEnd = NULL;
+        while (!pEnd && ((count = m_storage->readBytes(queue, buffer, maxLength - 1)) > 0))
+        {
+            pEnd = (char *)memchr(buffer, '\n', count);
+            skipped += pEnd ? (uint32_t)((pEnd - buffer) + 1) : count;
+        }
+
+        if (!pEnd) { break; }
+
+        m_cursor += skipped;
+        writeCursor();
+    }
+
+    m_storage->closeFile(queue);
+
+    // Everything left was skipped
+    if (pending() == 0) { reset(); }
+
+    buffer[length] = '\0';
+    m_batchLength = length;
+
+    for (i = 0; i < length; i++)
+    {
+        if (buffer[i] == '\n') { rows++; }
+    }
+
+    return rows;
+}
+
+/*
+ * acknowledge
+ *
+ * Moves the cursor past the rows returned by the last readBatch call.
+ */
+void UploadQueue::acknowledge(void)
+{
+    if (m_batchLength == 0) { return; }
+
+    m_cursor += m_batchLength;
+    m_batchLength = 0;
+
+    if (m_cursor >= m_size)
+    {
+        reset();
+    }
+    else
+    {
+        writeCursor();
+    }
+}
+
+/*
+ * drain
+ *
+ * Sends the next batch of rows as a single bulk upload and acknowledges them if the
+ * server accepts it. Returns the number of rows sent (0 if the queue is empty or the upload failed).
+ */
+uint16_t UploadQueue::drain(ServiceInterface * service, NetworkInterface * network,
+    char * batch, uint16_t batchSize, char * request, uint16_t requestSize, char * response, uint8_t nFields)
+{
+    if (!service || !network || !request || !response) { return 0; }
+
+    uint16_t rows = readBatch(batch, batchSize);
+    if (rows == 0) { return 0; }
+
+    service->createBulkUploadCall(request, requestSize, batch, m_queuePath, nFields);
+
+    response[0] = '\0';
+    if (!network->sendHTTPRequest(service->getURL(), request, response)) { return 0; }
+    if (!responseAccepted(response)) { return 0; }
+
+    acknowledge();
+
+    return rows;
+}
+
+/*
+ * drain (streaming)
+ *
+ * Streams up to maxBytes of whole rows (0 for no limit) from the queue file as a single
+ * bulk upload and acknowledges them if the server accepts it. Rows that can never be sent
+ * (see CSVFileSource) are skipped.
+ * Returns the number of rows sent (0 if the queue is empty or the upload failed).
+ */
+uint16_t UploadQueue::drain(ServiceInterface * service, NetworkInterface * network,
+    char * response, uint32_t maxBytes, uint8_t nFields)
+{
+    if (!service || !network || !response) { return 0; }
+
+    while (pending() > 0)
+    {
+        FILE_HANDLE queue = m_storage->openFile(m_queuePath, false);
+        if (queue == INVALID_HANDLE) { return 0; }
+
+        CSVFileSource source(m_storage, queue, m_cursor, maxBytes);
+        BulkUploadRequest request(service, &source, m_queuePath, nFields);
+        uint32_t length;
+        bool sent = false;
+
+        // Don't send an empty upload if there is no whole row to send
+        bool haveRows = (source.nextChunk(&length) != NULL);
+        if (haveRows)
+        {
+            response[0] = '\0';
+            sent = network->streamHTTPRequest(service->getURL(), &request, response);
+        }
+
+        m_storage->closeFile(queue);
+
+        if (!haveRows)
+        {
+            // Nothing to send, but move past any rows that were skipped and try again
+            if (source.bytesRead() == 0) { return 0; }
+            m_batchLength = source.bytesRead();
+            acknowledge();
+            continue;
+        }
+
+        if (!sent || !responseAccepted(response)) { return 0; }
+
+        m_batchLength = source.bytesRead();
+        uint16_t rows = source.rows();
+        acknowledge();
+
+        return rows;
+    }
+
+    return 0;
+}
+
+/*
+ * Private Class Functions
+ */
+
+bool UploadQueue::responseAccepted(char const * const response)
+{
+    ResponseParser parser(response);
+    return (parser.getStatus() >= OK) && (parser.getStatus() < MULTIPLE_CHOICES);
+}
+
+uint32_t UploadQueue::readCursor(void)
+{
+    if (!m_storage->fileExists(m_cursorPath)) { return 0; }
+
+    FILE_HANDLE cursorFile = m_storage->openFile(m_cursorPath, false);
+    if (cursorFile == INVALID_HANDLE) { return 0; }
+
+    uint32_t size = m_storage->fileSize(cursorFile);
+    uint8_t entry[UPLOAD_QUEUE_CURSOR_SIZE];
+    uint32_t cursor = 0;
+
+    // Ignore any partly written entry at the end of the file
+    size -= (size % UPLOAD_QUEUE_CURSOR_SIZE);
+
+    if (size >= UPLOAD_QUEUE_CURSOR_SIZE)
+    {
+        if (m_storage->seek(cursorFile, size - UPLOAD_QUEUE_CURSOR_SIZE) &&
+            (m_storage->readBytes(cursorFile, (char *)entry, UPLOAD_QUEUE_CURSOR_SIZE) == UPLOAD_QUEUE_CURSOR_SIZE))
+        {
+            cursor = getU32(entry);
+        }
+    }
+
+    m_storage->closeFile(cursorFile);
+
+    return cursor;
+}
+
+void UploadQueue::writeCursor(void)
+{
+    uint8_t entry[UPLOAD_QUEUE_CURSOR_SIZE];
+    putU32(entry, m_cursor);
+
+    FILE_HANDLE cursorFile = m_storage->openFile(m_cursorPath, true);
+    if (cursorFile == INVALID_HANDLE) { return; }
+
+    m_storage->writeBytes(cursorFile, entry, UPLOAD_QUEUE_CURSOR_SIZE);
+    m_storage->closeFile(cursorFile);
+}
+
+void UploadQueue::reset(void)
+{
+    // Remove the queue first: a cursor without a queue is detected by begin()
+    m_storage->removeFile(m_queuePath);
+    m_storage->removeFile(m_cursorPath);
+
+    m_size = 0;
+    m_cursor = 0;
+    m_batchLength = 0;
+}
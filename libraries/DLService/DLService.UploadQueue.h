@@ -0,0 +1,56 @@
+#ifndef _SERVICE_UPLOAD_QUEUE_H_
+#define _SERVICE_UPLOAD_QUEUE_H_
+
+/*
+ * UploadQueue
+ *
+ * Persistent backlog of CSV rows waiting to be uploaded.
+ *
+ * Rows are appended once to a queue file on local storage. A cursor file records the byte offset
+ * of the first row not yet acknowledged by the service. The cursor file is append-only: each
+ * acknowledgement adds a 4 byte (little-endian) offset and the last complete one is used,
+ * so an interrupted write loses at most the latest acknowledgement (and those rows are re-sent).
+ * When every row has been acknowledged, both files are removed and the queue starts again.
+ * A row left part written by an interrupted enqueue is cancelled by begin() and never sent.
+ *
+ * drain() reads as many whole rows as fit in the batch buffer and sends them as a single
+ * bulk upload. The streaming drain() sends up to maxBytes of rows straight from the queue file
+ * instead, so no batch or request buffer is needed. In both cases the cursor only moves on
+ * once the server responds with a 2xx status. The response buffer must hold NETWORK_RESPONSE_LENGTH chars.
+ */
+
+#define UPLOAD_QUEUE_CURSOR_SIZE (4)
+
+class UploadQueue
+{
+    public:
+        UploadQueue(LocalStorageInterface * storage, char const * const queuePath, char const * const cursorPath);
+
+        bool begin(void);
+        bool enqueue(char const * const row);
+
+        uint32_t pending(void);
+        uint16_t readBatch(char * buffer, uint32_t maxLength);
+        void acknowledge(void);
+
+        uint16_t drain(ServiceInterface * service, NetworkInterface * network,
+            char * batch, uint16_t batchSize, char * request, uint16_t requestSize, char * response, uint8_t nFields);
+        uint16_t drain(ServiceInterface * service, NetworkInterface * network,
+            char * response, uint32_t maxBytes, uint8_t nFields);
+
+    private:
+        bool responseAccepted(char const * const response);
+        uint32_t readCursor(void);
+        void writeCursor(void);
+        void reset(void);
+
+        LocalStorageInterface * m_storage;
+        char const * m_queuePath;
+        char const * m_cursorPath;
+
+        uint32_t m_size;
+        uint32_t m_cursor;
+        uint32_t m_batchLength;
+};
+
+#endif
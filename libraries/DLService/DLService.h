@@ -12,6 +12,8 @@ typedef enum service SERVICE;
  */
 
 class DataField;
+class HTTPSink;
+class CSVDataSource;
 
 /*
  * Service Interface class
@@ -29,6 +31,10 @@ class ServiceInterface
         
         virtual void createBulkUploadCall(
         	char * buffer, uint16_t maxSize, const char * csvData, const char * filename, uint8_t nFields) = 0;
+
+        // Streams a complete bulk upload request (with the CSV pulled from source) to sink
+        virtual bool writeBulkUpload(
+            HTTPSink * sink, CSVDataSource * source, const char * filename, uint8_t nFields) = 0;
 };
 
 ServiceInterface * Service_GetService(SERVICE service);
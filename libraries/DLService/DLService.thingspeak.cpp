@@ -13,12 +13,15 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 #endif
 
 #include "DLUtility.h"
 #include "DLService.h"
 #include "DLService.thingspeak.h"
 #include "DLHTTP.h"
+#include "DLLocalStorage.h"
+#include "DLService.BulkUpload.h"
 
 /*
  * Public static class members
@@ -41,7 +44,6 @@ const char Thingspeak::THINGSPEAK_BULK_UPDATE_PATH[] = "/update_csv";
 const char Thingspeak::THINGSPEAK_MULTIPART_BOUNDARY[] = __THINGSPEAK_MULTIPART_BOUNDARY_STR__;
 
 static RequestBuilder builder;
-static char * s_body = NULL;
 
 /*
  * Public Class Functions
@@ -49,19 +51,16 @@ static char * s_body = NULL;
 
 Thingspeak::Thingspeak(char const * const url, char const * const key)
 {
-    if (url)
-    {
-        memcpy(m_url, url, strlen(url));   
-    }
-    else
-    {
-        memcpy(m_url, THINGSPEAK_DEFAULT_URL, strlen(THINGSPEAK_DEFAULT_URL));   
-    }
+    strncpy_safe(m_url, url ? url : THINGSPEAK_DEFAULT_URL, _MAX_URL_LENGTH);
+    strncpy_safe(m_key, key ? key : "", _MAX_API_KEY_LENGTH);
 
-    memcpy(m_key, key, strlen(key)); 
+    m_postTemplate = NULL;
 }
 
-Thingspeak::~Thingspeak() {}
+Thingspeak::~Thingspeak()
+{
+    delete m_postTemplate;
+}
 
 char * Thingspeak::getURL(void)
 {
@@ -78,17 +77,11 @@ uint16_t Thingspeak::createPostAPICall(
     char * buffer, float * data,  uint32_t * channels, uint8_t nFields, uint16_t maxSize, char const * const pTime)
 {
     if (!buffer) { return 0; }
-    if (!m_key) { return 0; }
-    
-    char m_body[maxSize];
+    if (!m_key[0]) { return 0; }
     
-    builder.reset();
-    builder.setMethodAndURL("POST", THINGSPEAK_UPDATE_PATH);
+    if (!renderPostTemplate()) { return 0; }
 
-    builder.putHeader("Host", m_url);
-    builder.putHeader("Connection", "Close");
-    builder.putHeader("X-THINGSPEAKAPIKEY", m_key);
-    builder.putHeader("Content-Type", "application/x-www-form-urlencoded");
+    char m_body[maxSize];
 
     uint8_t field = 0;
     uint8_t index = 0;
@@ -108,9 +101,12 @@ uint16_t Thingspeak::createPostAPICall(
         index += sprintf(&m_body[index], "created_at=%s", pTime);
     }
 
-    builder.putBody(m_body);
-
-    builder.writeToBuffer(buffer, maxSize, true);
+    // Only the Content-Length and body change between posts
+    if (m_postTemplate->fill(buffer, maxSize, m_body, index) == 0)
+    {
+        buffer[0] = '\0';
+        return 0;
+    }
 
     return index;
 }
@@ -127,19 +123,33 @@ uint16_t Thingspeak::createPostAPICall(
 void Thingspeak::createBulkUploadCall(char * buffer, uint16_t maxSize, const char * csvData, const char * filename, uint8_t nFields)
 {
     if (!buffer) { return; }
-    if (!m_key) { return; }
+    if (!m_key[0]) { return; }
 
-    /* Creates the HTTP headers for the bulk upload */
-    if (!s_body)
-    {
-        Serial.print("Allocating ");
-        Serial.print(maxSize);
-        Serial.println("B for HTTP body");
-        s_body = new char[maxSize];
-    }
+    /* The request is streamed straight into the buffer, so no separate body buffer is needed */
+    CSVStringSource source(csvData);
+    HTTPBufferSink sink(buffer, maxSize);
+
+    writeBulkUpload(&sink, &source, filename, nFields);
+
+    // Buffered requests have always had a CRLF after the body
+    sink.writeString(CRLF);
+}
+
+/* Streams a bulk upload request for thingspeak.
+ * The body is generated once to find its length for the Content-Length header,
+ * then the headers and body are written to the sink in chunks.
+ * Returns false if any write to the sink failed.
+ */
+
+bool Thingspeak::writeBulkUpload(HTTPSink * sink, CSVDataSource * source, const char * filename, uint8_t nFields)
+{
+    if (!sink || !source) { return false; }
+
+    HTTPLengthCounter counter;
+
+    source->rewind();
+    writeBulkUploadBody(&counter, source, filename, nFields);
 
-    FixedLengthAccumulator bodyAccumulator(s_body, maxSize);
-    
     builder.reset();
     builder.setMethodAndURL("POST", THINGSPEAK_BULK_UPDATE_PATH);
 
@@ -147,40 +157,79 @@ void Thingspeak::createBulkUploadCall(char * buffer, uint16_t maxSize, const cha
 
     builder.putHeader("Content-Type", "multipart/form-data; boundary=" __THINGSPEAK_MULTIPART_BOUNDARY_STR__);
 
+    if (!builder.writeHead(sink, counter.length())) { return false; }
+
+    source->rewind();
+    return writeBulkUploadBody(sink, source, filename, nFields);
+}
+
+/*
+ * Private Class Functions
+ */
+
+/*
+ * renderPostTemplate
+ *
+ * The request line and headers of update posts never change, so they are rendered once
+ * (on first use, since the builder is a static object that may not be constructed yet
+ * when a static Thingspeak is).
+ */
+
+bool Thingspeak::renderPostTemplate(void)
+{
+    if (!m_postTemplate) { m_postTemplate = new RequestTemplate(); }
+    if (m_postTemplate->isRendered()) { return true; }
+
+    builder.reset();
+    builder.setMethodAndURL("POST", THINGSPEAK_UPDATE_PATH);
+
+    builder.putHeader("Host", m_url);
+    builder.putHeader("X-THINGSPEAKAPIKEY", m_key);
+    builder.putHeader("Content-Type", "application/x-www-form-urlencoded");
+
+    return m_postTemplate->render(&builder);
+}
+
+bool Thingspeak::writeBulkUploadBody(HTTPSink * sink, CSVDataSource * source, const char * filename, uint8_t nFields)
+{
+    bool ok = true;
+    const char * chunk;
+    uint32_t length;
+
     // Write the API key
-    bodyAccumulator.writeString("--");
-    bodyAccumulator.writeLine(THINGSPEAK_MULTIPART_BOUNDARY);
-    bodyAccumulator.writeLine("Content-Disposition: form-data; name=\"api_key\"");
-    bodyAccumulator.writeLine("");
-    bodyAccumulator.writeLine(m_key);
-    bodyAccumulator.writeString("--");
-    bodyAccumulator.writeLine(THINGSPEAK_MULTIPART_BOUNDARY);
+    ok &= sink->writeString("--" __THINGSPEAK_MULTIPART_BOUNDARY_STR__ CRLF);
+    ok &= sink->writeString("Content-Disposition: form-data; name=\"api_key\"" CRLF);
+    ok &= sink->writeString(CRLF);
+    ok &= sink->writeString(m_key);
+    ok &= sink->writeString(CRLF);
+    ok &= sink->writeString("--" __THINGSPEAK_MULTIPART_BOUNDARY_STR__ CRLF);
 
     // Write the CSV data
-    bodyAccumulator.writeString("Content-Disposition: form-data; name=\"upload[csv]\"; filename=\"");
-    bodyAccumulator.writeString(filename);
-    bodyAccumulator.writeLine("\"");
-    bodyAccumulator.writeLine("Content-Type: application/octet-stream");
+    ok &= sink->writeString("Content-Disposition: form-data; name=\"upload[csv]\"; filename=\"");
+    ok &= sink->writeString(filename);
+    ok &= sink->writeString("\"" CRLF);
+    ok &= sink->writeString("Content-Type: application/octet-stream" CRLF);
 
-    bodyAccumulator.writeLine("");
+    ok &= sink->writeString(CRLF);
 
-    putCSVUploadHeaders(&bodyAccumulator, nFields);
-    bodyAccumulator.writeString(csvData);
-    bodyAccumulator.writeLine("");
-    bodyAccumulator.writeString("--");
-    bodyAccumulator.writeString(THINGSPEAK_MULTIPART_BOUNDARY);
-    bodyAccumulator.writeString("--");
+    ok &= putCSVUploadHeaders(sink, nFields);
 
-    builder.putBody(s_body);
+    while (ok && ((chunk = source->nextChunk(&length)) != NULL))
+    {
+        ok &= sink->write(chunk, length);
+    }
+
+    ok &= sink->writeString(CRLF);
+    ok &= sink->writeString("--" __THINGSPEAK_MULTIPART_BOUNDARY_STR__ "--");
 
-    builder.writeToBuffer(buffer, maxSize, true);
+    return ok;
 }
 
-void Thingspeak::putCSVUploadHeaders(FixedLengthAccumulator * accumulator, uint8_t nFields)
+bool Thingspeak::putCSVUploadHeaders(HTTPSink * sink, uint8_t nFields)
 {
-    if (!accumulator) { return; }
+    if (!sink) { return false; }
 
-    accumulator->writeString("created_at,entry_id,");
+    bool ok = sink->writeString("created_at,entry_id,");
 
     uint8_t field = 0;
 
@@ -188,16 +237,18 @@ void Thingspeak::putCSVUploadHeaders(FixedLengthAccumulator * accumulator, uint8
 
     for (field = 1; field < nFields + 1; field++)
     {
-        accumulator->writeString("field");
+        ok &= sink->writeString("field");
     
         sprintf(fieldBuffer, "%d", field);
 
-        accumulator->writeString(fieldBuffer);
+        ok &= sink->writeString(fieldBuffer);
 
         if (!lastinloop(field, nFields + 1))
         {
-            accumulator->writeChar(',');
+            ok &= sink->writeString(",");
         }
     }
-    accumulator->writeString("\r\n");
+    ok &= sink->writeString("\r\n");
+
+    return ok;
 }
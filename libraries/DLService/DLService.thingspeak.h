@@ -5,7 +5,9 @@
 #define _MAX_API_KEY_LENGTH 30
 
 // Forward declarations of classes/structs
-class FixedLengthAccumulator;
+class HTTPSink;
+class CSVDataSource;
+class RequestTemplate;
 
 class Thingspeak : public ServiceInterface
 {
@@ -21,16 +23,22 @@ class Thingspeak : public ServiceInterface
             char * buffer, float * data, uint32_t * channels, uint8_t nFields, uint16_t maxSize, char const * const time);
 
         void createBulkUploadCall(char * buffer, uint16_t maxSize, const char * csvData, const char * filename, uint8_t nFields);
+        bool writeBulkUpload(HTTPSink * sink, CSVDataSource * source, const char * filename, uint8_t nFields);
 
     private:
 
-        void putCSVUploadHeaders(FixedLengthAccumulator * accumulator, uint8_t nFields);
+        bool writeBulkUploadBody(HTTPSink * sink, CSVDataSource * source, const char * filename, uint8_t nFields);
+        bool putCSVUploadHeaders(HTTPSink * sink, uint8_t nFields);
+        bool renderPostTemplate(void);
         
         static const char THINGSPEAK_UPDATE_PATH[];
         static const char THINGSPEAK_BULK_UPDATE_PATH[];
         static const char THINGSPEAK_MULTIPART_BOUNDARY[];
         char m_url[_MAX_URL_LENGTH];
         char m_key[_MAX_API_KEY_LENGTH];
+
+        // Request line and headers of update posts, rendered on first use
+        RequestTemplate * m_postTemplate;
 };
 
 #endif
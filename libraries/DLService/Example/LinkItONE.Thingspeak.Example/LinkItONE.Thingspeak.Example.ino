@@ -65,7 +65,7 @@ void doBulkUpload(void)
     Serial.println(s_thingSpeakService->getURL());
 
     char request_buffer[1024];
-    char response_buffer[200] = "";
+    char response_buffer[NETWORK_RESPONSE_LENGTH] = "";
     s_thingSpeakService->createBulkUploadCall(request_buffer, 1024, csvData, "linkitone.example.csv", 6);
 
     Serial.print("Request '");
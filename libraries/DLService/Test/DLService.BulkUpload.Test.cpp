@@ -0,0 +1,304 @@
+/*
+ * DLService.BulkUpload.Test.cpp
+ *
+ * Tests streaming bulk upload generation
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLLocalStorage.h"
+#include "DLHTTP.h"
+#include "DLService.h"
+#include "DLService.thingspeak.h"
+#include "DLService.BulkUpload.h"
+#include "DLTest.CSVRows.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define xstr(s) str(s)
+#define str(s) #s
+#define QUOTED_DL_PATH xstr(DL_PATH)
+
+#define TEST_CSV_PATH QUOTED_DL_PATH "/DLService/Test/TestBulk.csv"
+
+static char const * s_expectedRequest =
+    "POST /update_csv HTTP/1.1\r\n"
+    "Host: api.thingspeak.com\r\n"
+    "Content-Type: multipart/form-data; boundary=----------------------9f1bb96494379c3e\r\n"
+    "Content-Length: 629\r\n"
+    "\r\n"
+    "------------------------9f1bb96494379c3e\r\n"
+    "Content-Disposition: form-data; name=\"api_key\"\r\n"
+    "\r\n"
+    "IZ2O45C3BM257VCH\r\n"
+    "------------------------9f1bb96494379c3e\r\n"
+    "Content-Disposition: form-data; name=\"upload[csv]\"; filename=\"example.csv\"\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "\r\n"
+    "created_at,entry_id,field1,field2,field3,field4,field5,field6\r\n"
+    "2015-02-13 07:12:22 +0000,1,43.478,51.752,4.90,5.23,9.23,2.84\r\n"
+    "2015-02-13 07:12:52 +0000,2,49.321,54.782,9.63,5.01,7.30,8.63\r\n"
+    "2015-02-13 07:13:22 +0000,3,51.023,42.647,7.57,6.89,8.24,0.52\r\n"
+    "2015-02-13 07:13:52 +0000,4,54.194,59.884,7.68,9.67,5.35,6.02\r\n"
+    "\r\n"
+    "------------------------9f1bb96494379c3e--\r\n";
+
+static char const * s_csvData =
+    "2015-02-13 07:12:22 +0000,1,43.478,51.752,4.90,5.23,9.23,2.84\r\n"
+    "2015-02-13 07:12:52 +0000,2,49.321,54.782,9.63,5.01,7.30,8.63\r\n"
+    "2015-02-13 07:13:22 +0000,3,51.023,42.647,7.57,6.89,8.24,0.52\r\n"
+    "2015-02-13 07:13:52 +0000,4,54.194,59.884,7.68,9.67,5.35,6.02\r\n";
+
+static LocalStorageInterface * s_storage;
+static Thingspeak s_thingspeak("api.thingspeak.com", "IZ2O45C3BM257VCH");
+
+static char s_buffered[1024];
+static char s_streamed[2048];
+
+static void writeRows(uint16_t count)
+{
+    FILE_HANDLE file = s_storage->openFile(TEST_CSV_PATH, true);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        s_storage->write(file, TEST_MakeCSVRow(i));
+    }
+    s_storage->closeFile(file);
+}
+
+void setUp(void)
+{
+    s_storage = LocalStorage_GetLocalStorageInterface(LOCAL_STORAGE_TYPE(0));
+    s_storage->removeFile(TEST_CSV_PATH);
+}
+
+void tearDown(void)
+{
+    s_storage->removeFile(TEST_CSV_PATH);
+}
+
+void test_RowLengthIsFixed(void)
+{
+    TEST_ASSERT_EQUAL(TEST_CSV_ROW_LENGTH, strlen(TEST_MakeCSVRow(0)));
+    TEST_ASSERT_EQUAL(TEST_CSV_ROW_LENGTH, strlen(TEST_MakeCSVRow(1234)));
+}
+
+void test_BufferedRequestIsUnchanged(void)
+{
+    s_thingspeak.createBulkUploadCall(s_buffered, sizeof(s_buffered), s_csvData, "example.csv", 6);
+
+    TEST_ASSERT_EQUAL_STRING(s_expectedRequest, s_buffered);
+}
+
+void test_StreamedRequestMatchesBufferedRequest(void)
+{
+    CSVStringSource source(s_csvData);
+    HTTPBufferSink sink(s_streamed, sizeof(s_streamed));
+
+    TEST_ASSERT_TRUE(s_thingspeak.writeBulkUpload(&sink, &source, "example.csv", 6));
+
+    // Streamed requests end with the closing boundary, without the CRLF buffered requests add
+    TEST_ASSERT_EQUAL(strlen(s_expectedRequest) - 2, strlen(s_streamed));
+    TEST_ASSERT_EQUAL_MEMORY(s_expectedRequest, s_streamed, strlen(s_streamed));
+}
+
+void test_StreamingFailsIfTheSinkIsFull(void)
+{
+    CSVStringSource source(s_csvData);
+    HTTPBufferSink sink(s_streamed, 256);
+
+    TEST_ASSERT_FALSE(s_thingspeak.writeBulkUpload(&sink, &source, "example.csv", 6));
+}
+
+void test_FileSourceReturnsWholeRowsInChunks(void)
+{
+    writeRows(10);
+
+    FILE_HANDLE file = s_storage->openFile(TEST_CSV_PATH, false);
+    CSVFileSource source(s_storage, file, 0, 0);
+
+    uint32_t length;
+    uint32_t total = 0;
+    char const * chunk;
+
+    while ((chunk = source.nextChunk(&length)) != NULL)
+    {
+        // Each chunk fits in the block and ends on a row boundary
+        TEST_ASSERT_TRUE(length <= CSV_FILE_SOURCE_BLOCK_SIZE);
+        TEST_ASSERT_EQUAL(0, length % TEST_CSV_ROW_LENGTH);
+        TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(total / TEST_CSV_ROW_LENGTH), chunk, TEST_CSV_ROW_LENGTH);
+        total += length;
+    }
+
+    s_storage->closeFile(file);
+
+    TEST_ASSERT_EQUAL(10 * TEST_CSV_ROW_LENGTH, total);
+    TEST_ASSERT_EQUAL(10 * TEST_CSV_ROW_LENGTH, source.bytesRead());
+    TEST_ASSERT_EQUAL(10, source.rows());
+}
+
+void test_FileSourceStopsAtMaxBytesOnARowBoundary(void)
+{
+    writeRows(10);
+
+    FILE_HANDLE file = s_storage->openFile(TEST_CSV_PATH, false);
+    CSVFileSource source(s_storage, file, 2 * TEST_CSV_ROW_LENGTH, (TEST_CSV_ROW_LENGTH * 11) / 2);
+
+    uint32_t length;
+    char const * chunk = source.nextChunk(&length);
+    TEST_ASSERT_NOT_NULL(chunk);
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(2), chunk, TEST_CSV_ROW_LENGTH);
+
+    while (source.nextChunk(&length) != NULL) {}
+
+    TEST_ASSERT_EQUAL(5 * TEST_CSV_ROW_LENGTH, source.bytesRead());
+    TEST_ASSERT_EQUAL(5, source.rows());
+
+    // A rewind starts the same pass again
+    source.rewind();
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(2), source.nextChunk(&length), TEST_CSV_ROW_LENGTH);
+
+    s_storage->closeFile(file);
+}
+
+void test_FileSourceLeavesOutPartWrittenLastRow(void)
+{
+    writeRows(3);
+
+    FILE_HANDLE file = s_storage->openFile(TEST_CSV_PATH, true);
+    s_storage->write(file, "2015-02-13 07:00:03 +0000,0003,43.4");
+    s_storage->closeFile(file);
+
+    file = s_storage->openFile(TEST_CSV_PATH, false);
+    CSVFileSource source(s_storage, file, 0, 0);
+
+    uint32_t length;
+    while (source.nextChunk(&length) != NULL) {}
+    s_storage->closeFile(file);
+
+    TEST_ASSERT_EQUAL(3 * TEST_CSV_ROW_LENGTH, source.bytesRead());
+    TEST_ASSERT_EQUAL(3, source.rows());
+}
+
+void test_FileSourceSkipsRowsThatCanNeverBeReturned(void)
+{
+    char longRow[CSV_FILE_SOURCE_BLOCK_SIZE + 10];
+    memset(longRow, 'x', sizeof(longRow));
+    strcpy(&longRow[sizeof(longRow) - 3], "\r\n");
+    char const cancelled[] = {'4', '3', CSV_CANCELLED_ROW_MARK, '\n', '\0'};
+
+    FILE_HANDLE file = s_storage->openFile(TEST_CSV_PATH, true);
+    s_storage->write(file, longRow);
+    s_storage->write(file, TEST_MakeCSVRow(0));
+    s_storage->write(file, cancelled);
+    s_storage->write(file, TEST_MakeCSVRow(1));
+    s_storage->closeFile(file);
+
+    file = s_storage->openFile(TEST_CSV_PATH, false);
+    CSVFileSource source(s_storage, file, 0, 0);
+
+    uint32_t length;
+    char const * chunk = source.nextChunk(&length);
+    TEST_ASSERT_NOT_NULL(chunk);
+    TEST_ASSERT_EQUAL(TEST_CSV_ROW_LENGTH, length);
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(0), chunk, TEST_CSV_ROW_LENGTH);
+
+    chunk = source.nextChunk(&length);
+    TEST_ASSERT_NOT_NULL(chunk);
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(1), chunk, TEST_CSV_ROW_LENGTH);
+
+    TEST_ASSERT_NULL(source.nextChunk(&length));
+    s_storage->closeFile(file);
+
+    // Skipped rows are read past, but not returned
+    TEST_ASSERT_EQUAL(strlen(longRow) + strlen(cancelled) + 2 * TEST_CSV_ROW_LENGTH, source.bytesRead());
+    TEST_ASSERT_EQUAL(2, source.rows());
+}
+
+void test_FileSourceSkipsFirstRowLongerThanMaxBytes(void)
+{
+    char longRow[TEST_CSV_ROW_LENGTH * 2];
+    memset(longRow, 'x', sizeof(longRow));
+    strcpy(&longRow[sizeof(longRow) - 3], "\r\n");
+
+    FILE_HANDLE file = s_storage->openFile(TEST_CSV_PATH, true);
+    s_storage->write(file, longRow);
+    s_storage->write(file, TEST_MakeCSVRow(0));
+    s_storage->write(file, TEST_MakeCSVRow(1));
+    s_storage->closeFile(file);
+
+    file = s_storage->openFile(TEST_CSV_PATH, false);
+    CSVFileSource source(s_storage, file, 0, TEST_CSV_ROW_LENGTH + 1);
+
+    uint32_t length;
+    char const * chunk = source.nextChunk(&length);
+    TEST_ASSERT_NOT_NULL(chunk);
+    TEST_ASSERT_EQUAL(TEST_CSV_ROW_LENGTH, length);
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(0), chunk, TEST_CSV_ROW_LENGTH);
+
+    // The next row is not too long, so is left for the next upload
+    TEST_ASSERT_NULL(source.nextChunk(&length));
+    s_storage->closeFile(file);
+
+    TEST_ASSERT_EQUAL(strlen(longRow) + TEST_CSV_ROW_LENGTH, source.bytesRead());
+    TEST_ASSERT_EQUAL(1, source.rows());
+}
+
+void test_StreamedFileUploadHasCorrectContentLength(void)
+{
+    writeRows(10);
+
+    FILE_HANDLE file = s_storage->openFile(TEST_CSV_PATH, false);
+    CSVFileSource source(s_storage, file, 0, 0);
+    HTTPBufferSink sink(s_streamed, sizeof(s_streamed));
+
+    TEST_ASSERT_TRUE(s_thingspeak.writeBulkUpload(&sink, &source, "TestBulk.csv", 6));
+    s_storage->closeFile(file);
+
+    char const * header = strstr(s_streamed, "Content-Length: ");
+    char const * body = strstr(s_streamed, "\r\n\r\n");
+    TEST_ASSERT_NOT_NULL(header);
+    TEST_ASSERT_NOT_NULL(body);
+
+    unsigned long contentLength = 0;
+    sscanf(header, "Content-Length: %lu", &contentLength);
+    TEST_ASSERT_EQUAL(strlen(body + 4), contentLength);
+
+    TEST_ASSERT_NOT_NULL(strstr(s_streamed, TEST_MakeCSVRow(9)));
+}
+
+int main(void)
+{
+    UnityBegin("DLService.BulkUpload.Test.cpp");
+
+    RUN_TEST(test_RowLengthIsFixed);
+    RUN_TEST(test_BufferedRequestIsUnchanged);
+    RUN_TEST(test_StreamedRequestMatchesBufferedRequest);
+    RUN_TEST(test_StreamingFailsIfTheSinkIsFull);
+    RUN_TEST(test_FileSourceReturnsWholeRowsInChunks);
+    RUN_TEST(test_FileSourceStopsAtMaxBytesOnARowBoundary);
+    RUN_TEST(test_FileSourceLeavesOutPartWrittenLastRow);
+    RUN_TEST(test_FileSourceSkipsRowsThatCanNeverBeReturned);
+    RUN_TEST(test_FileSourceSkipsFirstRowLongerThanMaxBytes);
+    RUN_TEST(test_StreamedFileUploadHasCorrectContentLength);
+
+    return (UnityEnd());
+}
@@ -0,0 +1,23 @@
+INC_DIRS += -IDLService
+INC_DIRS += -IDLUtility
+INC_DIRS += -IDLLocalStorage
+INC_DIRS += -IDLNetwork
+INC_DIRS += -IDLHTTP
+
+SRC_FILES += DLService/DLService.thingspeak.cpp
+SRC_FILES += DLHTTP/DLHTTP.RequestBuilder.cpp
+SRC_FILES += DLHTTP/DLHTTP.RequestTemplate.cpp
+SRC_FILES += DLHTTP/DLHTTP.Header.cpp
+SRC_FILES += DLHTTP/DLHTTP.Stream.cpp
+SRC_FILES += DLUtility/DLUtility.Strings.cpp
+SRC_FILES += DLUtility/DLUtility.ArrayFunctions.cpp
+SRC_FILES += DLTest/DLTest.Mock.LocalStorage.cpp
+SRC_FILES += DLTest/DLTest.Mock.Serial.cpp
+SRC_FILES += DLTest/DLTest.CSVRows.cpp
+SRC_FILES += DLLocalStorage/DLLocalStorage.Handles.cpp
+
+local_setup:
+	rm -f ./DLService/Test/TestBulk.csv
+
+local_teardown:
+	rm -f ./DLService/Test/TestBulk.csv
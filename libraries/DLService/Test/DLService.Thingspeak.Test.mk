@@ -4,12 +4,16 @@ SRC_FILES += DLService/DLService.cpp
 SRC_FILES += DLSettings/DLSettings.cpp
 SRC_FILES += DLDataField/DLDataField.cpp
 SRC_FILES += DLHTTP/DLHTTP.RequestBuilder.cpp
+SRC_FILES += DLHTTP/DLHTTP.RequestTemplate.cpp
 SRC_FILES += DLHTTP/DLHTTP.Header.cpp
+SRC_FILES += DLHTTP/DLHTTP.Stream.cpp
+SRC_FILES += DLService/DLService.BulkUpload.cpp
 
 INC_DIRS += -IDLService
 INC_DIRS += -IDLUtility
 INC_DIRS += -IDLDataField
 INC_DIRS += -IDLSettings
 INC_DIRS += -IDLHTTP
+INC_DIRS += -IDLLocalStorage
 
 SYMBOLS += -D_MAX_FIELDS=6
\ No newline at end of file
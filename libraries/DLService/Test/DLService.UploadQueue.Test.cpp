@@ -0,0 +1,424 @@
+/*
+ * DLService.UploadQueue.Test.cpp
+ *
+ * Tests the persistent upload queue
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Strings.h"
+#include "DLLocalStorage.h"
+#include "DLNetwork.h"
+#include "DLHTTP.h"
+#include "DLService.h"
+#include "DLService.thingspeak.h"
+#include "DLService.BulkUpload.h"
+#include "DLService.UploadQueue.h"
+#include "DLTest.CSVRows.h"
+
+/*
+ * Unity Test Framework
+ */
+
+#include "unity.h"
+
+#define xstr(s) str(s)
+#define str(s) #s
+#define QUOTED_DL_PATH xstr(DL_PATH)
+
+#define TEST_QUEUE_PATH QUOTED_DL_PATH "/DLService/Test/TestQueue.csv"
+#define TEST_CURSOR_PATH QUOTED_DL_PATH "/DLService/Test/TestQueue.cur"
+
+static char s_streamed[4096];
+
+// Accepts or rejects every request and counts them
+class FakeNetwork : public NetworkInterface
+{
+    public:
+        FakeNetwork() : requests(0), connected(true), response("HTTP/1.1 200 OK\r\n\r\n") {}
+
+        bool tryConnection(uint8_t timeoutSeconds) { (void)timeoutSeconds; return connected; }
+        bool isConnected(void) { return connected; }
+
+        bool sendHTTPRequest(const char * const url, const char * request, char * responseBuffer, bool useHTTPS)
+        {
+            (void)url; (void)useHTTPS;
+            if (!connected) { return false; }
+
+            requests++;
+            lastRequest = request;
+            strcpy(responseBuffer, response);
+            return true;
+        }
+
+        bool streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * responseBuffer, bool useHTTPS)
+        {
+            (void)url; (void)useHTTPS;
+            if (!connected) { return false; }
+
+            HTTPBufferSink sink(s_streamed, sizeof(s_streamed));
+            if (!request->writeTo(&sink)) { return false; }
+
+            requests++;
+            lastRequest = s_streamed;
+            strcpy(responseBuffer, response);
+            return true;
+        }
+
+        uint16_t requests;
+        bool connected;
+        char const * response;
+        char const * lastRequest;
+};
+
+static LocalStorageInterface * s_storage;
+static Thingspeak s_thingspeak("api.thingspeak.com", "IZ2O45C3BM257VCH");
+static FakeNetwork s_network;
+
+static char s_batch[TEST_CSV_ROW_LENGTH * 8];
+static char s_request[2048];
+static char s_response[NETWORK_RESPONSE_LENGTH];
+
+static void enqueueRows(UploadQueue * queue, uint16_t first, uint16_t count)
+{
+    for (uint16_t i = first; i < first + count; i++)
+    {
+        queue->enqueue(TEST_MakeCSVRow(i));
+    }
+}
+
+static uint16_t drain(UploadQueue * queue, uint16_t batchSize)
+{
+    return queue->drain(&s_thingspeak, &s_network, s_batch, batchSize, s_request, 2048, s_response, 6);
+}
+
+static uint16_t streamDrain(UploadQueue * queue, uint32_t maxBytes)
+{
+    return queue->drain(&s_thingspeak, &s_network, s_response, maxBytes, 6);
+}
+
+void setUp(void)
+{
+    s_storage = LocalStorage_GetLocalStorageInterface(LOCAL_STORAGE_TYPE(0));
+    s_storage->removeFile(TEST_QUEUE_PATH);
+    s_storage->removeFile(TEST_CURSOR_PATH);
+
+    s_network.requests = 0;
+    s_network.connected = true;
+    s_network.response = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+    s_network.lastRequest = NULL;
+}
+
+void tearDown(void)
+{
+    s_storage->removeFile(TEST_QUEUE_PATH);
+    s_storage->removeFile(TEST_CURSOR_PATH);
+}
+
+void test_RowLengthIsFixed(void)
+{
+    TEST_ASSERT_EQUAL(TEST_CSV_ROW_LENGTH, strlen(TEST_MakeCSVRow(0)));
+    TEST_ASSERT_EQUAL(TEST_CSV_ROW_LENGTH, strlen(TEST_MakeCSVRow(1234)));
+}
+
+void test_EnqueuedRowsArePending(void)
+{
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    TEST_ASSERT_TRUE(queue.begin());
+    TEST_ASSERT_EQUAL(0, queue.pending());
+
+    enqueueRows(&queue, 0, 3);
+    TEST_ASSERT_EQUAL(3 * TEST_CSV_ROW_LENGTH, queue.pending());
+
+    TEST_ASSERT_EQUAL(3, queue.readBatch(s_batch, sizeof(s_batch)));
+    TEST_ASSERT_EQUAL(3 * TEST_CSV_ROW_LENGTH, strlen(s_batch));
+
+    // Reading a batch does not remove it
+    TEST_ASSERT_EQUAL(3 * TEST_CSV_ROW_LENGTH, queue.pending());
+}
+
+void test_BatchesOnlyContainWholeRows(void)
+{
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    enqueueRows(&queue, 0, 5);
+
+    // Room for two and a half rows
+    TEST_ASSERT_EQUAL(2, queue.readBatch(s_batch, (TEST_CSV_ROW_LENGTH * 5) / 2));
+    TEST_ASSERT_EQUAL(2 * TEST_CSV_ROW_LENGTH, strlen(s_batch));
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(0), s_batch, TEST_CSV_ROW_LENGTH);
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(1), &s_batch[TEST_CSV_ROW_LENGTH], TEST_CSV_ROW_LENGTH);
+
+    queue.acknowledge();
+    TEST_ASSERT_EQUAL(3 * TEST_CSV_ROW_LENGTH, queue.pending());
+
+    TEST_ASSERT_EQUAL(2, queue.readBatch(s_batch, (TEST_CSV_ROW_LENGTH * 5) / 2));
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(2), s_batch, TEST_CSV_ROW_LENGTH);
+}
+
+void test_FailedUploadsAreNotAcknowledged(void)
+{
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    enqueueRows(&queue, 0, 4);
+
+    s_network.connected = false;
+    TEST_ASSERT_EQUAL(0, drain(&queue, sizeof(s_batch)));
+    TEST_ASSERT_EQUAL(4 * TEST_CSV_ROW_LENGTH, queue.pending());
+
+    s_network.connected = true;
+    s_network.response = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+    TEST_ASSERT_EQUAL(0, drain(&queue, sizeof(s_batch)));
+    TEST_ASSERT_EQUAL(4 * TEST_CSV_ROW_LENGTH, queue.pending());
+    TEST_ASSERT_EQUAL(1, s_network.requests);
+}
+
+void test_BacklogIsDrainedInBulkRequests(void)
+{
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    enqueueRows(&queue, 0, 20);
+
+    uint16_t total = 0;
+    uint16_t rows;
+
+    // Eight rows (less the NULL terminator) leaves room for seven per request
+    while ((rows = drain(&queue, sizeof(s_batch))) > 0)
+    {
+        total += rows;
+    }
+
+    TEST_ASSERT_EQUAL(20, total);
+    TEST_ASSERT_EQUAL(3, s_network.requests);
+    TEST_ASSERT_EQUAL(0, queue.pending());
+
+    // The last request holds the final six rows
+    TEST_ASSERT_TRUE(strstr(s_network.lastRequest, TEST_MakeCSVRow(14)) != NULL);
+    TEST_ASSERT_TRUE(strstr(s_network.lastRequest, TEST_MakeCSVRow(19)) != NULL);
+    TEST_ASSERT_TRUE(strstr(s_network.lastRequest, TEST_MakeCSVRow(13)) == NULL);
+
+    // A fully drained queue is removed from storage
+    TEST_ASSERT_FALSE(s_storage->fileExists(TEST_QUEUE_PATH));
+    TEST_ASSERT_FALSE(s_storage->fileExists(TEST_CURSOR_PATH));
+}
+
+void test_CursorPersistsAcrossRestarts(void)
+{
+    UploadQueue first(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    first.begin();
+    enqueueRows(&first, 0, 10);
+
+    TEST_ASSERT_EQUAL(7, drain(&first, sizeof(s_batch)));
+
+    UploadQueue second(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    TEST_ASSERT_TRUE(second.begin());
+    TEST_ASSERT_EQUAL(3 * TEST_CSV_ROW_LENGTH, second.pending());
+
+    TEST_ASSERT_EQUAL(3, second.readBatch(s_batch, sizeof(s_batch)));
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(7), s_batch, TEST_CSV_ROW_LENGTH);
+}
+
+void test_PartlyWrittenCursorIsIgnored(void)
+{
+    UploadQueue first(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    first.begin();
+    enqueueRows(&first, 0, 10);
+
+    first.readBatch(s_batch, (TEST_CSV_ROW_LENGTH * 3) + 1);
+    first.acknowledge();
+
+    // Simulate power loss part way through writing the next cursor
+    FILE_HANDLE cursorFile = s_storage->openFile(TEST_CURSOR_PATH, true);
+    s_storage->writeBytes(cursorFile, (uint8_t const *)"\x80\x02", 2);
+    s_storage->closeFile(cursorFile);
+
+    UploadQueue second(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    second.begin();
+    TEST_ASSERT_EQUAL(7 * TEST_CSV_ROW_LENGTH, second.pending());
+}
+
+void test_OversizedRowsAreSkipped(void)
+{
+    char longRow[TEST_CSV_ROW_LENGTH * 3];
+    memset(longRow, 'x', sizeof(longRow));
+    strcpy(&longRow[sizeof(longRow) - 3], "\r\n");
+
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    queue.enqueue(longRow);
+    enqueueRows(&queue, 0, 2);
+
+    TEST_ASSERT_EQUAL(1, queue.readBatch(s_batch, TEST_CSV_ROW_LENGTH + 1));
+    TEST_ASSERT_EQUAL_STRING(TEST_MakeCSVRow(0), s_batch);
+    TEST_ASSERT_EQUAL(2 * TEST_CSV_ROW_LENGTH, queue.pending());
+}
+
+static void writePartRow(void)
+{
+    // Simulate power loss part way through enqueueing a row
+    FILE_HANDLE queueFile = s_storage->openFile(TEST_QUEUE_PATH, true);
+    s_storage->write(queueFile, "2015-02-13 07:59:00 +0000,99");
+    s_storage->closeFile(queueFile);
+}
+
+void test_PartWrittenRowIsNeverSent(void)
+{
+    UploadQueue first(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    first.begin();
+    enqueueRows(&first, 0, 3);
+    writePartRow();
+
+    UploadQueue second(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    TEST_ASSERT_TRUE(second.begin());
+    enqueueRows(&second, 3, 2);
+
+    // The batch stops before the cancelled row...
+    TEST_ASSERT_EQUAL(3, second.readBatch(s_batch, sizeof(s_batch)));
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(0), s_batch, TEST_CSV_ROW_LENGTH);
+    second.acknowledge();
+
+    // ...which is then skipped, and the rows after it are whole
+    TEST_ASSERT_EQUAL(2, second.readBatch(s_batch, sizeof(s_batch)));
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(3), s_batch, TEST_CSV_ROW_LENGTH);
+    TEST_ASSERT_EQUAL_MEMORY(TEST_MakeCSVRow(4), &s_batch[TEST_CSV_ROW_LENGTH], TEST_CSV_ROW_LENGTH);
+    second.acknowledge();
+
+    TEST_ASSERT_EQUAL(0, second.pending());
+}
+
+void test_QueueOfOnlyAPartWrittenRowEmpties(void)
+{
+    writePartRow();
+
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    TEST_ASSERT_TRUE(queue.begin());
+    TEST_ASSERT_TRUE(queue.pending() > 0);
+
+    TEST_ASSERT_EQUAL(0, queue.readBatch(s_batch, sizeof(s_batch)));
+    TEST_ASSERT_EQUAL(0, queue.pending());
+    TEST_ASSERT_FALSE(s_storage->fileExists(TEST_QUEUE_PATH));
+}
+
+void test_BacklogIsStreamedInBulkRequests(void)
+{
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    enqueueRows(&queue, 0, 20);
+
+    // Room for eight and a half rows per request
+    uint32_t maxBytes = (TEST_CSV_ROW_LENGTH * 17) / 2;
+
+    TEST_ASSERT_EQUAL(8, streamDrain(&queue, maxBytes));
+    TEST_ASSERT_EQUAL(12 * TEST_CSV_ROW_LENGTH, queue.pending());
+    TEST_ASSERT_TRUE(strstr(s_network.lastRequest, TEST_MakeCSVRow(7)) != NULL);
+    TEST_ASSERT_TRUE(strstr(s_network.lastRequest, TEST_MakeCSVRow(8)) == NULL);
+
+    TEST_ASSERT_EQUAL(8, streamDrain(&queue, maxBytes));
+    TEST_ASSERT_EQUAL(4, streamDrain(&queue, maxBytes));
+    TEST_ASSERT_EQUAL(0, streamDrain(&queue, maxBytes));
+
+    TEST_ASSERT_EQUAL(3, s_network.requests);
+    TEST_ASSERT_EQUAL(0, queue.pending());
+    TEST_ASSERT_TRUE(strstr(s_network.lastRequest, TEST_MakeCSVRow(16)) != NULL);
+    TEST_ASSERT_TRUE(strstr(s_network.lastRequest, TEST_MakeCSVRow(19)) != NULL);
+    TEST_ASSERT_FALSE(s_storage->fileExists(TEST_QUEUE_PATH));
+}
+
+void test_StreamedContentLengthMatchesBody(void)
+{
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    enqueueRows(&queue, 0, 5);
+
+    TEST_ASSERT_EQUAL(5, streamDrain(&queue, 0));
+
+    char const * header = strstr(s_network.lastRequest, "Content-Length: ");
+    char const * body = strstr(s_network.lastRequest, "\r\n\r\n");
+    TEST_ASSERT_NOT_NULL(header);
+    TEST_ASSERT_NOT_NULL(body);
+
+    unsigned long contentLength = 0;
+    sscanf(header, "Content-Length: %lu", &contentLength);
+    TEST_ASSERT_EQUAL(strlen(body + 4), contentLength);
+}
+
+void test_FailedStreamedUploadsAreNotAcknowledged(void)
+{
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    enqueueRows(&queue, 0, 4);
+
+    s_network.response = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+    TEST_ASSERT_EQUAL(0, streamDrain(&queue, 0));
+    TEST_ASSERT_EQUAL(4 * TEST_CSV_ROW_LENGTH, queue.pending());
+}
+
+void test_OversizedRowsAreSkippedWhenStreaming(void)
+{
+    char longRow[CSV_FILE_SOURCE_BLOCK_SIZE * 2];
+    memset(longRow, 'x', sizeof(longRow));
+    strcpy(&longRow[sizeof(longRow) - 3], "\r\n");
+
+    UploadQueue queue(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    queue.begin();
+    queue.enqueue(longRow);
+    enqueueRows(&queue, 0, 2);
+
+    TEST_ASSERT_EQUAL(2, streamDrain(&queue, 0));
+    TEST_ASSERT_EQUAL(1, s_network.requests);
+    TEST_ASSERT_NULL(strchr(s_network.lastRequest, 'x'));
+    TEST_ASSERT_EQUAL(0, queue.pending());
+}
+
+void test_PartWrittenRowIsNeverStreamed(void)
+{
+    UploadQueue first(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    first.begin();
+    enqueueRows(&first, 0, 2);
+    writePartRow();
+
+    UploadQueue second(s_storage, TEST_QUEUE_PATH, TEST_CURSOR_PATH);
+    second.begin();
+    enqueueRows(&second, 2, 1);
+
+    TEST_ASSERT_EQUAL(3, streamDrain(&second, 0));
+    TEST_ASSERT_NULL(strstr(s_network.lastRequest, ",99"));
+    TEST_ASSERT_EQUAL(0, second.pending());
+}
+
+int main(void)
+{
+    UnityBegin("DLService.UploadQueue.Test.cpp");
+
+    RUN_TEST(test_RowLengthIsFixed);
+    RUN_TEST(test_EnqueuedRowsArePending);
+    RUN_TEST(test_BatchesOnlyContainWholeRows);
+    RUN_TEST(test_FailedUploadsAreNotAcknowledged);
+    RUN_TEST(test_BacklogIsDrainedInBulkRequests);
+    RUN_TEST(test_CursorPersistsAcrossRestarts);
+    RUN_TEST(test_PartlyWrittenCursorIsIgnored);
+    RUN_TEST(test_OversizedRowsAreSkipped);
+    RUN_TEST(test_PartWrittenRowIsNeverSent);
+    RUN_TEST(test_QueueOfOnlyAPartWrittenRowEmpties);
+    RUN_TEST(test_BacklogIsStreamedInBulkRequests);
+    RUN_TEST(test_StreamedContentLengthMatchesBody);
+    RUN_TEST(test_FailedStreamedUploadsAreNotAcknowledged);
+    RUN_TEST(test_OversizedRowsAreSkippedWhenStreaming);
+    RUN_TEST(test_PartWrittenRowIsNeverStreamed);
+
+    return (UnityEnd());
+}
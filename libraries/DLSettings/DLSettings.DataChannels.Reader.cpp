@@ -12,6 +12,7 @@
  * Standard Library Includes
  */
 
+#include <stddef.h>
 #include <stdint.h>
 
 /*
@@ -20,8 +21,12 @@
 
 #include "DLUtility.Averager.h"
 #include "DLLocalStorage.h"
+#include "DLLocalStorage.LineReader.h"
 #include "DLDataField.Types.h"
 #include "DLDataField.h"
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.Arena.h"
+#include "DLDataField.Store.h"
 #include "DLDataField.Manager.h"
 #include "DLSettings.Reader.Errors.h"
 #include "DLSettings.DataChannels.h"
@@ -63,10 +68,12 @@ SETTINGS_READER_RESULT Settings_readChannelsFromFile(
     }
     
     uint8_t hndl = pInterface->openFile(filename, false);
-    while (!pInterface->endOfFile(hndl))
+    LineReader reader(pInterface, hndl);
+
+    while (!reader.endOfFile())
     {
         // Read from file into lineBuffer and strip CRLF endings
-        pInterface->readLine(hndl, lineBuffer, 256, true);
+        reader.readLine(lineBuffer, 256, true);
         err = Settings_parseDataChannelSetting(lineBuffer, lineCount++);
         if (err != ERR_READER_NONE) { break; } // Stop on any error encountered
     }
@@ -31,6 +31,7 @@
 #include "DLSettings.DataChannels.h"
 #include "DLSettings.DataChannels.Helper.h"
 #include "DLUtility.h"
+#include "DLUtility.Arena.h"
 
 /*
  * Defines and Typedefs
@@ -38,6 +39,17 @@
 
 #define MAX_LINE_LENGTH (200)
 
+/*
+ * Each channel gets one block big enough for any channel settings struct,
+ * so a channel can change type without needing a new allocation
+ */
+union channel_settings
+{
+    VOLTAGECHANNEL voltage;
+    CURRENTCHANNEL current;
+    THERMISTORCHANNEL thermistor;
+};
+
 /*
  * Private Variables
  */
@@ -45,6 +57,12 @@
 static void * s_channels[MAX_CHANNELS];
 static FIELD_TYPE s_fieldTypes[MAX_CHANNELS];
 
+// All channel settings are allocated from this arena, reserved once for MAX_CHANNELS.
+// Each channel's settings memory is allocated the first time it is needed and then kept,
+// (even if the settings are re-initialised) since fields hold pointers to it.
+static Arena s_arena;
+static void * s_channelMemory[MAX_CHANNELS];
+
 /*
  * For each of the channels that can be stored,
  * the bitfield stores a 1 if a setting has been set.
@@ -66,14 +84,23 @@ static void setupChannel(uint8_t ch, FIELD_TYPE type)
     switch(type)    
     {
     case VOLTAGE:
-        s_channels[ch] = new VOLTAGECHANNEL();
-        break;
     case CURRENT:
-        s_channels[ch] = new CURRENTCHANNEL();
     case TEMPERATURE_C:
     case TEMPERATURE_F:
     case TEMPERATURE_K:
-        s_channels[ch] = new THERMISTORCHANNEL();
+        if (!s_arena.size())
+        {
+            s_arena.reserve(MAX_CHANNELS * ARENA_ALIGN(sizeof(union channel_settings)));
+        }
+        if (!s_channelMemory[ch])
+        {
+            s_channelMemory[ch] = s_arena.allocate(sizeof(union channel_settings));
+        }
+        s_channels[ch] = s_channelMemory[ch];
+        if (s_channels[ch])
+        {
+            memset(s_channels[ch], 0, sizeof(union channel_settings));
+        }
         break;
     default:
     case INVALID_TYPE:
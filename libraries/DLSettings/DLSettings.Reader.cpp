@@ -29,6 +29,7 @@
  */
 
 #include "DLLocalStorage.h"
+#include "DLLocalStorage.LineReader.h"
 #include "DLSettings.h"
 #include "DLSettings.Global.h"
 #include "DLSettings.Reader.h"
@@ -82,16 +83,19 @@ SETTINGS_READER_RESULT Settings_readGlobalFromFile(LocalStorageInterface * pInte
     }
     
     uint8_t hndl = pInterface->openFile(filename, false);
-    while (!pInterface->endOfFile(hndl))
+    LineReader reader(pInterface, hndl);
+    SETTINGS_READER_RESULT res = ERR_READER_NONE;
+
+    while (!reader.endOfFile())
     {
         // Read from file into lineBuffer and strip CRLF endings
-        pInterface->readLine(hndl, lineBuffer, 256, true);
-        SETTINGS_READER_RESULT res = Settings_readFromString(lineBuffer, lineCount++);
-        if (res != ERR_READER_NONE) { return res; }
+        reader.readLine(lineBuffer, 256, true);
+        res = Settings_readFromString(lineBuffer, lineCount++);
+        if (res != ERR_READER_NONE) { break; }
     }
 
     pInterface->closeFile(hndl);
-    return noError();
+    return (res == ERR_READER_NONE) ? noError() : res;
 }
 
 SETTINGS_READER_RESULT Settings_readFromString(char const * const string, int lineNo)
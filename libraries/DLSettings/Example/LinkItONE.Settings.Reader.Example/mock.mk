@@ -1,10 +1,14 @@
 SRC_FILES += DLUtility/DLUtility.Strings.cpp
 SRC_FILES += DLUtility/DLUtility.ArrayFunctions.cpp
 SRC_FILES += DLUtility/DLUtility.Averager.cpp
+SRC_FILES += DLUtility/DLUtility.FixedPoint.cpp
+SRC_FILES += DLUtility/DLUtility.Arena.cpp
 SRC_FILES += DLUtility/DLUtility.Time.cpp
 
 SRC_FILES += DLSettings/DLSettings.cpp
 SRC_FILES += DLSettings/DLSettings.Global.cpp
 SRC_FILES += DLSettings/DLSettings.DataChannels.cpp
 SRC_FILES += DLSettings/DLSettings.DataChannels.Helper.cpp
-SRC_FILES += DLSettings/DLSettings.Reader.cpp
\ No newline at end of file
+SRC_FILES += DLSettings/DLSettings.Reader.cpp
+
+SRC_FILES += DLLocalStorage/DLLocalStorage.LineReader.cpp
\ No newline at end of file
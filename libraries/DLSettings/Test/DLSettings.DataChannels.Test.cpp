@@ -206,6 +206,21 @@ void test_ValidCurrentSettingsAreParsedCorrectly(void)
     TEST_ASSERT_EQUAL_FLOAT(0.125, Settings_GetDataAsCurrent(1)->mvPerBit);
 }
 
+void test_ChannelSettingsMemoryIsKeptWhenSettingsAreReinitialised(void)
+{
+    TEST_ASSERT_EQUAL(ERR_READER_NONE, Settings_parseDataChannelSetting("ch1.Type =Current", 1));
+    CURRENTCHANNEL * pSettings = Settings_GetDataAsCurrent(1);
+    TEST_ASSERT_NOT_NULL(pSettings);
+
+    Settings_InitDataChannels();
+    TEST_ASSERT_NULL(Settings_GetData(1));
+
+    TEST_ASSERT_EQUAL(ERR_READER_NONE, Settings_parseDataChannelSetting("ch1.Type =Current", 1));
+    TEST_ASSERT_EQUAL(ERR_READER_NONE, Settings_parseDataChannelSetting("channel1.mvperAmp= 400", 2));
+    TEST_ASSERT_EQUAL_PTR(pSettings, Settings_GetDataAsCurrent(1));
+    TEST_ASSERT_EQUAL_FLOAT(400.0, pSettings->mvPerAmp);
+}
+
 int main(void)
 {
     UnityBegin("DLSettings.DataChannels.Test.cpp");
@@ -229,6 +244,7 @@ int main(void)
 
     RUN_TEST(test_ValidVoltageSettingsAreParsedCorrectly);
     RUN_TEST(test_ValidCurrentSettingsAreParsedCorrectly);
+    RUN_TEST(test_ChannelSettingsMemoryIsKeptWhenSettingsAreReinitialised);
 
   	UnityEnd();
   	return 0;
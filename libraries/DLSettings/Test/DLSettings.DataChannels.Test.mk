@@ -1,5 +1,5 @@
 SRC_FILES += DLSettings/DLSettings.DataChannels.Helper.cpp DLSettings/DLSettings.Reader.Errors.cpp
-SRC_FILES += DLUtility/DLUtility.Strings.cpp
+SRC_FILES += DLUtility/DLUtility.Strings.cpp DLUtility/DLUtility.Arena.cpp
 
 INC_DIRS += -IDLUtility -IDLDataField -IDLLocalStorage
 
@@ -3,6 +3,8 @@ SRC_FILES += ./DLSettings/DLSettings.Reader.Errors.cpp
 
 SRC_FILES += ./DLUtility/DLUtility.Strings.cpp
 SRC_FILES += ./DLTest/DLTest.Mock.LocalStorage.cpp
+SRC_FILES += ./DLLocalStorage/DLLocalStorage.Handles.cpp
+SRC_FILES += ./DLLocalStorage/DLLocalStorage.LineReader.cpp
 
 INC_DIRS += -IDLUtility -IDLLocalStorage
 
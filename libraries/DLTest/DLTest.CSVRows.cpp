@@ -0,0 +1,27 @@
+/*
+ * DLTest.CSVRows.cpp
+ *
+ * Fixed length CSV rows for upload tests
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * C++ Library Includes
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "DLTest.CSVRows.h"
+
+static char s_row[TEST_CSV_ROW_LENGTH + 1];
+
+char const * TEST_MakeCSVRow(uint16_t i)
+{
+    snprintf(s_row, sizeof(s_row), "2015-02-13 07:%02d:%02d +0000,%04d,43.478,51.752,4.90,5.23,9.23,2.84\r\n",
+        (i / 60) % 60, i % 60, i % 10000);
+    return s_row;
+}
@@ -0,0 +1,14 @@
+#ifndef _DL_TEST_CSV_ROWS_H_
+#define _DL_TEST_CSV_ROWS_H_
+
+/*
+ * Fixed length CSV rows for upload tests, so that batch and chunk sizes are easy to work out.
+ * TEST_CSV_ROW_LENGTH includes the "\r\n" at the end of each row.
+ */
+
+#define TEST_CSV_ROW_LENGTH (66)
+
+// Returns row i (each row has a different timestamp and entry id). Valid until the next call.
+char const * TEST_MakeCSVRow(uint16_t i);
+
+#endif
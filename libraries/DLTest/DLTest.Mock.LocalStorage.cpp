@@ -20,21 +20,24 @@
 #include <fstream>
 
 #include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
 #include "DLTest.Mock.LocalStorage.h"
 
 #include "DLUtility.Strings.h"
 
-static std::fstream s_file;
-
 LocalStorageInterface * LocalStorage_GetLocalStorageInterface(LOCAL_STORAGE_TYPE storage_type)
 {
     (void)storage_type;
     return new TestStorageInterface();
 }
 
-TestStorageInterface::TestStorageInterface()
+// maxOpenFiles (up to STORAGE_MAX_OPEN_FILES) can be reduced to 1 to behave as on the LinkIt ONE
+TestStorageInterface::TestStorageInterface(uint8_t maxOpenFiles) :
+    m_handles((maxOpenFiles < STORAGE_MAX_OPEN_FILES) ? maxOpenFiles : STORAGE_MAX_OPEN_FILES)
 {
     m_echo = false;
+    m_physicalOpens = 0;
+    clearWriteRecord();
 }
 
 bool TestStorageInterface::fileExists(char const * const filePath)
@@ -72,21 +75,28 @@ bool TestStorageInterface::mkDir(char const * const dirPath)
 
 FILE_HANDLE TestStorageInterface::openFile(char const * const filename, bool forWrite)
 {
-
     if (!filename) { return INVALID_HANDLE; }
 
-    s_file.open(filename, forWrite ? std::ios::app : std::ios::in);
+    FILE_HANDLE file = m_handles.add(filename, forWrite);
+
+    if ((file != INVALID_HANDLE) && (getSlot(file) == STORAGE_NO_SLOT))
+    {
+        m_handles.remove(file);
+        file = INVALID_HANDLE;
+    }
 
-    return 0;
+    return file;
 }
 
 void TestStorageInterface::write(FILE_HANDLE file, char const * const toWrite)
 {
-    (void)file;
-    if (!s_file.is_open()) { return; }
     if (!toWrite) { return; }
 
-    s_file << toWrite;
+    uint8_t slot = getSlot(file);
+    if (slot == STORAGE_NO_SLOT) { return; }
+
+    m_files[slot] << toWrite;
+    recordWrite(strlen(toWrite));
 
     if (m_echo)
     {
@@ -94,24 +104,37 @@ void TestStorageInterface::write(FILE_HANDLE file, char const * const toWrite)
     }
 }
 
+void TestStorageInterface::writeBytes(FILE_HANDLE file, uint8_t const * const toWrite, uint32_t n)
+{
+    if (!toWrite) { return; }
+
+    uint8_t slot = getSlot(file);
+    if (slot == STORAGE_NO_SLOT) { return; }
+
+    m_files[slot].write((char const *)toWrite, n);
+    recordWrite(n);
+}
+
 uint32_t TestStorageInterface::readBytes(FILE_HANDLE file, char * buffer, uint32_t n)
 {
-    (void)file;
-    if (!s_file.is_open()) { return 0; }
     if (!buffer) { return 0; }
-    s_file.read(buffer, n);
-    return s_file.gcount();
+
+    uint8_t slot = getSlot(file);
+    if (slot == STORAGE_NO_SLOT) { return 0; }
+
+    m_files[slot].read(buffer, n);
+    return m_files[slot].gcount();
 }
 
 uint32_t TestStorageInterface::readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool stripCRLF)
 {
-    (void)file;
-
-    if (!s_file.is_open()) { return 0; }
     if (!buffer) { return 0; }
 
+    uint8_t slot = getSlot(file);
+    if (slot == STORAGE_NO_SLOT) { return 0; }
+
     std::string strBuffer;
-    std::getline(s_file, strBuffer);
+    std::getline(m_files[slot], strBuffer);
 
     strncpy_safe(buffer, strBuffer.c_str(), n);
 
@@ -136,14 +159,49 @@ uint32_t TestStorageInterface::readLine(FILE_HANDLE file, char * buffer, uint32_
 
 void TestStorageInterface::closeFile(FILE_HANDLE file)
 {
-    (void)file;
-    s_file.close();
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+    if (!pHandle) { return; }
+
+    if (pHandle->slot != STORAGE_NO_SLOT)
+    {
+        m_files[pHandle->slot].close();
+    }
+
+    m_handles.remove(file);
 }
 
 bool TestStorageInterface::endOfFile(FILE_HANDLE file)
 {
-    (void)file;
-    return s_file.eof();
+    uint8_t slot = getSlot(file);
+    if (slot == STORAGE_NO_SLOT) { return true; }
+
+    return m_files[slot].eof();
+}
+
+bool TestStorageInterface::seek(FILE_HANDLE file, uint32_t position)
+{
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+
+    // Files opened for write always append, so only read handles can seek
+    if (!pHandle || pHandle->forWrite) { return false; }
+
+    uint8_t slot = getSlot(file);
+    if (slot == STORAGE_NO_SLOT) { return false; }
+
+    m_files[slot].clear();
+    m_files[slot].seekg(position);
+    return !m_files[slot].fail();
+}
+
+uint32_t TestStorageInterface::fileSize(FILE_HANDLE file)
+{
+    struct stat info;
+
+    uint8_t slot = getSlot(file);
+    if (slot == STORAGE_NO_SLOT) { return 0; }
+
+    m_files[slot].flush();
+    return (stat(m_handles.get(file)->path, &info) == 0) ? info.st_size : 0;
 }
 
 void TestStorageInterface::setEcho(bool set)
@@ -156,3 +214,104 @@ void TestStorageInterface::removeFile(char const * const dirPath)
     remove(dirPath);
 }
 
+StorageHandleTable * TestStorageInterface::getHandleTable(void)
+{
+    return &m_handles;
+}
+
+uint32_t TestStorageInterface::getPhysicalOpenCount(void)
+{
+    return m_physicalOpens;
+}
+
+/*
+ * Handle management
+ * Mirrors the LinkIt ONE implementation: a handle that is not physically open is
+ * reopened on use, suspending the least recently used open handle if required.
+ */
+
+uint8_t TestStorageInterface::getSlot(FILE_HANDLE file)
+{
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+    if (!pHandle) { return STORAGE_NO_SLOT; }
+
+    if (pHandle->slot == STORAGE_NO_SLOT)
+    {
+        uint8_t slot = m_handles.freeSlot();
+        if (slot == STORAGE_NO_SLOT)
+        {
+            FILE_HANDLE lru = m_handles.leastRecentlyUsed();
+            slot = m_handles.get(lru)->slot;
+            suspend(lru);
+        }
+
+        if (!resume(file, slot)) { return STORAGE_NO_SLOT; }
+    }
+
+    m_handles.touch(file);
+    return pHandle->slot;
+}
+
+void TestStorageInterface::suspend(FILE_HANDLE file)
+{
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+    std::fstream& f = m_files[pHandle->slot];
+
+    uint32_t position = 0;
+    if (!pHandle->forWrite)
+    {
+        f.clear();
+        position = f.tellg();
+    }
+
+    f.close();
+    m_handles.setSuspended(file, position);
+}
+
+bool TestStorageInterface::resume(FILE_HANDLE file, uint8_t slot)
+{
+    STORAGE_HANDLE * pHandle = m_handles.get(file);
+    std::fstream& f = m_files[slot];
+
+    f.clear();
+
+    f.open(pHandle->path, (pHandle->forWrite ? std::ios::app : std::ios::in) | std::ios::binary);
+    if (!f.is_open()) { return false; }
+
+    if (!pHandle->forWrite) { f.seekg(pHandle->position); }
+
+    m_handles.setOpen(file, slot);
+    m_physicalOpens++;
+    return true;
+}
+
+/*
+ * Physical write record
+ * Each call to write or writeBytes is counted and (up to TEST_STORAGE_MAX_WRITE_RECORDS) its size kept,
+ * so that tests can check how writes reach the storage.
+ */
+
+uint32_t TestStorageInterface::getWriteCount(void)
+{
+    return m_writeCount;
+}
+
+uint32_t TestStorageInterface::getWriteSize(uint32_t index)
+{
+    return (index < m_writeCount && index < TEST_STORAGE_MAX_WRITE_RECORDS) ? m_writeSizes[index] : 0;
+}
+
+void TestStorageInterface::clearWriteRecord(void)
+{
+    m_writeCount = 0;
+    memset(m_writeSizes, 0, sizeof(m_writeSizes));
+}
+
+void TestStorageInterface::recordWrite(uint32_t n)
+{
+    if (m_writeCount < TEST_STORAGE_MAX_WRITE_RECORDS)
+    {
+        m_writeSizes[m_writeCount] = n;
+    }
+    m_writeCount++;
+}
@@ -1,24 +1,52 @@
 #ifndef _TEST_LOCAL_STORAGE_H_
 #define _TEST_LOCAL_STORAGE_H_
 
+#include <fstream>
+
+// Number of physical write calls recorded by the mock
+#define TEST_STORAGE_MAX_WRITE_RECORDS (64)
+
 class TestStorageInterface : public LocalStorageInterface
 {
     public:
-        TestStorageInterface();
+        TestStorageInterface(uint8_t maxOpenFiles = STORAGE_MAX_OPEN_FILES);
         bool fileExists(char const * const filePath);
         bool directoryExists(char const * const dirPath);
         bool mkDir(char const * const dirPath);
         void write(FILE_HANDLE file, char const * const toWrite);
+        void writeBytes(FILE_HANDLE file, uint8_t const * const toWrite, uint32_t n);
         uint32_t readBytes(FILE_HANDLE file, char * buffer, uint32_t n);
         uint32_t readLine(FILE_HANDLE file, char * buffer, uint32_t n, bool stripCRLF);
         FILE_HANDLE openFile(char const * const filename, bool forWrite);
         void closeFile(FILE_HANDLE file);
         bool endOfFile(FILE_HANDLE file);
+        bool seek(FILE_HANDLE file, uint32_t position);
+        uint32_t fileSize(FILE_HANDLE file);
         void setEcho(bool set);
         void removeFile(char const * const dirPath);
 
+        uint32_t getWriteCount(void);
+        uint32_t getWriteSize(uint32_t index);
+        void clearWriteRecord(void);
+
+        StorageHandleTable * getHandleTable(void);
+        uint32_t getPhysicalOpenCount(void);
+
     private:
+        void recordWrite(uint32_t n);
+
+        uint8_t getSlot(FILE_HANDLE file);
+        void suspend(FILE_HANDLE file);
+        bool resume(FILE_HANDLE file, uint8_t slot);
+
+        // The physical files shared between this instance's handles (see StorageHandleTable)
+        std::fstream m_files[STORAGE_MAX_OPEN_FILES];
+        StorageHandleTable m_handles;
+        uint32_t m_physicalOpens;
+
         bool m_echo;
+        uint32_t m_writeCount;
+        uint32_t m_writeSizes[TEST_STORAGE_MAX_WRITE_RECORDS];
 };
 
 #endif
\ No newline at end of file
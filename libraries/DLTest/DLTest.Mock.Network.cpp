@@ -18,13 +18,22 @@
  * LinkIt One Includes
  */
 
+#include "DLUtility.Strings.h"
 #include "DLNetwork.h"
+#include "DLHTTP.h"
 #include "DLTest.Mock.Network.h"
 
 /*
  * Private Variables
  */
 
+// Generates requests without sending them anywhere
+class DiscardSink : public HTTPSink
+{
+    public:
+        bool write(const char * data, uint32_t n) { (void)data; (void)n; return true; }
+};
+
  /*
  * Public Functions 
  */
@@ -65,4 +74,14 @@ bool TestNetworkInterface::sendHTTPRequest(const char * const url, const char *
     return success;
 }
 
+bool TestNetworkInterface::streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * response, bool useHTTPS)
+{
+    (void)url;
+    (void)useHTTPS;
+    (void)response;
+
+    DiscardSink sink;
+    return request ? request->writeTo(&sink) : false;
+}
+
 bool TestNetworkInterface::isConnected(void) { return true; }
@@ -7,6 +7,7 @@ class TestNetworkInterface : public NetworkInterface
     	TestNetworkInterface();
         bool tryConnection(uint8_t timeoutSeconds);
         bool sendHTTPRequest(const char * const url, const char * request, char * response, bool useHTTPS=false);
+        bool streamHTTPRequest(const char * const url, HTTPRequestStream * request, char * response, bool useHTTPS=false);
         bool isConnected(void);
 };
 
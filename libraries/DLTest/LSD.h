@@ -2,6 +2,7 @@
 #define _MOCK_LSD_H_
 
 #include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
 #include "DLTest.Mock.LocalStorage.h"
 
 #endif
\ No newline at end of file
@@ -23,6 +23,8 @@
  */
 
 #include "DLLocalStorage.h"
+#include "DLLocalStorage.Handles.h"
+#include "DLTest.Mock.LocalStorage.h"
 
 /*
  * Unity Test Framework
@@ -160,6 +162,101 @@ void test_write_CanWriteBytesToOpenFile(void)
     TEST_ASSERT_EQUAL_STRING(expected, actual);
 }
 
+void test_handles_ReadsAndWritesCanInterleave(void)
+{
+    FILE_HANDLE readHandle = s_testInterface->openFile(QUOTED_DL_PATH "/DLTest/Test/TempForRead", false);
+    FILE_HANDLE writeHandle = s_testInterface->openFile(QUOTED_DL_PATH "/DLTest/Test/NewFileInterleaved", true);
+
+    TEST_ASSERT_NOT_EQUAL(INVALID_HANDLE, readHandle);
+    TEST_ASSERT_NOT_EQUAL(INVALID_HANDLE, writeHandle);
+    TEST_ASSERT_NOT_EQUAL(readHandle, writeHandle);
+
+    char actual[10];
+
+    s_testInterface->readBytes(readHandle, actual, 4);
+    TEST_ASSERT_EQUAL_MEMORY("TEST", actual, 4);
+    s_testInterface->write(writeHandle, "ABC");
+    s_testInterface->readBytes(readHandle, actual, 5);
+    TEST_ASSERT_EQUAL_MEMORY(" FILE", actual, 5);
+    s_testInterface->write(writeHandle, "DEF");
+
+    s_testInterface->closeFile(readHandle);
+    s_testInterface->closeFile(writeHandle);
+
+    readHandle = s_testInterface->openFile(QUOTED_DL_PATH "/DLTest/Test/NewFileInterleaved", false);
+    s_testInterface->readLine(readHandle, actual, 10, true);
+    s_testInterface->closeFile(readHandle);
+
+    TEST_ASSERT_EQUAL_STRING("ABCDEF", actual);
+}
+
+void test_handles_ReadPositionIsKeptWhenFileIsSuspended(void)
+{
+    FILE_HANDLE handles[STORAGE_MAX_OPEN_FILES + 1];
+    char actual[10];
+    uint8_t i;
+
+    // Open one more handle than can be physically open at once
+    for (i = 0; i < STORAGE_MAX_OPEN_FILES + 1; i++)
+    {
+        handles[i] = s_testInterface->openFile(QUOTED_DL_PATH "/DLTest/Test/TempForRead", false);
+        TEST_ASSERT_NOT_EQUAL(INVALID_HANDLE, handles[i]);
+    }
+
+    s_testInterface->readBytes(handles[0], actual, 5);
+    TEST_ASSERT_EQUAL_MEMORY("TEST ", actual, 5);
+
+    // Using all the other handles suspends the first
+    for (i = 1; i < STORAGE_MAX_OPEN_FILES + 1; i++)
+    {
+        s_testInterface->readBytes(handles[i], actual, 1);
+        TEST_ASSERT_EQUAL('T', actual[0]);
+    }
+
+    s_testInterface->readBytes(handles[0], actual, 4);
+    TEST_ASSERT_EQUAL_MEMORY("FILE", actual, 4);
+
+    for (i = 0; i < STORAGE_MAX_OPEN_FILES + 1; i++)
+    {
+        s_testInterface->closeFile(handles[i]);
+    }
+}
+
+void test_handles_ClosedHandleIsInvalid(void)
+{
+    char actual[10];
+
+    FILE_HANDLE handle = s_testInterface->openFile(QUOTED_DL_PATH "/DLTest/Test/TempForRead", false);
+    s_testInterface->closeFile(handle);
+
+    TEST_ASSERT_EQUAL(0, s_testInterface->readBytes(handle, actual, 4));
+    TEST_ASSERT_TRUE(s_testInterface->endOfFile(handle));
+}
+
+void test_handles_SingleOpenFileReopensOnEachSwitch(void)
+{
+    // As on the LinkIt ONE, where only one file can be open at a time
+    TestStorageInterface storage(1);
+    char actual[10];
+
+    FILE_HANDLE readHandle = storage.openFile(QUOTED_DL_PATH "/DLTest/Test/TempForRead", false);
+    FILE_HANDLE writeHandle = storage.openFile(QUOTED_DL_PATH "/DLTest/Test/NewFileInterleaved", true);
+    TEST_ASSERT_EQUAL(2, storage.getPhysicalOpenCount());
+
+    storage.readBytes(readHandle, actual, 4);
+    storage.write(writeHandle, "ABC");
+    storage.readBytes(readHandle, actual, 5);
+    TEST_ASSERT_EQUAL_MEMORY(" FILE", actual, 5);
+    storage.write(writeHandle, "DEF");
+
+    // Each switch between the files closes one and reopens the other
+    TEST_ASSERT_EQUAL(6, storage.getPhysicalOpenCount());
+    TEST_ASSERT_EQUAL(1, storage.getHandleTable()->openCount());
+
+    storage.closeFile(readHandle);
+    storage.closeFile(writeHandle);
+}
+
 int main(void)
 {
     UnityBegin("DLTest.LocalStorage.Mock.Test.cpp");
@@ -180,5 +277,10 @@ int main(void)
     
     RUN_TEST(test_openFile_CanOpenNewFileForWrite);
     RUN_TEST(test_write_CanWriteBytesToOpenFile);
+
+    RUN_TEST(test_handles_ReadsAndWritesCanInterleave);
+    RUN_TEST(test_handles_ReadPositionIsKeptWhenFileIsSuspended);
+    RUN_TEST(test_handles_ClosedHandleIsInvalid);
+    RUN_TEST(test_handles_SingleOpenFileReopensOnEachSwitch);
     return 0;
 }
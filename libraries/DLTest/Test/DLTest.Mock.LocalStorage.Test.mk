@@ -2,6 +2,7 @@ INC_DIRS += -IDLLocalStorage
 INC_DIRS += -IDLUtility
 
 SRC_FILES += DLUtility/DLUtility.Strings.cpp
+SRC_FILES += DLLocalStorage/DLLocalStorage.Handles.cpp
 
 local_setup:
 	# Remove test directory
@@ -9,6 +10,7 @@ local_setup:
 
 	# Remove test files
 	rm -f ./DLTest/Test/NewFile
+	rm -f ./DLTest/Test/NewFileInterleaved
 
 	# Create a file for reading
 	printf "TEST FILE CONTENT\r\n" > ./DLTest/Test/TempForRead
@@ -16,4 +18,5 @@ local_setup:
 local_teardown:
 	rm -f ./DLTest/Test/TempForRead
 	rm -f ./DLTest/Test/NewFile
+	rm -f ./DLTest/Test/NewFileInterleaved
 	rm -rf ./DLTest/Test/NewDir
\ No newline at end of file
@@ -0,0 +1,257 @@
+/*
+ * DLUtility.Aggregator.cpp
+ *
+ * Provides cascaded (multi-resolution) min/max/mean aggregation of a data stream
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.HelperMacros.h"
+
+/*
+ * Public Class Functions
+ */
+
+AggregatePyramid::AggregatePyramid()
+{
+    m_levelCount = 0;
+
+    uint8_t i;
+    for (i = 0; i < AGGREGATOR_MAX_LEVELS; i++)
+    {
+        m_levels[i].history = NULL;
+    }
+}
+
+AggregatePyramid::~AggregatePyramid()
+{
+    uint8_t i;
+    for (i = 0; i < m_levelCount; i++)
+    {
+        if (m_levels[i].ownsHistory) { delete[] m_levels[i].history; }
+    }
+}
+
+/*
+ * addLevel
+ *
+ * Adds a level on top of the existing ones.
+ * ratio is the number of items from the level below (raw samples for the first level)
+ * that make up one aggregate at this level, depth is the number of completed aggregates kept.
+ * The history is either allocated here or supplied by the caller (e.g. from an arena),
+ * in which case it must have space for depth aggregates and is not freed by the pyramid.
+ */
+bool AggregatePyramid::addLevel(uint16_t ratio, uint16_t depth)
+{
+    if (depth == 0) { return false; }
+
+    AGGREGATE * history = new AGGREGATE[depth];
+    if (!history) { return false; }
+
+    if (!addLevel(ratio, depth, history))
+    {
+        delete[] history;
+        return false;
+    }
+
+    m_levels[m_levelCount - 1].ownsHistory = true;
+    return true;
+}
+
+bool AggregatePyramid::addLevel(uint16_t ratio, uint16_t depth, AGGREGATE * history)
+{
+    if (m_levelCount == AGGREGATOR_MAX_LEVELS) { return false; }
+    if (ratio == 0 || depth == 0 || !history) { return false; }
+
+    struct level * pLevel = &m_levels[m_levelCount];
+
+    pLevel->history = history;
+    pLevel->ownsHistory = false;
+    pLevel->ratio = ratio;
+    pLevel->depth = depth;
+    pLevel->write = 0;
+    pLevel->length = 0;
+    pLevel->completed = 0;
+    clearPartial(m_levelCount);
+
+    m_levelCount++;
+    return true;
+}
+
+uint8_t AggregatePyramid::levels(void)
+{
+    return m_levelCount;
+}
+
+/*
+ * newData
+ *
+ * Adds a raw sample to the pyramid.
+ * Returns true if this completes an aggregate at level 0.
+ */
+bool AggregatePyramid::newData(int32_t value)
+{
+    if (!m_levelCount) { return false; }
+
+    uint32_t completed = m_levels[0].completed;
+    accumulate(0, value, value, value, 1);
+    return m_levels[0].completed != completed;
+}
+
+void AggregatePyramid::reset(void)
+{
+    uint8_t i;
+    for (i = 0; i < m_levelCount; i++)
+    {
+        m_levels[i].write = 0;
+        m_levels[i].length = 0;
+        m_levels[i].completed = 0;
+        clearPartial(i);
+    }
+}
+
+/*
+ * length
+ *
+ * Returns the number of completed aggregates available at a level
+ */
+uint16_t AggregatePyramid::length(uint8_t level)
+{
+    return (level < m_levelCount) ? m_levels[level].length : 0;
+}
+
+/*
+ * completed
+ *
+ * Returns the number of aggregates completed at a level since the last reset.
+ * Callers can compare this against a previous value to see if new aggregates are ready.
+ */
+uint32_t AggregatePyramid::completed(uint8_t level)
+{
+    return (level < m_levelCount) ? m_levels[level].completed : 0;
+}
+
+/*
+ * getAggregate
+ *
+ * Copies a completed aggregate from a level, where index 0 is the oldest one kept
+ */
+bool AggregatePyramid::getAggregate(uint8_t level, uint16_t index, AGGREGATE * pAggregate)
+{
+    if (!pAggregate) { return false; }
+    if (index >= length(level)) { return false; }
+
+    struct level * pLevel = &m_levels[level];
+
+    uint16_t oldest = (pLevel->length < pLevel->depth) ? 0 : pLevel->write;
+    *pAggregate = pLevel->history[(oldest + index) % pLevel->depth];
+    return true;
+}
+
+bool AggregatePyramid::getLatest(uint8_t level, AGGREGATE * pAggregate)
+{
+    uint16_t n = length(level);
+    return n ? getAggregate(level, n - 1, pAggregate) : false;
+}
+
+/*
+ * getPartial
+ *
+ * Summarises the items received at a level since its last completed aggregate
+ */
+bool AggregatePyramid::getPartial(uint8_t level, AGGREGATE * pAggregate)
+{
+    if (!pAggregate) { return false; }
+    if (level >= m_levelCount) { return false; }
+
+    struct level * pLevel = &m_levels[level];
+    if (pLevel->partialN == 0) { return false; }
+
+    pAggregate->min = (float)pLevel->partialMin;
+    pAggregate->max = (float)pLevel->partialMax;
+    pAggregate->mean = (float)pLevel->partialSum / pLevel->partialCount;
+    pAggregate->count = pLevel->partialCount;
+    return true;
+}
+
+/*
+ * Private Class Functions
+ */
+
+/*
+ * accumulate
+ *
+ * Adds one item to a level. When that completes an aggregate, it is stored in the
+ * level history and passed up to the next level.
+ */
+void AggregatePyramid::accumulate(uint8_t level, int32_t minValue, int32_t maxValue, int64_t sum, uint32_t count)
+{
+    struct level * pLevel = &m_levels[level];
+
+    if (pLevel->partialN == 0)
+    {
+        pLevel->partialMin = minValue;
+        pLevel->partialMax = maxValue;
+    }
+    else
+    {
+        pLevel->partialMin = min(pLevel->partialMin, minValue);
+        pLevel->partialMax = max(pLevel->partialMax, maxValue);
+    }
+
+    pLevel->partialSum += sum;
+    pLevel->partialCount += count;
+    pLevel->partialN++;
+
+    if (pLevel->partialN < pLevel->ratio) { return; }
+
+    AGGREGATE * pAggregate = &pLevel->history[pLevel->write];
+    pAggregate->min = (float)pLevel->partialMin;
+    pAggregate->max = (float)pLevel->partialMax;
+    pAggregate->mean = (float)pLevel->partialSum / pLevel->partialCount;
+    pAggregate->count = pLevel->partialCount;
+
+    incrementwithrollover(pLevel->write, pLevel->depth - 1);
+    if (pLevel->length < pLevel->depth) { pLevel->length++; }
+    pLevel->completed++;
+
+    // Sum and count (rather than mean) are passed up so that the next level weights correctly
+    int32_t completedMin = pLevel->partialMin;
+    int32_t completedMax = pLevel->partialMax;
+    int64_t completedSum = pLevel->partialSum;
+    uint32_t completedCount = pLevel->partialCount;
+    clearPartial(level);
+
+    if ((level + 1) < m_levelCount)
+    {
+        accumulate(level + 1, completedMin, completedMax, completedSum, completedCount);
+    }
+}
+
+void AggregatePyramid::clearPartial(uint8_t level)
+{
+    m_levels[level].partialN = 0;
+    m_levels[level].partialMin = 0;
+    m_levels[level].partialMax = 0;
+    m_levels[level].partialSum = 0;
+    m_levels[level].partialCount = 0;
+}
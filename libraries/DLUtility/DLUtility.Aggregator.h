@@ -0,0 +1,83 @@
+#ifndef _DL_UTILITY_AGGREGATOR_H_
+#define _DL_UTILITY_AGGREGATOR_H_
+
+/*
+ * Defines and Typedefs
+ */
+
+#define AGGREGATOR_MAX_LEVELS 4
+
+/*
+ * AGGREGATE
+ *
+ * Summary of a block of raw samples.
+ * count is always the number of raw samples in the block, at every level.
+ */
+struct aggregate
+{
+    float min;
+    float max;
+    float mean;
+    uint32_t count;
+};
+typedef struct aggregate AGGREGATE;
+
+/*
+ * AggregatePyramid
+ *
+ * Cascaded min/max/mean/count aggregation of a stream of samples.
+ * Level 0 summarises every "ratio" raw samples, level 1 summarises every "ratio" level 0
+ * aggregates and so on, so a raw -> 1s -> 1min -> 1h pyramid is built with
+ * ratios of (samples per second), 60 and 60.
+ * Each level keeps a ring of its last "depth" completed aggregates.
+ * Every raw sample is only touched once, however many levels are read.
+ *
+ * Samples are raw (integer) ADC values, accumulated with integer arithmetic
+ * so that no floating point work is done per sample; each completed aggregate
+ * needs one division for its mean.
+ */
+
+class AggregatePyramid
+{
+    public:
+        AggregatePyramid();
+        ~AggregatePyramid();
+
+        bool addLevel(uint16_t ratio, uint16_t depth);
+        bool addLevel(uint16_t ratio, uint16_t depth, AGGREGATE * history);
+        uint8_t levels(void);
+
+        bool newData(int32_t value);
+        void reset(void);
+
+        uint16_t length(uint8_t level);
+        uint32_t completed(uint8_t level);
+        bool getAggregate(uint8_t level, uint16_t index, AGGREGATE * pAggregate);
+        bool getLatest(uint8_t level, AGGREGATE * pAggregate);
+        bool getPartial(uint8_t level, AGGREGATE * pAggregate);
+
+    private:
+        struct level
+        {
+            uint16_t ratio;
+            uint16_t depth;
+            uint16_t write;
+            uint16_t length;
+            uint16_t partialN;
+            uint32_t completed;
+            int32_t partialMin;
+            int32_t partialMax;
+            int64_t partialSum;
+            uint32_t partialCount;
+            AGGREGATE * history;
+            bool ownsHistory;
+        };
+
+        void accumulate(uint8_t level, int32_t min, int32_t max, int64_t sum, uint32_t count);
+        void clearPartial(uint8_t level);
+
+        struct level m_levels[AGGREGATOR_MAX_LEVELS];
+        uint8_t m_levelCount;
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * DLUtility.Arena.cpp
+ *
+ * Provides a bump allocator for setup-time allocations
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.Arena.h"
+
+/*
+ * Public Class Functions
+ */
+
+Arena::Arena()
+{
+    m_memory = NULL;
+    m_size = 0;
+    m_used = 0;
+    m_highWaterMark = 0;
+    m_failures = 0;
+}
+
+Arena::~Arena()
+{
+    delete[] m_memory;
+}
+
+/*
+ * reserve
+ *
+ * Allocates the arena memory. This can only be done once.
+ */
+bool Arena::reserve(uint32_t size)
+{
+    if (m_memory || (size == 0)) { return false; }
+
+    m_memory = new uint8_t[ARENA_ALIGN(size)];
+
+    if (m_memory)
+    {
+        m_size = ARENA_ALIGN(size);
+        m_used = 0;
+    }
+
+    return m_memory != NULL;
+}
+
+void * Arena::allocate(uint32_t size)
+{
+    uint32_t alignedSize = ARENA_ALIGN(size);
+
+    if (!m_memory || (alignedSize > (m_size - m_used)))
+    {
+        m_failures++;
+        return NULL;
+    }
+
+    void * p = &m_memory[m_used];
+    m_used += alignedSize;
+
+    if (m_used > m_highWaterMark) { m_highWaterMark = m_used; }
+
+    return p;
+}
+
+/*
+ * reset
+ *
+ * Makes all the arena memory available again.
+ * Anything allocated from the arena must no longer be used.
+ * The high-water mark is kept.
+ */
+void Arena::reset(void)
+{
+    m_used = 0;
+}
+
+uint32_t Arena::size(void) { return m_size; }
+uint32_t Arena::used(void) { return m_used; }
+uint32_t Arena::highWaterMark(void) { return m_highWaterMark; }
+uint32_t Arena::failures(void) { return m_failures; }
@@ -0,0 +1,51 @@
+#ifndef _DL_UTILITY_ARENA_H_
+#define _DL_UTILITY_ARENA_H_
+
+/*
+ * Defines and Typedefs
+ */
+
+// Every allocation is aligned to this many bytes (enough for int64_t and double)
+#define ARENA_ALIGNMENT 8
+
+#define ARENA_ALIGN(size) (((size) + (ARENA_ALIGNMENT - 1)) & ~(uint32_t)(ARENA_ALIGNMENT - 1))
+
+/*
+ * Arena
+ *
+ * Bump allocator for memory that lives as long as the application.
+ * The arena is reserved once (a single heap allocation) and allocations are
+ * then taken from it in order. There is no per-allocation free: the whole arena
+ * can be reset, and the high-water mark records the most that was ever used.
+ * When the arena is full, allocate returns NULL (and counts the failure).
+ *
+ * Objects are constructed in an arena with "new (arena) T(...)";
+ * they must not be deleted.
+ */
+class Arena
+{
+    public:
+        Arena();
+        ~Arena();
+
+        bool reserve(uint32_t size);
+        void * allocate(uint32_t size);
+        void reset(void);
+
+        uint32_t size(void);
+        uint32_t used(void);
+        uint32_t highWaterMark(void);
+        uint32_t failures(void);
+
+    private:
+        uint8_t * m_memory;
+        uint32_t m_size;
+        uint32_t m_used;
+        uint32_t m_highWaterMark;
+        uint32_t m_failures;
+};
+
+inline void * operator new(size_t size, Arena& arena) throw() { return arena.allocate(size); }
+inline void operator delete(void * p, Arena& arena) throw() { (void)p; (void)arena; }
+
+#endif
@@ -24,6 +24,7 @@
 #include "DLUtility.Averager.h"
 #include "DLUtility.HelperMacros.h"
 #include "DLUtility.ArrayFunctions.h"
+#include "DLUtility.FixedPoint.h"
 
 /*
  * Defines and Typedefs
@@ -37,6 +38,21 @@ template <typename T>
 Averager<T>::Averager(uint16_t size)
 {
 	m_data = new T[size];
+	m_sum = 0;
+	m_write = 0;
+	m_maxIndex = size -1;
+	m_full = false;
+}
+
+/*
+ * As above, but the averager uses the caller's buffer (of at least size values)
+ * instead of allocating its own
+ */
+template <typename T>
+Averager<T>::Averager(uint16_t size, T * buffer)
+{
+	m_data = buffer;
+	m_sum = 0;
 	m_write = 0;
 	m_maxIndex = size -1;
 	m_full = false;
@@ -68,6 +84,7 @@ void Averager<T>::reset(T * value)
 		fillArray(m_data, *value, size());
 	}
 
+	m_sum = value ? (typename AveragerSum<T>::type)(*value) * size() : 0;
 	m_write = 0;
 	m_full = (value != NULL); 
 }
@@ -78,60 +95,94 @@ uint16_t Averager<T>::N(void)
 	return m_full ? m_maxIndex : m_write;
 }
 
+/*
+ * getFloatAverage, getAverage
+ *
+ * The sum of the window is kept up to date by newData,
+ * so both averages are O(1) regardless of the averager size.
+ */
 template <typename T>
 float Averager<T>::getFloatAverage(void)
 {
-	float sum = 0;
-	uint16_t count = 0;
-
-	if (m_write || m_full)
-	{
-		uint16_t n = 0;
-		count = m_full ? m_maxIndex : m_write - 1;
-		for (n = 0; n <= count; n++)
-		{
-			sum += m_data[n];
-		}
-	}
-	else
-	{
-		sum = 0;
-	}
-
-	sum = sum / (float)(count+1.0f);
-	return sum;
+	uint16_t n = count();
+	return n ? (float)m_sum / n : 0.0f;
 }
 
 template <typename T>
 T Averager<T>::getAverage(void)
 {
-	int64_t sum = 0;
-	uint16_t count = 0;
+	uint16_t n = count();
+	int64_t sum = (int64_t)m_sum;
 
-	if (m_write || m_full)
-	{
-		uint16_t n = 0;
-		count = m_full ? m_maxIndex : m_write - 1;
-		for (n = 0; n <= count; n++)
-		{
-			sum += m_data[n];
-		}
-	}
-	else
+	if (n)
 	{
-		sum = 0;
+		sum = div_round(sum, n);
 	}
 
-	sum = div_round(sum, count+1);
 	return sum;
 }
 
+/*
+ * getFixedAverage
+ *
+ * Returns the average as a Q16.16 fixed-point value (see DLUtility.FixedPoint.h),
+ * using integer arithmetic only for integer averagers.
+ */
+template <typename T>
+int32_t Averager<T>::getFixedAverage(void)
+{
+	return FIXED_FromRatio((int64_t)m_sum, count());
+}
+
 template <typename T>
 void Averager<T>::newData(T newData)
 {
+	// Once the averager is full, the value being written over drops out of the window
+	if (m_full) { m_sum -= m_data[m_write]; }
+
 	m_data[m_write] = newData;
+	m_sum += newData;
+
 	m_full |= (m_write == m_maxIndex);
 	incrementwithrollover(m_write, m_maxIndex);
+
+	if (!AveragerSum<T>::exact && (m_write == 0))
+	{
+		resum();
+	}
+}
+
+/*
+ * Private Functions
+ */
+
+/*
+ * count
+ *
+ * Returns the number of values currently in the averaging window
+ */
+template <typename T>
+uint16_t Averager<T>::count(void)
+{
+	return m_full ? size() : m_write;
+}
+
+/*
+ * resum
+ *
+ * Recalculates the running sum from scratch to remove accumulated rounding error
+ */
+template <typename T>
+void Averager<T>::resum(void)
+{
+	uint16_t n;
+	uint16_t total = count();
+
+	m_sum = 0;
+	for (n = 0; n < total; n++)
+	{
+		m_sum += m_data[n];
+	}
 }
 
 #ifdef TEST
@@ -5,15 +5,38 @@
  * Defines and Typedefs
  */
 
+/*
+ * AveragerSum
+ *
+ * The type used to hold the running sum of an Averager<T>.
+ * Integer data is summed exactly. Floating point sums can drift as values are
+ * added and removed, so those averagers re-sum the whole window once per rollover.
+ */
+template <typename T>
+struct AveragerSum
+{
+	typedef int64_t type;
+	static const bool exact = true;
+};
+
+template <>
+struct AveragerSum<float>
+{
+	typedef double type;
+	static const bool exact = false;
+};
+
 template <typename T>
 class Averager
 {
 	public:
 		Averager(uint16_t size);
+		Averager(uint16_t size, T * buffer);
 		void reset(T * value);
 		uint16_t size(void);
 		float getFloatAverage(void);
 		T getAverage(void);
+		int32_t getFixedAverage(void);
 		void newData(T NewData);
 		uint16_t N(void);
 		bool full(void);
@@ -23,7 +46,11 @@ class Averager
 		#endif
 
 	private:
+		uint16_t count(void);
+		void resum(void);
+
 		T * m_data;
+		typename AveragerSum<T>::type m_sum;
 		uint16_t m_write;
 		uint16_t m_maxIndex;
 		bool m_full;
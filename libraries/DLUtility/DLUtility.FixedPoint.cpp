@@ -0,0 +1,189 @@
+/*
+ * DLUtility.FixedPoint.cpp
+ *
+ * Q16.16 fixed-point arithmetic and formatting
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.FixedPoint.h"
+
+/*
+ * Private Variables
+ */
+
+static const uint32_t s_powersOfTen[] = {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL};
+
+/*
+ * Private Functions
+ */
+
+/*
+ * roundingShift
+ *
+ * Arithmetic right shift of a 64-bit value, rounding to the nearest result
+ */
+static int64_t roundingShift(int64_t value, uint8_t shift)
+{
+    if (shift == 0) { return value; }
+    return (value + ((int64_t)1 << (shift - 1))) >> shift;
+}
+
+/*
+ * Public Functions
+ */
+
+FIXED FIXED_FromInt(int32_t value)
+{
+    return value * FIXED_ONE;
+}
+
+FIXED FIXED_FromFloat(float value)
+{
+    return (FIXED)floor((value * FIXED_ONE) + 0.5f);
+}
+
+float FIXED_ToFloat(FIXED value)
+{
+    return (float)value / FIXED_ONE;
+}
+
+FIXED FIXED_Multiply(FIXED a, FIXED b)
+{
+    return (FIXED)roundingShift((int64_t)a * b, FIXED_FRACTIONAL_BITS);
+}
+
+/*
+ * FIXED_FromRatio
+ *
+ * Returns numerator/denominator as a fixed-point value, rounded to nearest
+ * (e.g. an average from a sum and a count).
+ */
+FIXED FIXED_FromRatio(int64_t numerator, int64_t denominator)
+{
+    if (denominator == 0) { return 0; }
+
+    if (denominator < 0)
+    {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+
+    numerator *= FIXED_ONE;
+
+    if (numerator >= 0)
+    {
+        return (FIXED)((numerator + (denominator / 2)) / denominator);
+    }
+    else
+    {
+        return (FIXED)((numerator - (denominator / 2)) / denominator);
+    }
+}
+
+/*
+ * FIXED_ScaleFromFloat
+ *
+ * Works out the multiplier and shift for a scale factor.
+ * Factors of 2^31 or more can't be represented and are clamped.
+ */
+FIXED_SCALE FIXED_ScaleFromFloat(double scale)
+{
+    FIXED_SCALE result = {0, 0};
+    double magnitude = fabs(scale);
+
+    if (magnitude == 0.0) { return result; }
+
+    // The value being scaled is up to 2^31, so multiplier * value must fit in 62 bits
+    while ((result.shift < 62) && ((magnitude * 2.0) < 2147483647.0))
+    {
+        magnitude *= 2.0;
+        result.shift++;
+    }
+
+    if (magnitude > 2147483647.0) { magnitude = 2147483647.0; }
+
+    result.multiplier = (int32_t)floor(magnitude + 0.5);
+    if (scale < 0) { result.multiplier = -result.multiplier; }
+
+    return result;
+}
+
+FIXED FIXED_ApplyScale(FIXED value, FIXED_SCALE scale)
+{
+    return (FIXED)roundingShift((int64_t)value * scale.multiplier, scale.shift);
+}
+
+void FIXED_LinearFromFloat(FIXED_LINEAR * pLinear, double scale, double offset)
+{
+    if (!pLinear) { return; }
+
+    pLinear->scale = FIXED_ScaleFromFloat(scale);
+    pLinear->offset = (FIXED)floor((offset * FIXED_ONE) + 0.5);
+}
+
+FIXED FIXED_ApplyLinear(FIXED value, FIXED_LINEAR const * pLinear)
+{
+    return FIXED_ApplyScale(value, pLinear->scale) + pLinear->offset;
+}
+
+/*
+ * FIXED_ToString
+ *
+ * Writes value to buffer with the given number of decimal places (maximum FIXED_MAX_DECIMALS),
+ * rounded to nearest. Only integer arithmetic is used.
+ * Returns the number of characters written.
+ */
+uint8_t FIXED_ToString(char * buffer, FIXED value, uint8_t decimals)
+{
+    if (!buffer) { return 0; }
+
+    if (decimals > FIXED_MAX_DECIMALS) { decimals = FIXED_MAX_DECIMALS; }
+
+    bool negative = value < 0;
+    uint32_t magnitude = negative ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+
+    uint32_t integer = magnitude >> FIXED_FRACTIONAL_BITS;
+    uint32_t fraction = magnitude & (FIXED_ONE - 1);
+
+    uint32_t scaledFraction = (uint32_t)(((uint64_t)fraction * s_powersOfTen[decimals] + (FIXED_ONE / 2)) >> FIXED_FRACTIONAL_BITS);
+    if (scaledFraction >= s_powersOfTen[decimals])
+    {
+        integer++;
+        scaledFraction -= s_powersOfTen[decimals];
+    }
+
+    // Don't print "-0.00" for small negative values
+    negative = negative && (integer || scaledFraction);
+
+    int length;
+    if (decimals)
+    {
+        length = sprintf(buffer, "%s%lu.%0*lu", negative ? "-" : "",
+            (unsigned long)integer, (int)decimals, (unsigned long)scaledFraction);
+    }
+    else
+    {
+        length = sprintf(buffer, "%s%lu", negative ? "-" : "", (unsigned long)integer);
+    }
+
+    return (uint8_t)length;
+}
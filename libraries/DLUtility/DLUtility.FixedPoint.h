@@ -0,0 +1,60 @@
+#ifndef _DL_UTILITY_FIXEDPOINT_H_
+#define _DL_UTILITY_FIXEDPOINT_H_
+
+/*
+ * Q16.16 fixed-point arithmetic
+ *
+ * Values are int32_t with 16 integer and 16 fractional bits
+ * (range about +/-32768, resolution about 0.000015).
+ * Only the FromFloat/ToFloat/ScaleFromFloat functions use floating point:
+ * these are for setup and testing, not per-sample work.
+ */
+
+typedef int32_t FIXED;
+
+#define FIXED_FRACTIONAL_BITS 16
+#define FIXED_ONE ((FIXED)1 << FIXED_FRACTIONAL_BITS)
+#define FIXED_MAX_DECIMALS 5
+
+/*
+ * FIXED_SCALE
+ *
+ * A multiplication factor stored as multiplier / 2^shift.
+ * The shift is chosen per factor to keep as many significant bits as possible,
+ * so very small factors (e.g. volts per ADC bit) keep their precision.
+ */
+struct fixed_scale
+{
+    int32_t multiplier;
+    uint8_t shift;
+};
+typedef struct fixed_scale FIXED_SCALE;
+
+/*
+ * FIXED_LINEAR
+ *
+ * A linear conversion: out = (in * scale) + offset
+ */
+struct fixed_linear
+{
+    FIXED_SCALE scale;
+    FIXED offset;
+};
+typedef struct fixed_linear FIXED_LINEAR;
+
+FIXED FIXED_FromInt(int32_t value);
+FIXED FIXED_FromFloat(float value);
+float FIXED_ToFloat(FIXED value);
+
+FIXED FIXED_Multiply(FIXED a, FIXED b);
+FIXED FIXED_FromRatio(int64_t numerator, int64_t denominator);
+
+FIXED_SCALE FIXED_ScaleFromFloat(double scale);
+FIXED FIXED_ApplyScale(FIXED value, FIXED_SCALE scale);
+
+void FIXED_LinearFromFloat(FIXED_LINEAR * pLinear, double scale, double offset);
+FIXED FIXED_ApplyLinear(FIXED value, FIXED_LINEAR const * pLinear);
+
+uint8_t FIXED_ToString(char * buffer, FIXED value, uint8_t decimals);
+
+#endif
@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #endif
 
 /*
@@ -59,12 +60,11 @@ uint32_t readLineWithReadFunction(READFN fn, char * buffer, uint32_t n, bool str
 
 	if (stripCRLF)
 	{
-		readCount--;
-		while((buffer[readCount] == '\r') || (buffer[readCount] == '\n'))
+		// Check readCount first, so that an empty (or all CRLF) line does not underflow
+		while((readCount > 0) && ((buffer[readCount - 1] == '\r') || (buffer[readCount - 1] == '\n')))
 		{
-			buffer[readCount--] = '\0';
+			buffer[--readCount] = '\0';
 		}
-		readCount++; // Put read pointer back to position of last NULL
 	}
 
 	if (readCount < n)
@@ -0,0 +1,49 @@
+/*
+ * DLUtility.RingBuffer.cpp
+ *
+ * Support functions for power-of-two ring buffers
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.RingBuffer.h"
+
+/*
+ * Public Functions
+ */
+
+/*
+ * RING_RoundUpToPowerOfTwo
+ *
+ * Used to size storage for runtime-sized rings,
+ * so that indexes can be masked instead of taken modulo the size.
+ */
+uint32_t RING_RoundUpToPowerOfTwo(uint32_t n)
+{
+    if (n <= 1) { return 1; }
+
+    n--;
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+    return n + 1;
+}
@@ -0,0 +1,361 @@
+#ifndef _DL_UTILITY_RINGBUFFER_H_
+#define _DL_UTILITY_RINGBUFFER_H_
+
+/*
+ * Defines and Typedefs
+ */
+
+/*
+ * Indexes shared between a producer and a consumer (SPSCRingIndex).
+ * On hosts with C++11 these are std::atomic with acquire/release ordering.
+ * On embedded targets they are volatile, with a full barrier around each access
+ * (on a single core, this orders them against interrupts).
+ */
+#if !defined(ARDUINO) && (__cplusplus >= 201103L)
+#define RINGBUFFER_USE_ATOMICS
+#include <atomic>
+typedef std::atomic<uint32_t> RING_INDEX;
+#else
+typedef volatile uint32_t RING_INDEX;
+#endif
+
+#if defined(__GNUC__)
+#define RINGBUFFER_BARRIER() __sync_synchronize()
+#else
+#define RINGBUFFER_BARRIER()
+#endif
+
+// Reads an index written by the other side (loads after this see the data it published)
+inline uint32_t RING_LoadAcquire(RING_INDEX const& index)
+{
+#ifdef RINGBUFFER_USE_ATOMICS
+    return index.load(std::memory_order_acquire);
+#else
+    uint32_t value = index;
+    RINGBUFFER_BARRIER();
+    return value;
+#endif
+}
+
+// Publishes an index (stores before this are visible to the other side first)
+inline void RING_StoreRelease(RING_INDEX& index, uint32_t value)
+{
+#ifdef RINGBUFFER_USE_ATOMICS
+    index.store(value, std::memory_order_release);
+#else
+    RINGBUFFER_BARRIER();
+    index = value;
+#endif
+}
+
+// Reads an index that only this side writes
+inline uint32_t RING_LoadOwn(RING_INDEX const& index)
+{
+#ifdef RINGBUFFER_USE_ATOMICS
+    return index.load(std::memory_order_relaxed);
+#else
+    return index;
+#endif
+}
+
+/*
+ * Public Functions
+ */
+
+// Returns the smallest power of two >= n (n = 0 returns 1)
+uint32_t RING_RoundUpToPowerOfTwo(uint32_t n);
+
+/*
+ * RingBuffer
+ *
+ * Fixed-capacity FIFO of N values, where N must be a power of two.
+ * Head and tail are free-running counters, and a slot index is the counter
+ * masked with (N - 1). This means no modulo (division) and no wraparound
+ * special case, since unsigned overflow of the counters is harmless.
+ *
+ * The stored values occupy at most two contiguous spans of the buffer
+ * (before and after the wrap), which getSpans returns for bulk access.
+ */
+template <typename T, uint32_t N>
+class RingBuffer
+{
+    // Fails to compile if N is not a power of two
+    typedef char CapacityMustBePowerOfTwo[((N > 0) && ((N & (N - 1)) == 0)) ? 1 : -1];
+
+    public:
+        RingBuffer() : m_head(0), m_tail(0) {}
+
+        static uint32_t capacity(void) { return N; }
+        uint32_t length(void) const { return m_head - m_tail; }
+        uint32_t space(void) const { return N - length(); }
+        bool empty(void) const { return m_head == m_tail; }
+        bool full(void) const { return length() == N; }
+        void clear(void) { m_head = m_tail = 0; }
+
+        // Adds a value. Returns false (and does nothing) if the buffer is full.
+        bool push(T const& value)
+        {
+            if (full()) { return false; }
+            m_data[slot(m_head++)] = value;
+            return true;
+        }
+
+        // Adds a value, discarding the oldest value if the buffer is full.
+        void pushOverwrite(T const& value)
+        {
+            if (full()) { m_tail++; }
+            m_data[slot(m_head++)] = value;
+        }
+
+        // Removes the oldest value into *value (if not NULL). Returns false if empty.
+        bool pop(T * value)
+        {
+            if (empty()) { return false; }
+            if (value) { *value = m_data[slot(m_tail)]; }
+            m_tail++;
+            return true;
+        }
+
+        // Returns a pointer to the value at index (0 is the oldest), or NULL.
+        T * peek(uint32_t index)
+        {
+            return (index < length()) ? &m_data[slot(m_tail + index)] : NULL;
+        }
+
+        // Adds up to n values. Returns the number added.
+        uint32_t push(T const * values, uint32_t n)
+        {
+            if (n > space()) { n = space(); }
+
+            uint32_t i;
+            for (i = 0; i < n; i++) { m_data[slot(m_head + i)] = values[i]; }
+            m_head += n;
+            return n;
+        }
+
+        // Removes up to n values (oldest first) into values. Returns the number removed.
+        uint32_t pop(T * values, uint32_t n)
+        {
+            if (n > length()) { n = length(); }
+
+            uint32_t i;
+            for (i = 0; i < n; i++) { values[i] = m_data[slot(m_tail + i)]; }
+            m_tail += n;
+            return n;
+        }
+
+        // Removes up to n values without reading them. Returns the number removed.
+        uint32_t discard(uint32_t n)
+        {
+            if (n > length()) { n = length(); }
+            m_tail += n;
+            return n;
+        }
+
+        /*
+         * getSpans
+         *
+         * Gets the stored values (oldest first) as up to two contiguous spans.
+         * Returns the total number of values. Use discard to remove them once used.
+         */
+        uint32_t getSpans(T ** first, uint32_t * firstN, T ** second, uint32_t * secondN)
+        {
+            uint32_t count = length();
+            uint32_t tail = slot(m_tail);
+            uint32_t nFirst = (count < (N - tail)) ? count : (N - tail);
+            uint32_t nSecond = count - nFirst;
+
+            if (first) { *first = nFirst ? &m_data[tail] : NULL; }
+            if (firstN) { *firstN = nFirst; }
+            if (second) { *second = nSecond ? m_data : NULL; }
+            if (secondN) { *secondN = nSecond; }
+
+            return count;
+        }
+
+    private:
+        static uint32_t slot(uint32_t counter) { return counter & (N - 1); }
+
+        T m_data[N];
+        uint32_t m_head;
+        uint32_t m_tail;
+};
+
+/*
+ * SPSCRingIndex
+ *
+ * The head/tail bookkeeping of a wait-free single-producer/single-consumer ring,
+ * without the storage. Capacity is set at runtime (a power of two), so rings whose
+ * element size or count is only known at runtime (e.g. SampleQueue rows) share it
+ * with SPSCRingBuffer.
+ *
+ * Only the producer writes the head and only the consumer writes the tail.
+ * Each side publishes its index only after the data access it guards.
+ */
+class SPSCRingIndex
+{
+    public:
+        SPSCRingIndex() : m_mask(0), m_head(0), m_tail(0) {}
+
+        // Empties the ring. Must not be called while the producer or consumer is running.
+        void reset(uint32_t capacity)
+        {
+            m_mask = capacity - 1;
+            RING_StoreRelease(m_head, 0);
+            RING_StoreRelease(m_tail, 0);
+        }
+
+        uint32_t capacity(void) const { return m_mask + 1; }
+
+        // Either side (exact for the consumer, a lower bound of free space for the producer)
+        uint32_t length(void) const { return RING_LoadAcquire(m_head) - RING_LoadAcquire(m_tail); }
+
+        /*
+         * Producer only: writeSpan
+         *
+         * Gets the slot of the next free element and how many free elements follow it
+         * contiguously (up to the end of the storage). Returns 0 if the ring is full.
+         * Write into the span, then call commitWrite.
+         */
+        uint32_t writeSpan(uint32_t * slot) const
+        {
+            uint32_t head = RING_LoadOwn(m_head);
+            uint32_t space = (m_mask + 1) - (head - RING_LoadAcquire(m_tail));
+            uint32_t toEnd = (m_mask + 1) - (head & m_mask);
+
+            if (slot) { *slot = head & m_mask; }
+            return (space < toEnd) ? space : toEnd;
+        }
+
+        void commitWrite(uint32_t n)
+        {
+            RING_StoreRelease(m_head, RING_LoadOwn(m_head) + n);
+        }
+
+        /*
+         * Consumer only: readSpan
+         *
+         * Gets the slot of the oldest element and how many elements follow it
+         * contiguously (up to the end of the storage; the rest are returned
+         * by the next call after commitRead). Returns 0 if the ring is empty.
+         */
+        uint32_t readSpan(uint32_t * slot) const
+        {
+            uint32_t tail = RING_LoadOwn(m_tail);
+            uint32_t count = RING_LoadAcquire(m_head) - tail;
+            uint32_t toEnd = (m_mask + 1) - (tail & m_mask);
+
+            if (slot) { *slot = tail & m_mask; }
+            return (count < toEnd) ? count : toEnd;
+        }
+
+        // Frees up to n elements for the producer to reuse. Returns the number freed.
+        uint32_t commitRead(uint32_t n)
+        {
+            uint32_t tail = RING_LoadOwn(m_tail);
+            uint32_t count = RING_LoadAcquire(m_head) - tail;
+
+            if (n > count) { n = count; }
+            RING_StoreRelease(m_tail, tail + n);
+            return n;
+        }
+
+    private:
+        uint32_t m_mask;
+        RING_INDEX m_head;
+        RING_INDEX m_tail;
+};
+
+/*
+ * SPSCRingBuffer
+ *
+ * As RingBuffer, but wait-free and safe for one producer and one consumer running
+ * concurrently (e.g. an interrupt or thread pushing and the main loop popping).
+ */
+template <typename T, uint32_t N>
+class SPSCRingBuffer
+{
+    typedef char CapacityMustBePowerOfTwo[((N > 0) && ((N & (N - 1)) == 0)) ? 1 : -1];
+
+    public:
+        SPSCRingBuffer() { m_index.reset(N); }
+
+        static uint32_t capacity(void) { return N; }
+        uint32_t length(void) const { return m_index.length(); }
+        bool empty(void) const { return length() == 0; }
+
+        // Producer only
+        bool push(T const& value) { return push(&value, 1) == 1; }
+
+        // Producer only: adds up to n values. Returns the number added.
+        uint32_t push(T const * values, uint32_t n)
+        {
+            uint32_t total = 0;
+            uint32_t slot;
+            uint32_t count;
+
+            while ((total < n) && ((count = m_index.writeSpan(&slot)) > 0))
+            {
+                if (count > (n - total)) { count = n - total; }
+
+                uint32_t i;
+                for (i = 0; i < count; i++) { m_data[slot + i] = values[total + i]; }
+                m_index.commitWrite(count);
+                total += count;
+            }
+            return total;
+        }
+
+        // Consumer only: removes the oldest value into *value (if not NULL). Returns false if empty.
+        bool pop(T * value)
+        {
+            uint32_t slot;
+            if (m_index.readSpan(&slot) == 0) { return false; }
+
+            if (value) { *value = m_data[slot]; }
+            m_index.commitRead(1);
+            return true;
+        }
+
+        // Consumer only: removes up to n values (oldest first) into values. Returns the number removed.
+        uint32_t pop(T * values, uint32_t n)
+        {
+            uint32_t total = 0;
+            uint32_t slot;
+            uint32_t count;
+
+            while ((total < n) && ((count = m_index.readSpan(&slot)) > 0))
+            {
+                if (count > (n - total)) { count = n - total; }
+
+                uint32_t i;
+                for (i = 0; i < count; i++) { values[total + i] = m_data[slot + i]; }
+                m_index.commitRead(count);
+                total += count;
+            }
+            return total;
+        }
+
+        /*
+         * Consumer only: peekSpan
+         *
+         * Points *values at the oldest values, which are contiguous.
+         * Returns how many can be read there; use discard to remove them once used.
+         */
+        uint32_t peekSpan(T ** values)
+        {
+            uint32_t slot;
+            uint32_t count = m_index.readSpan(&slot);
+            if (values) { *values = count ? &m_data[slot] : NULL; }
+            return count;
+        }
+
+        // Consumer only: removes up to n values without reading them. Returns the number removed.
+        uint32_t discard(uint32_t n) { return m_index.commitRead(n); }
+
+    private:
+        T m_data[N];
+        SPSCRingIndex m_index;
+};
+
+#endif
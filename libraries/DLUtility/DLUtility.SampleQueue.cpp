@@ -0,0 +1,169 @@
+/*
+ * DLUtility.SampleQueue.cpp
+ *
+ * Wait-free queue of raw sample rows between a sampling interrupt/thread and the main loop
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Arduino/C++ Library Includes
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+/*
+ * Local Application Includes
+ */
+
+#include "DLUtility.RingBuffer.h"
+#include "DLUtility.SampleQueue.h"
+
+/*
+ * Public Class Functions
+ */
+
+SampleQueue::SampleQueue() : m_dropped(0)
+{
+    m_data = NULL;
+    m_columns = 0;
+}
+
+SampleQueue::~SampleQueue()
+{
+    delete[] m_data;
+}
+
+/*
+ * setSize
+ *
+ * Allocates space for at least rows rows of columns values and empties the queue.
+ * Must not be called while the producer or consumer is running.
+ */
+bool SampleQueue::setSize(uint32_t rows, uint32_t columns)
+{
+    delete[] m_data;
+    m_data = NULL;
+    m_columns = 0;
+    RING_StoreRelease(m_dropped, 0);
+    m_index.reset(1);
+
+    if (rows == 0 || columns == 0) { return false; }
+
+    uint32_t capacity = RING_RoundUpToPowerOfTwo(rows);
+    m_data = new int32_t[capacity * columns];
+
+    if (m_data)
+    {
+        m_index.reset(capacity);
+        m_columns = columns;
+    }
+
+    return m_data != NULL;
+}
+
+uint32_t SampleQueue::capacity(void)
+{
+    return m_data ? m_index.capacity() : 0;
+}
+
+uint32_t SampleQueue::columns(void)
+{
+    return m_columns;
+}
+
+/*
+ * push
+ *
+ * Copies one row (columns() values) into the queue.
+ * Returns false and counts a dropped row if the queue is full.
+ */
+bool SampleQueue::push(const int32_t * row)
+{
+    if (!m_data || !row) { return false; }
+
+    uint32_t slot;
+
+    if (m_index.writeSpan(&slot) == 0)
+    {
+        RING_StoreRelease(m_dropped, RING_LoadOwn(m_dropped) + 1);
+        return false;
+    }
+
+    memcpy(&m_data[slot * m_columns], row, m_columns * sizeof(int32_t));
+    m_index.commitWrite(1);
+    return true;
+}
+
+uint32_t SampleQueue::dropped(void)
+{
+    return RING_LoadAcquire(m_dropped);
+}
+
+uint32_t SampleQueue::length(void)
+{
+    return m_data ? m_index.length() : 0;
+}
+
+/*
+ * peekRows
+ *
+ * Points *rows at the oldest queued rows, which are contiguous and columns() values apart.
+ * Returns how many rows can be read there (up to the end of the storage;
+ * any further rows are returned by the next call after release).
+ */
+uint32_t SampleQueue::peekRows(const int32_t ** rows)
+{
+    if (!m_data) { return 0; }
+
+    uint32_t slot;
+    uint32_t count = m_index.readSpan(&slot);
+
+    if (rows) { *rows = &m_data[slot * m_columns]; }
+
+    return count;
+}
+
+/*
+ * release
+ *
+ * Frees rows returned by peekRows for the producer to reuse
+ */
+void SampleQueue::release(uint32_t nRows)
+{
+    m_index.commitRead(nRows);
+}
+
+/*
+ * pop
+ *
+ * Copies up to maxRows rows (oldest first) into buffer and removes them from the queue.
+ * Returns the number of rows copied.
+ */
+uint32_t SampleQueue::pop(int32_t * buffer, uint32_t maxRows)
+{
+    if (!buffer) { return 0; }
+
+    uint32_t total = 0;
+    const int32_t * rows;
+    uint32_t count;
+
+    while ((total < maxRows) && ((count = peekRows(&rows)) > 0))
+    {
+        if (count > (maxRows - total)) { count = maxRows - total; }
+
+        memcpy(&buffer[total * m_columns], rows, count * m_columns * sizeof(int32_t));
+        release(count);
+        total += count;
+    }
+
+    return total;
+}
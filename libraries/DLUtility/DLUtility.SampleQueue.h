@@ -0,0 +1,48 @@
+#ifndef _DL_UTILITY_SAMPLEQUEUE_H_
+#define _DL_UTILITY_SAMPLEQUEUE_H_
+
+/*
+ * SampleQueue
+ *
+ * Wait-free single-producer/single-consumer queue of fixed-width rows of raw samples.
+ * A timer interrupt or sampling thread pushes one row per sample period;
+ * the main loop drains rows in batches (e.g. with DataFieldManager::drainSampleQueue),
+ * so slow work in the main loop does not delay sampling.
+ *
+ * Storage is allocated once by setSize, with the row count rounded up to a power of two,
+ * and indexed by an SPSCRingIndex (one element per row).
+ * If the queue is full, push drops the row and counts it (see dropped()).
+ *
+ * Requires DLUtility.RingBuffer.h.
+ */
+
+class SampleQueue
+{
+    public:
+        SampleQueue();
+        ~SampleQueue();
+
+        bool setSize(uint32_t rows, uint32_t columns);
+        uint32_t capacity(void);
+        uint32_t columns(void);
+
+        // Producer only
+        bool push(const int32_t * row);
+
+        // Either side
+        uint32_t dropped(void);
+
+        // Consumer only
+        uint32_t length(void);
+        uint32_t peekRows(const int32_t ** rows);
+        void release(uint32_t nRows);
+        uint32_t pop(int32_t * buffer, uint32_t maxRows);
+
+    private:
+        int32_t * m_data;
+        uint32_t m_columns;
+        RING_INDEX m_dropped;
+        SPSCRingIndex m_index;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * DLUtility.Statistics.cpp
+ * 
+ * Provides streaming statistics (min, max, mean, variance)
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+/*
+ * Standard Library Includes
+ */
+ 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+ 
+/*
+ * Generic Library Includes
+ */
+
+#include "DLUtility.Statistics.h"
+
+/*
+ * Statistics Class Definition
+ */
+
+template <typename T>
+Statistics<T>::Statistics()
+{
+	reset();
+}
+
+template <typename T>
+void Statistics<T>::reset(void)
+{
+	m_count = 0;
+	m_min = 0;
+	m_max = 0;
+	m_mean = 0.0f;
+	m_M2 = 0.0f;
+}
+
+template <typename T>
+void Statistics<T>::newData(T newData)
+{
+	if (m_count == 0)
+	{
+		m_min = newData;
+		m_max = newData;
+	}
+	else
+	{
+		if (newData < m_min) { m_min = newData; }
+		if (newData > m_max) { m_max = newData; }
+	}
+
+	m_count++;
+
+	// Welford's algorithm: update the mean and the sum of squared differences from it
+	float delta = (float)newData - m_mean;
+	m_mean += delta / m_count;
+	m_M2 += delta * ((float)newData - m_mean);
+}
+
+template <typename T>
+uint32_t Statistics<T>::count(void)
+{
+	return m_count;
+}
+
+template <typename T>
+T Statistics<T>::minimum(void)
+{
+	return m_min;
+}
+
+template <typename T>
+T Statistics<T>::maximum(void)
+{
+	return m_max;
+}
+
+template <typename T>
+float Statistics<T>::mean(void)
+{
+	return m_mean;
+}
+
+template <typename T>
+float Statistics<T>::variance(void)
+{
+	return m_count ? (m_M2 / m_count) : 0.0f;
+}
+
+template <typename T>
+float Statistics<T>::stdDev(void)
+{
+	return sqrt(variance());
+}
+
+template class Statistics<float>;
+template class Statistics<uint8_t>;
+template class Statistics<int8_t>;
+template class Statistics<uint16_t>;
+template class Statistics<int16_t>;
+template class Statistics<uint32_t>;
+template class Statistics<int32_t>;
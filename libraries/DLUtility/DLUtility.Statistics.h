@@ -0,0 +1,35 @@
+#ifndef _DL_STATISTICS_H_
+#define _DL_STATISTICS_H_
+
+/*
+ * Statistics
+ *
+ * Streaming min/max/mean/variance of a series of values,
+ * updated in O(1) per value using Welford's algorithm.
+ * Variance is the population variance of the values since the last reset.
+ */
+
+template <typename T>
+class Statistics
+{
+	public:
+		Statistics();
+		void reset(void);
+		void newData(T newData);
+
+		uint32_t count(void);
+		T minimum(void);
+		T maximum(void);
+		float mean(void);
+		float variance(void);
+		float stdDev(void);
+
+	private:
+		uint32_t m_count;
+		T m_min;
+		T m_max;
+		float m_mean;
+		float m_M2;
+};
+
+#endif
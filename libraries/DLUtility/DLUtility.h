@@ -4,6 +4,12 @@
 #include "DLUtility.AVR.h"
 #include "DLUtility.HelperMacros.h"
 #include "DLUtility.Averager.h"
+#include "DLUtility.Aggregator.h"
+#include "DLUtility.Statistics.h"
+#include "DLUtility.FixedPoint.h"
+#include "DLUtility.Arena.h"
+#include "DLUtility.RingBuffer.h"
+#include "DLUtility.SampleQueue.h"
 #include "DLUtility.Readline.h"
 #include "DLUtility.ArrayFunctions.h"
 #include "DLUtility.Time.h"
@@ -0,0 +1,126 @@
+/*
+ * DLUtility.RingBuffer.Benchmark.cpp
+ *
+ * Compares modulo indexing of a circular buffer (as DataField used to do)
+ * with power-of-two masked indexing (as SampleQueue does) and
+ * compare-and-wrap indexing (as DataField does now)
+ *
+ * Author: James Fowkes
+ *
+ * www.re-innovation.co.uk
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <iostream>
+
+#include "DLUtility.RingBuffer.h"
+
+#define N_OPERATIONS (50UL * 1000UL * 1000UL)
+#define BUFFER_SIZE 100
+
+static double elapsedMs(clock_t start)
+{
+    return 1000.0 * (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/*
+ * The buffer size is only known at runtime (as for a DataField),
+ * so "volatile" stops the compiler turning the modulo into a multiply
+ */
+static volatile uint32_t s_runtimeSize = BUFFER_SIZE;
+
+static int32_t s_data[256];
+
+static int64_t moduloIndexing(void)
+{
+    uint32_t size = s_runtimeSize;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    int64_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < N_OPERATIONS; i++)
+    {
+        if ((head - tail) >= size) { tail++; }
+        s_data[head % size] = i;
+        head++;
+        sum += s_data[tail % size];
+    }
+    return sum;
+}
+
+static int64_t maskIndexing(void)
+{
+    uint32_t size = s_runtimeSize;
+    uint32_t mask = RING_RoundUpToPowerOfTwo(size) - 1;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    int64_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < N_OPERATIONS; i++)
+    {
+        if ((head - tail) >= size) { tail++; }
+        s_data[head & mask] = i;
+        head++;
+        sum += s_data[tail & mask];
+    }
+    return sum;
+}
+
+static int64_t wrapIndexing(void)
+{
+    uint32_t maxIndex = s_runtimeSize - 1;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t count = 0;
+    int64_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < N_OPERATIONS; i++)
+    {
+        if (count > maxIndex) { tail = (tail < maxIndex) ? tail + 1 : 0; count--; }
+        s_data[head] = i;
+        head = (head < maxIndex) ? head + 1 : 0;
+        count++;
+        sum += s_data[tail];
+    }
+    return sum;
+}
+
+int main(int argc, char * argv[])
+{
+    (void)argc; (void)argv;
+
+    clock_t start;
+    double moduloMs;
+    double maskMs;
+    double wrapMs;
+    int64_t check = 0;
+
+    std::cout << N_OPERATIONS << " push/read operations on a " << BUFFER_SIZE << " entry buffer" << std::endl;
+
+    start = clock();
+    check += moduloIndexing();
+    moduloMs = elapsedMs(start);
+
+    start = clock();
+    check += maskIndexing();
+    maskMs = elapsedMs(start);
+
+    start = clock();
+    check += wrapIndexing();
+    wrapMs = elapsedMs(start);
+
+    std::cout << "Modulo indexing: " << moduloMs << "ms" << std::endl;
+    std::cout << "Masked indexing: " << maskMs << "ms (x" << (moduloMs / maskMs) << ")" << std::endl;
+    std::cout << "Compare-and-wrap indexing: " << wrapMs << "ms (x" << (moduloMs / wrapMs) << ")" << std::endl;
+
+    // Stops the compiler optimising away the loops
+    std::cout << "(Checksum " << check << ")" << std::endl;
+
+    return 0;
+}
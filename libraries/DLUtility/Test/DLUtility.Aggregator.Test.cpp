@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "unity.h"
+
+#include "../DLUtility.Aggregator.h"
+
+static AggregatePyramid * s_pyramid;
+
+void setUp(void)
+{
+	s_pyramid = new AggregatePyramid();
+}
+
+void tearDown(void)
+{
+	delete s_pyramid;
+}
+
+static void test_LevelsCanBeAddedUpToMaximum(void)
+{
+	uint8_t i;
+	for (i = 0; i < AGGREGATOR_MAX_LEVELS; i++)
+	{
+		TEST_ASSERT_TRUE(s_pyramid->addLevel(2, 4));
+	}
+	TEST_ASSERT_FALSE(s_pyramid->addLevel(2, 4));
+	TEST_ASSERT_EQUAL(AGGREGATOR_MAX_LEVELS, s_pyramid->levels());
+}
+
+static void test_InvalidLevelsAreRejected(void)
+{
+	TEST_ASSERT_FALSE(s_pyramid->addLevel(0, 4));
+	TEST_ASSERT_FALSE(s_pyramid->addLevel(4, 0));
+	TEST_ASSERT_EQUAL(0, s_pyramid->levels());
+}
+
+static void test_LevelHistoryCanBeSuppliedByCaller(void)
+{
+	AGGREGATE history[2];
+	AGGREGATE aggregate;
+
+	TEST_ASSERT_FALSE(s_pyramid->addLevel(2, 2, NULL));
+	TEST_ASSERT_TRUE(s_pyramid->addLevel(2, 2, history));
+
+	s_pyramid->newData(1);
+	s_pyramid->newData(5);
+
+	TEST_ASSERT_TRUE(s_pyramid->getLatest(0, &aggregate));
+	TEST_ASSERT_EQUAL_FLOAT(3.0f, history[0].mean);
+	TEST_ASSERT_EQUAL_FLOAT(3.0f, aggregate.mean);
+}
+
+static void test_FirstLevelSummarisesRawSamples(void)
+{
+	AGGREGATE aggregate;
+
+	s_pyramid->addLevel(4, 2);
+
+	TEST_ASSERT_FALSE(s_pyramid->newData(3));
+	TEST_ASSERT_FALSE(s_pyramid->newData(-1));
+	TEST_ASSERT_FALSE(s_pyramid->newData(7));
+	TEST_ASSERT_EQUAL(0, s_pyramid->length(0));
+	TEST_ASSERT_FALSE(s_pyramid->getLatest(0, &aggregate));
+
+	TEST_ASSERT_TRUE(s_pyramid->newData(3));
+	TEST_ASSERT_EQUAL(1, s_pyramid->length(0));
+	TEST_ASSERT_TRUE(s_pyramid->getLatest(0, &aggregate));
+
+	TEST_ASSERT_EQUAL_FLOAT(-1.0f, aggregate.min);
+	TEST_ASSERT_EQUAL_FLOAT(7.0f, aggregate.max);
+	TEST_ASSERT_EQUAL_FLOAT(3.0f, aggregate.mean);
+	TEST_ASSERT_EQUAL(4, aggregate.count);
+}
+
+static void test_HigherLevelsCascadeFromLowerLevels(void)
+{
+	AGGREGATE aggregate;
+
+	// 2 samples per level 0 aggregate, 3 level 0 aggregates per level 1 aggregate
+	s_pyramid->addLevel(2, 8);
+	s_pyramid->addLevel(3, 8);
+
+	uint8_t i;
+	for (i = 1; i <= 6; i++)
+	{
+		s_pyramid->newData(i);
+	}
+
+	TEST_ASSERT_EQUAL(3, s_pyramid->length(0));
+	TEST_ASSERT_EQUAL(1, s_pyramid->length(1));
+
+	TEST_ASSERT_TRUE(s_pyramid->getLatest(1, &aggregate));
+	TEST_ASSERT_EQUAL_FLOAT(1.0f, aggregate.min);
+	TEST_ASSERT_EQUAL_FLOAT(6.0f, aggregate.max);
+	TEST_ASSERT_EQUAL_FLOAT(3.5f, aggregate.mean);
+	TEST_ASSERT_EQUAL(6, aggregate.count);
+}
+
+static void test_HistoryKeepsNewestAggregatesOldestFirst(void)
+{
+	AGGREGATE aggregate;
+
+	s_pyramid->addLevel(1, 3);
+
+	uint8_t i;
+	for (i = 0; i < 5; i++)
+	{
+		s_pyramid->newData(i);
+	}
+
+	TEST_ASSERT_EQUAL(3, s_pyramid->length(0));
+	TEST_ASSERT_EQUAL(5, s_pyramid->completed(0));
+
+	for (i = 0; i < 3; i++)
+	{
+		TEST_ASSERT_TRUE(s_pyramid->getAggregate(0, i, &aggregate));
+		TEST_ASSERT_EQUAL_FLOAT((float)(i + 2), aggregate.mean);
+	}
+	TEST_ASSERT_FALSE(s_pyramid->getAggregate(0, 3, &aggregate));
+}
+
+static void test_PartialAggregateIsAvailable(void)
+{
+	AGGREGATE aggregate;
+
+	s_pyramid->addLevel(10, 1);
+	TEST_ASSERT_FALSE(s_pyramid->getPartial(0, &aggregate));
+
+	s_pyramid->newData(2);
+	s_pyramid->newData(4);
+
+	TEST_ASSERT_TRUE(s_pyramid->getPartial(0, &aggregate));
+	TEST_ASSERT_EQUAL_FLOAT(2.0f, aggregate.min);
+	TEST_ASSERT_EQUAL_FLOAT(4.0f, aggregate.max);
+	TEST_ASSERT_EQUAL_FLOAT(3.0f, aggregate.mean);
+	TEST_ASSERT_EQUAL(2, aggregate.count);
+}
+
+static void test_LargeSamplesAreSummedExactly(void)
+{
+	AGGREGATE aggregate;
+
+	s_pyramid->addLevel(4, 1);
+	s_pyramid->addLevel(2, 1);
+
+	uint8_t i;
+	for (i = 0; i < 8; i++)
+	{
+		s_pyramid->newData(2000000000);
+	}
+
+	TEST_ASSERT_TRUE(s_pyramid->getLatest(1, &aggregate));
+	TEST_ASSERT_EQUAL_FLOAT(2000000000.0f, aggregate.mean);
+	TEST_ASSERT_EQUAL(8, aggregate.count);
+}
+
+static void test_ResetClearsAllLevels(void)
+{
+	s_pyramid->addLevel(1, 4);
+	s_pyramid->addLevel(1, 4);
+
+	s_pyramid->newData(1);
+	TEST_ASSERT_EQUAL(1, s_pyramid->length(1));
+
+	s_pyramid->reset();
+	TEST_ASSERT_EQUAL(0, s_pyramid->length(0));
+	TEST_ASSERT_EQUAL(0, s_pyramid->length(1));
+	TEST_ASSERT_EQUAL(2, s_pyramid->levels());
+}
+
+int main(void)
+{
+  UnityBegin("DLUtility.Aggregator.cpp");
+
+  RUN_TEST(test_LevelsCanBeAddedUpToMaximum);
+  RUN_TEST(test_InvalidLevelsAreRejected);
+  RUN_TEST(test_LevelHistoryCanBeSuppliedByCaller);
+  RUN_TEST(test_FirstLevelSummarisesRawSamples);
+  RUN_TEST(test_HigherLevelsCascadeFromLowerLevels);
+  RUN_TEST(test_HistoryKeepsNewestAggregatesOldestFirst);
+  RUN_TEST(test_PartialAggregateIsAvailable);
+  RUN_TEST(test_LargeSamplesAreSummedExactly);
+  RUN_TEST(test_ResetClearsAllLevels);
+
+  return (UnityEnd());
+}
@@ -0,0 +1,112 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "unity.h"
+
+#include "../DLUtility.Arena.h"
+
+class TestObject
+{
+	public:
+		TestObject(int32_t value) : m_value(value) {}
+		int32_t m_value;
+};
+
+static void test_UnreservedArenaReturnsNull(void)
+{
+	Arena arena;
+
+	TEST_ASSERT_NULL(arena.allocate(4));
+	TEST_ASSERT_EQUAL(1, arena.failures());
+	TEST_ASSERT_EQUAL(0, arena.size());
+}
+
+static void test_ArenaCanOnlyBeReservedOnce(void)
+{
+	Arena arena;
+
+	TEST_ASSERT_TRUE(arena.reserve(64));
+	TEST_ASSERT_FALSE(arena.reserve(128));
+	TEST_ASSERT_EQUAL(64, arena.size());
+}
+
+static void test_AllocationsAreAlignedAndContiguous(void)
+{
+	Arena arena;
+	arena.reserve(64);
+
+	uint8_t * a = (uint8_t*)arena.allocate(3);
+	uint8_t * b = (uint8_t*)arena.allocate(8);
+
+	TEST_ASSERT_NOT_NULL(a);
+	TEST_ASSERT_NOT_NULL(b);
+	TEST_ASSERT_EQUAL(0, (uintptr_t)a % ARENA_ALIGNMENT);
+	TEST_ASSERT_EQUAL(0, (uintptr_t)b % ARENA_ALIGNMENT);
+	TEST_ASSERT_EQUAL(ARENA_ALIGNMENT, b - a);
+	TEST_ASSERT_EQUAL(16, arena.used());
+}
+
+static void test_FullArenaReturnsNull(void)
+{
+	Arena arena;
+	arena.reserve(16);
+
+	TEST_ASSERT_NOT_NULL(arena.allocate(16));
+	TEST_ASSERT_NULL(arena.allocate(1));
+	TEST_ASSERT_EQUAL(1, arena.failures());
+	TEST_ASSERT_EQUAL(16, arena.used());
+}
+
+static void test_HighWaterMarkIsKeptAfterReset(void)
+{
+	Arena arena;
+	arena.reserve(64);
+
+	arena.allocate(24);
+	arena.allocate(8);
+	arena.reset();
+
+	TEST_ASSERT_EQUAL(0, arena.used());
+	TEST_ASSERT_EQUAL(32, arena.highWaterMark());
+
+	arena.allocate(8);
+	TEST_ASSERT_EQUAL(32, arena.highWaterMark());
+}
+
+static void test_ObjectsCanBeConstructedInArena(void)
+{
+	Arena arena;
+	arena.reserve(sizeof(TestObject));
+
+	TestObject * pObject = new (arena) TestObject(1234);
+
+	TEST_ASSERT_NOT_NULL(pObject);
+	TEST_ASSERT_EQUAL(1234, pObject->m_value);
+
+	TEST_ASSERT_NULL(new (arena) TestObject(5678));
+}
+
+//=======Test Reset Option=====
+void resetTest()
+{
+	tearDown();
+	setUp();
+}
+
+//=======MAIN=====
+int main(void)
+{
+	UnityBegin("DLUtility.Arena.Test.cpp");
+
+	RUN_TEST(test_UnreservedArenaReturnsNull);
+	RUN_TEST(test_ArenaCanOnlyBeReservedOnce);
+	RUN_TEST(test_AllocationsAreAlignedAndContiguous);
+	RUN_TEST(test_FullArenaReturnsNull);
+	RUN_TEST(test_HighWaterMarkIsKeptAfterReset);
+	RUN_TEST(test_ObjectsCanBeConstructedInArena);
+
+	return (UnityEnd());
+}
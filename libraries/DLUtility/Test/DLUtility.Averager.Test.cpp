@@ -122,6 +122,82 @@ void test_AveragerSizeIsCorrect(void)
 	TEST_ASSERT_TRUE(averager.full());
 }
 
+void test_AveragerSlidingWindowDropsOldestValue(void)
+{
+	Averager<int32_t> averager = Averager<int32_t>(4);
+
+	int32_t i;
+	for (i = 1; i <= 10; i++)
+	{
+		averager.newData(i);
+	}
+
+	// Window now holds 7, 8, 9, 10
+	TEST_ASSERT_EQUAL(9, averager.getAverage());
+	TEST_ASSERT_EQUAL_FLOAT(8.5f, averager.getFloatAverage());
+
+	averager.newData(-100);
+
+	// Window now holds 8, 9, 10, -100
+	TEST_ASSERT_EQUAL(-18, averager.getAverage());
+	TEST_ASSERT_EQUAL_FLOAT(-18.25f, averager.getFloatAverage());
+}
+
+void test_AveragerPartiallyFilledWindow(void)
+{
+	Averager<uint16_t> averager = Averager<uint16_t>(10);
+
+	TEST_ASSERT_EQUAL(0, averager.getAverage());
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, averager.getFloatAverage());
+
+	averager.newData(10);
+	averager.newData(21);
+
+	TEST_ASSERT_EQUAL(16, averager.getAverage());
+	TEST_ASSERT_EQUAL_FLOAT(15.5f, averager.getFloatAverage());
+}
+
+void test_AveragerFloatRunningSumDoesNotDrift(void)
+{
+	Averager<float> averager = Averager<float>(3);
+
+	uint32_t i;
+	for (i = 0; i < 30000; i++)
+	{
+		averager.newData((i & 1) ? 123456.7f : 0.1f);
+	}
+
+	averager.newData(1.0f);
+	averager.newData(2.0f);
+	averager.newData(3.0f);
+
+	TEST_ASSERT_EQUAL_FLOAT(2.0f, averager.getFloatAverage());
+	TEST_ASSERT_EQUAL_FLOAT(2.0f, averager.getAverage());
+}
+
+void test_AveragerFixedAverageKeepsFraction(void)
+{
+	Averager<int16_t> averager(4);
+
+	averager.newData(1);
+	averager.newData(2);
+	averager.newData(2);
+	averager.newData(2);
+
+	// 7/4 = 1.75 in Q16.16
+	TEST_ASSERT_EQUAL(114688, averager.getFixedAverage());
+}
+
+void test_AveragerFixedAverageOfNegativeValues(void)
+{
+	Averager<int32_t> averager(2);
+
+	averager.newData(-1);
+	averager.newData(-2);
+
+	TEST_ASSERT_EQUAL(-98304, averager.getFixedAverage());
+}
+
 //=======Test Reset Option=====
 void resetTest()
 {
@@ -149,6 +225,12 @@ int main(void)
 	RUN_TEST(test_AveragerU32Reset);
 
 	RUN_TEST(test_AveragerSizeIsCorrect);
+
+	RUN_TEST(test_AveragerSlidingWindowDropsOldestValue);
+	RUN_TEST(test_AveragerPartiallyFilledWindow);
+	RUN_TEST(test_AveragerFloatRunningSumDoesNotDrift);
+	RUN_TEST(test_AveragerFixedAverageKeepsFraction);
+	RUN_TEST(test_AveragerFixedAverageOfNegativeValues);
 	
 	return (UnityEnd());
 }
@@ -1,4 +1,5 @@
 SRC_FILES += ./DLUtility/DLUtility.ArrayFunctions.cpp
+SRC_FILES += ./DLUtility/DLUtility.FixedPoint.cpp
 
 local_setup: ;
 local_teardown: ;
@@ -0,0 +1,103 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "../DLUtility.FixedPoint.h"
+
+static void test_IntegerConversion(void)
+{
+	TEST_ASSERT_EQUAL(65536, FIXED_FromInt(1));
+	TEST_ASSERT_EQUAL(-131072, FIXED_FromInt(-2));
+	TEST_ASSERT_EQUAL_FLOAT(1.5f, FIXED_ToFloat(FIXED_FromFloat(1.5f)));
+	TEST_ASSERT_EQUAL_FLOAT(-0.25f, FIXED_ToFloat(FIXED_FromFloat(-0.25f)));
+}
+
+static void test_MultiplyIsCorrect(void)
+{
+	TEST_ASSERT_EQUAL(FIXED_FromFloat(3.75f), FIXED_Multiply(FIXED_FromFloat(1.5f), FIXED_FromFloat(2.5f)));
+	TEST_ASSERT_EQUAL(FIXED_FromFloat(-3.75f), FIXED_Multiply(FIXED_FromFloat(-1.5f), FIXED_FromFloat(2.5f)));
+}
+
+static void test_RatioIsRounded(void)
+{
+	TEST_ASSERT_EQUAL(21845, FIXED_FromRatio(1, 3));
+	TEST_ASSERT_EQUAL(43691, FIXED_FromRatio(2, 3));
+	TEST_ASSERT_EQUAL(-43691, FIXED_FromRatio(-2, 3));
+	TEST_ASSERT_EQUAL(0, FIXED_FromRatio(1, 0));
+}
+
+static void test_SmallScaleKeepsPrecision(void)
+{
+	// 4.8828125mV per bit (5V, 10-bit ADC), scaled up by a 10:1 divider
+	FIXED_SCALE scale = FIXED_ScaleFromFloat(0.048828125);
+	FIXED result = FIXED_ApplyScale(FIXED_FromInt(1023), scale);
+
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 49.951171875f, FIXED_ToFloat(result));
+}
+
+static void test_LinearConversionIsCorrect(void)
+{
+	FIXED_LINEAR linear;
+	FIXED_LinearFromFloat(&linear, 0.0049, -2.5);
+
+	FIXED result = FIXED_ApplyLinear(FIXED_FromInt(512), &linear);
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0088f, FIXED_ToFloat(result));
+
+	result = FIXED_ApplyLinear(FIXED_FromInt(0), &linear);
+	TEST_ASSERT_FLOAT_WITHIN(0.0001f, -2.5f, FIXED_ToFloat(result));
+}
+
+static void test_StringFormatting(void)
+{
+	char buffer[16];
+
+	FIXED_ToString(buffer, FIXED_FromFloat(12.5f), 2);
+	TEST_ASSERT_EQUAL_STRING("12.50", buffer);
+
+	FIXED_ToString(buffer, FIXED_FromFloat(-3.25f), 1);
+	TEST_ASSERT_EQUAL_STRING("-3.3", buffer);
+
+	TEST_ASSERT_EQUAL(1, FIXED_ToString(buffer, FIXED_FromInt(7), 0));
+	TEST_ASSERT_EQUAL_STRING("7", buffer);
+
+	FIXED_ToString(buffer, FIXED_FromFloat(0.125f), 3);
+	TEST_ASSERT_EQUAL_STRING("0.125", buffer);
+}
+
+static void test_StringRoundingCarriesIntoInteger(void)
+{
+	char buffer[16];
+
+	FIXED_ToString(buffer, FIXED_FromFloat(1.9999f), 2);
+	TEST_ASSERT_EQUAL_STRING("2.00", buffer);
+
+	FIXED_ToString(buffer, FIXED_FromFloat(-0.001f), 2);
+	TEST_ASSERT_EQUAL_STRING("0.00", buffer);
+}
+
+//=======Test Reset Option=====
+void resetTest()
+{
+	tearDown();
+	setUp();
+}
+
+//=======MAIN=====
+int main(void)
+{
+	UnityBegin("DLUtility.FixedPoint.Test.cpp");
+
+	RUN_TEST(test_IntegerConversion);
+	RUN_TEST(test_MultiplyIsCorrect);
+	RUN_TEST(test_RatioIsRounded);
+	RUN_TEST(test_SmallScaleKeepsPrecision);
+	RUN_TEST(test_LinearConversionIsCorrect);
+	RUN_TEST(test_StringFormatting);
+	RUN_TEST(test_StringRoundingCarriesIntoInteger);
+
+	return (UnityEnd());
+}
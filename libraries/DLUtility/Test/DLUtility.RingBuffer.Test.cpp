@@ -0,0 +1,215 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "unity.h"
+
+#include "../DLUtility.RingBuffer.h"
+
+static void test_RoundUpToPowerOfTwo(void)
+{
+	TEST_ASSERT_EQUAL(1, RING_RoundUpToPowerOfTwo(0));
+	TEST_ASSERT_EQUAL(1, RING_RoundUpToPowerOfTwo(1));
+	TEST_ASSERT_EQUAL(2, RING_RoundUpToPowerOfTwo(2));
+	TEST_ASSERT_EQUAL(4, RING_RoundUpToPowerOfTwo(3));
+	TEST_ASSERT_EQUAL(16, RING_RoundUpToPowerOfTwo(10));
+	TEST_ASSERT_EQUAL(1024, RING_RoundUpToPowerOfTwo(1024));
+	TEST_ASSERT_EQUAL(2048, RING_RoundUpToPowerOfTwo(1025));
+}
+
+static void test_PushAndPopAreFirstInFirstOut(void)
+{
+	RingBuffer<int32_t, 4> ring;
+	int32_t value;
+
+	TEST_ASSERT_TRUE(ring.empty());
+	TEST_ASSERT_TRUE(ring.push(1));
+	TEST_ASSERT_TRUE(ring.push(2));
+	TEST_ASSERT_TRUE(ring.push(3));
+	TEST_ASSERT_TRUE(ring.push(4));
+	TEST_ASSERT_TRUE(ring.full());
+	TEST_ASSERT_FALSE(ring.push(5));
+
+	TEST_ASSERT_TRUE(ring.pop(&value));
+	TEST_ASSERT_EQUAL(1, value);
+	TEST_ASSERT_EQUAL(2, *ring.peek(0));
+	TEST_ASSERT_EQUAL(4, *ring.peek(2));
+	TEST_ASSERT_NULL(ring.peek(3));
+	TEST_ASSERT_EQUAL(3, ring.length());
+}
+
+static void test_PushOverwriteDropsOldest(void)
+{
+	RingBuffer<int32_t, 2> ring;
+
+	ring.pushOverwrite(1);
+	ring.pushOverwrite(2);
+	ring.pushOverwrite(3);
+
+	TEST_ASSERT_EQUAL(2, ring.length());
+	TEST_ASSERT_EQUAL(2, *ring.peek(0));
+	TEST_ASSERT_EQUAL(3, *ring.peek(1));
+}
+
+static void test_BulkPushAndPopWrap(void)
+{
+	RingBuffer<int32_t, 8> ring;
+	int32_t in[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+	int32_t out[10];
+
+	TEST_ASSERT_EQUAL(6, ring.push(in, 6));
+	TEST_ASSERT_EQUAL(5, ring.discard(5));
+
+	// Only 7 values fit
+	TEST_ASSERT_EQUAL(7, ring.push(&in[1], 9));
+	TEST_ASSERT_TRUE(ring.full());
+
+	TEST_ASSERT_EQUAL(8, ring.pop(out, 10));
+	TEST_ASSERT_EQUAL(6, out[0]);
+	TEST_ASSERT_EQUAL(2, out[1]);
+	TEST_ASSERT_EQUAL(8, out[7]);
+	TEST_ASSERT_TRUE(ring.empty());
+}
+
+static void test_SpansCoverBothSidesOfWrap(void)
+{
+	RingBuffer<int32_t, 4> ring;
+	int32_t * first;
+	int32_t * second;
+	uint32_t firstN;
+	uint32_t secondN;
+
+	TEST_ASSERT_EQUAL(0, ring.getSpans(&first, &firstN, &second, &secondN));
+	TEST_ASSERT_NULL(first);
+	TEST_ASSERT_NULL(second);
+
+	ring.push(1); ring.push(2); ring.push(3);
+	ring.discard(2);
+	ring.push(4); ring.push(5);
+
+	TEST_ASSERT_EQUAL(3, ring.getSpans(&first, &firstN, &second, &secondN));
+	TEST_ASSERT_EQUAL(2, firstN);
+	TEST_ASSERT_EQUAL(3, first[0]);
+	TEST_ASSERT_EQUAL(4, first[1]);
+	TEST_ASSERT_EQUAL(1, secondN);
+	TEST_ASSERT_EQUAL(5, second[0]);
+}
+
+static void test_ManyPushesAndPopsStayInOrder(void)
+{
+	RingBuffer<int32_t, 4> ring;
+	uint32_t i;
+	int32_t value;
+
+	// Cycle through the slots many times
+	for (i = 0; i < 1000; i++)
+	{
+		ring.push(i);
+		ring.pop(&value);
+		TEST_ASSERT_EQUAL(i, value);
+	}
+}
+
+static void test_SPSCBufferIsFirstInFirstOut(void)
+{
+	SPSCRingBuffer<int32_t, 4> ring;
+	int32_t value;
+
+	TEST_ASSERT_FALSE(ring.pop(&value));
+
+	TEST_ASSERT_TRUE(ring.push(10));
+	TEST_ASSERT_TRUE(ring.push(20));
+	TEST_ASSERT_TRUE(ring.push(30));
+	TEST_ASSERT_TRUE(ring.push(40));
+	TEST_ASSERT_FALSE(ring.push(50));
+
+	TEST_ASSERT_TRUE(ring.pop(&value));
+	TEST_ASSERT_EQUAL(10, value);
+	TEST_ASSERT_TRUE(ring.push(50));
+	TEST_ASSERT_EQUAL(4, ring.length());
+}
+
+static void test_SPSCBufferBulkPushAndPopWrap(void)
+{
+	SPSCRingBuffer<int32_t, 4> ring;
+	int32_t in[] = {1, 2, 3, 4, 5, 6};
+	int32_t out[6];
+	int32_t * values;
+
+	TEST_ASSERT_EQUAL(3, ring.push(in, 3));
+	TEST_ASSERT_EQUAL(2, ring.discard(2));
+
+	// Only 3 values fit, and they wrap
+	TEST_ASSERT_EQUAL(3, ring.push(&in[3], 3));
+	TEST_ASSERT_EQUAL(0, ring.push(in, 1));
+
+	// First contiguous span runs to the end of the storage
+	TEST_ASSERT_EQUAL(2, ring.peekSpan(&values));
+	TEST_ASSERT_EQUAL(3, values[0]);
+	TEST_ASSERT_EQUAL(4, values[1]);
+
+	TEST_ASSERT_EQUAL(4, ring.pop(out, 6));
+	TEST_ASSERT_EQUAL(3, out[0]);
+	TEST_ASSERT_EQUAL(4, out[1]);
+	TEST_ASSERT_EQUAL(5, out[2]);
+	TEST_ASSERT_EQUAL(6, out[3]);
+	TEST_ASSERT_TRUE(ring.empty());
+	TEST_ASSERT_EQUAL(0, ring.peekSpan(&values));
+	TEST_ASSERT_NULL(values);
+}
+
+static void test_SPSCIndexSpansStopAtEndOfStorage(void)
+{
+	SPSCRingIndex index;
+	uint32_t slot;
+
+	index.reset(8);
+	TEST_ASSERT_EQUAL(8, index.writeSpan(&slot));
+	TEST_ASSERT_EQUAL(0, slot);
+	TEST_ASSERT_EQUAL(0, index.readSpan(&slot));
+
+	index.commitWrite(6);
+	TEST_ASSERT_EQUAL(5, index.commitRead(5));
+
+	// 7 free, but only 2 before the end of the storage
+	TEST_ASSERT_EQUAL(2, index.writeSpan(&slot));
+	TEST_ASSERT_EQUAL(6, slot);
+	index.commitWrite(2);
+	TEST_ASSERT_EQUAL(5, index.writeSpan(&slot));
+	TEST_ASSERT_EQUAL(0, slot);
+
+	TEST_ASSERT_EQUAL(3, index.readSpan(&slot));
+	TEST_ASSERT_EQUAL(5, slot);
+	TEST_ASSERT_EQUAL(3, index.length());
+
+	// Can't free more than is stored
+	TEST_ASSERT_EQUAL(3, index.commitRead(10));
+	TEST_ASSERT_EQUAL(0, index.length());
+}
+
+//=======Test Reset Option=====
+void resetTest()
+{
+	tearDown();
+	setUp();
+}
+
+//=======MAIN=====
+int main(void)
+{
+	UnityBegin("DLUtility.RingBuffer.Test.cpp");
+
+	RUN_TEST(test_RoundUpToPowerOfTwo);
+	RUN_TEST(test_PushAndPopAreFirstInFirstOut);
+	RUN_TEST(test_PushOverwriteDropsOldest);
+	RUN_TEST(test_BulkPushAndPopWrap);
+	RUN_TEST(test_SpansCoverBothSidesOfWrap);
+	RUN_TEST(test_ManyPushesAndPopsStayInOrder);
+	RUN_TEST(test_SPSCBufferIsFirstInFirstOut);
+	RUN_TEST(test_SPSCBufferBulkPushAndPopWrap);
+	RUN_TEST(test_SPSCIndexSpansStopAtEndOfStorage);
+
+	return (UnityEnd());
+}
@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <thread>
+
+#include "unity.h"
+
+#include "../DLUtility.RingBuffer.h"
+#include "../DLUtility.SampleQueue.h"
+
+#define THREADED_ROWS 1000000UL
+#define COLUMNS 3
+
+static void test_UnsizedQueueRejectsRows(void)
+{
+	SampleQueue queue;
+	int32_t row[COLUMNS] = {1, 2, 3};
+
+	TEST_ASSERT_FALSE(queue.push(row));
+	TEST_ASSERT_EQUAL(0, queue.length());
+	TEST_ASSERT_EQUAL(0, queue.capacity());
+}
+
+static void test_CapacityIsRoundedUpToPowerOfTwo(void)
+{
+	SampleQueue queue;
+
+	TEST_ASSERT_TRUE(queue.setSize(5, COLUMNS));
+	TEST_ASSERT_EQUAL(8, queue.capacity());
+	TEST_ASSERT_EQUAL(COLUMNS, queue.columns());
+}
+
+static void test_FullQueueDropsAndCountsRows(void)
+{
+	SampleQueue queue;
+	queue.setSize(2, COLUMNS);
+
+	int32_t row[COLUMNS] = {1, 2, 3};
+
+	TEST_ASSERT_TRUE(queue.push(row));
+	TEST_ASSERT_TRUE(queue.push(row));
+	TEST_ASSERT_FALSE(queue.push(row));
+	TEST_ASSERT_EQUAL(1, queue.dropped());
+	TEST_ASSERT_EQUAL(2, queue.length());
+}
+
+static void test_PeekedRowsAreContiguousUpToWrap(void)
+{
+	SampleQueue queue;
+	queue.setSize(4, COLUMNS);
+
+	int32_t row[COLUMNS];
+	int32_t i;
+	for (i = 0; i < 3; i++)
+	{
+		row[0] = i; row[1] = i * 10; row[2] = i * 100;
+		queue.push(row);
+	}
+	queue.release(2);
+
+	for (i = 3; i < 6; i++)
+	{
+		row[0] = i; row[1] = i * 10; row[2] = i * 100;
+		queue.push(row);
+	}
+
+	const int32_t * rows;
+
+	// Rows 2 and 3 are at the end of the storage, 4 and 5 are at the start
+	TEST_ASSERT_EQUAL(2, queue.peekRows(&rows));
+	TEST_ASSERT_EQUAL(2, rows[0]);
+	TEST_ASSERT_EQUAL(30, rows[COLUMNS + 1]);
+	queue.release(2);
+
+	TEST_ASSERT_EQUAL(2, queue.peekRows(&rows));
+	TEST_ASSERT_EQUAL(4, rows[0]);
+	TEST_ASSERT_EQUAL(500, rows[COLUMNS + 2]);
+}
+
+static void test_PopCopiesAcrossWrap(void)
+{
+	SampleQueue queue;
+	queue.setSize(4, 1);
+
+	int32_t value;
+	for (value = 0; value < 3; value++) { queue.push(&value); }
+	queue.release(3);
+	for (value = 3; value < 7; value++) { queue.push(&value); }
+
+	int32_t buffer[4];
+	TEST_ASSERT_EQUAL(4, queue.pop(buffer, 10));
+	TEST_ASSERT_EQUAL(3, buffer[0]);
+	TEST_ASSERT_EQUAL(6, buffer[3]);
+	TEST_ASSERT_EQUAL(0, queue.length());
+}
+
+static void producer(SampleQueue * pQueue, uint32_t * pRetries)
+{
+	int32_t row[COLUMNS];
+	uint32_t i;
+
+	for (i = 0; i < THREADED_ROWS; i++)
+	{
+		row[0] = i; row[1] = -(int32_t)i; row[2] = i ^ 0x5A5A5A5A;
+
+		// Retry rather than drop, so that every row should arrive
+		while (!pQueue->push(row))
+		{
+			(*pRetries)++;
+			std::this_thread::yield();
+		}
+	}
+}
+
+static void test_RowsArriveInOrderAcrossThreads(void)
+{
+	SampleQueue queue;
+	queue.setSize(64, COLUMNS);
+
+	uint32_t expected = 0;
+	uint32_t retries = 0;
+	bool rowsCorrect = true;
+	int32_t buffer[16 * COLUMNS];
+
+	std::thread producerThread(producer, &queue, &retries);
+
+	while (expected < THREADED_ROWS)
+	{
+		uint32_t count = queue.pop(buffer, 16);
+		uint32_t i;
+		for (i = 0; i < count; i++)
+		{
+			int32_t * row = &buffer[i * COLUMNS];
+			rowsCorrect &= (row[0] == (int32_t)expected);
+			rowsCorrect &= (row[1] == -(int32_t)expected);
+			rowsCorrect &= (row[2] == (int32_t)(expected ^ 0x5A5A5A5A));
+			expected++;
+		}
+		if (!count) { std::this_thread::yield(); }
+	}
+
+	producerThread.join();
+
+	TEST_ASSERT_TRUE(rowsCorrect);
+	TEST_ASSERT_EQUAL(THREADED_ROWS, expected);
+	TEST_ASSERT_EQUAL(retries, queue.dropped());
+	TEST_ASSERT_EQUAL(0, queue.length());
+}
+
+//=======Test Reset Option=====
+void resetTest()
+{
+	tearDown();
+	setUp();
+}
+
+//=======MAIN=====
+int main(void)
+{
+	UnityBegin("DLUtility.SampleQueue.Test.cpp");
+
+	RUN_TEST(test_UnsizedQueueRejectsRows);
+	RUN_TEST(test_CapacityIsRoundedUpToPowerOfTwo);
+	RUN_TEST(test_FullQueueDropsAndCountsRows);
+	RUN_TEST(test_PeekedRowsAreContiguousUpToWrap);
+	RUN_TEST(test_PopCopiesAcrossWrap);
+	RUN_TEST(test_RowsArriveInOrderAcrossThreads);
+
+	return (UnityEnd());
+}
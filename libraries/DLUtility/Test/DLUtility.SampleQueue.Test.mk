@@ -0,0 +1,5 @@
+SRC_FILES += ./DLUtility/DLUtility.RingBuffer.cpp
+CFLAGS += -pthread
+
+local_setup: ;
+local_teardown: ;
@@ -0,0 +1,96 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "../DLUtility.Statistics.h"
+#include "../DLUtility.HelperMacros.h"
+
+static int16_t s_data[] = {2, 4, 4, 4, 5, 5, 7, 9};
+
+static void test_EmptyStatisticsAreZero(void)
+{
+	Statistics<int16_t> statistics;
+
+	TEST_ASSERT_EQUAL(0, statistics.count());
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, statistics.mean());
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, statistics.variance());
+}
+
+static void test_StatisticsAreCorrect(void)
+{
+	Statistics<int16_t> statistics;
+
+	uint8_t i;
+	for (i = 0; i < N_ELE(s_data); i++)
+	{
+		statistics.newData(s_data[i]);
+	}
+
+	TEST_ASSERT_EQUAL(8, statistics.count());
+	TEST_ASSERT_EQUAL(2, statistics.minimum());
+	TEST_ASSERT_EQUAL(9, statistics.maximum());
+	TEST_ASSERT_EQUAL_FLOAT(5.0f, statistics.mean());
+	TEST_ASSERT_EQUAL_FLOAT(4.0f, statistics.variance());
+	TEST_ASSERT_EQUAL_FLOAT(2.0f, statistics.stdDev());
+}
+
+static void test_NegativeValuesAreHandled(void)
+{
+	Statistics<int32_t> statistics;
+
+	statistics.newData(-5);
+	TEST_ASSERT_EQUAL(-5, statistics.minimum());
+	TEST_ASSERT_EQUAL(-5, statistics.maximum());
+
+	statistics.newData(-10);
+	statistics.newData(3);
+	TEST_ASSERT_EQUAL(-10, statistics.minimum());
+	TEST_ASSERT_EQUAL(3, statistics.maximum());
+	TEST_ASSERT_EQUAL_FLOAT(-4.0f, statistics.mean());
+}
+
+static void test_VarianceIsStableWithLargeOffset(void)
+{
+	Statistics<float> statistics;
+
+	// Naive sum-of-squares loses all precision here
+	uint16_t i;
+	for (i = 0; i < 1000; i++)
+	{
+		statistics.newData((i & 1) ? 100001.0f : 99999.0f);
+	}
+
+	TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, statistics.variance());
+}
+
+static void test_ResetClearsStatistics(void)
+{
+	Statistics<uint16_t> statistics;
+
+	statistics.newData(10);
+	statistics.newData(20);
+	statistics.reset();
+	statistics.newData(5);
+
+	TEST_ASSERT_EQUAL(1, statistics.count());
+	TEST_ASSERT_EQUAL(5, statistics.minimum());
+	TEST_ASSERT_EQUAL(5, statistics.maximum());
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, statistics.variance());
+}
+
+int main(void)
+{
+  UnityBegin("DLUtility.Statistics.cpp");
+
+  RUN_TEST(test_EmptyStatisticsAreZero);
+  RUN_TEST(test_StatisticsAreCorrect);
+  RUN_TEST(test_NegativeValuesAreHandled);
+  RUN_TEST(test_VarianceIsStableWithLargeOffset);
+  RUN_TEST(test_ResetClearsStatistics);
+
+  return (UnityEnd());
+}
@@ -0,0 +1,2 @@
+local_setup: ;
+local_teardown: ;